@@ -95,6 +95,10 @@ public:
 
 	void ReadFromBuffer(const Lib3MF_uint64 nBufferBufferSize, const Lib3MF_uint8 * pBufferBuffer);
 
+	void GetCompression(eLib3MFAttachmentCompression & eCompression, Lib3MF_uint32 & nLevel);
+
+	void SetCompression(const eLib3MFAttachmentCompression eCompression, const Lib3MF_uint32 nLevel);
+
 };
 
 }
@@ -91,6 +91,10 @@ public:
 
 	sLib3MFColor GetDisplayColor(const Lib3MF_uint32 nPropertyID);
 
+	void SetDisplayColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer);
+
+	void GetDisplayColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer);
+
 	void GetAllPropertyIDs(Lib3MF_uint64 nPropertyIDsBufferSize, Lib3MF_uint64* pPropertyIDsNeededCount, Lib3MF_uint32 * pPropertyIDsBuffer);
 };
 
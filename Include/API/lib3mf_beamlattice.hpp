@@ -106,6 +106,8 @@ public:
 
 	void SetBeams (const Lib3MF_uint64 nBeamInfoBufferSize, const sLib3MFBeam * pBeamInfoBuffer);
 
+	Lib3MF_uint32 GetDroppedBallCount ();
+
 	void GetBeams (Lib3MF_uint64 nBeamInfoBufferSize, Lib3MF_uint64 * pBeamInfoNeededCount, sLib3MFBeam * pBeamInfoBuffer);
 
 	Lib3MF_uint32 GetBallCount ();
@@ -88,6 +88,16 @@ public:
 
 	sLib3MFColor GetColor (const Lib3MF_uint32 nPropertyID);
 
+	Lib3MF_uint32 AddColors(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer);
+
+	void SetColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer);
+
+	void GetColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer);
+
+	void GetAllColors(Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer);
+
+	void SetAllColors(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer);
+
 	void RemoveColor(const Lib3MF_uint32 nPropertyID);
 
 };
@@ -93,6 +93,10 @@ public:
 
 	virtual void GetVertices(Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64* pVerticesNeededCount, sLib3MFPosition * pVerticesBuffer);
 
+	void GetVertexRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint32 nCount, Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64* pVerticesNeededCount, sLib3MFPosition * pVerticesBuffer);
+
+	void SetVertexRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint64 nVerticesBufferSize, const sLib3MFPosition * pVerticesBuffer);
+
 	sLib3MFTriangle GetTriangle (const Lib3MF_uint32 nIndex);
 
 	void SetTriangle (const Lib3MF_uint32 nIndex, const sLib3MFTriangle Indices);
@@ -125,7 +129,23 @@ public:
 
 	void GetAllTriangleProperties(Lib3MF_uint64 nPropertiesArrayBufferSize, Lib3MF_uint64* pPropertiesArrayNeededCount, sLib3MFTriangleProperties * pPropertiesArrayBuffer);
 
+	void SetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint64 nPropertiesArrayBufferSize, const sLib3MFTriangleProperties * pPropertiesArrayBuffer);
+
+	void GetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint32 nCount, Lib3MF_uint64 nPropertiesArrayBufferSize, Lib3MF_uint64* pPropertiesArrayNeededCount, sLib3MFTriangleProperties * pPropertiesArrayBuffer);
+
 	void ClearAllProperties();
+
+	void BuildBVH();
+
+	void ReleaseBVH();
+
+	bool IntersectRay(const sLib3MFPosition Origin, const sLib3MFPosition Direction, Lib3MF_uint32 & nTriangleIndex, Lib3MF_double & dDistance);
+
+	bool GetClosestPoint(const sLib3MFPosition Point, sLib3MFPosition & sClosestPoint, Lib3MF_uint32 & nTriangleIndex, Lib3MF_double & dDistance);
+
+	void GetTrianglesInBox(const sLib3MFBox Box, Lib3MF_uint64 nTriangleIndicesBufferSize, Lib3MF_uint64* pTriangleIndicesNeededCount, Lib3MF_uint32 * pTriangleIndicesBuffer);
+
+	IMeshValidationReport * Validate(const Lib3MF_uint32 nMaxSampleCount);
 };
 
 }
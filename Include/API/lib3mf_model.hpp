@@ -143,6 +143,8 @@ public:
 
 	IModel * MergeToModel() override;
 
+	IModel * MergeToInstancedModel() override;
+
 	IMeshObject * AddMeshObject() override;
 
 	IComponentsObject * AddComponentsObject() override;
@@ -99,6 +99,24 @@ public:
 
 	Lib3MF_uint32 GetWarningCount ();
 
+	Lib3MF_uint32 GetWarningOccurrenceCount (const Lib3MF_uint32 nIndex);
+
+	void SetAggregateWarnings (const bool bAggregateWarnings);
+
+	bool GetAggregateWarnings ();
+
+	Lib3MF_uint32 GetExtractionThreadCount ();
+
+	void SetExtractionThreadCount (const Lib3MF_uint32 nThreadCount);
+
+	void SetRootModelReadAhead (const bool bReadAhead);
+
+	bool GetRootModelReadAhead ();
+
+	void SetPackageConsistencyCheck (const bool bCheckConsistency);
+
+	bool GetPackageConsistencyCheck ();
+
 	void AddKeyWrappingCallback(const std::string &sConsumerID, const Lib3MF::KeyWrappingCallback pTheCallback,  const Lib3MF_pvoid pUserData);
 
 	void SetContentEncryptionCallback(const Lib3MF::ContentEncryptionCallback pTheCallback, const Lib3MF_pvoid pUserData);
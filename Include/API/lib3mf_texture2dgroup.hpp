@@ -88,6 +88,14 @@ public:
 
 	sLib3MFTex2Coord GetTex2Coord (const Lib3MF_uint32 nPropertyID);
 
+	Lib3MF_uint32 AddTex2Coords(const Lib3MF_uint64 nUVCoordinatesBufferSize, const sLib3MFTex2Coord * pUVCoordinatesBuffer);
+
+	void GetTex2Coords(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, Lib3MF_uint64 nUVCoordinatesBufferSize, Lib3MF_uint64* pUVCoordinatesNeededCount, sLib3MFTex2Coord * pUVCoordinatesBuffer);
+
+	void GetAllTex2Coords(Lib3MF_uint64 nUVCoordinatesBufferSize, Lib3MF_uint64* pUVCoordinatesNeededCount, sLib3MFTex2Coord * pUVCoordinatesBuffer);
+
+	void SetAllTex2Coords(const Lib3MF_uint64 nUVCoordinatesBufferSize, const sLib3MFTex2Coord * pUVCoordinatesBuffer);
+
 	void RemoveTex2Coord(const Lib3MF_uint32 nPropertyID);
 
 };
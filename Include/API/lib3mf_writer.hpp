@@ -66,6 +66,8 @@ private:
 	NMR::PModelWriter m_pWriter;
 
 	NMR::PExportStreamMemory momentBuffer;
+
+	NMR::EXPORTSTREAMFILEOPTIONS m_FileOptions;
 protected:
 
 	/**
@@ -98,6 +100,12 @@ public:
 
 	void SetDecimalPrecision(const Lib3MF_uint32 nDecimalPrecision) override;
 
+	Lib3MF_uint32 GetEncryptionThreadCount() override;
+
+	void SetEncryptionThreadCount(const Lib3MF_uint32 nThreadCount) override;
+
+	void SetFileWriteOptions(const Lib3MF_uint64 nSizeHint, const bool bDropWrittenPages, const bool bDirectIO) override;
+
 	void AddKeyWrappingCallback(const std::string & sConsumerID, const Lib3MF::KeyWrappingCallback pTheCallback, const Lib3MF_pvoid pUserData);
 
 	void SetContentEncryptionCallback(const Lib3MF::ContentEncryptionCallback pTheCallback, const Lib3MF_pvoid pUserData);
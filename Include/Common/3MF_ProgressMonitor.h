@@ -33,6 +33,7 @@ Abstract: Progress Monitor
 
 #include "Common/3MF_ProgressTypes.h"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <stack>
@@ -47,13 +48,16 @@ namespace NMR
 #define PROGRESS_READSLICESUPDATE 100
 #define PROGRESS_READBUFFERUPDATE 100
 
+// Minimum time between two callback calls in milliseconds. PROGRESS_DONE is always reported.
+#define PROGRESS_CALLBACKINTERVAL 100
+
 	class CProgressMonitor
 	{
 	public:
 		CProgressMonitor();
 		void SetProgressCallback(Lib3MFProgressCallback callback, void* userData);
 		void ClearProgressCallback();
-		// Returns true if the last callback call returned false
+		// Returns true if the last callback call requested to abort
 		bool WasAborted();
 		bool QueryCancelled(bool throwIfCancelled);
 		bool ReportProgressAndQueryCancelled(bool throwIfCancelled);
@@ -66,13 +70,19 @@ namespace NMR
 		static void GetProgressMessage(ProgressIdentifier progressIdentifier, std::string& progressString);
 
 	private:
-		ProgressIdentifier m_eProgressIdentifier;
-		double m_dProgress;
-		double m_dProgressMax;
+		std::atomic<ProgressIdentifier> m_eProgressIdentifier;
+		std::atomic<double> m_dProgress;
+		std::atomic<double> m_dProgressMax;
 		Lib3MFProgressCallback m_progressCallback;
 		void* m_userData;
-		bool m_lastCallbackResult;
+		std::atomic<bool> m_bAborted;
 		std::mutex m_callbackMutex;
+
+		// Only written while m_callbackMutex is held
+		std::atomic<long long> m_nNextCallbackTime;
+
+		bool isCallbackDue(ProgressIdentifier identifier);
+		bool reportProgress(ProgressIdentifier identifier, bool throwIfCancelled);
 	};
 
 	typedef std::shared_ptr <CProgressMonitor> PProgressMonitor;
@@ -38,7 +38,7 @@ NMR_MeshBeamLattice.h defines the class CMeshBeamLattice.
 #include "Common/NMR_Types.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 
-#include <unordered_set>
+#include <vector>
 
 namespace NMR {
 
@@ -47,17 +47,28 @@ namespace NMR {
 		friend class CMesh;
 
 		MESHNODES &m_Nodes;	// reference to the nodes of the parent mesh
-		std::unordered_set<nfInt32> m_OccupiedNodes;    // datastructure used to ensure that balls are only placed at nodes with beams
+		std::vector<nfUint64> m_OccupiedNodes;    // bitmap over the node indices, used to ensure that balls are only placed at nodes with beams
+		nfUint32 m_nOccupiedNodeCount;
+		std::vector<nfInt32> m_OccupiedNodeIndices;    // sorted list of occupied nodes, built on demand for index based access
+		nfBool m_bOccupiedNodeIndicesValid;
 		MESHBEAMS m_Beams;
 		std::vector<PBEAMSET> m_pBeamSets;
 		MESHBALLS m_Balls;
+		nfUint32 m_nDroppedBallCount;	// number of balls that the last validation of the balls removed
 		
 		nfDouble m_dMinLength;
+		nfDouble m_dDefaultRadius;
+		eModelBeamLatticeCapMode m_eDefaultCapMode;
 		eModelBeamLatticeBallMode m_eBallMode;
 		nfDouble m_dDefaultBallRadius;
 	public:
 		CBeamLattice(_In_ MESHNODES &nodes);
 
+		void occupyNode(_In_ nfInt32 nNodeIndex);
+		nfBool isNodeOccupied(_In_ nfInt32 nNodeIndex);
+		nfInt32 getOccupiedNodeIndex(_In_ nfUint32 nIdx);
+		void clearOccupiedNodes();
+
 		void clearBeams();
 		void clearBalls();
 		void clear();
@@ -48,9 +48,13 @@ You can only add nodes and faces to mesh. You cannot remove the existing structu
 #include "Common/Mesh/NMR_BeamLattice.h"
 
 #include <map>
+#include <vector>
+#include <memory>
 
 namespace NMR {
 
+	class CMeshBVH;
+
 	class CMesh {
 	private:
 		MESHNODES m_Nodes;
@@ -59,6 +63,16 @@ namespace NMR {
 
 		PMeshInformationHandler m_pMeshInformationHandler;
 
+		// Cached local outbox and the node positions which may lie on the convex hull
+		NOUTBOX3 m_LocalOutbox;
+		std::vector<NVEC3> m_OutboxHullCandidates;
+		nfBool m_bOutboxIsValid;
+
+		// Lazily built bounding volume hierarchy of the faces
+		std::shared_ptr<CMeshBVH> m_pBVH;
+
+		void updateOutboxCache();
+
 	public:
 		CMesh();
 		CMesh(_In_opt_ CMesh * pMesh);
@@ -74,6 +88,8 @@ namespace NMR {
 		_Ret_notnull_ MESHFACE * addFace(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfInt32 nNodeIndex3);
 		_Ret_notnull_ MESHBEAM * addBeam(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
 			_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2);
+		_Ret_notnull_ MESHBEAM * addBeam(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
+			_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2);
 		_Ret_notnull_ MESHBALL * addBall(_In_ MESHNODE * pNode, _In_ nfDouble dRadius);
 		_Ret_notnull_ PBEAMSET addBeamSet();
 		
@@ -95,11 +111,11 @@ namespace NMR {
 		void setBeamLatticeMinLength(nfDouble dMinLength);
 		nfDouble getBeamLatticeMinLength();
 
-		// TODO: make these return sensible values
 		void setDefaultBeamRadius(nfDouble dRadius);
 		nfDouble getDefaultBeamRadius();
 		void setDefaultBallRadius(nfDouble dBallRadius);
 		nfDouble getDefaultBallRadius();
+		// TODO: make these return sensible values
 		void setBeamLatticeAccuracy(nfDouble dAccuracy);
 		nfBool getBeamLatticeAccuracy(nfDouble& dAccuracy);
 		void setBeamLatticeBallMode(eModelBeamLatticeBallMode eBallMode);
@@ -114,13 +130,22 @@ namespace NMR {
 		void clearBeamLatticeBeams();
 		void clearBeamLatticeBalls();
 		void scanOccupiedNodes();
-		void validateBeamLatticeBalls();
+		// Removes all balls which are not placed at a node with a beam and remaps the ball references of the beamsets, returns the number of removed balls
+		nfUint32 validateBeamLatticeBalls();
+		// Returns the number of balls that the last call of validateBeamLatticeBalls removed
+		nfUint32 getBeamLatticeDroppedBallCount();
 
 		_Ret_maybenull_ CMeshInformationHandler * getMeshInformationHandler();
 		_Ret_notnull_ CMeshInformationHandler * createMeshInformationHandler();
 		void clearMeshInformationHandler();
 		void patchMeshInformationResources(_In_ std::map<UniqueResourceID, UniqueResourceID> &oldToNewMapping);
 		void extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix);
+		NOUTBOX3 getLocalOutbox();
+		// Has to be called after node positions or face indices have been changed in place
+		void invalidateGeometryCache();
+
+		_Ret_notnull_ CMeshBVH * getBVH();
+		void releaseBVH();
 	};
 
 	typedef std::shared_ptr <CMesh> PMesh;
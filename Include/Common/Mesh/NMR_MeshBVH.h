@@ -0,0 +1,115 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshBVH.h defines the class CMeshBVH.
+
+CMeshBVH is a bounding volume hierarchy over the faces of a mesh. It is built with
+a binned surface area heuristic and stores its nodes in depth first order in one flat
+array, with copies of the triangle corners in leaf order, so that queries only touch
+contiguous memory. It answers ray intersection, closest point and outbox overlap queries.
+
+The hierarchy is a snapshot of the mesh: it has to be rebuilt once the mesh changes.
+
+--*/
+
+#ifndef __NMR_MESHBVH
+#define __NMR_MESHBVH
+
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Math/NMR_Geometry.h"
+#include "Common/NMR_Types.h"
+
+#include <vector>
+#include <memory>
+
+// Maximum number of triangles in a leaf, and the size up to which a leaf may be kept if splitting does not pay off
+#define NMR_MESHBVH_MAXLEAFSIZE 4
+#define NMR_MESHBVH_MAXSAHLEAFSIZE 16
+#define NMR_MESHBVH_BINCOUNT 16
+// Below this depth, nodes are split at the median to keep the hierarchy shallow for degenerate inputs
+#define NMR_MESHBVH_MAXSAHDEPTH 48
+#define NMR_MESHBVH_MAXSTACKSIZE 256
+// Subtrees with at least this many faces are built on a separate thread, up to the given depth
+#define NMR_MESHBVH_PARALLELMINFACECOUNT 65536
+#define NMR_MESHBVH_PARALLELMAXDEPTH 3
+
+namespace NMR {
+
+	typedef struct {
+		NOUTBOX3 m_Outbox;
+		// Leaf nodes: index of the first triangle. Inner nodes: index of the second child (the first child follows directly).
+		nfUint32 m_nFirst;
+		// Number of triangles of a leaf node, 0 for inner nodes
+		nfUint32 m_nCount;
+	} MESHBVHNODE;
+
+	typedef struct {
+		NVEC3 m_vCorners[3];
+		nfUint32 m_nFaceIndex;
+	} MESHBVHTRIANGLE;
+
+	typedef struct {
+		nfUint32 m_nFaceIndex;
+		nfFloat m_fDistance;
+		NVEC3 m_vPosition;
+	} MESHBVHHIT;
+
+	typedef struct {
+		NOUTBOX3 m_Outbox;
+		NVEC3 m_vCentroid;
+		nfUint32 m_nFaceIndex;
+	} MESHBVHBUILDITEM;
+
+	class CMeshBVH {
+	private:
+		std::vector<MESHBVHNODE> m_Nodes;
+		std::vector<MESHBVHTRIANGLE> m_Triangles;
+
+		void buildSubtree(_Inout_ std::vector<MESHBVHNODE> & Nodes, _Inout_ std::vector<MESHBVHBUILDITEM> & Items, _In_ nfUint32 nBegin, _In_ nfUint32 nEnd, _In_ nfUint32 nDepth);
+		nfBool findSplit(_Inout_ std::vector<MESHBVHBUILDITEM> & Items, _In_ nfUint32 nBegin, _In_ nfUint32 nEnd, _In_ const NOUTBOX3 & Outbox, _In_ nfUint32 nDepth, _Out_ nfUint32 & nSplit);
+
+	public:
+		CMeshBVH() = delete;
+		CMeshBVH(_In_ CMesh * pMesh);
+
+		nfUint32 getNodeCount();
+		nfUint32 getTriangleCount();
+
+		// Finds the first face hit by a ray. Faces are hit from both sides, the distance is measured in multiples of the direction.
+		nfBool intersectRay(_In_ const NVEC3 vOrigin, _In_ const NVEC3 vDirection, _Out_ MESHBVHHIT & Hit);
+		// Finds the point on the surface of the mesh that is closest to vPoint
+		nfBool findClosestPoint(_In_ const NVEC3 vPoint, _Out_ MESHBVHHIT & Hit);
+		// Returns the sorted indices of all faces that intersect an outbox
+		void findOverlappingFaces(_In_ const NOUTBOX3 & Outbox, _Out_ std::vector<nfUint32> & FaceIndices);
+	};
+
+	typedef std::shared_ptr <CMeshBVH> PMeshBVH;
+
+}
+
+#endif // __NMR_MESHBVH
@@ -50,12 +50,18 @@ In addition, some constants are defined here.
 
 #define NMR_MESH_MAXCOORDINATE 1000000000.0f
 
+// Relative distance a node needs to keep from the estimated hull to be excluded from the outbox hull candidates
+#define NMR_MESH_OUTBOXHULLMARGIN 1.0e-9
+// Meshes with fewer nodes keep all nodes as outbox hull candidates
+#define NMR_MESH_OUTBOXHULLMINNODECOUNT 64
+
 #define NMR_MESH_NODEBLOCKCOUNT 256
 #define NMR_MESH_EDGEBLOCKCOUNT 256
 #define NMR_MESH_FACEBLOCKCOUNT 256
-#define NMR_MESH_BEAMBLOCKCOUNT 256
+#define NMR_MESH_BEAMBLOCKCOUNT 4096
 #define NMR_MESH_BALLBLOCKCOUNT 256
 #define NMR_MESH_NODEEDGELINKBLOCKCOUNT 256
+#define NMR_MESH_BEAMSETREFBLOCKCOUNT 4096
 
 namespace NMR {
 
@@ -83,12 +89,13 @@ namespace NMR {
 	} BEAMSET;
 	typedef std::shared_ptr <BEAMSET> PBEAMSET;
 
+	// Beams are stored compactly (20 bytes per beam), as lattices can consist of hundreds of millions of them.
+	// The index of a beam is its position within the beam lattice, radii are stored in single precision
+	// and the cap modes (eModelBeamLatticeCapMode) are stored as bytes.
 	typedef struct MESHBEAM {
-		nfInt32 m_index;
 		nfInt32 m_nodeindices[2];
-		nfDouble m_radius[2];
-		nfInt32 m_capMode[2];
-		// eModelBeamLatticeCapMode m_capMode[2];
+		nfSingle m_radius[2];
+		nfByte m_capMode[2];
 		MESHBEAM() { 
 		};
 	} MESHBEAM;
@@ -0,0 +1,119 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshValidator.h defines the class CMeshValidator.
+
+CMeshValidator checks a mesh for invalid node indices and coordinates, degenerate and
+duplicate faces, and for edges that are open, non-manifold or inconsistently oriented.
+It reports the number of occurrences of each issue together with a limited number of
+sample indices, so that large defective meshes can be diagnosed without listing every defect.
+
+The faces and nodes are split into ranges that are processed on separate threads. Edges and
+faces are grouped by distributing them into buckets of node indices, followed by a counting
+sort per bucket, so no global sort or search tree is needed. The result does not depend on
+the number of threads.
+
+--*/
+
+#ifndef __NMR_MESHVALIDATOR
+#define __NMR_MESHVALIDATOR
+
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/NMR_Types.h"
+
+#include <vector>
+#include <memory>
+
+// Number of node index buckets that edges and faces are distributed to
+#define NMR_MESHVALIDATOR_BUCKETCOUNT 256
+// Ranges with less than this many faces or nodes are not split among threads
+#define NMR_MESHVALIDATOR_PARALLELMINCOUNT 65536
+#define NMR_MESHVALIDATOR_MAXTHREADCOUNT 64
+#define NMR_MESHVALIDATOR_DEFAULTSAMPLECOUNT 16
+// A face has zero area, if the sine of the angle between its edges is at most this value
+#define NMR_MESHVALIDATOR_ZEROAREAEPSILON 1.0E-6
+
+namespace NMR {
+
+	enum eMeshValidationIssue {
+		// Node issues, samples are node indices
+		MESHVALIDATIONISSUE_COORDINATEOUTOFRANGE = 0,
+		// Face issues, samples are face indices
+		MESHVALIDATIONISSUE_NODEINDEXOUTOFRANGE = 1,
+		MESHVALIDATIONISSUE_REPEATEDNODEINDEX = 2,
+		MESHVALIDATIONISSUE_ZEROAREAFACE = 3,
+		MESHVALIDATIONISSUE_DUPLICATEFACE = 4,
+		// Edge issues, counted per edge, samples are the indices of the faces adjacent to the edges
+		MESHVALIDATIONISSUE_BOUNDARYEDGE = 5,
+		MESHVALIDATIONISSUE_NONMANIFOLDEDGE = 6,
+		MESHVALIDATIONISSUE_INCONSISTENTORIENTATION = 7
+	};
+
+#define NMR_MESHVALIDATOR_ISSUECOUNT 8
+
+	typedef struct {
+		nfUint64 m_nCount;
+		std::vector<nfUint32> m_Samples;
+	} MESHVALIDATIONRESULT;
+
+	class CMeshValidator {
+	private:
+		nfUint32 m_nNodeCount;
+		nfUint32 m_nFaceCount;
+		nfUint32 m_nMaxSampleCount;
+		MESHVALIDATIONRESULT m_Results[NMR_MESHVALIDATOR_ISSUECOUNT];
+
+		void validateNodes(_In_ CMesh * pMesh);
+		void validateFaces(_In_ CMesh * pMesh, _In_ nfBool bCheckGeometry);
+		void validateEdges(_In_ CMesh * pMesh);
+		void validateDuplicateFaces(_In_ CMesh * pMesh);
+
+	public:
+		CMeshValidator() = delete;
+		// Validates the mesh. bCheckGeometry = false skips the checks for coordinates, zero area and duplicate faces.
+		CMeshValidator(_In_ CMesh * pMesh, _In_ nfUint32 nMaxSampleCount, _In_ nfBool bCheckGeometry = true);
+
+		nfUint32 getNodeCount();
+		nfUint32 getFaceCount();
+		nfUint32 getMaxSampleCount();
+
+		nfUint64 getIssueCount(_In_ eMeshValidationIssue eIssue);
+		// Returns up to the maximum sample count of the smallest indices affected by an issue, in ascending order
+		const std::vector<nfUint32> & getIssueSamples(_In_ eMeshValidationIssue eIssue);
+
+		// Returns true if no issue has been found
+		nfBool isValid();
+		// Returns true if the mesh has at least three nodes and faces, valid face indices and every edge is shared by exactly two faces in opposite direction
+		nfBool isManifoldAndOriented();
+	};
+
+	typedef std::shared_ptr <CMeshValidator> PMeshValidator;
+
+}
+
+#endif // __NMR_MESHVALIDATOR
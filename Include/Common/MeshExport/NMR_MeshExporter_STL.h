@@ -41,6 +41,9 @@ This is a derived class for Exporting the binary STL and color STL Mesh Format.
 
 #include <vector>
 
+// Number of facets that are collected before they are written to the stream
+#define NMR_MESHEXPORTER_STL_FACETBUFFERSIZE 1024
+
 namespace NMR {
 
 	class CMeshExporter_STL : public CMeshExporter {
@@ -51,6 +54,11 @@ namespace NMR {
 		CMeshExporter_STL(PExportStream pStream);
 
 		virtual void exportMeshEx(_In_ CMesh * pMesh, _In_opt_ NMATRIX3 * pmMatrix, _In_opt_ CMeshExportEdgeMap * pExportEdgeMap);
+
+		// Writes the header and facet count. Exactly nFacetCount facets have to be written with writeFacets afterwards.
+		void writeHeader(_In_ nfUint32 nFacetCount);
+		// Writes the faces of a mesh as facets, in chunks of NMR_MESHEXPORTER_STL_FACETBUFFERSIZE
+		void writeFacets(_In_ CMesh * pMesh, _In_opt_ const NMATRIX3 * pmMatrix);
 	};
 
 }
@@ -40,6 +40,7 @@ a relaxed import policy on the file format.
 #include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 #define NMR_MAXWARNINGCOUNT 1000000000
 
@@ -57,32 +58,51 @@ namespace NMR {
 		std::string m_sMessage;
 		eModelWarningLevel m_WarningLevel;
 		nfError m_nErrorCode;
+		nfUint32 m_nOccurrenceCount;
 	public:
 		CModelWarning() = delete;
-		CModelWarning(std::string sMessage, eModelWarningLevel WarningLevel, nfError nErrorCode);
+		CModelWarning(std::string sMessage, eModelWarningLevel WarningLevel, nfError nErrorCode, nfUint32 nOccurrenceCount = 1);
 
 		std::string getMessage();
 		eModelWarningLevel getWarningLevel();
 		nfError getErrorCode();
+		nfUint32 getOccurrenceCount();
 	};
 
 	typedef std::shared_ptr <CModelWarning> PModelReaderWarning;
 
+	// Compact record of a warning, the message is only formatted when the warning is retrieved
+	typedef struct {
+		nfError m_nErrorCode;
+		eModelWarningLevel m_WarningLevel;
+		nfUint32 m_nOccurrenceCount;
+		nfInt32 m_nCustomMessageIndex; // -1, if the message is the default message of the error code
+	} MODELWARNINGENTRY;
+
 	class CModelWarnings {
 	private:
-		std::vector<PModelReaderWarning> m_Warnings;
+		std::vector<MODELWARNINGENTRY> m_Warnings;
+		std::vector<std::string> m_CustomMessages;
 		eModelWarningLevel m_CriticalWarningLevel;
+
+		// In aggregation mode, warnings with the same error code and level share one entry
+		nfBool m_bAggregateWarnings;
+		std::unordered_map<nfUint64, nfUint32> m_AggregatedWarningIndices;
 	public:
 		CModelWarnings();
 
 		eModelWarningLevel getCriticalWarningLevel ();
 		void setCriticalWarningLevel(_In_ eModelWarningLevel WarningLevel);
 
+		nfBool getAggregateWarnings();
+		void setAggregateWarnings(_In_ nfBool bAggregateWarnings);
+
 		void addWarning(_In_ nfError nErrorCode, _In_ eModelWarningLevel WarningLevel);
 		void addException(const _In_ CNMRException & Exception, _In_ eModelWarningLevel WarningLevel);
 
 		nfUint32 getWarningCount();
 		PModelReaderWarning getWarning(_In_ nfUint32 nIndex);
+		nfUint32 getWarningOccurrenceCount(_In_ nfUint32 nIndex);
 	};
 
 	typedef std::shared_ptr <CModelWarnings> PModelWarnings;
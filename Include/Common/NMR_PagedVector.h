@@ -126,6 +126,20 @@ namespace NMR {
 			return block[nIdx % m_nBlockSize];
 		}
 
+		// Drops all elements from index nNewCount on and frees the blocks which are not used anymore.
+		void shrinkToCount(_In_ nfUint32 nNewCount) {
+			if (nNewCount > m_nCount)
+				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+			size_t nBlockCount = ((size_t)nNewCount + m_nBlockSize - 1) / m_nBlockSize;
+			for (size_t nBlockIndex = nBlockCount; nBlockIndex < m_pBlocks.size(); nBlockIndex++)
+				delete[] m_pBlocks[nBlockIndex];
+			m_pBlocks.resize(nBlockCount);
+
+			m_nCount = nNewCount;
+			m_pHeadBlock = (nBlockCount > 0) ? m_pBlocks.back() : NULL;
+		}
+
 		void clearAllData() {
 			for (auto iIterator = m_pBlocks.begin(); iIterator != m_pBlocks.end(); iIterator++)
 			{
@@ -44,6 +44,7 @@ namespace NMR {
 	typedef int nfError;
 	typedef bool nfBool;
 	typedef double nfFloat;
+	typedef float nfSingle;
 	typedef double nfDouble;
 	typedef unsigned int nfUint32;
 	typedef unsigned int nfColor;
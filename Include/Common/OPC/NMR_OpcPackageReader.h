@@ -48,6 +48,12 @@ NMR_OpcPackageReader.h defines an OPC Package reader in a portable way.
 
 namespace NMR {
 
+	typedef struct {
+		std::string m_sName;
+		nfUint64 m_nIndex;
+		nfUint64 m_nSize;
+	} OPCPACKAGEZIPENTRY;
+
 	class COpcPackageReader: public IOpcPackageReader {
 	protected:
 		PModelWarnings m_pWarnings;
@@ -57,7 +63,8 @@ namespace NMR {
 		std::vector<nfByte> m_Buffer;
 		zip_error_t m_ZIPError;
 		zip_t * m_ZIParchive;
-		std::map <std::string, nfUint64> m_ZIPEntries;
+		// ZIP entries sorted by name, read once from the central directory
+		std::vector<OPCPACKAGEZIPENTRY> m_ZIPEntries;
 		std::map <std::string, POpcPackagePart> m_Parts;
 
 		std::string m_relationShipExtension;
@@ -67,6 +74,9 @@ namespace NMR {
 
 		void releaseZIP();
 
+		void readZIPEntries();
+		_Ret_maybenull_ const OPCPACKAGEZIPENTRY * findZIPEntry(_In_ const std::string & sName);
+
 		PImportStream openZIPEntry(_In_ std::string sName);
 		PImportStream openZIPEntryIndexed(_In_ nfUint64 nIndex);
 
@@ -74,7 +84,9 @@ namespace NMR {
 		void readRootRelationships();
 
 	public:
-		COpcPackageReader(_In_ PImportStream pImportStream, _In_ PModelWarnings pWarnings, _In_ PProgressMonitor pProgressMonitor);
+		// Without bCheckConsistency, local headers are not compared against the central directory when opening.
+		// Entries are still verified by their sizes and checksums when they are read.
+		COpcPackageReader(_In_ PImportStream pImportStream, _In_ PModelWarnings pWarnings, _In_ PProgressMonitor pProgressMonitor, _In_ nfBool bCheckConsistency);
 		~COpcPackageReader();
 
 		_Ret_maybenull_ COpcPackageRelationship * findRootRelation(_In_ std::string sRelationType, _In_ nfBool bMustBeUnique) override;
@@ -67,6 +67,7 @@ namespace NMR {
 		~COpcPackageWriter();
 
 		POpcPackagePart addPart(_In_ std::string sPath) override;
+		POpcPackagePart addPart(_In_ std::string sPath, _In_ nfUint16 nCompressionMethod, _In_ nfInt32 nCompressionLevel) override;
 
 		void addContentType(_In_ std::string sExtension, _In_ std::string sContentType) override;
 		void addContentType(_In_ POpcPackagePart pOpcPackagePart, _In_ std::string sContentType) override;
@@ -42,6 +42,13 @@ This is an abstract base stream class for exporting from various data sources.
 
 namespace NMR {
 
+	// Hints for native file streams, which are ignored where the platform does not support them
+	typedef struct {
+		nfUint64 m_nSizeHint; // Expected file size, which is preallocated. 0 preallocates as the file grows.
+		nfBool m_bDropWrittenPages; // Writes back data early and drops it from the page cache
+		nfBool m_bDirectIO; // Writes whole blocks past the page cache
+	} EXPORTSTREAMFILEOPTIONS;
+
 	class CExportStream {
 	private:
 	public:
@@ -53,7 +60,9 @@ namespace NMR {
 		virtual nfUint64 getPosition () = 0;
 		virtual nfUint64 writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite) = 0;
 		virtual void close();
-		void copyFrom(_In_ CImportStream * pImportStream, _In_ nfUint64 cbCount, _In_ nfUint32 cbBufferSize);
+		// Returns false for streams that can only be written sequentially
+		virtual nfBool canSeek();
+		virtual void copyFrom(_In_ CImportStream * pImportStream, _In_ nfUint64 cbCount, _In_ nfUint32 cbBufferSize);
 	};
 
 	typedef std::shared_ptr <CExportStream> PExportStream;
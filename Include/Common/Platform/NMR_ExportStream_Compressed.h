@@ -38,7 +38,12 @@ NMR_ExportStream_Compressed.h defines a stream to write compressed files
 #include "Common/Platform/NMR_PortableZIPWriter.h"
 #include "Libraries/zlib/zlib.h"
 
-#define EXPORTSTREAM_WRITE_BUFFER_CHUNKSIZE 1024
+#include <vector>
+
+// Size of the output chunks that are passed on to the underlying stream. Every chunk
+// is a separate write, which is a separate encryption callback for secured parts.
+#define EXPORTSTREAM_COMPRESSED_DEFAULTCHUNKSIZE 262144
+#define EXPORTSTREAM_COMPRESSED_MINCHUNKSIZE 1024
 
 namespace NMR {
 
@@ -46,12 +51,13 @@ namespace NMR {
 	private:
 		z_stream m_strm;
 		PExportStream m_pUncompressedStream;
-		nfByte out[EXPORTSTREAM_WRITE_BUFFER_CHUNKSIZE];
+		std::vector<nfByte> m_OutBuffer;
 
 		nfInt32 compress(nfInt32 flush);
 	public:
 		CExportStream_Compressed() = delete;
 		CExportStream_Compressed(PExportStream pUncompressedStream);
+		CExportStream_Compressed(PExportStream pUncompressedStream, nfInt32 nCompressionLevel, nfUint32 cbChunkSize);
 		~CExportStream_Compressed();
 
 		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed);
@@ -40,6 +40,8 @@ to the proper callbacks that will decrypt the content before returning back to t
 #include "Common/Platform/NMR_ExportStream.h"
 #include "Common/Platform/NMR_EncryptionHeader.h"
 
+#include <vector>
+
 namespace NMR {
 
 
@@ -48,6 +50,8 @@ namespace NMR {
 		PExportStream m_pEncryptedStream;
 		ContentEncryptionDescriptor m_pDecryptContext;
 		CEncryptionHeader m_header;
+		// Scratch buffer for the encrypted data, reused across writes
+		std::vector<nfByte> m_EncryptedBuffer;
 	public:
 		CExportStream_Encrypted(PExportStream pEncryptedStream, ContentEncryptionDescriptor context);
 
@@ -0,0 +1,95 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ExportStream_GCC_POSIX.h defines the CExportStream_GCC_POSIX Class.
+This is a file export stream on POSIX file descriptors, which collects writes in
+a large aligned buffer and writes it with pwrite.
+
+--*/
+
+#ifndef __NMR_EXPORTSTREAM_GCC_POSIX
+#define __NMR_EXPORTSTREAM_GCC_POSIX
+
+#include "Common/Platform/NMR_ExportStream.h"
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+
+#define NMR_EXPORTSTREAM_POSIX_BUFFERSIZE (4 * 1024 * 1024)
+// Block size for O_DIRECT, which has to divide the buffer size
+#define NMR_EXPORTSTREAM_POSIX_ALIGNMENT 4096
+#define NMR_EXPORTSTREAM_POSIX_PREALLOCATIONSTEP (64 * 1024 * 1024)
+#define NMR_EXPORTSTREAM_POSIX_WRITEBACKWINDOW (32 * 1024 * 1024)
+
+namespace NMR {
+
+#ifndef _WIN32
+
+	class CExportStream_GCC_POSIX : public CExportStream {
+	private:
+		int m_nFileDescriptor;
+		// Second descriptor opened with O_DIRECT, or -1. Unaligned pieces go through m_nFileDescriptor.
+		int m_nDirectFileDescriptor;
+		EXPORTSTREAMFILEOPTIONS m_Options;
+
+		// The buffer holds the file range [m_nBufferPosition, m_nBufferPosition + m_cbBufferFill),
+		// and the write position is at its end.
+		nfByte * m_pBuffer;
+		nfUint64 m_nBufferPosition;
+		nfUint64 m_cbBufferFill;
+
+		nfUint64 m_nFileSize;
+		nfUint64 m_nAllocatedSize;
+		nfBool m_bCanPreallocate;
+		nfUint64 m_nWritebackPosition;
+		nfUint64 m_nDroppedPosition;
+
+		void startBuffer(_In_ nfUint64 nPosition);
+		void flushBuffer();
+		void writeToFile(_In_ int nFileDescriptor, _In_ const nfByte * pData, _In_ nfUint64 cbCount, _In_ nfUint64 nPosition);
+		void preallocate(_In_ nfUint64 nEndPosition);
+		void writeBack();
+		void releaseFile();
+	public:
+		CExportStream_GCC_POSIX() = delete;
+		CExportStream_GCC_POSIX(_In_ const nfWChar * pwszFileName, _In_ const EXPORTSTREAMFILEOPTIONS & Options);
+		~CExportStream_GCC_POSIX();
+
+		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed);
+		virtual nfBool seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed);
+		virtual nfBool seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed);
+		virtual nfUint64 getPosition();
+		virtual nfUint64 writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite);
+		// Writes out the buffer, so that write errors are reported
+		virtual void close();
+	};
+
+#endif // _WIN32
+
+}
+
+#endif // __NMR_EXPORTSTREAM_GCC_POSIX
@@ -28,6 +28,11 @@ Abstract:
 
 NMR_ExportStream_Memory.h defines the ExportStream to Memory Class.
 
+The data is kept in a list of chunks, so that growing the stream never moves the data
+that has already been written. The first chunks are small and double in size up to
+NMR_EXPORTSTREAM_MEMORY_MAXCHUNKSIZE, so small streams stay small. The chunks can be
+read in place, which avoids flattening large streams into one contiguous buffer.
+
 --*/
 
 #ifndef _NMR_EXPORT_STREAM_MEMORY
@@ -39,14 +44,31 @@ NMR_ExportStream_Memory.h defines the ExportStream to Memory Class.
 #include "Common/NMR_Local.h"
 #include "Common/Platform/NMR_ImportStream.h"
 #include <vector>
+#include <memory>
+
+#define NMR_EXPORTSTREAM_MEMORY_MINCHUNKSIZE (64ULL * 1024ULL)
+#define NMR_EXPORTSTREAM_MEMORY_MAXCHUNKSIZE (8ULL * 1024ULL * 1024ULL)
 
 namespace NMR {
 
+	typedef struct {
+		std::unique_ptr<nfByte[]> m_pData;
+		nfUint64 m_nStart;
+		nfUint64 m_cbCapacity;
+	} EXPORTSTREAMMEMORYCHUNK;
+
 	class CExportStreamMemory : public CExportStream {
 	private:
-		std::vector<nfByte> m_Buffer;
+		std::vector<EXPORTSTREAMMEMORYCHUNK> m_Chunks;
+		nfUint64 m_cbSize;
 		nfUint64 m_Position;
 
+		// Returns the index of the chunk that contains nPosition, which has to be below the capacity of the last chunk
+		nfUint32 findChunk(_In_ nfUint64 nPosition);
+		void appendChunk();
+		// Writes cbBytes at nPosition, growing the chunk list as needed. A null buffer writes zeros.
+		void writeData(_In_ nfUint64 nPosition, _In_opt_ const nfByte * pBuffer, _In_ nfUint64 cbBytes);
+
 	public:
 		CExportStreamMemory();
 
@@ -57,6 +79,17 @@ namespace NMR {
 		virtual nfUint64 writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite);
 
 		nfUint64 getDataSize();
+		// Empties the stream, but keeps its chunks allocated to be written again
+		void clear();
+
+		// Gathers the data without flattening it: the chunks are returned in order, the last one may be partially filled
+		nfUint32 getChunkCount();
+		const nfByte * getChunkData(_In_ nfUint32 nIndex, _Out_ nfUint64 & cbChunkSize);
+		// Copies cbBytes from nPosition on into pBuffer
+		void copyData(_In_ nfUint64 nPosition, _In_ nfUint64 cbBytes, _Out_ nfByte * pBuffer);
+
+		// Returns the data as one contiguous buffer. This merges all chunks into one and should be avoided for large streams.
+		// Merging frees the chunks, so pointers returned by getChunkData before are invalid afterwards.
 		const nfByte *getData();
 	};
 
@@ -49,16 +49,19 @@ namespace NMR {
 	private:
 		CPortableZIPWriter * m_pZIPWriter;
 		nfUint32 m_nEntryKey;
+		nfUint16 m_nCompressionMethod;
 		z_stream m_pStream;
 		std::array<nfByte, ZIPEXPORTBUFFERSIZE> m_nOutBuffer;
 
 		nfBool m_bIsInitialized;
+		nfBool m_bHasDeflatedContent;
 
 		nfUint32 writeChunk(_In_ const nfByte * pData, nfUint32 cbCount);
+		nfUint32 storeChunk(_In_ const nfByte * pData, nfUint32 cbCount);
 		void finishDeflate();
 	public:
 		CExportStream_ZIP() = delete;
-		CExportStream_ZIP(_In_ CPortableZIPWriter * pZIPWriter, nfUint32 nEntryKey);
+		CExportStream_ZIP(_In_ CPortableZIPWriter * pZIPWriter, nfUint32 nEntryKey, nfUint16 nCompressionMethod, nfInt32 nCompressionLevel);
 		~CExportStream_ZIP();
 
 		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed);
@@ -66,6 +69,8 @@ namespace NMR {
 		virtual nfBool seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed);
 		virtual nfUint64 getPosition();
 		virtual nfUint64 writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite);
+		// Copies unchanged deflated streams verbatim, without inflating and deflating them again
+		virtual void copyFrom(_In_ CImportStream * pImportStream, _In_ nfUint64 cbCount, _In_ nfUint32 cbBufferSize);
 
 		void flushZIPStream();
 	};
@@ -0,0 +1,60 @@
+/*++
+
+Copyright (C) 2018 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ImportStream_Chunked_Memory.h defines a memory import stream that reads the chunks of a
+memory export stream in place, without flattening or copying them.
+
+--*/
+
+#ifndef __NMR_IMPORTSTREAM_CHUNKED_MEMORY
+#define __NMR_IMPORTSTREAM_CHUNKED_MEMORY
+
+#include "Common/Platform/NMR_ImportStream_Memory.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+
+namespace NMR {
+
+	class CImportStream_Chunked_Memory : public CImportStream_Memory {
+		private:
+			PExportStreamMemory m_pExportStream;
+		protected:
+			// Only the bytes up to the end of the containing chunk are contiguous
+			virtual const nfByte * getAt(nfUint64 nPosition);
+		public:
+			CImportStream_Chunked_Memory(_In_ PExportStreamMemory pExportStream);
+
+			virtual nfUint64 readBuffer(_In_ nfByte * pBuffer, _In_ nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll);
+			virtual void writeToFile(_In_ const nfWChar * pwszFileName);
+			virtual PImportStream copyToMemory();
+	};
+
+} // namespace NMR
+
+#endif // __NMR_IMPORTSTREAM_CHUNKED_MEMORY
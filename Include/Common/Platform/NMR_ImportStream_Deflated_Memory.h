@@ -0,0 +1,74 @@
+/*++
+
+Copyright (C) 2018 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ImportStream_Deflated_Memory.h defines the CImportStream_Deflated_Memory Class.
+This is a memory stream that keeps the raw deflated data of a ZIP entry and only inflates
+it when the stream is read. A ZIP writer can copy the deflated data verbatim instead.
+
+--*/
+
+#ifndef __NMR_IMPORTSTREAM_DEFLATED_MEMORY
+#define __NMR_IMPORTSTREAM_DEFLATED_MEMORY
+
+#include "Common/Platform/NMR_ImportStream_Memory.h"
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+
+#include <vector>
+
+namespace NMR {
+
+	class CImportStream_Deflated_Memory : public CImportStream_Memory {
+		private:
+			std::vector<nfByte> m_DeflatedBuffer;
+			nfUint32 m_nCRC32;
+			std::vector<nfByte> m_Buffer;
+			nfBool m_bIsInflated;
+
+			void inflateBuffer();
+		protected:
+			// zlib counts in 32 bit, so the buffers are passed on in steps of at most this size
+			nfUint64 m_cbMaxInflateStep;
+
+			virtual const nfByte * getAt(nfUint64 nPosition);
+		public:
+			CImportStream_Deflated_Memory(_In_ std::vector<nfByte> && DeflatedBuffer, _In_ nfUint64 cbInflatedSize, _In_ nfUint32 nCRC32);
+
+			const nfByte * getDeflatedData();
+			nfUint64 getDeflatedSize();
+			nfUint32 getCRC32();
+
+			// Inflates the data ahead of the first read. Different streams may be inflated concurrently.
+			void ensureInflated();
+
+			virtual PImportStream copyToMemory();
+	};
+
+} // namespace NMR
+
+#endif // __NMR_IMPORTSTREAM_DEFLATED_MEMORY
@@ -0,0 +1,100 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ImportStream_Pipelined.h defines the CImportStream_Pipelined Class.
+This is a stream class that reads ahead from another stream on a background thread
+into a ring of buffers, so that inflating and decrypting overlaps with parsing.
+
+--*/
+
+#ifndef __NMR_IMPORTSTREAM_PIPELINED
+#define __NMR_IMPORTSTREAM_PIPELINED
+
+#include "Common/Platform/NMR_ImportStream.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#define NMR_IMPORTSTREAM_PIPELINEBUFFERCOUNT 4
+#define NMR_IMPORTSTREAM_PIPELINEBUFFERSIZE (1024 * 1024)
+#define NMR_IMPORTSTREAM_PIPELINEMINSIZE (1024 * 1024)
+
+namespace NMR {
+
+	class CImportStream_Pipelined : public CImportStream {
+	private:
+		PImportStream m_pSourceStream;
+		nfUint64 m_nSize;
+		nfUint64 m_nPosition;
+
+		// Ring of buffers, filled by the background thread and consumed by readBuffer
+		std::vector<std::vector<nfByte>> m_Buffers;
+		std::vector<nfUint64> m_BufferSizes;
+		nfUint32 m_nReadBuffer;
+		nfUint64 m_nReadOffset;
+		nfUint32 m_nFilledBufferCount;
+
+		nfBool m_bSourceFinished;
+		nfBool m_bStopRequested;
+		std::exception_ptr m_pSourceException;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_BufferFilled;
+		std::condition_variable m_BufferConsumed;
+		std::thread m_Thread;
+
+		void readAhead();
+	public:
+		CImportStream_Pipelined() = delete;
+		CImportStream_Pipelined(_In_ PImportStream pSourceStream, _In_ nfUint32 nBufferCount = NMR_IMPORTSTREAM_PIPELINEBUFFERCOUNT, _In_ nfUint32 cbBufferSize = NMR_IMPORTSTREAM_PIPELINEBUFFERSIZE);
+		~CImportStream_Pipelined();
+
+		// Stops the background thread. The source stream is not accessed anymore after this call returns.
+		void stopReading();
+
+		// Returns true, if reading ahead is worthwhile for a stream of the given size on this machine
+		static nfBool isPipeliningBeneficial(_In_ nfUint64 nStreamSize);
+
+		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed);
+		virtual nfBool seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed);
+		virtual nfBool seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed);
+		virtual nfUint64 readBuffer(_In_ nfByte * pBuffer, _In_ nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll);
+		virtual nfUint64 retrieveSize();
+		virtual void writeToFile(_In_ const nfWChar * pwszFileName);
+		virtual PImportStream copyToMemory();
+		virtual nfUint64 getPosition();
+	};
+
+	typedef std::shared_ptr <CImportStream_Pipelined> PImportStream_Pipelined;
+
+}
+
+#endif // __NMR_IMPORTSTREAM_PIPELINED
@@ -45,9 +45,16 @@ namespace NMR {
 	private:
 		zip_file_t * m_pFile;
 		nfUint64 m_nSize;
+		zip_t * m_pArchive;
+		nfUint64 m_nIndex;
+		nfBool m_bHasBeenRead;
+
+		PImportStream copyDeflatedToMemory();
 	public:
 		CImportStream_ZIP() = delete;
 		CImportStream_ZIP(_In_ zip_file_t * pFile, _In_ nfUint64 nSize);
+		// If the archive is given, copyToMemory keeps deflated entries deflated
+		CImportStream_ZIP(_In_ zip_file_t * pFile, _In_ nfUint64 nSize, _In_ zip_t * pArchive, _In_ nfUint64 nIndex);
 		~CImportStream_ZIP();
 
 		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed);
@@ -44,6 +44,7 @@ namespace NMR {
 
 	PImportStream fnCreateImportStreamInstance(_In_ const nfChar * pszFileName);
 	PExportStream fnCreateExportStreamInstance(_In_ const nfChar * pszFileName);
+	PExportStream fnCreateExportStreamInstance(_In_ const nfChar * pszFileName, _In_ const EXPORTSTREAMFILEOPTIONS & Options);
 	PXmlReader fnCreateXMLReaderInstance(_In_ PImportStream pImportStream, PProgressMonitor  pProgressMonitor);
 	PXmlWriter fnCreateXMLWriterInstance(_In_ PExportStream pExportStream, PProgressMonitor pProgressMonitor);
 
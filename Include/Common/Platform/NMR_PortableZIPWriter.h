@@ -52,21 +52,32 @@ namespace NMR {
 		nfBool m_bIsFinished;
 
 		nfBool m_bWriteZIP64;
+		nfBool m_bWriteDataDescriptors;
+		nfUint16 m_nGeneralPurposeFlags;
 		nfUint16 m_nVersionMade;
 		nfUint16 m_nVersionNeeded;
 
 		std::list<PPortableZIPWriterEntry> m_Entries;
 		PExportStream m_pCurrentStream;
+
+		void writeDataDescriptor();
+		void patchLocalHeader();
 	public:
 		CPortableZIPWriter() = delete;
-		CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64);
+		// If bWriteDataDescriptors is set, CRC and sizes follow each entry in a data descriptor,
+		// and the package is written strictly sequentially, without seeking back.
+		CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64, _In_ nfBool bWriteDataDescriptors);
 		~CPortableZIPWriter();
 
-		PExportStream createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp);
+		// nCompressionMethod is ZIPFILECOMPRESSION_UNCOMPRESSED or ZIPFILECOMPRESSION_DEFLATED,
+		// nCompressionLevel is the zlib deflate level from 0 to ZIPFILECOMPRESSIONLEVEL_MAX.
+		PExportStream createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp, _In_ nfUint16 nCompressionMethod, _In_ nfInt32 nCompressionLevel);
 		void closeEntry();
 
 		void writeDeflatedBuffer(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbCompressedBytes);
 		void calculateChecksum(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbUncompressedBytes);
+		// Writes already deflated data as the complete content of an empty entry
+		void writeDeflatedContent(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint64 cbCompressedBytes, _In_ nfUint64 cbUncompressedBytes, _In_ nfUint32 nCRC32);
 		nfUint64 getCurrentSize(_In_ nfUint32 nEntryKey);
 
 		void writeDirectory();
@@ -41,6 +41,7 @@ NMR_PortableZIPWriterTypes.h defines a portable and fast writer of ZIP files
 #define ZIPFILEENDOFCENTRALDIRSIGNATURE 0x06054b50
 #define ZIPFILEDATADESCRIPTORSIGNATURE 0x08074b50
 #define ZIPFILEDESCRIPTOROFFSET 14
+#define ZIPFILEGENERALPURPOSEFLAG_DATADESCRIPTOR 0x0008
 #define ZIPFILEVERSIONNEEDED 0x0A
 #define ZIPFILEVERSIONNEEDEDZIP64 0x2D
 #define ZIP64FILEENDOFCENTRALDIRRECORDSIGNATURE 0x06064b50
@@ -53,6 +54,8 @@ NMR_PortableZIPWriterTypes.h defines a portable and fast writer of ZIP files
 
 #define ZIPFILECOMPRESSION_UNCOMPRESSED 0
 #define ZIPFILECOMPRESSION_DEFLATED 8
+#define ZIPFILECOMPRESSIONLEVEL_DEFAULT 1 // Z_BEST_SPEED
+#define ZIPFILECOMPRESSIONLEVEL_MAX 9 // Z_BEST_COMPRESSION
 #define ZIPFILEMAXFILENAMELENGTH 32000
 
 #define ZIPFILEMAXIMUMSIZENON64 0xFFFFFFFF
@@ -98,6 +101,32 @@ namespace NMR {
 		}
 	} ZIPLOCALFILEDESCRIPTOR;
 
+	typedef struct ZIPDATADESCRIPTOR {
+		nfUint32 m_nSignature;
+		nfUint32 m_nCRC32;
+		nfUint32 m_nCompressedSize;
+		nfUint32 m_nUnCompressedSize;
+		void swapByteOrder() {
+			m_nSignature = swapBytes(m_nSignature);
+			m_nCRC32 = swapBytes(m_nCRC32);
+			m_nCompressedSize = swapBytes(m_nCompressedSize);
+			m_nUnCompressedSize = swapBytes(m_nUnCompressedSize);
+		}
+	} ZIPDATADESCRIPTOR;
+
+	typedef struct ZIP64DATADESCRIPTOR {
+		nfUint32 m_nSignature;
+		nfUint32 m_nCRC32;
+		nfUint64 m_nCompressedSize;
+		nfUint64 m_nUnCompressedSize;
+		void swapByteOrder() {
+			m_nSignature = swapBytes(m_nSignature);
+			m_nCRC32 = swapBytes(m_nCRC32);
+			m_nCompressedSize = swapBytes(m_nCompressedSize);
+			m_nUnCompressedSize = swapBytes(m_nUnCompressedSize);
+		}
+	} ZIP64DATADESCRIPTOR;
+
 	typedef struct ZIP64EXTRAINFORMATIONFIELD {
 		nfUint16 m_nTag;
 		nfUint16 m_nFieldSize;
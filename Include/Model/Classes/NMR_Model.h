@@ -43,6 +43,7 @@ NMR_Model.h defines the Model Class. A model is an in memory representation of t
 
 #include <list>
 #include <map>
+#include <functional>
 #include <set>
 #include <vector>
 
@@ -61,6 +62,8 @@ namespace NMR {
 	class CModelObject;
 	typedef std::shared_ptr <CModelObject> PModelObject;
 
+	class CModelMeshObject;
+
 	class CModelMetaData;
 	typedef std::shared_ptr <CModelMetaData> PModelMetaData;
 
@@ -96,6 +99,14 @@ namespace NMR {
 
 	typedef std::map<NMR::UniqueResourceID, NMR::UniqueResourceID> UniqueResourceIDMapping;
 
+	// Receives a mesh object placed by the build, together with the product of all transforms that lead to it
+	typedef std::function<void(_In_ CModelMeshObject * pMeshObject, _In_ const NMATRIX3 & mTransform)> ModelMeshInstanceCallback;
+
+	typedef struct {
+		PModelResource m_pResource;
+		eModelResourceType m_eType;
+	} MODELRESOURCEENTRY;
+
 	// The Model class implements the unification of all model-file in a 3MF package
 	// It should be understood as a "MultiModel"
 	class CModel {
@@ -105,8 +116,9 @@ namespace NMR {
 
 		std::unordered_map<std::string, PUUID> usedUUIDs;	// datastructure used to ensure that UUIDs within one model (package) are unique
 
-		// map of all UniqueResourceIDs to actual object resources of the model
-		std::map<UniqueResourceID, PModelResource> m_ResourceMap;
+		// all resources of the model and their types, indexed by UniqueResourceID.
+		// The table never ends with an empty entry.
+		std::vector<MODELRESOURCEENTRY> m_ResourceTable;
 		CResourceHandler m_resourceHandler;
 	private:
 		std::vector<PModelResource> m_Resources;
@@ -154,7 +166,10 @@ namespace NMR {
 		CryptoRandGenDescriptor m_sRandDescriptor;
 
 		// Add Resource to resource lookup tables
-		void addResourceToLookupTable(_In_ PModelResource pResource);
+		void addResourceToLookupTable(_In_ PModelResource pResource, _In_ eModelResourceType eType);
+
+		// Returns the resource with a unique ID, throws if it is not of the given type
+		PModelResource findResourceOfType(_In_ UniqueResourceID nID, _In_ eModelResourceType eType);
 
 	public:
 		CModel();
@@ -174,6 +189,10 @@ namespace NMR {
 		// Merge all build items into one mesh
 		void mergeToMesh(_In_ CMesh * pMesh);
 
+		// Visits every placement of a mesh object by the build items and their components, in the order of mergeToMesh.
+		// Shared objects are visited once per placement, their meshes are not copied.
+		void forEachMeshInstance(_In_ const ModelMeshInstanceCallback & fnCallback);
+
 		// Units setter/getter
 		void setUnit(_In_ eModelUnit Unit);
 		void setUnitString(_In_ std::string sUnitString);
@@ -188,6 +207,7 @@ namespace NMR {
 		PModelResource findResource(_In_ std::string path, ModelResourceID nID);
 		PModelResource findResource(_In_ UniqueResourceID nID);
 		PModelResource findResource(_In_ PPackageResourceID pID);
+		eModelResourceType findResourceType(_In_ UniqueResourceID nID);
 
 		PPackageResourceID findPackageResourceID(_In_ std::string path, ModelResourceID nID);
 		PPackageResourceID findPackageResourceID(_In_ UniqueResourceID nID);
@@ -316,7 +336,7 @@ namespace NMR {
 		PModelResource getSliceStackResource(_In_ nfUint32 nIndex);
 
 		// Sorts objects by correct dependency
-		std::list<CModelObject *> getSortedObjectList ();
+		std::vector<CModelObject *> getSortedObjectList ();
 
 
 		// Gets the KeyStore
@@ -48,6 +48,9 @@ namespace NMR {
 		PImportStream m_pStream;
 		std::string m_sPathURI;
 		std::string m_sRelationShipType;
+		eModelAttachmentCompression m_eCompression;
+		nfInt32 m_nCompressionLevel;
+		nfBool m_bHasCompression;
 
 	public:
 		CModelAttachment() = delete;
@@ -61,6 +64,15 @@ namespace NMR {
 
 		void setStream(_In_ PImportStream pStream);
 		void setRelationShipType(_In_ const std::string sRelationShipType);
+
+		// Auto stores attachments whose leading bytes look incompressible and deflates all others.
+		// The level (0 to 9) is the deflate level used by Auto and Deflate.
+		eModelAttachmentCompression getCompression();
+		nfInt32 getCompressionLevel();
+		void setCompression(_In_ eModelAttachmentCompression eCompression, _In_ nfInt32 nCompressionLevel);
+		// Whether the compression has been set explicitly. Secured attachments that do not set it
+		// are deflated before the encryption at KEYSTORE_CONTENTCOMPRESSIONLEVEL_DEFAULT.
+		nfBool hasCompression();
 	};
 
 	typedef std::shared_ptr <CModelAttachment> PModelAttachment;
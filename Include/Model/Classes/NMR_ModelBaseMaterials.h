@@ -39,6 +39,7 @@ material resource object.
 #include "Model/Classes/NMR_ModelResource.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
 #include <vector>
 
 namespace NMR {
@@ -48,8 +49,7 @@ namespace NMR {
 
 	class CModelBaseMaterialResource : public CModelResource {
 	private:
-		std::map<ModelPropertyID, PModelBaseMaterial> m_pMaterials;
-		ModelPropertyID m_nNextPropertyID;
+		CModelPropertyArray<PModelBaseMaterial> m_Materials;
 
 	public:
 		CModelBaseMaterialResource() = delete;
@@ -58,11 +58,14 @@ namespace NMR {
 		nfUint32 addBaseMaterial(_In_ const std::string sName, _In_ nfColor cDisplayColor);
 
 		nfUint32 getCount();
+		nfBool hasBaseMaterial(_In_ nfUint32 nPropertyID);
 		PModelBaseMaterial getBaseMaterial(_In_ nfUint32 nPropertyID);
+		PModelBaseMaterial getBaseMaterialByIndex(_In_ ModelResourceIndex nIndex);
 
 		void removeMaterial(_In_ nfUint32 nPropertyID);
 		void mergeFrom(_In_ CModelBaseMaterialResource * pSourceMaterial);
 		void buildResourceIndexMap();
+		bool mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID);
 	};
 
 	typedef std::shared_ptr <CModelBaseMaterialResource> PModelBaseMaterialResource;
@@ -38,6 +38,7 @@ color group resource object.
 #include "Model/Classes/NMR_ModelResource.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
 #include <vector>
 
 namespace NMR {
@@ -47,8 +48,7 @@ namespace NMR {
 
 	class CModelColorGroupResource : public CModelResource {
 	private:
-		std::map<ModelPropertyID, nfColor> m_pColors;
-		ModelPropertyID m_nNextPropertyID;
+		CModelPropertyArray<nfColor> m_Colors;
 
 	public:
 		CModelColorGroupResource() = delete;
@@ -57,12 +57,17 @@ namespace NMR {
 		nfUint32 addColor(_In_ nfColor cColor);
 
 		nfUint32 getCount();
+		nfBool hasColor(_In_ ModelPropertyID nPropertyID);
 		nfColor getColor(_In_ ModelPropertyID nPropertyID);
 		void setColor(_In_ ModelPropertyID nPropertyID, _In_ nfColor cColor);
+		nfColor getColorByIndex(_In_ ModelResourceIndex nIndex);
+		void setColorByIndex(_In_ ModelResourceIndex nIndex, _In_ nfColor cColor);
+		void reserveColors(_In_ nfUint32 nCount);
 
 		void removeColor(_In_ ModelPropertyID nPropertyID);
 		void mergeFrom(_In_ CModelColorGroupResource * pSourceMaterial);
 		void buildResourceIndexMap();
+		bool mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID);
 	};
 
 	typedef std::shared_ptr <CModelColorGroupResource> PModelColorGroupResource;
@@ -67,8 +67,6 @@ namespace NMR {
 		nfBool hasSlices(nfBool bRecursive) override;
 		nfBool isValidForSlices(const NMATRIX3& totalParentMatrix) override;
 
-		void calculateComponentDepthLevel(nfUint32 nLevel) override;
-
 		void extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix) override;
 	};
 
@@ -39,6 +39,7 @@ composite materials resource object.
 #include "Model/Classes/NMR_ModelResource.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
 #include <vector>
 
 namespace NMR {
@@ -63,8 +64,7 @@ namespace NMR {
 
 	class CModelCompositeMaterialsResource : public CModelResource {
 	private:
-		std::map<ModelPropertyID, PModelComposite> m_pComposites;
-		ModelPropertyID m_nNextPropertyID;
+		CModelPropertyArray<PModelComposite> m_Composites;
 
 		PModelBaseMaterialResource m_pBaseMaterialResource;
 	public:
@@ -77,10 +77,12 @@ namespace NMR {
 		nfUint32 getCount();
 		PModelComposite getComposite(_In_ ModelPropertyID nPropertyID);
 		void setComposite(_In_ ModelPropertyID nPropertyID, _In_ PModelComposite pComposite);
+		PModelComposite getCompositeByIndex(_In_ ModelResourceIndex nIndex);
 
 		void removeComposite(_In_ ModelPropertyID nPropertyID);
 		void mergeFrom(_In_ CModelCompositeMaterialsResource * pSourceCompositesMaterials);
 		void buildResourceIndexMap();
+		bool mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID);
 
 		PModelBaseMaterialResource getBaseMaterialResource();
 	};
@@ -112,10 +112,10 @@ namespace NMR {
 		void setThumbnailAttachment(_In_ PModelAttachment pThumbnailAttachment, bool bThrowIfIncorrect);
 		PModelAttachment getThumbnailAttachment();
 
-		// Calculates the component Depths
+		// Component Depths, as determined by CModel::getSortedObjectList
 		nfUint32 getComponentDepthLevel ();
 		void clearComponentDepthLevel();
-		virtual void calculateComponentDepthLevel (nfUint32 nLevel);
+		void setComponentDepthLevel (nfUint32 nLevel);
 
 		virtual void extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix) = 0;
 
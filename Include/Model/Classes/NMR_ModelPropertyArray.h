@@ -0,0 +1,205 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelPropertyArray.h defines a contiguous container for the entries of property
+resources. PropertyIDs are dense indices as long as no entry has been removed.
+After a removal, the PropertyIDs are stored in a sorted vector next to the entries.
+Removed entries are only marked, and compacted on the next access by index.
+
+--*/
+
+#ifndef __NMR_MODELPROPERTYARRAY
+#define __NMR_MODELPROPERTYARRAY
+
+#include "Model/Classes/NMR_ModelTypes.h"
+#include "Common/NMR_Exception.h"
+#include <vector>
+#include <algorithm>
+
+namespace NMR {
+
+	template <class T> class CModelPropertyArray {
+	private:
+		std::vector<T> m_Entries;
+		// While the array is dense, the PropertyID of entry i is i + 1 and m_PropertyIDs is empty.
+		// Otherwise, m_PropertyIDs holds the ascending PropertyID of every entry.
+		std::vector<ModelPropertyID> m_PropertyIDs;
+		// Entries that have been removed, but not yet compacted. Empty if there are none.
+		std::vector<nfBool> m_Removed;
+		nfUint32 m_nRemovedCount;
+		nfBool m_bIsDense;
+		ModelPropertyID m_nNextPropertyID;
+
+		nfBool findIndex(_In_ ModelPropertyID nPropertyID, _Out_ ModelResourceIndex & nIndex)
+		{
+			if (m_bIsDense) {
+				if ((nPropertyID >= 1) && (nPropertyID <= m_Entries.size())) {
+					nIndex = nPropertyID - 1;
+					return true;
+				}
+				return false;
+			}
+
+			auto iIterator = std::lower_bound(m_PropertyIDs.begin(), m_PropertyIDs.end(), nPropertyID);
+			if ((iIterator != m_PropertyIDs.end()) && (*iIterator == nPropertyID)) {
+				nIndex = (ModelResourceIndex)(iIterator - m_PropertyIDs.begin());
+				return (m_nRemovedCount == 0) || !m_Removed[nIndex];
+			}
+			return false;
+		}
+
+		// Drops all removed entries in a single pass, so that indices are contiguous again
+		void compact()
+		{
+			if (m_nRemovedCount == 0)
+				return;
+
+			size_t nTarget = 0;
+			for (size_t nEntry = 0; nEntry < m_Entries.size(); nEntry++) {
+				if (!m_Removed[nEntry]) {
+					if (nTarget != nEntry) {
+						m_Entries[nTarget] = std::move(m_Entries[nEntry]);
+						m_PropertyIDs[nTarget] = m_PropertyIDs[nEntry];
+					}
+					nTarget++;
+				}
+			}
+			m_Entries.erase(m_Entries.begin() + nTarget, m_Entries.end());
+			m_PropertyIDs.resize(nTarget);
+			m_Removed.clear();
+			m_nRemovedCount = 0;
+		}
+
+	public:
+		CModelPropertyArray()
+		{
+			m_bIsDense = true;
+			m_nRemovedCount = 0;
+			m_nNextPropertyID = 1;
+		}
+
+		nfUint32 getCount()
+		{
+			return (nfUint32)(m_Entries.size() - m_nRemovedCount);
+		}
+
+		nfBool isDense()
+		{
+			return m_bIsDense;
+		}
+
+		void reserve(_In_ nfUint32 nCount)
+		{
+			compact();
+			m_Entries.reserve(nCount);
+			if (!m_bIsDense)
+				m_PropertyIDs.reserve(nCount);
+		}
+
+		ModelPropertyID add(_In_ const T & Entry)
+		{
+			ModelPropertyID nID = m_nNextPropertyID;
+			m_Entries.push_back(Entry);
+			if (!m_bIsDense)
+				m_PropertyIDs.push_back(nID);
+			if (m_nRemovedCount > 0)
+				m_Removed.push_back(false);
+			m_nNextPropertyID++;
+			return nID;
+		}
+
+		ModelPropertyID getNextPropertyID()
+		{
+			return m_nNextPropertyID;
+		}
+
+		nfBool hasPropertyID(_In_ ModelPropertyID nPropertyID)
+		{
+			ModelResourceIndex nIndex;
+			return findIndex(nPropertyID, nIndex);
+		}
+
+		T & get(_In_ ModelPropertyID nPropertyID)
+		{
+			ModelResourceIndex nIndex;
+			if (!findIndex(nPropertyID, nIndex))
+				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+			return m_Entries[nIndex];
+		}
+
+		T & getByIndex(_In_ ModelResourceIndex nIndex)
+		{
+			compact();
+			if (nIndex >= m_Entries.size())
+				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+			return m_Entries[nIndex];
+		}
+
+		nfBool getPropertyID(_In_ ModelResourceIndex nIndex, _Out_ ModelPropertyID & nPropertyID)
+		{
+			compact();
+			if (nIndex >= m_Entries.size()) {
+				nPropertyID = 0;
+				return false;
+			}
+			if (m_bIsDense)
+				nPropertyID = nIndex + 1;
+			else
+				nPropertyID = m_PropertyIDs[nIndex];
+			return true;
+		}
+
+		// Removing an unknown PropertyID does nothing.
+		// The entry is only marked as removed, which costs O(log n). The next access by index
+		// compacts all marked entries in one O(n) pass, so that removing many entries stays linear.
+		// The first removal from a dense array additionally builds the PropertyID vector in O(n).
+		void remove(_In_ ModelPropertyID nPropertyID)
+		{
+			ModelResourceIndex nIndex;
+			if (!findIndex(nPropertyID, nIndex))
+				return;
+
+			if (m_bIsDense) {
+				m_PropertyIDs.resize(m_Entries.size());
+				for (size_t nEntry = 0; nEntry < m_Entries.size(); nEntry++)
+					m_PropertyIDs[nEntry] = (ModelPropertyID)(nEntry + 1);
+				m_bIsDense = false;
+			}
+
+			if (m_nRemovedCount == 0)
+				m_Removed.assign(m_Entries.size(), false);
+			m_Removed[nIndex] = true;
+			m_nRemovedCount++;
+			// Release the removed entry right away, only its slot is kept until compaction
+			m_Entries[nIndex] = T();
+		}
+	};
+
+}
+
+#endif // __NMR_MODELPROPERTYARRAY
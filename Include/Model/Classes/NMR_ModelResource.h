@@ -63,7 +63,7 @@ namespace NMR {
 		virtual PPackageResourceID getPackageResourceID();
 		void setPackageResourceID(PPackageResourceID pID);
 
-		bool mapResourceIndexToPropertyID (_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID);
+		virtual bool mapResourceIndexToPropertyID (_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID);
 		void clearResourceIndexMap();
 		virtual void buildResourceIndexMap();
 		nfBool hasResourceIndexMap();
@@ -38,6 +38,7 @@ texture2d group resource object.
 #include "Model/Classes/NMR_ModelResource.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
 #include <vector>
 
 namespace NMR {
@@ -48,8 +49,7 @@ namespace NMR {
 	class CModelTexture2DGroupResource : public CModelResource {
 	private:
 		PModelTexture2DResource m_pTexture2D;
-		std::map<ModelPropertyID, MODELTEXTURE2DCOORDINATE> m_pUVCoordinates;
-		ModelPropertyID m_nNextPropertyID;
+		CModelPropertyArray<MODELTEXTURE2DCOORDINATE> m_UVCoordinates;
 
 	public:
 		CModelTexture2DGroupResource() = delete;
@@ -62,9 +62,13 @@ namespace NMR {
 		void setUVCoordinate(_In_ ModelPropertyID nPropertyID, _In_ MODELTEXTURE2DCOORDINATE sCoordinate);
 
 		MODELTEXTURE2DCOORDINATE getUVCoordinate(_In_ ModelPropertyID nPropertyID);
+		MODELTEXTURE2DCOORDINATE getUVCoordinateByIndex(_In_ ModelResourceIndex nIndex);
+		void setUVCoordinateByIndex(_In_ ModelResourceIndex nIndex, _In_ MODELTEXTURE2DCOORDINATE sCoordinate);
+		void reserveUVCoordinates(_In_ nfUint32 nCount);
 
 		void mergeFrom(_In_ CModelTexture2DGroupResource * pSourceMaterial);
 		void buildResourceIndexMap();
+		bool mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID);
 
 		PModelTexture2DResource getTexture2D();
 	};
@@ -43,6 +43,9 @@ NMR_ModelTypes.h defines 3MF Model Type Definitions
 
 #define MODEL_MAXSTRINGBUFFERLENGTH 1073741823 // (Safe margin for buffer overflows: 2^30 - 1)
 
+#define MODELATTACHMENT_DEFAULTCOMPRESSIONLEVEL 1
+#define MODELATTACHMENT_MAXCOMPRESSIONLEVEL 9
+
 namespace NMR {
 
 #pragma pack (1)
@@ -153,6 +156,19 @@ namespace NMR {
 		MODELPROPERTYTYPE_COMPOSITE = 4,
 	};
 
+	enum eModelResourceType {
+		MODELRESOURCETYPE_NONE = 0,
+		MODELRESOURCETYPE_OBJECT = 1,
+		MODELRESOURCETYPE_BASEMATERIALS = 2,
+		MODELRESOURCETYPE_COLORGROUP = 3,
+		MODELRESOURCETYPE_TEXTURE2D = 4,
+		MODELRESOURCETYPE_TEXTURE2DGROUP = 5,
+		MODELRESOURCETYPE_COMPOSITEMATERIALS = 6,
+		MODELRESOURCETYPE_MULTIPROPERTYGROUP = 7,
+		MODELRESOURCETYPE_SLICESTACK = 8,
+		MODELRESOURCETYPE_OTHER = 9
+	};
+
 	enum eModelTexture2DType {
 		MODELTEXTURETYPE_UNKNOWN = 0,
 		MODELTEXTURETYPE_PNG = 1,
@@ -172,6 +188,12 @@ namespace NMR {
 		MODELTEXTUREFILTER_NEAREST = 2
 	};
 
+	enum eModelAttachmentCompression {
+		MODELATTACHMENTCOMPRESSION_AUTO = 0,
+		MODELATTACHMENTCOMPRESSION_STORE = 1,
+		MODELATTACHMENTCOMPRESSION_DEFLATE = 2
+	};
+
 	enum eModelBlendMethod {
 		MODELBLENDMETHOD_NONE = 0,
 		MODELBLENDMETHOD_MIX = 1,
@@ -55,6 +55,7 @@ namespace NMR {
 		CModelReaderNode_BeamLattice1702_Ball(_In_ CModel * pModel, _In_ PModelWarnings pWarnings);
 
 		virtual void parseXML(_In_ CXmlReader * pXMLReader);
+		void reset();
 
 		void retrieveIndex(_Out_ nfInt32 & nIndex, nfInt32 nNodeCount);
 		void retrieveRadius(_Out_ nfBool & bHasRadius, _Out_ nfDouble & dRadius);
@@ -34,6 +34,7 @@ NMR_ModelReaderNode_BeamLattice1702_Balls.h covers the official 3MF beamlattice
 #define __NMR_MODELREADERNODE_BEAMLATTICE1702_BALLS
 
 #include "Model/Reader/NMR_ModelReaderNode.h"
+#include "Model/Reader/BeamLattice1702/NMR_ModelReaderNode_BeamLattice1702_Ball.h"
 #include "Model/Classes/NMR_ModelComponent.h"
 #include "Model/Classes/NMR_ModelObject.h"
 
@@ -46,6 +47,9 @@ namespace NMR {
 
 		nfDouble m_dDefaultBallRadius;
 
+		// Reused for every ball element
+		CModelReaderNode_BeamLattice1702_Ball m_BallNode;
+
 		virtual void OnAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue);
 		virtual void OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader);
 	public:
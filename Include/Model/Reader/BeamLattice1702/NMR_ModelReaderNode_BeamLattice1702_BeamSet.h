@@ -33,6 +33,8 @@ NMR_ModelReaderNode_BeamLattice1702_BeamSet.h covers the official 3MF beamlattic
 #define __NMR_MODELREADERNODE_BEAMLATTICE1702_BEAMSET
 
 #include "Model/Reader/NMR_ModelReaderNode.h"
+#include "Model/Reader/BeamLattice1702/NMR_ModelReaderNode_BeamLattice1702_Ref.h"
+#include "Model/Reader/BeamLattice1702/NMR_ModelReaderNode_BeamLattice1702_BallRef.h"
 #include "Model/Classes/NMR_ModelComponent.h"
 #include "Model/Classes/NMR_ModelComponentsObject.h"
 #include "Model/Classes/NMR_ModelObject.h"
@@ -46,6 +48,12 @@ namespace NMR {
 		BEAMSET * m_pBeamSet;
 
 		std::unordered_set<std::string> * m_pUniqueIdentifiers;
+
+		// Reused for every ref and ballref element
+		CModelReaderNode_BeamLattice1702_Ref m_RefNode;
+		CModelReaderNode_BeamLattice1702_BallRef m_BallRefNode;
+
+		void appendIndex(_In_ std::vector<nfUint32> & Indices, _In_ nfInt32 nIndex);
 	protected:
 		virtual void OnAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue);
 		virtual void OnNSAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue, _In_z_ const nfChar * pNameSpace);
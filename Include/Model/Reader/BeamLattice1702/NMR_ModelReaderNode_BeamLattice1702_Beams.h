@@ -36,6 +36,7 @@ NMR_ModelReaderNode_BeamLattice1702_Beams.h covers the official 3MF beamlattice
 #define __NMR_MODELREADERNODE_BEAMLATTICE1702_BEAMS
 
 #include "Model/Reader/NMR_ModelReaderNode.h"
+#include "Model/Reader/BeamLattice1702/NMR_ModelReaderNode_BeamLattice1702_Beam.h"
 #include "Model/Classes/NMR_ModelComponent.h"
 #include "Model/Classes/NMR_ModelObject.h"
 
@@ -49,6 +50,9 @@ namespace NMR {
 		nfDouble m_dDefaultRadius;
 		eModelBeamLatticeCapMode m_eDefaultCapMode;
 
+		// Reused for every beam element
+		CModelReaderNode_BeamLattice1702_Beam m_BeamNode;
+
 		virtual void OnAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue);
 		virtual void OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader);
 	public:
@@ -49,6 +49,7 @@ namespace NMR {
 		CModelReaderNode_BeamLattice1702_Ref(_In_ PModelWarnings pWarnings);
 
 		virtual void parseXML(_In_ CXmlReader * pXMLReader);
+		void reset();
 		void retrieveIndex(_Out_ nfInt32 & nIndex);
 	};
 
@@ -59,7 +59,7 @@ namespace NMR {
 		void openAllResourceDataGroups();
 		void checkAuthenticatedTags();
 	public:
-		CKeyStoreOpcPackageReader(_In_ PImportStream pImportStream, _In_ CModelContext const & context);
+		CKeyStoreOpcPackageReader(_In_ PImportStream pImportStream, _In_ CModelContext const & context, _In_ nfBool bCheckConsistency);
 
 		// Inherited via IOpcPackageReader
 		virtual COpcPackageRelationship * findRootRelation(std::string sRelationType, nfBool bMustBeUnique) override;
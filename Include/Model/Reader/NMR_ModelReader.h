@@ -48,6 +48,9 @@ namespace NMR {
 		PImportStream m_pPrintTicketStream;
 		std::string m_sPrintTicketContentType;
 		std::set<std::string> m_RelationsToRead;
+		nfUint32 m_nExtractionThreadCount;
+		nfBool m_bRootModelReadAhead;
+		nfBool m_bPackageConsistencyCheck;
 
 
 		void readFromMeshImporter(_In_ CMeshImporter * pImporter);
@@ -61,6 +64,18 @@ namespace NMR {
 
 		void addRelationToRead(_In_ std::string sRelationShipType);
 		void removeRelationToRead(_In_ std::string sRelationShipType);
+
+		// Number of threads that inflate the package parts after they are read, 0 uses all hardware threads.
+		void SetExtractionThreadCount(nfUint32 nThreadCount);
+		nfUint32 GetExtractionThreadCount();
+
+		// Reads large root model parts ahead on a background thread while they are parsed.
+		void SetRootModelReadAhead(nfBool bReadAhead);
+		nfBool GetRootModelReadAhead();
+
+		// Compares all local ZIP headers against the central directory when opening a package.
+		void SetPackageConsistencyCheck(nfBool bCheckConsistency);
+		nfBool GetPackageConsistencyCheck();
 	};
 
 	typedef std::shared_ptr <CModelReader> PModelReader;
@@ -56,6 +56,9 @@ namespace NMR {
 		void parseAttributes(_In_ CXmlReader * pXMLReader);
 		void parseContent(_In_ CXmlReader * pXMLReader);
 
+		// Allows a node object to be reused for the next sibling element instead of allocating a new one
+		void resetParseState();
+
 		virtual void OnAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue);
 		virtual void OnText(_In_z_ const nfChar * pText, _In_ CXmlReader * pXMLReader);
 		virtual void OnEndElement(_In_ CXmlReader * pXMLReader);
@@ -41,19 +41,25 @@ It uses libzip and irrxml to parse the OPC package.
 #include "Common/Platform/NMR_XmlReader.h"
 #include "Model/Reader/NMR_KeyStoreOpcPackageReader.h"
 #include "Common/OPC/NMR_OpcPackagePart.h"
+#include "Common/Platform/NMR_ImportStream_Deflated_Memory.h"
 #include <list>
+#include <vector>
 
 namespace NMR {
 
 	class CModelReader_3MF_Native : public CModelReader_3MF {
 	private:
 		PKeyStoreOpcPackageReader m_pPackageReader;
+		std::vector<std::shared_ptr<CImportStream_Deflated_Memory>> m_InflateQueue;
 
 	protected:
 		void extractCustomDataFromRelationships(_In_ std::string& sTargetPartURIDir, _In_ COpcPackagePart * pModelPart);
 		void extractTexturesFromRelationships(_In_ std::string& sTargetPartURIDir, _In_ COpcPackagePart * pModelPart);
 		void extractModelDataFromRelationships(_In_ std::string& sTargetPartURIDir, _In_ COpcPackagePart * pModelPart);
 		void checkContentTypes();
+
+		void queueInflate(_In_ PImportStream pMemoryStream);
+		void inflateQueuedStreams();
 	
 		virtual PImportStream extract3MFOPCPackage(_In_ PImportStream pPackageStream);
 		virtual void release3MFOPCPackage();
@@ -40,8 +40,17 @@ A triangles reader model node is a parser for the triangles node of an XML Model
 #include "Model/Classes/NMR_ModelComponent.h"
 #include "Model/Classes/NMR_ModelObject.h"
 
+#include <vector>
+#include <unordered_map>
+
 namespace NMR {
 
+	typedef struct {
+		ModelResourceID m_nResourceID;
+		PPackageResourceID m_pPackageResourceID;
+		PModelResource m_pResource;
+	} READERRESOLVEDPROPERTYRESOURCE;
+
 	class CModelReaderNode100_Triangles : public CModelReaderNode {
 	protected:
 		CMesh * m_pMesh;
@@ -51,10 +60,17 @@ namespace NMR {
 		ModelResourceIndex m_nDefaultResourceIndex;
 		ModelResourceID m_nUsedResourceID;
 
+		// Property resources are resolved once per distinct pid of this mesh
+		std::vector<READERRESOLVEDPROPERTYRESOURCE> m_ResolvedPropertyResources;
+		std::unordered_map<ModelResourceID, size_t> m_ResolvedPropertyResourceIndices;
+		size_t m_nLastResolvedPropertyResource;
+		CMeshInformation_Properties * m_pPropertiesInformation;
+
 		virtual void OnAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue);
 		virtual void OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader);
 
 		_Ret_notnull_ CMeshInformation_Properties * createPropertiesInformation();
+		READERRESOLVEDPROPERTYRESOURCE & resolvePropertyResource(_In_ ModelResourceID nResourceID);
 	public:
 		CModelReaderNode100_Triangles() = delete;
 		CModelReaderNode100_Triangles(_In_ CModel * pModel, _In_ CMesh * pMesh, _In_ PModelWarnings pWarnings,
@@ -0,0 +1,112 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_KeyStoreEncryptionPipeline.h defines the CKeyStoreEncryptionPipeline Class.
+Worker threads compress and encrypt the content of secured parts into a pool of
+memory streams, while the writing thread commits the finished parts to the package
+in the order in which they were added.
+
+--*/
+
+#ifndef __NMR_KEYSTOREENCRYPTIONPIPELINE
+#define __NMR_KEYSTOREENCRYPTIONPIPELINE
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_SecureContentTypes.h"
+#include "Common/Platform/NMR_ImportStream.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Model/Writer/NMR_KeyStoreOpcPackageWriter.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+// Buffers per thread, which bounds the memory that finished but uncommitted parts can take
+#define NMR_KEYSTOREENCRYPTIONPIPELINE_BUFFERSPERTHREAD 2
+#define NMR_KEYSTOREENCRYPTIONPIPELINE_COPYBUFFERSIZE 65536
+
+namespace NMR {
+
+	typedef struct {
+		std::string m_sPath;
+		PImportStream m_pStream;
+		ContentEncryptionDescriptor m_Descriptor;
+		nfBool m_bCompressed;
+		nfInt32 m_nCompressionLevel;
+		PExportStreamMemory m_pCipherText;
+		std::exception_ptr m_pException;
+		nfBool m_bIsDone;
+	} KEYSTOREENCRYPTIONJOB;
+
+	class CKeyStoreEncryptionPipeline {
+	private:
+		CKeyStoreOpcPackageWriter * m_pPackageWriter;
+		nfUint32 m_nThreadCount;
+		nfUint32 m_nMaxBufferCount;
+
+		// Jobs are started and committed in the order in which they are added
+		std::deque<KEYSTOREENCRYPTIONJOB> m_Jobs;
+		size_t m_nNextJobToStart;
+		size_t m_nNextJobToCommit;
+
+		std::vector<PExportStreamMemory> m_FreeBuffers;
+		nfUint32 m_nBufferCount;
+		nfBool m_bStopRequested;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_JobAvailable;
+		std::condition_variable m_JobDone;
+		std::vector<std::thread> m_Threads;
+
+		void runWorker();
+		void encryptJob(_In_ KEYSTOREENCRYPTIONJOB & Job, _In_ PExportStreamMemory pCipherText);
+	public:
+		CKeyStoreEncryptionPipeline() = delete;
+		CKeyStoreEncryptionPipeline(_In_ CKeyStoreOpcPackageWriter * pPackageWriter, _In_ nfUint32 nThreadCount);
+		~CKeyStoreEncryptionPipeline();
+
+		// Queues the content of a part for encryption. Returns false if the part is not secured,
+		// in which case it has to be written as usual. The stream must not be accessed until the part is committed.
+		nfBool addPart(_In_ std::string sPath, _In_ PImportStream pStream, _In_ nfInt32 nCompressionLevel);
+
+		// Waits for the oldest queued part and writes its cipher text into the package
+		POpcPackagePart commitNextPart();
+
+		// Returns the number of threads to use for a thread count setting, where 0 stands for all hardware threads
+		static nfUint32 resolveThreadCount(_In_ nfUint32 nThreadCount);
+	};
+
+	typedef std::shared_ptr <CKeyStoreEncryptionPipeline> PKeyStoreEncryptionPipeline;
+
+}
+
+#endif // __NMR_KEYSTOREENCRYPTIONPIPELINE
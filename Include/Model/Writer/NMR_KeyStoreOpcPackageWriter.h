@@ -37,6 +37,11 @@ NMR_KeyStoreOpcPackageWriter.h defines an OPC Package writer in a portable way.
 
 #include "Common/OPC/NMR_IOpcPackageWriter.h"
 #include "Common/Platform/NMR_ExportStream.h"
+#include "Common/NMR_SecureContentTypes.h"
+
+// Deflate level of secured content whose compression is not set explicitly. This is the level
+// that Z_DEFAULT_COMPRESSION selects, as the content cannot be deflated again after the encryption.
+#define KEYSTORE_CONTENTCOMPRESSIONLEVEL_DEFAULT 6
 
 namespace NMR {
 
@@ -57,7 +62,8 @@ namespace NMR {
 
 		void writeKeyStoreStream(_In_ CXmlWriter * pXMLWriter);
 		void refreshAllResourceDataGroups();
-		POpcPackagePart wrapPartStream(PKeyStoreResourceData rd, POpcPackagePart part);
+		ContentEncryptionDescriptor makeEncryptionDescriptor(PKeyStoreResourceData rd);
+		POpcPackagePart wrapPartStream(PKeyStoreResourceData rd, POpcPackagePart part, nfInt32 nCompressionLevel);
 		void refreshResourceDataTag(PKeyStoreResourceData rd);
 		void refreshAccessRight(PKeyStoreAccessRight ar, std::vector<nfByte> const & key);
 	public:
@@ -66,12 +72,21 @@ namespace NMR {
 			_In_ CModelContext const & context);
 
 		POpcPackagePart addPart(_In_ std::string sPath) override;
+		POpcPackagePart addPart(_In_ std::string sPath, _In_ nfUint16 nCompressionMethod, _In_ nfInt32 nCompressionLevel) override;
 		void close() override;
 		void addContentType(std::string sExtension, std::string sContentType) override;
 		void addContentType(_In_ POpcPackagePart pOpcPackagePart, _In_ std::string sContentType) override;
 		POpcPackageRelationship addRootRelationship(std::string sType, COpcPackagePart * pTargetPart) override;
 		POpcPackageRelationship addPartRelationship(_In_ POpcPackagePart pOpcPackagePart, _In_ std::string sType, _In_ COpcPackagePart * pTargetPart) override;
 		std::list<POpcPackageRelationship> addWriterSpecificRelationships(_In_ POpcPackagePart pOpcPackagePart, _In_ COpcPackagePart* pTargetPart) override;
+
+		// These allow to compress and encrypt the content of a secured part apart from writing it.
+		// getPartEncryption returns false if the part at sPath is not encrypted.
+		nfBool getPartEncryption(_In_ std::string sPath, _Out_ ContentEncryptionDescriptor & Descriptor, _Out_ nfBool & bCompressed);
+		// nCompressionLevel is the deflate level of compressed parts, where 0 stores deflate blocks as they are.
+		static PExportStream createEncryptionStream(_In_ PExportStream pCipherStream, _In_ ContentEncryptionDescriptor Descriptor, _In_ nfBool bCompressed, _In_ nfInt32 nCompressionLevel);
+		// Adds a part for content that has already been encrypted, which is stored as it is
+		POpcPackagePart addEncryptedPart(_In_ std::string sPath);
 	};
 
 	using PKeyStoreOpcPackageWriter = std::shared_ptr<CKeyStoreOpcPackageWriter>;
@@ -45,6 +45,7 @@ namespace NMR {
 	class CModelWriter : public CModelContext{
 	private:
 		nfUint32 m_nDecimalPrecision;
+		nfUint32 m_nEncryptionThreadCount;
 	public:
 		CModelWriter() = delete;
 		CModelWriter(_In_ PModel pModel);
@@ -54,6 +55,11 @@ namespace NMR {
 
 		void SetDecimalPrecision(nfUint32);
 		nfUint32 GetDecimalPrecision();
+
+		// Number of threads that compress and encrypt secured parts, 0 uses all hardware threads.
+		// With more than one thread, the content encryption callback is called concurrently for different resources.
+		void SetEncryptionThreadCount(nfUint32 nThreadCount);
+		nfUint32 GetEncryptionThreadCount();
 	};
 
 	typedef std::shared_ptr <CModelWriter> PModelWriter;
@@ -38,14 +38,17 @@ using LibZ and a native XML writer implementation.
 #include "Common/OPC/NMR_OpcPackageWriter.h" 
 #include "Model/Writer/NMR_ModelWriter_3MF.h" 
 #include "Model/Writer/NMR_KeyStoreOpcPackageWriter.h"
+#include "Model/Writer/NMR_KeyStoreEncryptionPipeline.h"
 
 #define MODELWRITER_NATIVE_BUFFERSIZE 65536
+#define MODELWRITER_NATIVE_COMPRESSIONSAMPLESIZE 65536
+#define MODELWRITER_NATIVE_INCOMPRESSIBLEENTROPY 7.5 // bits per byte
 
 namespace NMR {
 
 	class CModelWriter_3MF_Native : public CModelWriter_3MF {
 	protected:
-		std::shared_ptr<IOpcPackageWriter> m_pPackageWriter;
+		PKeyStoreOpcPackageWriter m_pPackageWriter;
 		CModel * m_pOtherModel;
 
 		// These are OPC dependent functions
@@ -54,6 +57,8 @@ namespace NMR {
 		virtual void releasePackage();
 
 		void addAttachments(_In_ CModel * pModel, _In_ POpcPackagePart pModelPart);
+		void selectAttachmentCompression(_In_ CModelAttachment * pAttachment, _Out_ nfUint16 & nCompressionMethod, _Out_ nfInt32 & nCompressionLevel);
+		POpcPackagePart addAttachmentPart(_In_ CModelAttachment * pAttachment, _In_ std::string sPath);
 
 		void addNonRootModels();
 
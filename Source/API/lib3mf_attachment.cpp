@@ -58,6 +58,8 @@ void CAttachment::SetPath (const std::string & sPath)
 {
 	NMR::CModel * pModel = m_pModelAttachment->getModel();
 	NMR::PImportStream pStream = m_pModelAttachment->getStream();
+	NMR::eModelAttachmentCompression eCompression = m_pModelAttachment->getCompression();
+	NMR::nfInt32 nCompressionLevel = m_pModelAttachment->getCompressionLevel();
 	if (pModel->getPackageThumbnail() == m_pModelAttachment) {
 		// different handling for package-wide attachment
 		pModel->removePackageThumbnail();
@@ -68,6 +70,7 @@ void CAttachment::SetPath (const std::string & sPath)
 		pModel->removeAttachment(m_pModelAttachment->getPathURI());
 		m_pModelAttachment = pModel->addAttachment(sPath, sRelationshipType, pStream);
 	}
+	m_pModelAttachment->setCompression(eCompression, nCompressionLevel);
 }
 
 IPackagePart * CAttachment::PackagePart()
@@ -129,3 +132,17 @@ void CAttachment::ReadFromBuffer(const Lib3MF_uint64 nBufferBufferSize, const Li
 	m_pModelAttachment->setStream(pImportStream);
 }
 
+void CAttachment::GetCompression(eLib3MFAttachmentCompression & eCompression, Lib3MF_uint32 & nLevel)
+{
+	eCompression = eLib3MFAttachmentCompression(m_pModelAttachment->getCompression());
+	nLevel = m_pModelAttachment->getCompressionLevel();
+}
+
+void CAttachment::SetCompression(const eLib3MFAttachmentCompression eCompression, const Lib3MF_uint32 nLevel)
+{
+	if (nLevel > MODELATTACHMENT_MAXCOMPRESSIONLEVEL)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	m_pModelAttachment->setCompression(NMR::eModelAttachmentCompression(eCompression), (NMR::nfInt32)nLevel);
+}
+
@@ -97,6 +97,48 @@ sLib3MFColor CBaseMaterialGroup::GetDisplayColor(const Lib3MF_uint32 nPropertyID
 	return c;
 }
 
+void CBaseMaterialGroup::SetDisplayColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer)
+{
+	if (nPropertyIDsBufferSize != nColorsBufferSize)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPROPERTYCOUNT);
+	if ((nPropertyIDsBufferSize > 0) && ((!pPropertyIDsBuffer) || (!pColorsBuffer)))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CModelBaseMaterialResource & BaseMaterialGroup = baseMaterialGroup();
+
+	// Check all PropertyIDs first, so that an unknown PropertyID leaves the base material group untouched
+	for (Lib3MF_uint64 i = 0; i < nPropertyIDsBufferSize; i++) {
+		if (!BaseMaterialGroup.hasBaseMaterial(pPropertyIDsBuffer[i]))
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	}
+
+	for (Lib3MF_uint64 i = 0; i < nPropertyIDsBufferSize; i++) {
+		const sLib3MFColor & TheColor = pColorsBuffer[i];
+		NMR::nfColor cColor = TheColor.m_Red | (TheColor.m_Green << 8) | (TheColor.m_Blue << 16) | (TheColor.m_Alpha << 24);
+		BaseMaterialGroup.getBaseMaterial(pPropertyIDsBuffer[i])->setColor(cColor);
+	}
+}
+
+void CBaseMaterialGroup::GetDisplayColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer)
+{
+	if ((!pPropertyIDsBuffer) && (nPropertyIDsBufferSize > 0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	if (pColorsNeededCount)
+		*pColorsNeededCount = nPropertyIDsBufferSize;
+
+	if (nColorsBufferSize >= nPropertyIDsBufferSize && pColorsBuffer) {
+		NMR::CModelBaseMaterialResource & BaseMaterialGroup = baseMaterialGroup();
+		for (Lib3MF_uint64 i = 0; i < nPropertyIDsBufferSize; i++) {
+			NMR::nfColor cColor = BaseMaterialGroup.getBaseMaterial(pPropertyIDsBuffer[i])->getDisplayColor();
+			pColorsBuffer[i].m_Red = (cColor) & 0xff;
+			pColorsBuffer[i].m_Green = (cColor >> 8) & 0xff;
+			pColorsBuffer[i].m_Blue = (cColor >> 16) & 0xff;
+			pColorsBuffer[i].m_Alpha = (cColor >> 24) & 0xff;
+		}
+	}
+}
+
 void CBaseMaterialGroup::GetAllPropertyIDs(Lib3MF_uint64 nPropertyIDsBufferSize, Lib3MF_uint64* pPropertyIDsNeededCount, Lib3MF_uint32 * pPropertyIDsBuffer)
 {
 	Lib3MF_uint32 nMaterialCount = baseMaterialGroup().getCount();
@@ -190,13 +190,9 @@ Lib3MF_uint32 CBeamLattice::AddBeam (const sLib3MFBeam BeamInfo)
 	if (!isBeamValid(m_mesh.getNodeCount(), BeamInfo))
 		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-	// retrieve nodes and add beam
-	NMR::MESHNODE * pNodes[2];
-	for (int j = 0; j < 2; j++)
-		pNodes[j] = m_mesh.getNode(BeamInfo.m_Indices[j]);
-
-	NMR::MESHBEAM * pMeshBeam = m_mesh.addBeam(pNodes[0], pNodes[1], BeamInfo.m_Radii[0], BeamInfo.m_Radii[1], (int)BeamInfo.m_CapModes[0], (int)BeamInfo.m_CapModes[1]);
-	return pMeshBeam->m_index;
+	// add beam, its index is its position in the beam lattice
+	m_mesh.addBeam((NMR::nfInt32)BeamInfo.m_Indices[0], (NMR::nfInt32)BeamInfo.m_Indices[1], BeamInfo.m_Radii[0], BeamInfo.m_Radii[1], (int)BeamInfo.m_CapModes[0], (int)BeamInfo.m_CapModes[1]);
+	return m_mesh.getBeamCount() - 1;
 }
 
 void CBeamLattice::SetBeam (const Lib3MF_uint32 nIndex, const sLib3MFBeam BeamInfo)
@@ -205,14 +201,14 @@ void CBeamLattice::SetBeam (const Lib3MF_uint32 nIndex, const sLib3MFBeam BeamIn
 		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
 	NMR::MESHBEAM* meshBeam = m_mesh.getBeam(nIndex);
-	meshBeam->m_capMode[0] = (int)BeamInfo.m_CapModes[0];
-	meshBeam->m_capMode[1] = (int)BeamInfo.m_CapModes[1];
+	meshBeam->m_capMode[0] = (NMR::nfByte)BeamInfo.m_CapModes[0];
+	meshBeam->m_capMode[1] = (NMR::nfByte)BeamInfo.m_CapModes[1];
 
 	meshBeam->m_nodeindices[0] = BeamInfo.m_Indices[0];
 	meshBeam->m_nodeindices[1] = BeamInfo.m_Indices[1];
 
-	meshBeam->m_radius[0] = BeamInfo.m_Radii[0];
-	meshBeam->m_radius[1] = BeamInfo.m_Radii[1];
+	meshBeam->m_radius[0] = (NMR::nfSingle)BeamInfo.m_Radii[0];
+	meshBeam->m_radius[1] = (NMR::nfSingle)BeamInfo.m_Radii[1];
 
 	// Occupied nodes may have changed, need to validate
 	m_mesh.scanOccupiedNodes();
@@ -224,19 +220,24 @@ void CBeamLattice::SetBeams(const Lib3MF_uint64 nBeamInfoBufferSize, const sLib3
 	if ((nBeamInfoBufferSize>0) && (!m_pMeshObject->isValidForBeamLattices()))
 		throw ELib3MFInterfaceException(LIB3MF_ERROR_BEAMLATTICE_INVALID_OBJECTTYPE);
 
-	m_mesh.clearBeamLatticeBeams();
+	if (nBeamInfoBufferSize > NMR_MESH_MAXBEAMCOUNT)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_ELEMENTCOUNTEXCEEDSLIMIT);
 
-	const sLib3MFBeam* pBeamInfoCurrent = pBeamInfoBuffer;
-	for (Lib3MF_uint32 nIndex = 0; nIndex < nBeamInfoBufferSize; nIndex++)
+	// Validate the whole block first, so that an invalid beam leaves the beam lattice untouched
+	const Lib3MF_uint32 nNodeCount = m_mesh.getNodeCount();
+	for (Lib3MF_uint64 nIndex = 0; nIndex < nBeamInfoBufferSize; nIndex++)
 	{
-		if (!isBeamValid(m_mesh.getNodeCount(), *pBeamInfoCurrent))
+		if (!isBeamValid(nNodeCount, pBeamInfoBuffer[nIndex]))
 			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	}
+
+	m_mesh.clearBeamLatticeBeams();
 
-		NMR::MESHNODE * pNodes[2];
-		for (int j = 0; j < 2; j++)
-			pNodes[j] = m_mesh.getNode(pBeamInfoCurrent->m_Indices[j]);
-		
-		m_mesh.addBeam(pNodes[0], pNodes[1], pBeamInfoCurrent->m_Radii[0], pBeamInfoCurrent->m_Radii[1], (int)pBeamInfoCurrent->m_CapModes[0], (int)pBeamInfoCurrent->m_CapModes[1]);
+	const sLib3MFBeam* pBeamInfoCurrent = pBeamInfoBuffer;
+	for (Lib3MF_uint64 nIndex = 0; nIndex < nBeamInfoBufferSize; nIndex++)
+	{
+		m_mesh.addBeam((NMR::nfInt32)pBeamInfoCurrent->m_Indices[0], (NMR::nfInt32)pBeamInfoCurrent->m_Indices[1],
+			pBeamInfoCurrent->m_Radii[0], pBeamInfoCurrent->m_Radii[1], (int)pBeamInfoCurrent->m_CapModes[0], (int)pBeamInfoCurrent->m_CapModes[1]);
 		pBeamInfoCurrent++;
 	}
 
@@ -244,6 +245,11 @@ void CBeamLattice::SetBeams(const Lib3MF_uint64 nBeamInfoBufferSize, const sLib3
 	m_mesh.validateBeamLatticeBalls();
 }
 
+Lib3MF_uint32 CBeamLattice::GetDroppedBallCount()
+{
+	return m_mesh.getBeamLatticeDroppedBallCount();
+}
+
 void CBeamLattice::GetBeams(Lib3MF_uint64 nBeamInfoBufferSize, Lib3MF_uint64* pBeamInfoNeededCount, sLib3MFBeam * pBeamInfoBuffer)
 {
 	Lib3MF_uint32 beamCount = m_mesh.getBeamCount();
@@ -109,6 +109,103 @@ sLib3MFColor CColorGroup::GetColor (const Lib3MF_uint32 nPropertyID)
 	return c;
 }
 
+Lib3MF_uint32 CColorGroup::AddColors(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer)
+{
+	if (nColorsBufferSize == 0)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if (!pColorsBuffer)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CModelColorGroupResource & ColorGroup = colorGroup();
+	Lib3MF_uint32 nFirstPropertyID = 0;
+	for (Lib3MF_uint64 i = 0; i < nColorsBufferSize; i++) {
+		const sLib3MFColor & TheColor = pColorsBuffer[i];
+		NMR::nfColor cColor = TheColor.m_Red | (TheColor.m_Green << 8) | (TheColor.m_Blue << 16) | (TheColor.m_Alpha << 24);
+		Lib3MF_uint32 nPropertyID = ColorGroup.addColor(cColor);
+		if (i == 0)
+			nFirstPropertyID = nPropertyID;
+	}
+	return nFirstPropertyID;
+}
+
+void CColorGroup::SetColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer)
+{
+	if (nPropertyIDsBufferSize != nColorsBufferSize)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPROPERTYCOUNT);
+	if ((nPropertyIDsBufferSize > 0) && ((!pPropertyIDsBuffer) || (!pColorsBuffer)))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CModelColorGroupResource & ColorGroup = colorGroup();
+
+	// Check all PropertyIDs first, so that an unknown PropertyID leaves the color group untouched
+	for (Lib3MF_uint64 i = 0; i < nPropertyIDsBufferSize; i++) {
+		if (!ColorGroup.hasColor(pPropertyIDsBuffer[i]))
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	}
+
+	for (Lib3MF_uint64 i = 0; i < nPropertyIDsBufferSize; i++) {
+		const sLib3MFColor & TheColor = pColorsBuffer[i];
+		NMR::nfColor cColor = TheColor.m_Red | (TheColor.m_Green << 8) | (TheColor.m_Blue << 16) | (TheColor.m_Alpha << 24);
+		ColorGroup.setColor(pPropertyIDsBuffer[i], cColor);
+	}
+}
+
+void CColorGroup::GetColors(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer)
+{
+	if ((!pPropertyIDsBuffer) && (nPropertyIDsBufferSize > 0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	if (pColorsNeededCount)
+		*pColorsNeededCount = nPropertyIDsBufferSize;
+
+	if (nColorsBufferSize >= nPropertyIDsBufferSize && pColorsBuffer) {
+		NMR::CModelColorGroupResource & ColorGroup = colorGroup();
+		for (Lib3MF_uint64 i = 0; i < nPropertyIDsBufferSize; i++) {
+			NMR::nfColor cColor = ColorGroup.getColor(pPropertyIDsBuffer[i]);
+			pColorsBuffer[i].m_Red = (cColor) & 0xff;
+			pColorsBuffer[i].m_Green = (cColor >> 8) & 0xff;
+			pColorsBuffer[i].m_Blue = (cColor >> 16) & 0xff;
+			pColorsBuffer[i].m_Alpha = (cColor >> 24) & 0xff;
+		}
+	}
+}
+
+void CColorGroup::GetAllColors(Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer)
+{
+	NMR::CModelColorGroupResource & ColorGroup = colorGroup();
+	Lib3MF_uint32 nCount = ColorGroup.getCount();
+
+	if (pColorsNeededCount)
+		*pColorsNeededCount = nCount;
+
+	if (nColorsBufferSize >= nCount && pColorsBuffer) {
+		for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+			NMR::nfColor cColor = ColorGroup.getColorByIndex(i);
+			pColorsBuffer[i].m_Red = (cColor) & 0xff;
+			pColorsBuffer[i].m_Green = (cColor >> 8) & 0xff;
+			pColorsBuffer[i].m_Blue = (cColor >> 16) & 0xff;
+			pColorsBuffer[i].m_Alpha = (cColor >> 24) & 0xff;
+		}
+	}
+}
+
+void CColorGroup::SetAllColors(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer)
+{
+	NMR::CModelColorGroupResource & ColorGroup = colorGroup();
+	Lib3MF_uint32 nCount = ColorGroup.getCount();
+
+	if (nColorsBufferSize != nCount)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPROPERTYCOUNT);
+	if ((nCount > 0) && (!pColorsBuffer))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+		const sLib3MFColor & TheColor = pColorsBuffer[i];
+		NMR::nfColor cColor = TheColor.m_Red | (TheColor.m_Green << 8) | (TheColor.m_Blue << 16) | (TheColor.m_Alpha << 24);
+		ColorGroup.setColorByIndex(i, cColor);
+	}
+}
+
 void CColorGroup::RemoveColor(const Lib3MF_uint32 nPropertyID)
 {
 	colorGroup().removeColor(nPropertyID);
@@ -31,9 +31,12 @@ Abstract: This is a stub class definition of CMeshObject
 #include "lib3mf_interfaceexception.hpp"
 
 #include "lib3mf_beamlattice.hpp"
+#include "lib3mf_meshvalidationreport.hpp"
 // Include custom headers here.
 
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Common/Mesh/NMR_MeshBVH.h"
+#include "Common/Mesh/NMR_MeshValidator.h"
 #include <cmath>
 
 using namespace Lib3MF::Impl;
@@ -108,6 +111,7 @@ void CMeshObject::SetVertex (const Lib3MF_uint32 nIndex, const sLib3MFPosition C
 	node->m_position.m_fields[0] = Coordinates.m_Coordinates[0];
 	node->m_position.m_fields[1] = Coordinates.m_Coordinates[1];
 	node->m_position.m_fields[2] = Coordinates.m_Coordinates[2];
+	mesh()->invalidateGeometryCache();
 }
 
 sLib3MFPosition CMeshObject::GetVertex(const Lib3MF_uint32 nIndex)
@@ -143,6 +147,56 @@ void CMeshObject::GetVertices(Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64*
 	}
 }
 
+void CMeshObject::GetVertexRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint32 nCount, Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64* pVerticesNeededCount, sLib3MFPosition * pVerticesBuffer)
+{
+	NMR::CMesh * pMesh = mesh();
+	if ((Lib3MF_uint64)nStartIndex + nCount > pMesh->getNodeCount())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	if (pVerticesNeededCount)
+		*pVerticesNeededCount = nCount;
+
+	if (nVerticesBufferSize >= nCount && pVerticesBuffer)
+	{
+		for (Lib3MF_uint32 i = 0; i < nCount; i++)
+		{
+			const NMR::MESHNODE* node = pMesh->getNode(nStartIndex + i);
+			pVerticesBuffer[i].m_Coordinates[0] = node->m_position.m_fields[0];
+			pVerticesBuffer[i].m_Coordinates[1] = node->m_position.m_fields[1];
+			pVerticesBuffer[i].m_Coordinates[2] = node->m_position.m_fields[2];
+		}
+	}
+}
+
+void CMeshObject::SetVertexRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint64 nVerticesBufferSize, const sLib3MFPosition * pVerticesBuffer)
+{
+	if ((!pVerticesBuffer) && (nVerticesBufferSize > 0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CMesh * pMesh = mesh();
+	if ((Lib3MF_uint64)nStartIndex + nVerticesBufferSize > pMesh->getNodeCount())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	// Check all coordinates first, so that an invalid one leaves the mesh unchanged
+	for (Lib3MF_uint64 i = 0; i < nVerticesBufferSize; i++) {
+		for (int j = 0; j < 3; j++) {
+			if (std::fabs(pVerticesBuffer[i].m_Coordinates[j]) > NMR_MESH_MAXCOORDINATE)
+				throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+		}
+	}
+
+	for (Lib3MF_uint32 i = 0; i < (Lib3MF_uint32)nVerticesBufferSize; i++)
+	{
+		NMR::MESHNODE* node = pMesh->getNode(nStartIndex + i);
+		node->m_position.m_fields[0] = (NMR::nfFloat)pVerticesBuffer[i].m_Coordinates[0];
+		node->m_position.m_fields[1] = (NMR::nfFloat)pVerticesBuffer[i].m_Coordinates[1];
+		node->m_position.m_fields[2] = (NMR::nfFloat)pVerticesBuffer[i].m_Coordinates[2];
+	}
+
+	if (nVerticesBufferSize > 0)
+		pMesh->invalidateGeometryCache();
+}
+
 sLib3MFTriangle CMeshObject::GetTriangle (const Lib3MF_uint32 nIndex)
 {
 	sLib3MFTriangle t;
@@ -162,6 +216,7 @@ void CMeshObject::SetTriangle (const Lib3MF_uint32 nIndex, const sLib3MFTriangle
 	mf->m_nodeindices[0] = Indices.m_Indices[0];
 	mf->m_nodeindices[1] = Indices.m_Indices[1];
 	mf->m_nodeindices[2] = Indices.m_Indices[2];
+	mesh()->invalidateGeometryCache();
 }
 
 Lib3MF_uint32 CMeshObject::AddTriangle(const sLib3MFTriangle Indices)
@@ -315,6 +370,60 @@ void CMeshObject::GetAllTriangleProperties(Lib3MF_uint64 nPropertiesArrayBufferS
 	}
 }
 
+void CMeshObject::SetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint64 nPropertiesArrayBufferSize, const sLib3MFTriangleProperties * pPropertiesArrayBuffer)
+{
+	if ((!pPropertiesArrayBuffer) && (nPropertiesArrayBufferSize > 0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if ((Lib3MF_uint64)nStartIndex + nPropertiesArrayBufferSize > mesh()->getFaceCount())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
+
+	const sLib3MFTriangleProperties * pProperty = pPropertiesArrayBuffer;
+	for (Lib3MF_uint32 i = 0; i < (Lib3MF_uint32)nPropertiesArrayBufferSize; i++) {
+		NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nStartIndex + i);
+		if (pFaceData != nullptr) {
+			pFaceData->m_nUniqueResourceID = pProperty->m_ResourceID;
+			for (unsigned j = 0; j < 3; j++) {
+				pFaceData->m_nPropertyIDs[j] = pProperty->m_PropertyIDs[j];
+			}
+		}
+		pProperty++;
+	}
+}
+
+void CMeshObject::GetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint32 nCount, Lib3MF_uint64 nPropertiesArrayBufferSize, Lib3MF_uint64* pPropertiesArrayNeededCount, sLib3MFTriangleProperties * pPropertiesArrayBuffer)
+{
+	if ((Lib3MF_uint64)nStartIndex + nCount > mesh()->getFaceCount())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	if (pPropertiesArrayNeededCount)
+		*pPropertiesArrayNeededCount = nCount;
+
+	if (nPropertiesArrayBufferSize >= nCount && pPropertiesArrayBuffer)
+	{
+		NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
+
+		sLib3MFTriangleProperties * pProperty = pPropertiesArrayBuffer;
+		for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+			NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nStartIndex + i);
+			if (pFaceData != nullptr) {
+				pProperty->m_ResourceID = pFaceData->m_nUniqueResourceID;
+				for (unsigned j = 0; j < 3; j++) {
+					pProperty->m_PropertyIDs[j] = pFaceData->m_nPropertyIDs[j];
+				}
+			}
+			else {
+				pProperty->m_ResourceID = 0;
+				for (unsigned j = 0; j < 3; j++) {
+					pProperty->m_PropertyIDs[j] = 0;
+				}
+			}
+			pProperty++;
+		}
+	}
+}
+
 void CMeshObject::ClearAllProperties()
 {
 	mesh()->clearMeshInformationHandler();
@@ -388,3 +497,70 @@ IBeamLattice* CMeshObject::BeamLattice()
 {
 	return new CBeamLattice(meshObject(), meshObject()->getBeamLatticeAttributes());
 }
+
+void CMeshObject::BuildBVH()
+{
+	mesh()->getBVH();
+}
+
+void CMeshObject::ReleaseBVH()
+{
+	mesh()->releaseBVH();
+}
+
+bool CMeshObject::IntersectRay(const sLib3MFPosition Origin, const sLib3MFPosition Direction, Lib3MF_uint32 & nTriangleIndex, Lib3MF_double & dDistance)
+{
+	NMR::NVEC3 vDirection = NMR::fnVEC3_make(Direction.m_Coordinates[0], Direction.m_Coordinates[1], Direction.m_Coordinates[2]);
+	NMR::nfFloat fLength = NMR::fnVEC3_length(vDirection);
+	if (!(fLength > 0.0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::MESHBVHHIT Hit;
+	NMR::NVEC3 vOrigin = NMR::fnVEC3_make(Origin.m_Coordinates[0], Origin.m_Coordinates[1], Origin.m_Coordinates[2]);
+	if (!mesh()->getBVH()->intersectRay(vOrigin, NMR::fnVEC3_scale(vDirection, 1.0 / fLength), Hit))
+		return false;
+
+	nTriangleIndex = Hit.m_nFaceIndex;
+	dDistance = Hit.m_fDistance;
+	return true;
+}
+
+bool CMeshObject::GetClosestPoint(const sLib3MFPosition Point, sLib3MFPosition & sClosestPoint, Lib3MF_uint32 & nTriangleIndex, Lib3MF_double & dDistance)
+{
+	NMR::MESHBVHHIT Hit;
+	NMR::NVEC3 vPoint = NMR::fnVEC3_make(Point.m_Coordinates[0], Point.m_Coordinates[1], Point.m_Coordinates[2]);
+	if (!mesh()->getBVH()->findClosestPoint(vPoint, Hit))
+		return false;
+
+	for (int j = 0; j < 3; j++)
+		sClosestPoint.m_Coordinates[j] = (Lib3MF_single)Hit.m_vPosition.m_fields[j];
+	nTriangleIndex = Hit.m_nFaceIndex;
+	dDistance = Hit.m_fDistance;
+	return true;
+}
+
+void CMeshObject::GetTrianglesInBox(const sLib3MFBox Box, Lib3MF_uint64 nTriangleIndicesBufferSize, Lib3MF_uint64* pTriangleIndicesNeededCount, Lib3MF_uint32 * pTriangleIndicesBuffer)
+{
+	NMR::NOUTBOX3 Outbox;
+	for (int j = 0; j < 3; j++) {
+		Outbox.m_min.m_fields[j] = Box.m_MinCoordinate[j];
+		Outbox.m_max.m_fields[j] = Box.m_MaxCoordinate[j];
+	}
+
+	std::vector<NMR::nfUint32> FaceIndices;
+	mesh()->getBVH()->findOverlappingFaces(Outbox, FaceIndices);
+
+	if (pTriangleIndicesNeededCount)
+		*pTriangleIndicesNeededCount = FaceIndices.size();
+
+	if (nTriangleIndicesBufferSize >= FaceIndices.size() && pTriangleIndicesBuffer)
+	{
+		for (size_t nIndex = 0; nIndex < FaceIndices.size(); nIndex++)
+			pTriangleIndicesBuffer[nIndex] = FaceIndices[nIndex];
+	}
+}
+
+IMeshValidationReport * CMeshObject::Validate(const Lib3MF_uint32 nMaxSampleCount)
+{
+	return new CMeshValidationReport(std::make_shared<NMR::CMeshValidator>(mesh(), nMaxSampleCount));
+}
@@ -0,0 +1,83 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium (Original Author)
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: This is a stub class definition of CMeshValidationReport
+
+*/
+
+#include "lib3mf_meshvalidationreport.hpp"
+#include "lib3mf_interfaceexception.hpp"
+
+// Include custom headers here.
+
+
+using namespace Lib3MF::Impl;
+
+/*************************************************************************************************************************
+ Class definition of CMeshValidationReport 
+**************************************************************************************************************************/
+
+CMeshValidationReport::CMeshValidationReport(NMR::PMeshValidator pValidator)
+  : m_pValidator(pValidator)
+{
+	if (!pValidator.get())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+}
+
+bool CMeshValidationReport::IsValid()
+{
+	return m_pValidator->isValid();
+}
+
+bool CMeshValidationReport::IsManifoldAndOriented()
+{
+	return m_pValidator->isManifoldAndOriented();
+}
+
+Lib3MF_uint64 CMeshValidationReport::GetIssueCount(const eLib3MFMeshValidationIssue eIssue)
+{
+	if ((Lib3MF_uint32)eIssue >= NMR_MESHVALIDATOR_ISSUECOUNT)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	return m_pValidator->getIssueCount((NMR::eMeshValidationIssue)eIssue);
+}
+
+void CMeshValidationReport::GetIssueSamples(const eLib3MFMeshValidationIssue eIssue, Lib3MF_uint64 nIndicesBufferSize, Lib3MF_uint64* pIndicesNeededCount, Lib3MF_uint32 * pIndicesBuffer)
+{
+	if ((Lib3MF_uint32)eIssue >= NMR_MESHVALIDATOR_ISSUECOUNT)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	const std::vector<NMR::nfUint32> & Samples = m_pValidator->getIssueSamples((NMR::eMeshValidationIssue)eIssue);
+
+	if (pIndicesNeededCount)
+		*pIndicesNeededCount = Samples.size();
+
+	if (nIndicesBufferSize >= Samples.size() && pIndicesBuffer)
+	{
+		for (size_t nIndex = 0; nIndex < Samples.size(); nIndex++)
+			pIndicesBuffer[nIndex] = Samples[nIndex];
+	}
+}
@@ -141,28 +141,22 @@ ITexture2D * CModel::GetTexture2DByID(const Lib3MF_uint32 nUniqueResourceID)
 
 eLib3MFPropertyType CModel::GetPropertyTypeByID(const Lib3MF_uint32 nUniqueResourceID)
 {
-	NMR::PModelResource pResource = model().findResource(nUniqueResourceID);
-	if (!pResource) {
+	switch (model().findResourceType(nUniqueResourceID)) {
+	case NMR::MODELRESOURCETYPE_NONE:
 		throw ELib3MFInterfaceException(LIB3MF_ERROR_RESOURCENOTFOUND);
-	}
-
-	if (dynamic_cast<NMR::CModelBaseMaterialResource*>(pResource.get())) {
+	case NMR::MODELRESOURCETYPE_BASEMATERIALS:
 		return ePropertyType::BaseMaterial;
-	}
-	else if ((dynamic_cast<NMR::CModelColorGroupResource*>(pResource.get()))) {
+	case NMR::MODELRESOURCETYPE_COLORGROUP:
 		return ePropertyType::Colors;
-	}
-	else if ((dynamic_cast<NMR::CModelTexture2DGroupResource*>(pResource.get()))) {
+	case NMR::MODELRESOURCETYPE_TEXTURE2DGROUP:
 		return ePropertyType::TexCoord;
-	}
-	else if ((dynamic_cast<NMR::CModelCompositeMaterialsResource*>(pResource.get()))) {
+	case NMR::MODELRESOURCETYPE_COMPOSITEMATERIALS:
 		return ePropertyType::Composite;
-	}
-	else if ((dynamic_cast<NMR::CModelMultiPropertyGroupResource*>(pResource.get()))) {
+	case NMR::MODELRESOURCETYPE_MULTIPROPERTYGROUP:
 		return ePropertyType::Multi;
-	}
-	else
+	default:
 		return ePropertyType::NoPropertyType;
+	}
 }
 
 IBaseMaterialGroup * CModel::GetBaseMaterialGroupByID(const Lib3MF_uint32 nUniqueResourceID)
@@ -421,6 +415,22 @@ ISliceStackIterator * CModel::GetSliceStacks()
 	return pResult.release();
 }
 
+// Copies the attachments, property resources and settings of a source model into a newly created model
+static void fnMergeModelResources(NMR::CModel & newModel, NMR::CModel & sourceModel, NMR::UniqueResourceIDMapping & oldToNewUniqueResourceIDs)
+{
+	newModel.mergeModelAttachments(&sourceModel);
+	newModel.mergeTextures2D(&sourceModel, oldToNewUniqueResourceIDs);
+	newModel.mergeBaseMaterials(&sourceModel, oldToNewUniqueResourceIDs);
+	newModel.mergeColorGroups(&sourceModel, oldToNewUniqueResourceIDs);
+	newModel.mergeTexture2DGroups(&sourceModel, oldToNewUniqueResourceIDs);
+	newModel.mergeCompositeMaterials(&sourceModel, oldToNewUniqueResourceIDs);
+	newModel.mergeMultiPropertyGroups(&sourceModel, oldToNewUniqueResourceIDs);
+	newModel.mergeMetaData(&sourceModel);
+
+	newModel.setUnit(sourceModel.getUnit());
+	newModel.setLanguage(sourceModel.getLanguage());
+}
+
 IModel * CModel::MergeToModel ()
 {
 	// Create merged mesh
@@ -433,21 +443,10 @@ IModel * CModel::MergeToModel ()
 	NMR::CModel& newModel = pOutModel->model();
 
 	NMR::UniqueResourceIDMapping oldToNewUniqueResourceIDs;
-
-	newModel.mergeModelAttachments(&model());
-	newModel.mergeTextures2D(&model(), oldToNewUniqueResourceIDs);
-	newModel.mergeBaseMaterials(&model(), oldToNewUniqueResourceIDs);
-	newModel.mergeColorGroups(&model(), oldToNewUniqueResourceIDs);
-	newModel.mergeTexture2DGroups(&model(), oldToNewUniqueResourceIDs);
-	newModel.mergeCompositeMaterials(&model(), oldToNewUniqueResourceIDs);
-	newModel.mergeMultiPropertyGroups(&model(), oldToNewUniqueResourceIDs);
-	newModel.mergeMetaData(&model());
+	fnMergeModelResources(newModel, model(), oldToNewUniqueResourceIDs);
 
 	pMesh->patchMeshInformationResources(oldToNewUniqueResourceIDs);
 
-	newModel.setUnit(model().getUnit());
-	newModel.setLanguage(model().getLanguage());
-
 	NMR::PModelMeshObject pMeshObject = std::make_shared<NMR::CModelMeshObject>(newModel.generateResourceID(), &newModel, pMesh);
 	newModel.addResource(pMeshObject);
 
@@ -457,6 +456,42 @@ IModel * CModel::MergeToModel ()
 	return pOutModel.release();
 }
 
+IModel * CModel::MergeToInstancedModel ()
+{
+	auto pOutModel = std::unique_ptr<CModel>(new CModel());
+	NMR::CModel& newModel = pOutModel->model();
+
+	NMR::UniqueResourceIDMapping oldToNewUniqueResourceIDs;
+	fnMergeModelResources(newModel, model(), oldToNewUniqueResourceIDs);
+
+	// Every mesh object is copied once, its placements become build items of the copy
+	std::map<NMR::CModelMeshObject *, NMR::CModelMeshObject *> meshObjectCopies;
+	model().forEachMeshInstance([&](NMR::CModelMeshObject * pSourceMeshObject, const NMR::NMATRIX3 & mTransform) {
+		NMR::CModelMeshObject * pCopy;
+		auto iIterator = meshObjectCopies.find(pSourceMeshObject);
+		if (iIterator == meshObjectCopies.end()) {
+			NMR::PMesh pMesh = std::make_shared<NMR::CMesh>(pSourceMeshObject->getMesh());
+			pMesh->patchMeshInformationResources(oldToNewUniqueResourceIDs);
+
+			NMR::PModelMeshObject pMeshObject = std::make_shared<NMR::CModelMeshObject>(newModel.generateResourceID(), &newModel, pMesh);
+			pMeshObject->setName(pSourceMeshObject->getName());
+			pMeshObject->setPartNumber(pSourceMeshObject->getPartNumber());
+			pMeshObject->setObjectType(pSourceMeshObject->getObjectType());
+			newModel.addResource(pMeshObject);
+
+			pCopy = pMeshObject.get();
+			meshObjectCopies.insert(std::make_pair(pSourceMeshObject, pCopy));
+		}
+		else {
+			pCopy = iIterator->second;
+		}
+
+		newModel.addBuildItem(std::make_shared<NMR::CModelBuildItem>(pCopy, mTransform, newModel.createHandle()));
+	});
+
+	return pOutModel.release();
+}
+
 IMeshObject * CModel::AddMeshObject ()
 {
 	NMR::ModelResourceID NewResourceID = model().generateResourceID();
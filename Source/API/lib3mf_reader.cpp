@@ -178,6 +178,51 @@ Lib3MF_uint32 CReader::GetWarningCount ()
 	return reader().warnings()->getWarningCount();
 }
 
+Lib3MF_uint32 CReader::GetWarningOccurrenceCount (const Lib3MF_uint32 nIndex)
+{
+	return reader().warnings()->getWarningOccurrenceCount(nIndex);
+}
+
+void CReader::SetAggregateWarnings (const bool bAggregateWarnings)
+{
+	reader().warnings()->setAggregateWarnings(bAggregateWarnings);
+}
+
+bool CReader::GetAggregateWarnings ()
+{
+	return reader().warnings()->getAggregateWarnings();
+}
+
+Lib3MF_uint32 CReader::GetExtractionThreadCount ()
+{
+	return reader().GetExtractionThreadCount();
+}
+
+void CReader::SetExtractionThreadCount (const Lib3MF_uint32 nThreadCount)
+{
+	reader().SetExtractionThreadCount(nThreadCount);
+}
+
+void CReader::SetRootModelReadAhead (const bool bReadAhead)
+{
+	reader().SetRootModelReadAhead(bReadAhead);
+}
+
+bool CReader::GetRootModelReadAhead ()
+{
+	return reader().GetRootModelReadAhead();
+}
+
+void CReader::SetPackageConsistencyCheck (const bool bCheckConsistency)
+{
+	reader().SetPackageConsistencyCheck(bCheckConsistency);
+}
+
+bool CReader::GetPackageConsistencyCheck ()
+{
+	return reader().GetPackageConsistencyCheck();
+}
+
 void Lib3MF::Impl::CReader::AddKeyWrappingCallback(const std::string &sConsumerID, const Lib3MF::KeyWrappingCallback pTheCallback, const Lib3MF_pvoid pUserData) {
 	NMR::KeyWrappingDescriptor descriptor;
 	descriptor.m_sKekDecryptData.m_pUserData = pUserData;
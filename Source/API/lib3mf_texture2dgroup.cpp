@@ -99,6 +99,73 @@ sLib3MFTex2Coord CTexture2DGroup::GetTex2Coord (const Lib3MF_uint32 nPropertyID)
 	return sLib3MFTex2Coord({ coord.m_dU, coord.m_dV});
 }
 
+Lib3MF_uint32 CTexture2DGroup::AddTex2Coords(const Lib3MF_uint64 nUVCoordinatesBufferSize, const sLib3MFTex2Coord * pUVCoordinatesBuffer)
+{
+	if (nUVCoordinatesBufferSize == 0)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if (!pUVCoordinatesBuffer)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CModelTexture2DGroupResource & Texture2DGroup = texture2DGroup();
+	Lib3MF_uint32 nFirstPropertyID = 0;
+	for (Lib3MF_uint64 i = 0; i < nUVCoordinatesBufferSize; i++) {
+		Lib3MF_uint32 nPropertyID = Texture2DGroup.addUVCoordinate(NMR::MODELTEXTURE2DCOORDINATE({ pUVCoordinatesBuffer[i].m_U, pUVCoordinatesBuffer[i].m_V }));
+		if (i == 0)
+			nFirstPropertyID = nPropertyID;
+	}
+	return nFirstPropertyID;
+}
+
+void CTexture2DGroup::GetTex2Coords(const Lib3MF_uint64 nPropertyIDsBufferSize, const Lib3MF_uint32 * pPropertyIDsBuffer, Lib3MF_uint64 nUVCoordinatesBufferSize, Lib3MF_uint64* pUVCoordinatesNeededCount, sLib3MFTex2Coord * pUVCoordinatesBuffer)
+{
+	if ((!pPropertyIDsBuffer) && (nPropertyIDsBufferSize > 0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	if (pUVCoordinatesNeededCount)
+		*pUVCoordinatesNeededCount = nPropertyIDsBufferSize;
+
+	if (nUVCoordinatesBufferSize >= nPropertyIDsBufferSize && pUVCoordinatesBuffer) {
+		NMR::CModelTexture2DGroupResource & Texture2DGroup = texture2DGroup();
+		for (Lib3MF_uint64 i = 0; i < nPropertyIDsBufferSize; i++) {
+			NMR::MODELTEXTURE2DCOORDINATE coord = Texture2DGroup.getUVCoordinate(pPropertyIDsBuffer[i]);
+			pUVCoordinatesBuffer[i].m_U = coord.m_dU;
+			pUVCoordinatesBuffer[i].m_V = coord.m_dV;
+		}
+	}
+}
+
+void CTexture2DGroup::GetAllTex2Coords(Lib3MF_uint64 nUVCoordinatesBufferSize, Lib3MF_uint64* pUVCoordinatesNeededCount, sLib3MFTex2Coord * pUVCoordinatesBuffer)
+{
+	NMR::CModelTexture2DGroupResource & Texture2DGroup = texture2DGroup();
+	Lib3MF_uint32 nCount = Texture2DGroup.getCount();
+
+	if (pUVCoordinatesNeededCount)
+		*pUVCoordinatesNeededCount = nCount;
+
+	if (nUVCoordinatesBufferSize >= nCount && pUVCoordinatesBuffer) {
+		for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+			NMR::MODELTEXTURE2DCOORDINATE coord = Texture2DGroup.getUVCoordinateByIndex(i);
+			pUVCoordinatesBuffer[i].m_U = coord.m_dU;
+			pUVCoordinatesBuffer[i].m_V = coord.m_dV;
+		}
+	}
+}
+
+void CTexture2DGroup::SetAllTex2Coords(const Lib3MF_uint64 nUVCoordinatesBufferSize, const sLib3MFTex2Coord * pUVCoordinatesBuffer)
+{
+	NMR::CModelTexture2DGroupResource & Texture2DGroup = texture2DGroup();
+	Lib3MF_uint32 nCount = Texture2DGroup.getCount();
+
+	if (nUVCoordinatesBufferSize != nCount)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPROPERTYCOUNT);
+	if ((nCount > 0) && (!pUVCoordinatesBuffer))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+		Texture2DGroup.setUVCoordinateByIndex(i, NMR::MODELTEXTURE2DCOORDINATE({ pUVCoordinatesBuffer[i].m_U, pUVCoordinatesBuffer[i].m_V }));
+	}
+}
+
 void CTexture2DGroup::RemoveTex2Coord(const Lib3MF_uint32 nPropertyID)
 {
 	texture2DGroup().removePropertyID(nPropertyID);
@@ -54,6 +54,9 @@ using namespace Lib3MF::Impl;
 CWriter::CWriter(std::string sWriterClass, NMR::PModel model)
 {
 	m_pWriter = nullptr;
+	m_FileOptions.m_nSizeHint = 0;
+	m_FileOptions.m_bDropWrittenPages = false;
+	m_FileOptions.m_bDirectIO = false;
 
 	// Create specified writer instance
 	if (sWriterClass.compare("3mf") == 0) {
@@ -75,9 +78,10 @@ NMR::CModelWriter& CWriter::writer()
 void CWriter::WriteToFile (const std::string & sFilename)
 {
 	setlocale(LC_ALL, "C");
-	NMR::PExportStream pStream = NMR::fnCreateExportStreamInstance(sFilename.c_str());
+	NMR::PExportStream pStream = NMR::fnCreateExportStreamInstance(sFilename.c_str(), m_FileOptions);
 	try {
 		writer().exportToStream(pStream);
+		pStream->close();
 	}
 	catch (NMR::CNMRException&e) {
 		if (e.getErrorCode() == NMR_USERABORTED) {
@@ -134,8 +138,8 @@ void CWriter::WriteToBuffer(Lib3MF_uint64 nBufferBufferSize, Lib3MF_uint64* pBuf
 		*pBufferNeededCount = cbStreamSize;
 
 	if (nBufferBufferSize >= cbStreamSize) {
-		// TODO eliminate this copy, perhaps by allowing CExportStreamMemory to use existing buffers
-		memcpy(pBufferBuffer, pStream->getData(), static_cast<size_t>(cbStreamSize));
+		// Gathers the chunks of the stream directly into the caller's buffer
+		pStream->copyData(0, cbStreamSize, pBufferBuffer);
 		momentBuffer.reset();
 	} else {
 		momentBuffer = pStream;
@@ -151,12 +155,15 @@ void CWriter::WriteToCallback(const Lib3MFWriteCallback pTheWriteCallback, const
 		return 0;
 	};
 
-	NMR::ExportStream_SeekCallbackType lambdaSeekCallback =
-		[pTheSeekCallback](NMR::nfUint64 nPosition, void* pUserData)
-	{
-		(*pTheSeekCallback)(nPosition, pUserData);
-		return 0;
-	};
+	// Without a seek callback, the package is written strictly sequentially
+	NMR::ExportStream_SeekCallbackType lambdaSeekCallback = nullptr;
+	if (pTheSeekCallback != nullptr) {
+		lambdaSeekCallback = [pTheSeekCallback](NMR::nfUint64 nPosition, void* pUserData)
+		{
+			(*pTheSeekCallback)(nPosition, pUserData);
+			return 0;
+		};
+	}
 
 	NMR::PExportStream pStream = std::make_shared<NMR::CExportStream_Callback>(lambdaWriteCallback, lambdaSeekCallback, pUserData);
 	try {
@@ -192,6 +199,23 @@ void CWriter::SetDecimalPrecision(const Lib3MF_uint32 nDecimalPrecision)
 	m_pWriter->SetDecimalPrecision(nDecimalPrecision);
 }
 
+Lib3MF_uint32 CWriter::GetEncryptionThreadCount()
+{
+	return m_pWriter->GetEncryptionThreadCount();
+}
+
+void CWriter::SetEncryptionThreadCount(const Lib3MF_uint32 nThreadCount)
+{
+	m_pWriter->SetEncryptionThreadCount(nThreadCount);
+}
+
+void CWriter::SetFileWriteOptions(const Lib3MF_uint64 nSizeHint, const bool bDropWrittenPages, const bool bDirectIO)
+{
+	m_FileOptions.m_nSizeHint = nSizeHint;
+	m_FileOptions.m_bDropWrittenPages = bDropWrittenPages;
+	m_FileOptions.m_bDirectIO = bDirectIO;
+}
+
 void Lib3MF::Impl::CWriter::AddKeyWrappingCallback(const std::string & sConsumerID, const Lib3MF::KeyWrappingCallback pTheCallback, const Lib3MF_pvoid pUserData){
 	NMR::KeyWrappingDescriptor descriptor;
 	descriptor.m_sKekDecryptData.m_pUserData = pUserData;
@@ -33,84 +33,105 @@ Abstract: Progress Monitor
 
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 #include <limits>
 
 NMR::CProgressMonitor::CProgressMonitor()
 {
 	m_progressCallback = nullptr;
 	m_userData = nullptr;
-	m_lastCallbackResult = true;
+	m_bAborted = false;
 	m_dProgress = 0;
 	m_dProgressMax = 1;
 	m_eProgressIdentifier = ProgressIdentifier::PROGRESS_QUERYCANCELED;
+	m_nNextCallbackTime = std::numeric_limits<long long>::min();
 }
 
-bool NMR::CProgressMonitor::QueryCancelled(bool throwIfCancelled)
+static long long fnProgressTimeInMilliseconds()
 {
-	if (m_progressCallback)
-	{
-		std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
-		if (lock) // If another progress callback is happening right _now_, just drop this one
-		{
-			int nProgress = (int)(100 * m_dProgress / m_dProgressMax);
-			m_lastCallbackResult = m_progressCallback(nProgress, ProgressIdentifier::PROGRESS_QUERYCANCELED, m_userData);
-
-			if (throwIfCancelled && m_lastCallbackResult)
-				throw CNMRException(NMR_USERABORTED);
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-			return m_lastCallbackResult;
-		}
-	}
-	return false;
+bool NMR::CProgressMonitor::isCallbackDue(ProgressIdentifier identifier)
+{
+	// An abort request is always confirmed by the callback, so that a later operation starts afresh
+	if (m_bAborted.load(std::memory_order_relaxed))
+		return true;
+	if (identifier == ProgressIdentifier::PROGRESS_DONE)
+		return true;
+	return fnProgressTimeInMilliseconds() >= m_nNextCallbackTime.load(std::memory_order_relaxed);
 }
 
-bool NMR::CProgressMonitor::ReportProgressAndQueryCancelled(bool throwIfCancelled)
+bool NMR::CProgressMonitor::reportProgress(ProgressIdentifier identifier, bool throwIfCancelled)
 {
-	if (m_progressCallback)
+	if (!m_progressCallback)
+		return false;
+
+	if (isCallbackDue(identifier))
 	{
 		std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
 		if (lock) // If another progress callback is happening right _now_, just drop this one
 		{
-			int nProgress = (int)(100 * m_dProgress / m_dProgressMax);
-			m_lastCallbackResult = m_progressCallback(nProgress, m_eProgressIdentifier, m_userData);
+			int nProgress = (int)(100 * m_dProgress.load(std::memory_order_relaxed) / m_dProgressMax.load(std::memory_order_relaxed));
+			bool bAborted = m_progressCallback(nProgress, identifier, m_userData);
 
-			if (throwIfCancelled && m_lastCallbackResult)
-				throw CNMRException(NMR_USERABORTED);
-
-			return m_lastCallbackResult;
+			m_bAborted.store(bAborted, std::memory_order_relaxed);
+			m_nNextCallbackTime.store(fnProgressTimeInMilliseconds() + PROGRESS_CALLBACKINTERVAL, std::memory_order_relaxed);
 		}
 	}
-	return false;
+
+	bool bAborted = m_bAborted.load(std::memory_order_relaxed);
+	if (throwIfCancelled && bAborted)
+		throw CNMRException(NMR_USERABORTED);
+
+	return bAborted;
+}
+
+bool NMR::CProgressMonitor::QueryCancelled(bool throwIfCancelled)
+{
+	return reportProgress(ProgressIdentifier::PROGRESS_QUERYCANCELED, throwIfCancelled);
+}
+
+bool NMR::CProgressMonitor::ReportProgressAndQueryCancelled(bool throwIfCancelled)
+{
+	return reportProgress(m_eProgressIdentifier.load(std::memory_order_relaxed), throwIfCancelled);
 }
 
 bool NMR::CProgressMonitor::WasAborted()
 {
-	return (m_lastCallbackResult == false);
+	return m_bAborted.load(std::memory_order_relaxed);
 }
 
 void NMR::CProgressMonitor::SetProgressIdentifier(ProgressIdentifier identifier)
 {
-	m_eProgressIdentifier = identifier;
+	m_eProgressIdentifier.store(identifier, std::memory_order_relaxed);
 }
 
 void NMR::CProgressMonitor::SetMaxProgress(double dProgressMax)
 {
-	m_dProgressMax = dProgressMax;
+	m_dProgressMax.store(dProgressMax, std::memory_order_relaxed);
 }
 
 void NMR::CProgressMonitor::DecreaseMaxProgress(double dMaxProgressDecrement)
 {
-	m_dProgressMax = std::max(m_dProgressMax - dMaxProgressDecrement, 1.0);
-	m_dProgress = std::min(m_dProgressMax, m_dProgress);
+	double dProgressMax = m_dProgressMax.load(std::memory_order_relaxed);
+	double dNewProgressMax;
+	do {
+		dNewProgressMax = std::max(dProgressMax - dMaxProgressDecrement, 1.0);
+	} while (!m_dProgressMax.compare_exchange_weak(dProgressMax, dNewProgressMax, std::memory_order_relaxed));
+
+	double dProgress = m_dProgress.load(std::memory_order_relaxed);
+	while ((dProgress > dNewProgressMax) && !m_dProgress.compare_exchange_weak(dProgress, dNewProgressMax, std::memory_order_relaxed)) {
+	}
 }
 
 void NMR::CProgressMonitor::IncrementProgress(double dProgressIncrement)
 {
 	if (m_progressCallback)
 	{
-		{
-			std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
-			m_dProgress = std::min(m_dProgressMax, m_dProgress + dProgressIncrement);
+		double dProgressMax = m_dProgressMax.load(std::memory_order_relaxed);
+		double dProgress = m_dProgress.load(std::memory_order_relaxed);
+		while (!m_dProgress.compare_exchange_weak(dProgress, std::min(dProgressMax, dProgress + dProgressIncrement), std::memory_order_relaxed)) {
 		}
 	}
 }
@@ -119,7 +140,8 @@ void NMR::CProgressMonitor::SetProgressCallback(Lib3MFProgressCallback callback,
 {
 	m_progressCallback = callback;
 	m_userData = userData;
-	m_lastCallbackResult = true;
+	m_bAborted = false;
+	m_nNextCallbackTime = std::numeric_limits<long long>::min();
 }
 
 void NMR::CProgressMonitor::ClearProgressCallback()
@@ -31,20 +31,88 @@ NMR_MeshBeamLattice.h implements the class CMeshBeamLattice.
 --*/
 
 #include "Common/Mesh/NMR_BeamLattice.h" 
+#include "Common/NMR_Exception.h" 
 
 namespace NMR {
 
 	CBeamLattice::CBeamLattice(_In_ MESHNODES &nodes) : m_Nodes(nodes)
 	{ 
 		m_dMinLength = 0.0001;
+		m_dDefaultRadius = 1.0;
+		m_eDefaultCapMode = eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE;
 		m_eBallMode = eModelBeamLatticeBallMode::MODELBEAMLATTICEBALLMODE_NONE;
 		m_dDefaultBallRadius = 0.0;
+		m_nOccupiedNodeCount = 0;
+		m_bOccupiedNodeIndicesValid = true;
+		m_nDroppedBallCount = 0;
+	}
+
+	void CBeamLattice::occupyNode(_In_ nfInt32 nNodeIndex)
+	{
+		if (nNodeIndex < 0)
+			throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+
+		nfUint32 nWord = ((nfUint32)nNodeIndex) >> 6;
+		nfUint64 nMask = 1ULL << (((nfUint32)nNodeIndex) & 63);
+		if (nWord >= m_OccupiedNodes.size())
+			m_OccupiedNodes.resize(nWord + 1, 0);
+
+		if ((m_OccupiedNodes[nWord] & nMask) == 0) {
+			m_OccupiedNodes[nWord] |= nMask;
+			m_nOccupiedNodeCount++;
+			m_bOccupiedNodeIndicesValid = false;
+		}
+	}
+
+	nfBool CBeamLattice::isNodeOccupied(_In_ nfInt32 nNodeIndex)
+	{
+		if (nNodeIndex < 0)
+			return false;
+
+		nfUint32 nWord = ((nfUint32)nNodeIndex) >> 6;
+		if (nWord >= m_OccupiedNodes.size())
+			return false;
+
+		return (m_OccupiedNodes[nWord] & (1ULL << (((nfUint32)nNodeIndex) & 63))) != 0;
+	}
+
+	nfInt32 CBeamLattice::getOccupiedNodeIndex(_In_ nfUint32 nIdx)
+	{
+		if (nIdx >= m_nOccupiedNodeCount)
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		if (!m_bOccupiedNodeIndicesValid) {
+			m_OccupiedNodeIndices.clear();
+			m_OccupiedNodeIndices.reserve(m_nOccupiedNodeCount);
+			nfUint32 nWordCount = (nfUint32)m_OccupiedNodes.size();
+			for (nfUint32 nWord = 0; nWord < nWordCount; nWord++) {
+				nfUint64 nBits = m_OccupiedNodes[nWord];
+				nfUint32 nBit = 0;
+				while (nBits != 0) {
+					if (nBits & 1)
+						m_OccupiedNodeIndices.push_back((nfInt32)((nWord << 6) + nBit));
+					nBits >>= 1;
+					nBit++;
+				}
+			}
+			m_bOccupiedNodeIndicesValid = true;
+		}
+
+		return m_OccupiedNodeIndices[nIdx];
+	}
+
+	void CBeamLattice::clearOccupiedNodes()
+	{
+		m_OccupiedNodes.clear();
+		m_OccupiedNodeIndices.clear();
+		m_nOccupiedNodeCount = 0;
+		m_bOccupiedNodeIndicesValid = true;
 	}
 
 	void CBeamLattice::clearBeams() {
 		m_Beams.clearAllData();
 		m_pBeamSets.clear();
-		m_OccupiedNodes.clear();
+		clearOccupiedNodes();
 	}
 
 	void CBeamLattice::clearBalls() {
@@ -54,6 +122,7 @@ namespace NMR {
 	void CBeamLattice::clear() {
 		clearBeams();
 		clearBalls();
+		m_nDroppedBallCount = 0;
 	}
 
 }
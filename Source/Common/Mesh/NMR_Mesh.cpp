@@ -40,19 +40,66 @@ structure.
 --*/
 
 #include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Mesh/NMR_MeshBVH.h"
 #include "Common/Math/NMR_Matrix.h" 
 #include "Common/NMR_Exception.h" 
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace NMR {
 
-	CMesh::CMesh(): m_BeamLattice(this->m_Nodes)
+	typedef struct {
+		NVEC3 m_vNormals[4];
+		nfFloat m_fOffsets[4];
+		nfBool m_bIsValid;
+	} MESHOUTBOXTETRAHEDRON;
+
+	static void fnMeshInitOutboxTetrahedron(_Out_ MESHOUTBOXTETRAHEDRON & Tetrahedron, _In_ const NVEC3 * pCorners)
+	{
+		Tetrahedron.m_bIsValid = true;
+		for (nfUint32 nFace = 0; nFace < 4; nFace++) {
+			const NVEC3 & vOpposite = pCorners[nFace];
+			const NVEC3 & vA = pCorners[(nFace + 1) % 4];
+			const NVEC3 & vB = pCorners[(nFace + 2) % 4];
+			const NVEC3 & vC = pCorners[(nFace + 3) % 4];
+
+			NVEC3 vNormal = fnVEC3_crossproduct(fnVEC3_sub(vB, vA), fnVEC3_sub(vC, vA));
+			nfFloat fLength = fnVEC3_length(vNormal);
+			if (fLength <= 0.0) {
+				Tetrahedron.m_bIsValid = false;
+				return;
+			}
+			vNormal = fnVEC3_scale(vNormal, 1.0 / fLength);
+
+			// Orient the face plane towards the opposite corner
+			if (fnVEC3_dotproduct(vNormal, fnVEC3_sub(vOpposite, vA)) < 0.0)
+				vNormal = fnVEC3_scale(vNormal, -1.0);
+
+			Tetrahedron.m_vNormals[nFace] = vNormal;
+			Tetrahedron.m_fOffsets[nFace] = fnVEC3_dotproduct(vNormal, vA);
+		}
+	}
+
+	static nfBool fnMeshIsInsideOutboxTetrahedron(_In_ const MESHOUTBOXTETRAHEDRON & Tetrahedron, _In_ const NVEC3 vPosition, _In_ nfFloat fMargin)
+	{
+		if (!Tetrahedron.m_bIsValid)
+			return false;
+
+		for (nfUint32 nFace = 0; nFace < 4; nFace++) {
+			if (fnVEC3_dotproduct(Tetrahedron.m_vNormals[nFace], vPosition) - Tetrahedron.m_fOffsets[nFace] < fMargin)
+				return false;
+		}
+		return true;
+	}
+
+	CMesh::CMesh(): m_BeamLattice(this->m_Nodes), m_bOutboxIsValid(false)
 	{
 		// empty on purpose
 	}
 
-	CMesh::CMesh(_In_opt_ CMesh * pMesh) : m_BeamLattice(this->m_Nodes)
+	CMesh::CMesh(_In_opt_ CMesh * pMesh) : m_BeamLattice(this->m_Nodes), m_bOutboxIsValid(false)
 	{
 		if (!pMesh)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
@@ -182,6 +229,7 @@ namespace NMR {
 		nfUint32 nNewIndex;
 		pNode = m_Nodes.allocData(nNewIndex);
 		pNode->m_index = nNewIndex;
+		m_bOutboxIsValid = false;
 		pNode->m_position = vPosition;
 
 		return pNode;
@@ -207,6 +255,7 @@ namespace NMR {
 		nfUint32 nNewIndex;
 		pNode = m_Nodes.allocData(nNewIndex);
 		pNode->m_index = nNewIndex;
+		m_bOutboxIsValid = false;
 		pNode->m_position.m_values.x = posX;
 		pNode->m_position.m_values.y = posY;
 		pNode->m_position.m_values.z = posZ;
@@ -235,6 +284,7 @@ namespace NMR {
 		pFace->m_nodeindices[1] = pNode2->m_index;
 		pFace->m_nodeindices[2] = pNode3->m_index;
 		pFace->m_index = nNewIndex;
+		m_pBVH.reset();
 
 		if (m_pMeshInformationHandler)
 			m_pMeshInformationHandler->addFace(getFaceCount());
@@ -260,6 +310,7 @@ namespace NMR {
 		pFace->m_nodeindices[1] = nNodeIndex2;
 		pFace->m_nodeindices[2] = nNodeIndex3;
 		pFace->m_index = nNewIndex;
+		m_pBVH.reset();
 
 		if (m_pMeshInformationHandler)
 			m_pMeshInformationHandler->addFace(getFaceCount());
@@ -277,25 +328,33 @@ namespace NMR {
 		if (pNode1 == pNode2)
 			throw CNMRException(NMR_ERROR_DUPLICATENODE);
 
+		return addBeam(pNode1->m_index, pNode2->m_index, dRadius1, dRadius2, eCapMode1, eCapMode2);
+	}
+
+	_Ret_notnull_ MESHBEAM * CMesh::addBeam(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2,
+		_In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
+		_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2)
+	{
+		if (nNodeIndex1 == nNodeIndex2)
+			throw CNMRException(NMR_ERROR_DUPLICATENODE);
+
 		MESHBEAM * pBeam;
 		nfUint32 nBeamCount = getBeamCount();
 
 		if (nBeamCount >= NMR_MESH_MAXBEAMCOUNT)
 			throw CNMRException(NMR_ERROR_TOOMANYBEAMS);
 
-		nfUint32 nNewIndex;
-
-		pBeam = m_BeamLattice.m_Beams.allocData(nNewIndex);
-		pBeam->m_nodeindices[0] = pNode1->m_index;
-		pBeam->m_nodeindices[1] = pNode2->m_index;
-		pBeam->m_index = nNewIndex;
-		pBeam->m_radius[0] = dRadius1;
-		pBeam->m_radius[1] = dRadius2;
+		m_BeamLattice.occupyNode(nNodeIndex1);
+		m_BeamLattice.occupyNode(nNodeIndex2);
 
-		pBeam->m_capMode[0] = eCapMode1;
-		pBeam->m_capMode[1] = eCapMode2;
+		pBeam = m_BeamLattice.m_Beams.allocData();
+		pBeam->m_nodeindices[0] = nNodeIndex1;
+		pBeam->m_nodeindices[1] = nNodeIndex2;
+		pBeam->m_radius[0] = (nfSingle)dRadius1;
+		pBeam->m_radius[1] = (nfSingle)dRadius2;
 
-		m_BeamLattice.m_OccupiedNodes.insert({ pNode1->m_index, pNode2->m_index });
+		pBeam->m_capMode[0] = (nfByte)eCapMode1;
+		pBeam->m_capMode[1] = (nfByte)eCapMode2;
 
 		return pBeam;
 	}
@@ -318,7 +377,7 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_TOOMANYBALLS);
 
 		// Ensure that at least one beam exists at this node
-		if (m_BeamLattice.m_OccupiedNodes.find(pNode->m_index) == m_BeamLattice.m_OccupiedNodes.end()) {
+		if (!m_BeamLattice.isNodeOccupied(pNode->m_index)) {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		}
 
@@ -359,12 +418,12 @@ namespace NMR {
 
 	nfUint32 CMesh::getOccupiedNodeCount()
 	{
-		return (nfUint32)m_BeamLattice.m_OccupiedNodes.size();
+		return m_BeamLattice.m_nOccupiedNodeCount;
 	}
 
 	nfBool CMesh::isNodeOccupied(_In_ nfUint32 nIdx)
 	{
-		return m_BeamLattice.m_OccupiedNodes.find(nIdx) != m_BeamLattice.m_OccupiedNodes.end();
+		return m_BeamLattice.isNodeOccupied((nfInt32)nIdx);
 	}
 
 	_Ret_notnull_ MESHNODE * CMesh::getNode(_In_ nfUint32 nIdx)
@@ -396,9 +455,7 @@ namespace NMR {
 
 	_Ret_notnull_ MESHNODE * CMesh::getOccupiedNode(_In_ nfUint32 nIdx)
 	{
-		std::unordered_set<nfInt32>::iterator iter = m_BeamLattice.m_OccupiedNodes.begin();
-		std::advance(iter, nIdx);
-		return getNode(*iter);
+		return getNode(m_BeamLattice.getOccupiedNodeIndex(nIdx));
 	}
 
 	void CMesh::setBeamLatticeMinLength(nfDouble dMinLength)
@@ -411,9 +468,14 @@ namespace NMR {
 		return m_BeamLattice.m_dMinLength;
 	}
 
+	void CMesh::setDefaultBeamRadius(nfDouble dRadius)
+	{
+		m_BeamLattice.m_dDefaultRadius = dRadius;
+	}
+
 	nfDouble CMesh::getDefaultBeamRadius()
 	{
-		return 1.0;
+		return m_BeamLattice.m_dDefaultRadius;
 	}
 
 	void CMesh::setDefaultBallRadius(nfDouble dDefaultBallRadius)
@@ -442,9 +504,14 @@ namespace NMR {
 		return m_BeamLattice.m_eBallMode;
 	}
 
+	void CMesh::setBeamLatticeCapMode(eModelBeamLatticeCapMode eCapMode)
+	{
+		m_BeamLattice.m_eDefaultCapMode = eCapMode;
+	}
+
 	eModelBeamLatticeCapMode CMesh::getBeamLatticeCapMode()
 	{
-		return eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE;
+		return m_BeamLattice.m_eDefaultCapMode;
 	}
 
 	nfBool CMesh::checkSanity()
@@ -511,6 +578,7 @@ namespace NMR {
 		m_Faces.clearAllData();
 		m_Nodes.clearAllData();
 		clearBeamLattice();
+		invalidateGeometryCache();
 	}
 	
 	void CMesh::clearBeamLattice() {
@@ -526,31 +594,64 @@ namespace NMR {
 	}
 
 	void CMesh::scanOccupiedNodes() {
-		m_BeamLattice.m_OccupiedNodes.clear();
+		m_BeamLattice.clearOccupiedNodes();
 
 		nfUint32 beamCount = m_BeamLattice.m_Beams.getCount();
 		for (nfUint32 iBeam = 0; iBeam < beamCount; iBeam++) {
 			MESHBEAM * meshBeam = getBeam(iBeam);
-			m_BeamLattice.m_OccupiedNodes.insert({ meshBeam->m_nodeindices[0], meshBeam->m_nodeindices[1] });
+			m_BeamLattice.occupyNode(meshBeam->m_nodeindices[0]);
+			m_BeamLattice.occupyNode(meshBeam->m_nodeindices[1]);
 		}
 	}
 
-	void CMesh::validateBeamLatticeBalls() {
+	nfUint32 CMesh::validateBeamLatticeBalls() {
+		// Compact the balls in place, dropping all balls that are not placed at a node with a beam
 		nfUint32 ballCount = m_BeamLattice.m_Balls.getCount();
-		MESHBALL * ballData = new MESHBALL[ballCount];
+		nfUint32 nValidCount = 0;
+		std::vector<nfInt32> newBallIndices;
+
 		for (nfUint32 iBall = 0; iBall < ballCount; iBall++) {
-			ballData[iBall] = *m_BeamLattice.m_Balls.getData(iBall);
+			MESHBALL & ball = m_BeamLattice.m_Balls.getDataRef(iBall);
+			if (m_BeamLattice.isNodeOccupied(ball.m_nodeindex)) {
+				if (nValidCount != iBall) {
+					MESHBALL & targetBall = m_BeamLattice.m_Balls.getDataRef(nValidCount);
+					targetBall = ball;
+					targetBall.m_index = nValidCount;
+				}
+				if (!newBallIndices.empty())
+					newBallIndices[iBall] = nValidCount;
+				nValidCount++;
+			}
+			else if (newBallIndices.empty()) {
+				// first invalid ball, the ball references of the beamsets will need to be remapped
+				newBallIndices.resize(ballCount, -1);
+				for (nfUint32 iValidBall = 0; iValidBall < iBall; iValidBall++)
+					newBallIndices[iValidBall] = iValidBall;
+			}
 		}
 
-		clearBeamLatticeBalls();
-		for (nfUint32 iBall = 0; iBall < ballCount; iBall++) {
-			try {
-				addBall(getNode(ballData[iBall].m_nodeindex), ballData[iBall].m_radius);
+		nfUint32 nDroppedCount = ballCount - nValidCount;
+		if (nDroppedCount > 0) {
+			m_BeamLattice.m_Balls.shrinkToCount(nValidCount);
+
+			for (auto pBeamSet : m_BeamLattice.m_pBeamSets) {
+				std::vector<nfUint32> & ballRefs = pBeamSet->m_BallRefs;
+				size_t nRefCount = 0;
+				for (size_t iRef = 0; iRef < ballRefs.size(); iRef++) {
+					if ((ballRefs[iRef] < ballCount) && (newBallIndices[ballRefs[iRef]] >= 0))
+						ballRefs[nRefCount++] = (nfUint32)newBallIndices[ballRefs[iRef]];
+				}
+				ballRefs.resize(nRefCount);
 			}
-			catch (CNMRException) {}
 		}
 
-		delete [] ballData;
+		m_BeamLattice.m_nDroppedBallCount = nDroppedCount;
+		return nDroppedCount;
+	}
+
+	nfUint32 CMesh::getBeamLatticeDroppedBallCount()
+	{
+		return m_BeamLattice.m_nDroppedBallCount;
 	}
 
 	void CMesh::clearMeshInformationHandler()
@@ -599,15 +700,145 @@ namespace NMR {
 
 	void CMesh::extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix)
 	{
+		if (!m_bOutboxIsValid)
+			updateOutboxCache();
+		if (m_OutboxHullCandidates.empty())
+			return;
+
 		if (fnMATRIX3_isIdentity(mAccumulatedMatrix)) {
-			for (nfUint32 iNode = 0; iNode < getNodeCount(); iNode++) {
-				fnOutboxMergeVector(vOutBox, getNode(iNode)->m_position);
-			}
+			fnOutboxMergeOutbox(vOutBox, m_LocalOutbox);
+			return;
+		}
+
+		nfBool bIsAxisAligned = true;
+		for (nfUint32 i = 0; i < 3; i++)
+			for (nfUint32 j = 0; j < 3; j++)
+				if ((i != j) && (mAccumulatedMatrix.m_fields[i][j] != 0.0))
+					bIsAxisAligned = false;
+
+		if (bIsAxisAligned) {
+			// Every transformed coordinate only depends on one local coordinate, so the corners give the exact outbox
+			fnOutboxMergeVector(vOutBox, fnMATRIX3_apply(mAccumulatedMatrix, m_LocalOutbox.m_min));
+			fnOutboxMergeVector(vOutBox, fnMATRIX3_apply(mAccumulatedMatrix, m_LocalOutbox.m_max));
 		}
 		else {
-			for (nfUint32 iNode = 0; iNode < getNodeCount(); iNode++) {
-				fnOutboxMergeVector(vOutBox, fnMATRIX3_apply(mAccumulatedMatrix, getNode(iNode)->m_position));
+			// The extremes of an affine transform are attained at vertices of the convex hull
+			for (auto iIterator = m_OutboxHullCandidates.begin(); iIterator != m_OutboxHullCandidates.end(); iIterator++) {
+				fnOutboxMergeVector(vOutBox, fnMATRIX3_apply(mAccumulatedMatrix, *iIterator));
 			}
 		}
 	}
+
+	NOUTBOX3 CMesh::getLocalOutbox()
+	{
+		if (!m_bOutboxIsValid)
+			updateOutboxCache();
+		return m_LocalOutbox;
+	}
+
+	void CMesh::invalidateGeometryCache()
+	{
+		m_bOutboxIsValid = false;
+		m_OutboxHullCandidates.clear();
+		m_pBVH.reset();
+	}
+
+	_Ret_notnull_ CMeshBVH * CMesh::getBVH()
+	{
+		if (!m_pBVH)
+			m_pBVH = std::make_shared<CMeshBVH>(this);
+		return m_pBVH.get();
+	}
+
+	void CMesh::releaseBVH()
+	{
+		m_pBVH.reset();
+	}
+
+	void CMesh::updateOutboxCache()
+	{
+		nfUint32 nNodeCount = getNodeCount();
+		fnOutboxInitialize(m_LocalOutbox);
+		m_OutboxHullCandidates.clear();
+
+		if (nNodeCount < NMR_MESH_OUTBOXHULLMINNODECOUNT) {
+			m_OutboxHullCandidates.reserve(nNodeCount);
+			for (nfUint32 iNode = 0; iNode < nNodeCount; iNode++) {
+				NVEC3 vPosition = getNode(iNode)->m_position;
+				fnOutboxMergeVector(m_LocalOutbox, vPosition);
+				m_OutboxHullCandidates.push_back(vPosition);
+			}
+			m_bOutboxIsValid = true;
+			return;
+		}
+
+		// Find the extreme nodes along the three axes (0..5) and the eight diagonals (6..13)
+		NVEC3 vDirections[14];
+		NVEC3 vExtremes[14];
+		nfFloat fExtremeValues[14];
+		for (nfUint32 k = 0; k < 3; k++) {
+			vDirections[2 * k] = fnVEC3_make(0.0, 0.0, 0.0);
+			vDirections[2 * k].m_fields[k] = 1.0;
+			vDirections[2 * k + 1] = fnVEC3_scale(vDirections[2 * k], -1.0);
+		}
+		for (nfUint32 nOctant = 0; nOctant < 8; nOctant++) {
+			vDirections[6 + nOctant] = fnVEC3_make((nOctant & 1) ? -1.0 : 1.0, (nOctant & 2) ? -1.0 : 1.0, (nOctant & 4) ? -1.0 : 1.0);
+		}
+		for (nfUint32 k = 0; k < 14; k++)
+			fExtremeValues[k] = -std::numeric_limits<nfFloat>::max();
+
+		for (nfUint32 iNode = 0; iNode < nNodeCount; iNode++) {
+			NVEC3 vPosition = getNode(iNode)->m_position;
+			fnOutboxMergeVector(m_LocalOutbox, vPosition);
+			for (nfUint32 k = 0; k < 14; k++) {
+				nfFloat fValue = fnVEC3_dotproduct(vDirections[k], vPosition);
+				if (fValue > fExtremeValues[k]) {
+					fExtremeValues[k] = fValue;
+					vExtremes[k] = vPosition;
+				}
+			}
+		}
+
+		// Each octant spans three tetrahedra between the centroid, two axis extremes and the diagonal extreme.
+		// All of them lie inside the convex hull, so nodes well inside them can never define an outbox.
+		NVEC3 vCentroid = fnVEC3_make(0.0, 0.0, 0.0);
+		for (nfUint32 k = 0; k < 14; k++)
+			vCentroid = fnVEC3_add(vCentroid, vExtremes[k]);
+		vCentroid = fnVEC3_scale(vCentroid, 1.0 / 14.0);
+
+		nfFloat fScale = 0.0;
+		for (nfUint32 k = 0; k < 3; k++) {
+			fScale = std::max(fScale, fabs(m_LocalOutbox.m_min.m_fields[k]));
+			fScale = std::max(fScale, fabs(m_LocalOutbox.m_max.m_fields[k]));
+		}
+		nfFloat fMargin = NMR_MESH_OUTBOXHULLMARGIN * fScale;
+
+		MESHOUTBOXTETRAHEDRON Tetrahedra[24];
+		for (nfUint32 nOctant = 0; nOctant < 8; nOctant++) {
+			NVEC3 vAxisExtremes[3];
+			vAxisExtremes[0] = vExtremes[(nOctant & 1) ? 1 : 0];
+			vAxisExtremes[1] = vExtremes[(nOctant & 2) ? 3 : 2];
+			vAxisExtremes[2] = vExtremes[(nOctant & 4) ? 5 : 4];
+			for (nfUint32 k = 0; k < 3; k++) {
+				NVEC3 vCorners[4] = { vCentroid, vAxisExtremes[k], vAxisExtremes[(k + 1) % 3], vExtremes[6 + nOctant] };
+				fnMeshInitOutboxTetrahedron(Tetrahedra[nOctant * 3 + k], vCorners);
+			}
+		}
+
+		for (nfUint32 iNode = 0; iNode < nNodeCount; iNode++) {
+			NVEC3 vPosition = getNode(iNode)->m_position;
+			NVEC3 vDelta = fnVEC3_sub(vPosition, vCentroid);
+			nfUint32 nOctant = ((vDelta.m_values.x < 0.0) ? 1 : 0) | ((vDelta.m_values.y < 0.0) ? 2 : 0) | ((vDelta.m_values.z < 0.0) ? 4 : 0);
+
+			nfBool bIsInterior = false;
+			for (nfUint32 k = 0; (k < 3) && !bIsInterior; k++) {
+				bIsInterior = fnMeshIsInsideOutboxTetrahedron(Tetrahedra[nOctant * 3 + k], vPosition, fMargin);
+			}
+
+			if (!bIsInterior)
+				m_OutboxHullCandidates.push_back(vPosition);
+		}
+
+		m_bOutboxIsValid = true;
+	}
 }
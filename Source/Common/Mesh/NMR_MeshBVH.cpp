@@ -0,0 +1,540 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshBVH.cpp implements the class CMeshBVH.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshBVH.h"
+#include "Common/Math/NMR_Vector.h"
+#include "Common/NMR_Exception.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <exception>
+#include <cmath>
+
+namespace NMR {
+
+	static nfFloat fnBVHOutboxArea(_In_ const NOUTBOX3 & Outbox)
+	{
+		NVEC3 vSize = fnVEC3_sub(Outbox.m_max, Outbox.m_min);
+		if ((vSize.m_values.x < 0.0) || (vSize.m_values.y < 0.0) || (vSize.m_values.z < 0.0))
+			return 0.0;
+		return 2.0 * (vSize.m_values.x * vSize.m_values.y + vSize.m_values.y * vSize.m_values.z + vSize.m_values.z * vSize.m_values.x);
+	}
+
+	static nfBool fnBVHOutboxesOverlap(_In_ const NOUTBOX3 & Outbox1, _In_ const NOUTBOX3 & Outbox2)
+	{
+		for (nfUint32 k = 0; k < 3; k++) {
+			if ((Outbox1.m_min.m_fields[k] > Outbox2.m_max.m_fields[k]) || (Outbox1.m_max.m_fields[k] < Outbox2.m_min.m_fields[k]))
+				return false;
+		}
+		return true;
+	}
+
+	// Returns the ray parameter at which the ray enters the outbox, or a negative value if it misses the outbox
+	static nfFloat fnBVHRayEntersOutbox(_In_ const NOUTBOX3 & Outbox, _In_ const NVEC3 & vOrigin, _In_ const NVEC3 & vInverseDirection, _In_ nfFloat fMaxDistance)
+	{
+		nfFloat fNear = 0.0;
+		nfFloat fFar = fMaxDistance;
+		for (nfUint32 k = 0; k < 3; k++) {
+			nfFloat fT1 = (Outbox.m_min.m_fields[k] - vOrigin.m_fields[k]) * vInverseDirection.m_fields[k];
+			nfFloat fT2 = (Outbox.m_max.m_fields[k] - vOrigin.m_fields[k]) * vInverseDirection.m_fields[k];
+			if (fT1 > fT2)
+				std::swap(fT1, fT2);
+			// NaN from an origin on a slab plane of a parallel ray leaves the interval unchanged
+			if (fT1 > fNear)
+				fNear = fT1;
+			if (fT2 < fFar)
+				fFar = fT2;
+			if (fNear > fFar)
+				return -1.0;
+		}
+		return fNear;
+	}
+
+	static nfFloat fnBVHOutboxDistanceSquared(_In_ const NOUTBOX3 & Outbox, _In_ const NVEC3 & vPoint)
+	{
+		nfFloat fDistance = 0.0;
+		for (nfUint32 k = 0; k < 3; k++) {
+			nfFloat fDelta = 0.0;
+			if (vPoint.m_fields[k] < Outbox.m_min.m_fields[k])
+				fDelta = Outbox.m_min.m_fields[k] - vPoint.m_fields[k];
+			else if (vPoint.m_fields[k] > Outbox.m_max.m_fields[k])
+				fDelta = vPoint.m_fields[k] - Outbox.m_max.m_fields[k];
+			fDistance += fDelta * fDelta;
+		}
+		return fDistance;
+	}
+
+	static nfBool fnBVHIntersectTriangle(_In_ const MESHBVHTRIANGLE & Triangle, _In_ const NVEC3 & vOrigin, _In_ const NVEC3 & vDirection, _Out_ nfFloat & fDistance)
+	{
+		NVEC3 vEdge1 = fnVEC3_sub(Triangle.m_vCorners[1], Triangle.m_vCorners[0]);
+		NVEC3 vEdge2 = fnVEC3_sub(Triangle.m_vCorners[2], Triangle.m_vCorners[0]);
+		NVEC3 vP = fnVEC3_crossproduct(vDirection, vEdge2);
+		nfFloat fDeterminant = fnVEC3_dotproduct(vEdge1, vP);
+		if (fDeterminant == 0.0)
+			return false;
+
+		nfFloat fInverseDeterminant = 1.0 / fDeterminant;
+		NVEC3 vS = fnVEC3_sub(vOrigin, Triangle.m_vCorners[0]);
+		nfFloat fU = fnVEC3_dotproduct(vS, vP) * fInverseDeterminant;
+		if ((fU < 0.0) || (fU > 1.0))
+			return false;
+
+		NVEC3 vQ = fnVEC3_crossproduct(vS, vEdge1);
+		nfFloat fV = fnVEC3_dotproduct(vDirection, vQ) * fInverseDeterminant;
+		if ((fV < 0.0) || (fU + fV > 1.0))
+			return false;
+
+		fDistance = fnVEC3_dotproduct(vEdge2, vQ) * fInverseDeterminant;
+		return fDistance >= 0.0;
+	}
+
+	static NVEC3 fnBVHClosestPointOnTriangle(_In_ const MESHBVHTRIANGLE & Triangle, _In_ const NVEC3 & vPoint)
+	{
+		const NVEC3 & vA = Triangle.m_vCorners[0];
+		const NVEC3 & vB = Triangle.m_vCorners[1];
+		const NVEC3 & vC = Triangle.m_vCorners[2];
+		NVEC3 vAB = fnVEC3_sub(vB, vA);
+		NVEC3 vAC = fnVEC3_sub(vC, vA);
+
+		// Classify the point against the Voronoi regions of the corners, edges and face
+		NVEC3 vAP = fnVEC3_sub(vPoint, vA);
+		nfFloat fD1 = fnVEC3_dotproduct(vAB, vAP);
+		nfFloat fD2 = fnVEC3_dotproduct(vAC, vAP);
+		if ((fD1 <= 0.0) && (fD2 <= 0.0))
+			return vA;
+
+		NVEC3 vBP = fnVEC3_sub(vPoint, vB);
+		nfFloat fD3 = fnVEC3_dotproduct(vAB, vBP);
+		nfFloat fD4 = fnVEC3_dotproduct(vAC, vBP);
+		if ((fD3 >= 0.0) && (fD4 <= fD3))
+			return vB;
+
+		nfFloat fVC = fD1 * fD4 - fD3 * fD2;
+		if ((fVC <= 0.0) && (fD1 >= 0.0) && (fD3 <= 0.0))
+			return fnVEC3_add(vA, fnVEC3_scale(vAB, fD1 / (fD1 - fD3)));
+
+		NVEC3 vCP = fnVEC3_sub(vPoint, vC);
+		nfFloat fD5 = fnVEC3_dotproduct(vAB, vCP);
+		nfFloat fD6 = fnVEC3_dotproduct(vAC, vCP);
+		if ((fD6 >= 0.0) && (fD5 <= fD6))
+			return vC;
+
+		nfFloat fVB = fD5 * fD2 - fD1 * fD6;
+		if ((fVB <= 0.0) && (fD2 >= 0.0) && (fD6 <= 0.0))
+			return fnVEC3_add(vA, fnVEC3_scale(vAC, fD2 / (fD2 - fD6)));
+
+		nfFloat fVA = fD3 * fD6 - fD5 * fD4;
+		if ((fVA <= 0.0) && ((fD4 - fD3) >= 0.0) && ((fD5 - fD6) >= 0.0))
+			return fnVEC3_add(vB, fnVEC3_scale(fnVEC3_sub(vC, vB), (fD4 - fD3) / ((fD4 - fD3) + (fD5 - fD6))));
+
+		nfFloat fDenominator = fVA + fVB + fVC;
+		if (fDenominator == 0.0)
+			return vA;
+		return fnVEC3_add(vA, fnVEC3_add(fnVEC3_scale(vAB, fVB / fDenominator), fnVEC3_scale(vAC, fVC / fDenominator)));
+	}
+
+	static nfBool fnBVHIsSeparatingAxis(_In_ const NVEC3 & vAxis, _In_ const NVEC3 * pCorners, _In_ const NVEC3 & vHalfSize)
+	{
+		nfFloat fP0 = fnVEC3_dotproduct(vAxis, pCorners[0]);
+		nfFloat fP1 = fnVEC3_dotproduct(vAxis, pCorners[1]);
+		nfFloat fP2 = fnVEC3_dotproduct(vAxis, pCorners[2]);
+		nfFloat fRadius = vHalfSize.m_values.x * fabs(vAxis.m_values.x) + vHalfSize.m_values.y * fabs(vAxis.m_values.y) + vHalfSize.m_values.z * fabs(vAxis.m_values.z);
+		return (std::min(fP0, std::min(fP1, fP2)) > fRadius) || (std::max(fP0, std::max(fP1, fP2)) < -fRadius);
+	}
+
+	// Separating axis test between a triangle and an outbox given by its center and half size
+	static nfBool fnBVHTriangleOverlapsOutbox(_In_ const MESHBVHTRIANGLE & Triangle, _In_ const NVEC3 & vCenter, _In_ const NVEC3 & vHalfSize)
+	{
+		NVEC3 vCorners[3];
+		for (nfUint32 j = 0; j < 3; j++)
+			vCorners[j] = fnVEC3_sub(Triangle.m_vCorners[j], vCenter);
+
+		for (nfUint32 k = 0; k < 3; k++) {
+			nfFloat fMin = std::min(vCorners[0].m_fields[k], std::min(vCorners[1].m_fields[k], vCorners[2].m_fields[k]));
+			nfFloat fMax = std::max(vCorners[0].m_fields[k], std::max(vCorners[1].m_fields[k], vCorners[2].m_fields[k]));
+			if ((fMin > vHalfSize.m_fields[k]) || (fMax < -vHalfSize.m_fields[k]))
+				return false;
+		}
+
+		NVEC3 vEdges[3];
+		for (nfUint32 j = 0; j < 3; j++)
+			vEdges[j] = fnVEC3_sub(vCorners[(j + 1) % 3], vCorners[j]);
+
+		if (fnBVHIsSeparatingAxis(fnVEC3_crossproduct(vEdges[0], vEdges[1]), vCorners, vHalfSize))
+			return false;
+
+		for (nfUint32 j = 0; j < 3; j++) {
+			for (nfUint32 k = 0; k < 3; k++) {
+				NVEC3 vAxis = fnVEC3_make(0.0, 0.0, 0.0);
+				vAxis.m_fields[k] = 1.0;
+				if (fnBVHIsSeparatingAxis(fnVEC3_crossproduct(vEdges[j], vAxis), vCorners, vHalfSize))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	CMeshBVH::CMeshBVH(_In_ CMesh * pMesh)
+	{
+		if (!pMesh)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nFaceCount = pMesh->getFaceCount();
+		nfUint32 nNodeCount = pMesh->getNodeCount();
+
+		std::vector<MESHBVHBUILDITEM> Items;
+		Items.resize(nFaceCount);
+		for (nfUint32 nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			MESHFACE * pFace = pMesh->getFace(nFaceIndex);
+			MESHBVHBUILDITEM & Item = Items[nFaceIndex];
+			fnOutboxInitialize(Item.m_Outbox);
+			Item.m_vCentroid = fnVEC3_make(0.0, 0.0, 0.0);
+			Item.m_nFaceIndex = nFaceIndex;
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfInt32 nNodeIndex = pFace->m_nodeindices[j];
+				if ((nNodeIndex < 0) || ((nfUint32)nNodeIndex >= nNodeCount))
+					throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+				NVEC3 vPosition = pMesh->getNode(nNodeIndex)->m_position;
+				fnOutboxMergeVector(Item.m_Outbox, vPosition);
+				Item.m_vCentroid = fnVEC3_add(Item.m_vCentroid, vPosition);
+			}
+			Item.m_vCentroid = fnVEC3_scale(Item.m_vCentroid, 1.0 / 3.0);
+		}
+
+		if (nFaceCount == 0)
+			return;
+
+		m_Nodes.reserve(2 * (nFaceCount / NMR_MESHBVH_MAXLEAFSIZE) + 1);
+		buildSubtree(m_Nodes, Items, 0, nFaceCount, 0);
+		m_Nodes.shrink_to_fit();
+
+		m_Triangles.resize(nFaceCount);
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			MESHBVHTRIANGLE & Triangle = m_Triangles[nIndex];
+			MESHFACE * pFace = pMesh->getFace(Items[nIndex].m_nFaceIndex);
+			for (nfUint32 j = 0; j < 3; j++)
+				Triangle.m_vCorners[j] = pMesh->getNode(pFace->m_nodeindices[j])->m_position;
+			Triangle.m_nFaceIndex = Items[nIndex].m_nFaceIndex;
+		}
+	}
+
+	void CMeshBVH::buildSubtree(_Inout_ std::vector<MESHBVHNODE> & Nodes, _Inout_ std::vector<MESHBVHBUILDITEM> & Items, _In_ nfUint32 nBegin, _In_ nfUint32 nEnd, _In_ nfUint32 nDepth)
+	{
+		nfUint32 nNodeIndex = (nfUint32)Nodes.size();
+		Nodes.push_back(MESHBVHNODE());
+
+		NOUTBOX3 Outbox;
+		fnOutboxInitialize(Outbox);
+		for (nfUint32 nIndex = nBegin; nIndex < nEnd; nIndex++)
+			fnOutboxMergeOutbox(Outbox, Items[nIndex].m_Outbox);
+		Nodes[nNodeIndex].m_Outbox = Outbox;
+
+		nfUint32 nSplit;
+		if ((nEnd - nBegin <= NMR_MESHBVH_MAXLEAFSIZE) || !findSplit(Items, nBegin, nEnd, Outbox, nDepth, nSplit)) {
+			Nodes[nNodeIndex].m_nFirst = nBegin;
+			Nodes[nNodeIndex].m_nCount = nEnd - nBegin;
+			return;
+		}
+		Nodes[nNodeIndex].m_nCount = 0;
+
+		if ((nDepth < NMR_MESHBVH_PARALLELMAXDEPTH) && (nEnd - nBegin >= NMR_MESHBVH_PARALLELMINFACECOUNT) && (std::thread::hardware_concurrency() > 1)) {
+			// Both halves work on disjoint ranges of the items; the second half gets its own node list
+			std::vector<MESHBVHNODE> SecondNodes;
+			std::exception_ptr pException;
+			std::thread Thread([&]() {
+				try {
+					buildSubtree(SecondNodes, Items, nSplit, nEnd, nDepth + 1);
+				}
+				catch (...) {
+					pException = std::current_exception();
+				}
+			});
+
+			try {
+				buildSubtree(Nodes, Items, nBegin, nSplit, nDepth + 1);
+			}
+			catch (...) {
+				Thread.join();
+				throw;
+			}
+			Thread.join();
+			if (pException)
+				std::rethrow_exception(pException);
+
+			nfUint32 nOffset = (nfUint32)Nodes.size();
+			Nodes[nNodeIndex].m_nFirst = nOffset;
+			for (auto iIterator = SecondNodes.begin(); iIterator != SecondNodes.end(); iIterator++) {
+				if (iIterator->m_nCount == 0)
+					iIterator->m_nFirst += nOffset;
+				Nodes.push_back(*iIterator);
+			}
+		}
+		else {
+			buildSubtree(Nodes, Items, nBegin, nSplit, nDepth + 1);
+			Nodes[nNodeIndex].m_nFirst = (nfUint32)Nodes.size();
+			buildSubtree(Nodes, Items, nSplit, nEnd, nDepth + 1);
+		}
+	}
+
+	nfBool CMeshBVH::findSplit(_Inout_ std::vector<MESHBVHBUILDITEM> & Items, _In_ nfUint32 nBegin, _In_ nfUint32 nEnd, _In_ const NOUTBOX3 & Outbox, _In_ nfUint32 nDepth, _Out_ nfUint32 & nSplit)
+	{
+		nfUint32 nCount = nEnd - nBegin;
+
+		NOUTBOX3 CentroidOutbox;
+		fnOutboxInitialize(CentroidOutbox);
+		for (nfUint32 nIndex = nBegin; nIndex < nEnd; nIndex++)
+			fnOutboxMergeVector(CentroidOutbox, Items[nIndex].m_vCentroid);
+
+		nfUint32 nAxis = 0;
+		NVEC3 vExtent = fnVEC3_sub(CentroidOutbox.m_max, CentroidOutbox.m_min);
+		for (nfUint32 k = 1; k < 3; k++) {
+			if (vExtent.m_fields[k] > vExtent.m_fields[nAxis])
+				nAxis = k;
+		}
+
+		if ((vExtent.m_fields[nAxis] <= 0.0) || (nDepth >= NMR_MESHBVH_MAXSAHDEPTH)) {
+			// Coincident centroids or a deep hierarchy: split at the median
+			nSplit = nBegin + nCount / 2;
+			std::nth_element(Items.begin() + nBegin, Items.begin() + nSplit, Items.begin() + nEnd,
+				[nAxis](const MESHBVHBUILDITEM & Item1, const MESHBVHBUILDITEM & Item2) { return Item1.m_vCentroid.m_fields[nAxis] < Item2.m_vCentroid.m_fields[nAxis]; });
+			return true;
+		}
+
+		nfFloat fMin = CentroidOutbox.m_min.m_fields[nAxis];
+		nfFloat fScale = NMR_MESHBVH_BINCOUNT / vExtent.m_fields[nAxis];
+		auto fnBinIndex = [nAxis, fMin, fScale](const MESHBVHBUILDITEM & Item) {
+			nfUint32 nBin = (nfUint32)((Item.m_vCentroid.m_fields[nAxis] - fMin) * fScale);
+			return std::min(nBin, (nfUint32)(NMR_MESHBVH_BINCOUNT - 1));
+		};
+
+		nfUint32 BinCounts[NMR_MESHBVH_BINCOUNT];
+		NOUTBOX3 BinOutboxes[NMR_MESHBVH_BINCOUNT];
+		for (nfUint32 nBin = 0; nBin < NMR_MESHBVH_BINCOUNT; nBin++) {
+			BinCounts[nBin] = 0;
+			fnOutboxInitialize(BinOutboxes[nBin]);
+		}
+		for (nfUint32 nIndex = nBegin; nIndex < nEnd; nIndex++) {
+			nfUint32 nBin = fnBinIndex(Items[nIndex]);
+			BinCounts[nBin]++;
+			fnOutboxMergeOutbox(BinOutboxes[nBin], Items[nIndex].m_Outbox);
+		}
+
+		// Sweep from the right to get the cost of all right sides, then from the left to evaluate each split plane
+		nfFloat RightCosts[NMR_MESHBVH_BINCOUNT];
+		NOUTBOX3 SweepOutbox;
+		fnOutboxInitialize(SweepOutbox);
+		nfUint32 nSweepCount = 0;
+		for (nfUint32 nBin = NMR_MESHBVH_BINCOUNT - 1; nBin > 0; nBin--) {
+			fnOutboxMergeOutbox(SweepOutbox, BinOutboxes[nBin]);
+			nSweepCount += BinCounts[nBin];
+			RightCosts[nBin] = fnBVHOutboxArea(SweepOutbox) * nSweepCount;
+		}
+
+		nfFloat fBestCost = std::numeric_limits<nfFloat>::max();
+		nfUint32 nBestBin = 0;
+		nfUint32 nBestCount = 0;
+		fnOutboxInitialize(SweepOutbox);
+		nSweepCount = 0;
+		for (nfUint32 nBin = 0; nBin < NMR_MESHBVH_BINCOUNT - 1; nBin++) {
+			fnOutboxMergeOutbox(SweepOutbox, BinOutboxes[nBin]);
+			nSweepCount += BinCounts[nBin];
+			if ((nSweepCount == 0) || (nSweepCount == nCount))
+				continue;
+
+			nfFloat fCost = fnBVHOutboxArea(SweepOutbox) * nSweepCount + RightCosts[nBin + 1];
+			if (fCost < fBestCost) {
+				fBestCost = fCost;
+				nBestBin = nBin;
+				nBestCount = nSweepCount;
+			}
+		}
+
+		if (nBestCount == 0)
+			return false;
+
+		// Keep small leaves if intersecting all their triangles is cheaper than traversing two children
+		nfFloat fParentArea = fnBVHOutboxArea(Outbox);
+		if ((nCount <= NMR_MESHBVH_MAXSAHLEAFSIZE) && (fParentArea + fBestCost >= fParentArea * nCount))
+			return false;
+
+		std::partition(Items.begin() + nBegin, Items.begin() + nEnd,
+			[&fnBinIndex, nBestBin](const MESHBVHBUILDITEM & Item) { return fnBinIndex(Item) <= nBestBin; });
+		nSplit = nBegin + nBestCount;
+		return true;
+	}
+
+	nfUint32 CMeshBVH::getNodeCount()
+	{
+		return (nfUint32)m_Nodes.size();
+	}
+
+	nfUint32 CMeshBVH::getTriangleCount()
+	{
+		return (nfUint32)m_Triangles.size();
+	}
+
+	nfBool CMeshBVH::intersectRay(_In_ const NVEC3 vOrigin, _In_ const NVEC3 vDirection, _Out_ MESHBVHHIT & Hit)
+	{
+		if (m_Nodes.empty())
+			return false;
+
+		NVEC3 vInverseDirection;
+		for (nfUint32 k = 0; k < 3; k++)
+			vInverseDirection.m_fields[k] = 1.0 / vDirection.m_fields[k];
+
+		nfFloat fBestDistance = std::numeric_limits<nfFloat>::max();
+		nfBool bHasHit = false;
+
+		nfUint32 Stack[NMR_MESHBVH_MAXSTACKSIZE];
+		nfUint32 nStackSize = 0;
+		if (fnBVHRayEntersOutbox(m_Nodes[0].m_Outbox, vOrigin, vInverseDirection, fBestDistance) >= 0.0)
+			Stack[nStackSize++] = 0;
+
+		while (nStackSize > 0) {
+			const MESHBVHNODE & Node = m_Nodes[Stack[--nStackSize]];
+			if (Node.m_nCount > 0) {
+				for (nfUint32 nIndex = Node.m_nFirst; nIndex < Node.m_nFirst + Node.m_nCount; nIndex++) {
+					nfFloat fDistance;
+					if (fnBVHIntersectTriangle(m_Triangles[nIndex], vOrigin, vDirection, fDistance) && (fDistance < fBestDistance)) {
+						fBestDistance = fDistance;
+						Hit.m_nFaceIndex = m_Triangles[nIndex].m_nFaceIndex;
+						bHasHit = true;
+					}
+				}
+				continue;
+			}
+
+			nfUint32 nChild1 = (nfUint32)(&Node - m_Nodes.data()) + 1;
+			nfUint32 nChild2 = Node.m_nFirst;
+			nfFloat fDistance1 = fnBVHRayEntersOutbox(m_Nodes[nChild1].m_Outbox, vOrigin, vInverseDirection, fBestDistance);
+			nfFloat fDistance2 = fnBVHRayEntersOutbox(m_Nodes[nChild2].m_Outbox, vOrigin, vInverseDirection, fBestDistance);
+			// Push the farther child first, so that the nearer one is visited next
+			if (fDistance1 > fDistance2) {
+				std::swap(fDistance1, fDistance2);
+				std::swap(nChild1, nChild2);
+			}
+			if (fDistance2 >= 0.0)
+				Stack[nStackSize++] = nChild2;
+			if (fDistance1 >= 0.0)
+				Stack[nStackSize++] = nChild1;
+		}
+
+		if (bHasHit) {
+			Hit.m_fDistance = fBestDistance;
+			Hit.m_vPosition = fnVEC3_add(vOrigin, fnVEC3_scale(vDirection, fBestDistance));
+		}
+		return bHasHit;
+	}
+
+	nfBool CMeshBVH::findClosestPoint(_In_ const NVEC3 vPoint, _Out_ MESHBVHHIT & Hit)
+	{
+		if (m_Nodes.empty())
+			return false;
+
+		nfFloat fBestDistanceSquared = std::numeric_limits<nfFloat>::max();
+
+		nfUint32 Stack[NMR_MESHBVH_MAXSTACKSIZE];
+		nfUint32 nStackSize = 0;
+		Stack[nStackSize++] = 0;
+
+		while (nStackSize > 0) {
+			const MESHBVHNODE & Node = m_Nodes[Stack[--nStackSize]];
+			if (fnBVHOutboxDistanceSquared(Node.m_Outbox, vPoint) >= fBestDistanceSquared)
+				continue;
+
+			if (Node.m_nCount > 0) {
+				for (nfUint32 nIndex = Node.m_nFirst; nIndex < Node.m_nFirst + Node.m_nCount; nIndex++) {
+					NVEC3 vClosest = fnBVHClosestPointOnTriangle(m_Triangles[nIndex], vPoint);
+					NVEC3 vDelta = fnVEC3_sub(vClosest, vPoint);
+					nfFloat fDistanceSquared = fnVEC3_dotproduct(vDelta, vDelta);
+					if (fDistanceSquared < fBestDistanceSquared) {
+						fBestDistanceSquared = fDistanceSquared;
+						Hit.m_nFaceIndex = m_Triangles[nIndex].m_nFaceIndex;
+						Hit.m_vPosition = vClosest;
+					}
+				}
+				continue;
+			}
+
+			nfUint32 nChild1 = (nfUint32)(&Node - m_Nodes.data()) + 1;
+			nfUint32 nChild2 = Node.m_nFirst;
+			if (fnBVHOutboxDistanceSquared(m_Nodes[nChild1].m_Outbox, vPoint) > fnBVHOutboxDistanceSquared(m_Nodes[nChild2].m_Outbox, vPoint))
+				std::swap(nChild1, nChild2);
+			Stack[nStackSize++] = nChild2;
+			Stack[nStackSize++] = nChild1;
+		}
+
+		Hit.m_fDistance = sqrt(fBestDistanceSquared);
+		return true;
+	}
+
+	void CMeshBVH::findOverlappingFaces(_In_ const NOUTBOX3 & Outbox, _Out_ std::vector<nfUint32> & FaceIndices)
+	{
+		FaceIndices.clear();
+		if (m_Nodes.empty())
+			return;
+		for (nfUint32 k = 0; k < 3; k++) {
+			if (Outbox.m_min.m_fields[k] > Outbox.m_max.m_fields[k])
+				return;
+		}
+
+		NVEC3 vCenter = fnVEC3_scale(fnVEC3_add(Outbox.m_min, Outbox.m_max), 0.5);
+		NVEC3 vHalfSize = fnVEC3_scale(fnVEC3_sub(Outbox.m_max, Outbox.m_min), 0.5);
+
+		nfUint32 Stack[NMR_MESHBVH_MAXSTACKSIZE];
+		nfUint32 nStackSize = 0;
+		Stack[nStackSize++] = 0;
+
+		while (nStackSize > 0) {
+			nfUint32 nNodeIndex = Stack[--nStackSize];
+			const MESHBVHNODE & Node = m_Nodes[nNodeIndex];
+			if (!fnBVHOutboxesOverlap(Node.m_Outbox, Outbox))
+				continue;
+
+			if (Node.m_nCount > 0) {
+				for (nfUint32 nIndex = Node.m_nFirst; nIndex < Node.m_nFirst + Node.m_nCount; nIndex++) {
+					if (fnBVHTriangleOverlapsOutbox(m_Triangles[nIndex], vCenter, vHalfSize))
+						FaceIndices.push_back(m_Triangles[nIndex].m_nFaceIndex);
+				}
+				continue;
+			}
+
+			Stack[nStackSize++] = Node.m_nFirst;
+			Stack[nStackSize++] = nNodeIndex + 1;
+		}
+
+		std::sort(FaceIndices.begin(), FaceIndices.end());
+	}
+
+}
@@ -0,0 +1,509 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshValidator.cpp implements the class CMeshValidator.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshValidator.h"
+#include "Common/NMR_Exception.h"
+
+#include <algorithm>
+#include <thread>
+#include <exception>
+#include <cmath>
+
+namespace NMR {
+
+	// An edge of a face. The node indices are ordered, the lowest bit of m_nFaceAndDirection is set if the face runs from the second to the first node.
+	// The shifted face index fits into 32 bits, as the face count is limited to NMR_MESH_MAXFACECOUNT.
+	typedef struct {
+		nfUint32 m_nNodeIndex1;
+		nfUint32 m_nNodeIndex2;
+		nfUint32 m_nFaceAndDirection;
+	} MESHVALIDATIONEDGE;
+
+	// The ordered node indices of a face
+	typedef struct {
+		nfUint32 m_nNodeIndex1;
+		nfUint32 m_nNodeIndex2;
+		nfUint32 m_nNodeIndex3;
+		nfUint32 m_nFaceIndex;
+	} MESHVALIDATIONFACEKEY;
+
+	static nfUint32 fnValidatorThreadCount(_In_ nfUint64 nItemCount)
+	{
+		nfUint64 nThreadCount = std::thread::hardware_concurrency();
+		if (nThreadCount > NMR_MESHVALIDATOR_MAXTHREADCOUNT)
+			nThreadCount = NMR_MESHVALIDATOR_MAXTHREADCOUNT;
+		if (nThreadCount > nItemCount / NMR_MESHVALIDATOR_PARALLELMINCOUNT)
+			nThreadCount = nItemCount / NMR_MESHVALIDATOR_PARALLELMINCOUNT;
+		if (nThreadCount < 1)
+			nThreadCount = 1;
+		return (nfUint32)nThreadCount;
+	}
+
+	static nfUint32 fnValidatorRangeBegin(_In_ nfUint32 nCount, _In_ nfUint32 nThreadCount, _In_ nfUint32 nThread)
+	{
+		return (nfUint32)(((nfUint64)nCount * nThread) / nThreadCount);
+	}
+
+	// Calls fnWork(nThread) for every thread index, using one thread per index. The first exception is rethrown.
+	template <typename F> static void fnValidatorRunParallel(_In_ nfUint32 nThreadCount, _In_ F fnWork)
+	{
+		if (nThreadCount <= 1) {
+			fnWork(0);
+			return;
+		}
+
+		std::vector<std::exception_ptr> Exceptions(nThreadCount);
+		std::vector<std::thread> Threads;
+		Threads.reserve(nThreadCount);
+		try {
+			for (nfUint32 nThread = 1; nThread < nThreadCount; nThread++) {
+				Threads.push_back(std::thread([&Exceptions, &fnWork, nThread]() {
+					try {
+						fnWork(nThread);
+					}
+					catch (...) {
+						Exceptions[nThread] = std::current_exception();
+					}
+				}));
+			}
+			fnWork(0);
+		}
+		catch (...) {
+			Exceptions[0] = std::current_exception();
+		}
+
+		for (auto iIterator = Threads.begin(); iIterator != Threads.end(); iIterator++)
+			iIterator->join();
+		for (auto iIterator = Exceptions.begin(); iIterator != Exceptions.end(); iIterator++) {
+			if (*iIterator)
+				std::rethrow_exception(*iIterator);
+		}
+	}
+
+	// Records an issue. Only the smallest indices are kept, the samples are compacted whenever twice the sample count is reached.
+	static void fnValidatorAddIssue(_Inout_ MESHVALIDATIONRESULT & Result, _In_ nfUint32 nIndex, _In_ nfUint32 nMaxSampleCount)
+	{
+		if (nMaxSampleCount == 0)
+			return;
+
+		Result.m_Samples.push_back(nIndex);
+		if (Result.m_Samples.size() >= 2 * (size_t)nMaxSampleCount) {
+			std::sort(Result.m_Samples.begin(), Result.m_Samples.end());
+			Result.m_Samples.erase(std::unique(Result.m_Samples.begin(), Result.m_Samples.end()), Result.m_Samples.end());
+			if (Result.m_Samples.size() > nMaxSampleCount)
+				Result.m_Samples.resize(nMaxSampleCount);
+		}
+	}
+
+	// Merges the results of several ranges, which are stored consecutively with NMR_MESHVALIDATOR_ISSUECOUNT entries per range
+	static void fnValidatorMergeResults(_In_ std::vector<MESHVALIDATIONRESULT> & Partials, _Inout_ MESHVALIDATIONRESULT * pResults, _In_ nfUint32 nMaxSampleCount)
+	{
+		for (size_t nIndex = 0; nIndex < Partials.size(); nIndex++) {
+			MESHVALIDATIONRESULT & Partial = Partials[nIndex];
+			if (Partial.m_nCount == 0)
+				continue;
+
+			MESHVALIDATIONRESULT & Result = pResults[nIndex % NMR_MESHVALIDATOR_ISSUECOUNT];
+			Result.m_nCount += Partial.m_nCount;
+			Result.m_Samples.insert(Result.m_Samples.end(), Partial.m_Samples.begin(), Partial.m_Samples.end());
+		}
+
+		for (nfUint32 nIssue = 0; nIssue < NMR_MESHVALIDATOR_ISSUECOUNT; nIssue++) {
+			std::vector<nfUint32> & Samples = pResults[nIssue].m_Samples;
+			std::sort(Samples.begin(), Samples.end());
+			Samples.erase(std::unique(Samples.begin(), Samples.end()), Samples.end());
+			if (Samples.size() > nMaxSampleCount)
+				Samples.resize(nMaxSampleCount);
+		}
+	}
+
+	// Returns true, if all node indices of the face are valid and distinct
+	static nfBool fnValidatorFaceIsProper(_In_ const MESHFACE * pFace, _In_ nfUint32 nNodeCount)
+	{
+		for (nfUint32 j = 0; j < 3; j++) {
+			if ((pFace->m_nodeindices[j] < 0) || ((nfUint32)pFace->m_nodeindices[j] >= nNodeCount))
+				return false;
+		}
+		return (pFace->m_nodeindices[0] != pFace->m_nodeindices[1]) && (pFace->m_nodeindices[0] != pFace->m_nodeindices[2]) && (pFace->m_nodeindices[1] != pFace->m_nodeindices[2]);
+	}
+
+	/*
+	Distributes the records emitted by all faces to buckets of their first node index, sorts every bucket
+	by first node index with a counting sort, sorts the records of each node with fnLess and passes them to
+	fnProcessNode. fnEmit writes up to three records of a face and returns their number. Records of a bucket
+	are processed in a deterministic order, so the results do not depend on the thread count.
+	*/
+	template <typename T, typename FEmit, typename FLess, typename FProcessNode>
+	static void fnValidatorGroupByNode(_In_ CMesh * pMesh, _In_ nfUint32 nNodeCount, _In_ nfUint32 nFaceCount, _In_ nfUint32 nMaxSampleCount,
+		_In_ FEmit fnEmit, _In_ FLess fnLess, _In_ FProcessNode fnProcessNode, _Inout_ MESHVALIDATIONRESULT * pResults)
+	{
+		const nfUint32 nBucketCount = NMR_MESHVALIDATOR_BUCKETCOUNT;
+		nfUint32 nBucketWidth = (nfUint32)(((nfUint64)nNodeCount + nBucketCount - 1) / nBucketCount);
+		if (nBucketWidth == 0)
+			nBucketWidth = 1;
+
+		nfUint32 nThreadCount = fnValidatorThreadCount(nFaceCount);
+		std::vector<nfUint64> Offsets((size_t)nThreadCount * nBucketCount, 0);
+
+		fnValidatorRunParallel(nThreadCount, [&](nfUint32 nThread) {
+			nfUint64 * pCounts = &Offsets[(size_t)nThread * nBucketCount];
+			nfUint32 nEnd = fnValidatorRangeBegin(nFaceCount, nThreadCount, nThread + 1);
+			T Records[3];
+			for (nfUint32 nFaceIndex = fnValidatorRangeBegin(nFaceCount, nThreadCount, nThread); nFaceIndex < nEnd; nFaceIndex++) {
+				nfUint32 nRecordCount = fnEmit(pMesh->getFace(nFaceIndex), nFaceIndex, Records);
+				for (nfUint32 nRecord = 0; nRecord < nRecordCount; nRecord++)
+					pCounts[Records[nRecord].m_nNodeIndex1 / nBucketWidth]++;
+			}
+		});
+
+		// Bucket b starts with the records of thread 0, followed by those of the other threads
+		std::vector<nfUint64> BucketStarts(nBucketCount + 1);
+		nfUint64 nTotal = 0;
+		for (nfUint32 nBucket = 0; nBucket < nBucketCount; nBucket++) {
+			BucketStarts[nBucket] = nTotal;
+			for (nfUint32 nThread = 0; nThread < nThreadCount; nThread++) {
+				nfUint64 & nOffset = Offsets[(size_t)nThread * nBucketCount + nBucket];
+				nfUint64 nCount = nOffset;
+				nOffset = nTotal;
+				nTotal += nCount;
+			}
+		}
+		BucketStarts[nBucketCount] = nTotal;
+
+		std::vector<T> Records((size_t)nTotal);
+		fnValidatorRunParallel(nThreadCount, [&](nfUint32 nThread) {
+			nfUint64 * pOffsets = &Offsets[(size_t)nThread * nBucketCount];
+			nfUint32 nEnd = fnValidatorRangeBegin(nFaceCount, nThreadCount, nThread + 1);
+			T FaceRecords[3];
+			for (nfUint32 nFaceIndex = fnValidatorRangeBegin(nFaceCount, nThreadCount, nThread); nFaceIndex < nEnd; nFaceIndex++) {
+				nfUint32 nRecordCount = fnEmit(pMesh->getFace(nFaceIndex), nFaceIndex, FaceRecords);
+				for (nfUint32 nRecord = 0; nRecord < nRecordCount; nRecord++)
+					Records[(size_t)(pOffsets[FaceRecords[nRecord].m_nNodeIndex1 / nBucketWidth]++)] = FaceRecords[nRecord];
+			}
+		});
+
+		// Every thread processes a fixed set of buckets and collects its own results per bucket
+		std::vector<MESHVALIDATIONRESULT> Partials((size_t)nBucketCount * NMR_MESHVALIDATOR_ISSUECOUNT, MESHVALIDATIONRESULT{ 0, std::vector<nfUint32>() });
+		nfUint32 nBucketThreadCount = fnValidatorThreadCount(nTotal);
+		fnValidatorRunParallel(nBucketThreadCount, [&](nfUint32 nThread) {
+			std::vector<nfUint64> NodeStarts;
+			std::vector<T> SortedRecords;
+			for (nfUint32 nBucket = nThread; nBucket < nBucketCount; nBucket += nBucketThreadCount) {
+				nfUint64 nBucketStart = BucketStarts[nBucket];
+				nfUint64 nBucketEnd = BucketStarts[nBucket + 1];
+				if (nBucketStart == nBucketEnd)
+					continue;
+
+				nfUint32 nFirstNode = nBucket * nBucketWidth;
+				NodeStarts.assign((size_t)nBucketWidth + 1, 0);
+				for (nfUint64 nRecord = nBucketStart; nRecord < nBucketEnd; nRecord++)
+					NodeStarts[Records[(size_t)nRecord].m_nNodeIndex1 - nFirstNode + 1]++;
+				for (nfUint32 nNode = 0; nNode < nBucketWidth; nNode++)
+					NodeStarts[nNode + 1] += NodeStarts[nNode];
+
+				SortedRecords.resize((size_t)(nBucketEnd - nBucketStart));
+				for (nfUint64 nRecord = nBucketStart; nRecord < nBucketEnd; nRecord++) {
+					const T & Record = Records[(size_t)nRecord];
+					SortedRecords[(size_t)(NodeStarts[Record.m_nNodeIndex1 - nFirstNode]++)] = Record;
+				}
+
+				MESHVALIDATIONRESULT * pBucketResults = &Partials[(size_t)nBucket * NMR_MESHVALIDATOR_ISSUECOUNT];
+				T * pBegin = SortedRecords.data();
+				T * pEnd = pBegin + SortedRecords.size();
+				while (pBegin != pEnd) {
+					T * pNodeEnd = pBegin + 1;
+					while ((pNodeEnd != pEnd) && (pNodeEnd->m_nNodeIndex1 == pBegin->m_nNodeIndex1))
+						pNodeEnd++;
+					std::sort(pBegin, pNodeEnd, fnLess);
+					fnProcessNode(pBegin, pNodeEnd, pBucketResults);
+					pBegin = pNodeEnd;
+				}
+			}
+		});
+
+		fnValidatorMergeResults(Partials, pResults, nMaxSampleCount);
+	}
+
+	CMeshValidator::CMeshValidator(_In_ CMesh * pMesh, _In_ nfUint32 nMaxSampleCount, _In_ nfBool bCheckGeometry)
+	{
+		if (pMesh == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_nNodeCount = pMesh->getNodeCount();
+		m_nFaceCount = pMesh->getFaceCount();
+		// Edges store the face index shifted by one bit, see MESHVALIDATIONEDGE
+		if (m_nFaceCount > NMR_MESH_MAXFACECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYFACES);
+		m_nMaxSampleCount = nMaxSampleCount;
+		for (nfUint32 nIssue = 0; nIssue < NMR_MESHVALIDATOR_ISSUECOUNT; nIssue++)
+			m_Results[nIssue].m_nCount = 0;
+
+		if (bCheckGeometry)
+			validateNodes(pMesh);
+		validateFaces(pMesh, bCheckGeometry);
+		validateEdges(pMesh);
+		if (bCheckGeometry)
+			validateDuplicateFaces(pMesh);
+	}
+
+	void CMeshValidator::validateNodes(_In_ CMesh * pMesh)
+	{
+		nfUint32 nThreadCount = fnValidatorThreadCount(m_nNodeCount);
+		std::vector<MESHVALIDATIONRESULT> Partials((size_t)nThreadCount * NMR_MESHVALIDATOR_ISSUECOUNT, MESHVALIDATIONRESULT{ 0, std::vector<nfUint32>() });
+
+		fnValidatorRunParallel(nThreadCount, [&](nfUint32 nThread) {
+			MESHVALIDATIONRESULT & Result = Partials[(size_t)nThread * NMR_MESHVALIDATOR_ISSUECOUNT + MESHVALIDATIONISSUE_COORDINATEOUTOFRANGE];
+			nfUint32 nEnd = fnValidatorRangeBegin(m_nNodeCount, nThreadCount, nThread + 1);
+			for (nfUint32 nNodeIndex = fnValidatorRangeBegin(m_nNodeCount, nThreadCount, nThread); nNodeIndex < nEnd; nNodeIndex++) {
+				MESHNODE * pNode = pMesh->getNode(nNodeIndex);
+				for (nfUint32 j = 0; j < 3; j++) {
+					// The negated comparison also catches NaN coordinates
+					if (!(fabs(pNode->m_position.m_fields[j]) <= NMR_MESH_MAXCOORDINATE)) {
+						Result.m_nCount++;
+						fnValidatorAddIssue(Result, nNodeIndex, m_nMaxSampleCount);
+						break;
+					}
+				}
+			}
+		});
+
+		fnValidatorMergeResults(Partials, m_Results, m_nMaxSampleCount);
+	}
+
+	void CMeshValidator::validateFaces(_In_ CMesh * pMesh, _In_ nfBool bCheckGeometry)
+	{
+		nfUint32 nThreadCount = fnValidatorThreadCount(m_nFaceCount);
+		std::vector<MESHVALIDATIONRESULT> Partials((size_t)nThreadCount * NMR_MESHVALIDATOR_ISSUECOUNT, MESHVALIDATIONRESULT{ 0, std::vector<nfUint32>() });
+
+		fnValidatorRunParallel(nThreadCount, [&](nfUint32 nThread) {
+			MESHVALIDATIONRESULT * pResults = &Partials[(size_t)nThread * NMR_MESHVALIDATOR_ISSUECOUNT];
+			nfUint32 nEnd = fnValidatorRangeBegin(m_nFaceCount, nThreadCount, nThread + 1);
+			for (nfUint32 nFaceIndex = fnValidatorRangeBegin(m_nFaceCount, nThreadCount, nThread); nFaceIndex < nEnd; nFaceIndex++) {
+				MESHFACE * pFace = pMesh->getFace(nFaceIndex);
+
+				eMeshValidationIssue eIssue;
+				nfBool bHasIssue = true;
+				if ((pFace->m_nodeindices[0] < 0) || ((nfUint32)pFace->m_nodeindices[0] >= m_nNodeCount) ||
+					(pFace->m_nodeindices[1] < 0) || ((nfUint32)pFace->m_nodeindices[1] >= m_nNodeCount) ||
+					(pFace->m_nodeindices[2] < 0) || ((nfUint32)pFace->m_nodeindices[2] >= m_nNodeCount)) {
+					eIssue = MESHVALIDATIONISSUE_NODEINDEXOUTOFRANGE;
+				}
+				else if ((pFace->m_nodeindices[0] == pFace->m_nodeindices[1]) || (pFace->m_nodeindices[0] == pFace->m_nodeindices[2]) ||
+					(pFace->m_nodeindices[1] == pFace->m_nodeindices[2])) {
+					eIssue = MESHVALIDATIONISSUE_REPEATEDNODEINDEX;
+				}
+				else if (bCheckGeometry) {
+					// A face has zero area, if the sine of the angle between its edge vectors is below the epsilon,
+					// i.e. |e1 x e2|^2 <= epsilon^2 * |e1|^2 * |e2|^2. Faces with zero length edges are included.
+					const NVEC3 & vPosition1 = pMesh->getNode(pFace->m_nodeindices[0])->m_position;
+					const NVEC3 & vPosition2 = pMesh->getNode(pFace->m_nodeindices[1])->m_position;
+					const NVEC3 & vPosition3 = pMesh->getNode(pFace->m_nodeindices[2])->m_position;
+					nfDouble dEdge1[3], dEdge2[3];
+					for (nfUint32 j = 0; j < 3; j++) {
+						dEdge1[j] = (nfDouble)vPosition2.m_fields[j] - (nfDouble)vPosition1.m_fields[j];
+						dEdge2[j] = (nfDouble)vPosition3.m_fields[j] - (nfDouble)vPosition1.m_fields[j];
+					}
+					nfDouble dCross[3];
+					dCross[0] = dEdge1[1] * dEdge2[2] - dEdge1[2] * dEdge2[1];
+					dCross[1] = dEdge1[2] * dEdge2[0] - dEdge1[0] * dEdge2[2];
+					dCross[2] = dEdge1[0] * dEdge2[1] - dEdge1[1] * dEdge2[0];
+					nfDouble dCrossLengthSq = dCross[0] * dCross[0] + dCross[1] * dCross[1] + dCross[2] * dCross[2];
+					nfDouble dEdge1LengthSq = dEdge1[0] * dEdge1[0] + dEdge1[1] * dEdge1[1] + dEdge1[2] * dEdge1[2];
+					nfDouble dEdge2LengthSq = dEdge2[0] * dEdge2[0] + dEdge2[1] * dEdge2[1] + dEdge2[2] * dEdge2[2];
+					eIssue = MESHVALIDATIONISSUE_ZEROAREAFACE;
+					bHasIssue = dCrossLengthSq <= NMR_MESHVALIDATOR_ZEROAREAEPSILON * NMR_MESHVALIDATOR_ZEROAREAEPSILON * dEdge1LengthSq * dEdge2LengthSq;
+				}
+				else {
+					bHasIssue = false;
+				}
+
+				if (bHasIssue) {
+					pResults[eIssue].m_nCount++;
+					fnValidatorAddIssue(pResults[eIssue], nFaceIndex, m_nMaxSampleCount);
+				}
+			}
+		});
+
+		fnValidatorMergeResults(Partials, m_Results, m_nMaxSampleCount);
+	}
+
+	void CMeshValidator::validateEdges(_In_ CMesh * pMesh)
+	{
+		nfUint32 nNodeCount = m_nNodeCount;
+		nfUint32 nMaxSampleCount = m_nMaxSampleCount;
+
+		auto fnEmit = [nNodeCount](const MESHFACE * pFace, nfUint32 nFaceIndex, MESHVALIDATIONEDGE * pEdges) -> nfUint32 {
+			if (!fnValidatorFaceIsProper(pFace, nNodeCount))
+				return 0;
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfUint32 nNodeIndex1 = (nfUint32)pFace->m_nodeindices[j];
+				nfUint32 nNodeIndex2 = (nfUint32)pFace->m_nodeindices[(j + 1) % 3];
+				if (nNodeIndex1 < nNodeIndex2) {
+					pEdges[j].m_nNodeIndex1 = nNodeIndex1;
+					pEdges[j].m_nNodeIndex2 = nNodeIndex2;
+					pEdges[j].m_nFaceAndDirection = nFaceIndex << 1;
+				}
+				else {
+					pEdges[j].m_nNodeIndex1 = nNodeIndex2;
+					pEdges[j].m_nNodeIndex2 = nNodeIndex1;
+					pEdges[j].m_nFaceAndDirection = (nFaceIndex << 1) | 1;
+				}
+			}
+			return 3;
+		};
+
+		auto fnLess = [](const MESHVALIDATIONEDGE & Edge1, const MESHVALIDATIONEDGE & Edge2) -> bool {
+			if (Edge1.m_nNodeIndex2 != Edge2.m_nNodeIndex2)
+				return Edge1.m_nNodeIndex2 < Edge2.m_nNodeIndex2;
+			return Edge1.m_nFaceAndDirection < Edge2.m_nFaceAndDirection;
+		};
+
+		// Every edge has to be used by exactly two faces in opposite directions
+		auto fnProcessNode = [nMaxSampleCount](const MESHVALIDATIONEDGE * pBegin, const MESHVALIDATIONEDGE * pEnd, MESHVALIDATIONRESULT * pResults) {
+			while (pBegin != pEnd) {
+				const MESHVALIDATIONEDGE * pEdgeEnd = pBegin + 1;
+				while ((pEdgeEnd != pEnd) && (pEdgeEnd->m_nNodeIndex2 == pBegin->m_nNodeIndex2))
+					pEdgeEnd++;
+
+				nfBool bHasIssue = true;
+				eMeshValidationIssue eIssue;
+				if (pEdgeEnd - pBegin == 1)
+					eIssue = MESHVALIDATIONISSUE_BOUNDARYEDGE;
+				else if (pEdgeEnd - pBegin > 2)
+					eIssue = MESHVALIDATIONISSUE_NONMANIFOLDEDGE;
+				else {
+					eIssue = MESHVALIDATIONISSUE_INCONSISTENTORIENTATION;
+					bHasIssue = ((pBegin[0].m_nFaceAndDirection & 1) == (pBegin[1].m_nFaceAndDirection & 1));
+				}
+
+				if (bHasIssue) {
+					pResults[eIssue].m_nCount++;
+					for (const MESHVALIDATIONEDGE * pEdge = pBegin; pEdge != pEdgeEnd; pEdge++)
+						fnValidatorAddIssue(pResults[eIssue], pEdge->m_nFaceAndDirection >> 1, nMaxSampleCount);
+				}
+				pBegin = pEdgeEnd;
+			}
+		};
+
+		fnValidatorGroupByNode<MESHVALIDATIONEDGE>(pMesh, m_nNodeCount, m_nFaceCount, m_nMaxSampleCount, fnEmit, fnLess, fnProcessNode, m_Results);
+	}
+
+	void CMeshValidator::validateDuplicateFaces(_In_ CMesh * pMesh)
+	{
+		nfUint32 nNodeCount = m_nNodeCount;
+		nfUint32 nMaxSampleCount = m_nMaxSampleCount;
+
+		auto fnEmit = [nNodeCount](const MESHFACE * pFace, nfUint32 nFaceIndex, MESHVALIDATIONFACEKEY * pKeys) -> nfUint32 {
+			if (!fnValidatorFaceIsProper(pFace, nNodeCount))
+				return 0;
+			nfUint32 nNodeIndices[3] = { (nfUint32)pFace->m_nodeindices[0], (nfUint32)pFace->m_nodeindices[1], (nfUint32)pFace->m_nodeindices[2] };
+			std::sort(&nNodeIndices[0], &nNodeIndices[3]);
+			pKeys[0].m_nNodeIndex1 = nNodeIndices[0];
+			pKeys[0].m_nNodeIndex2 = nNodeIndices[1];
+			pKeys[0].m_nNodeIndex3 = nNodeIndices[2];
+			pKeys[0].m_nFaceIndex = nFaceIndex;
+			return 1;
+		};
+
+		auto fnLess = [](const MESHVALIDATIONFACEKEY & Key1, const MESHVALIDATIONFACEKEY & Key2) -> bool {
+			if (Key1.m_nNodeIndex2 != Key2.m_nNodeIndex2)
+				return Key1.m_nNodeIndex2 < Key2.m_nNodeIndex2;
+			if (Key1.m_nNodeIndex3 != Key2.m_nNodeIndex3)
+				return Key1.m_nNodeIndex3 < Key2.m_nNodeIndex3;
+			return Key1.m_nFaceIndex < Key2.m_nFaceIndex;
+		};
+
+		// All but the first face with the same set of nodes are duplicates, regardless of their orientation
+		auto fnProcessNode = [nMaxSampleCount](const MESHVALIDATIONFACEKEY * pBegin, const MESHVALIDATIONFACEKEY * pEnd, MESHVALIDATIONRESULT * pResults) {
+			MESHVALIDATIONRESULT & Result = pResults[MESHVALIDATIONISSUE_DUPLICATEFACE];
+			for (const MESHVALIDATIONFACEKEY * pKey = pBegin + 1; pKey != pEnd; pKey++) {
+				if ((pKey->m_nNodeIndex2 == pKey[-1].m_nNodeIndex2) && (pKey->m_nNodeIndex3 == pKey[-1].m_nNodeIndex3)) {
+					Result.m_nCount++;
+					fnValidatorAddIssue(Result, pKey->m_nFaceIndex, nMaxSampleCount);
+				}
+			}
+		};
+
+		fnValidatorGroupByNode<MESHVALIDATIONFACEKEY>(pMesh, m_nNodeCount, m_nFaceCount, m_nMaxSampleCount, fnEmit, fnLess, fnProcessNode, m_Results);
+	}
+
+	nfUint32 CMeshValidator::getNodeCount()
+	{
+		return m_nNodeCount;
+	}
+
+	nfUint32 CMeshValidator::getFaceCount()
+	{
+		return m_nFaceCount;
+	}
+
+	nfUint32 CMeshValidator::getMaxSampleCount()
+	{
+		return m_nMaxSampleCount;
+	}
+
+	nfUint64 CMeshValidator::getIssueCount(_In_ eMeshValidationIssue eIssue)
+	{
+		if ((nfUint32)eIssue >= NMR_MESHVALIDATOR_ISSUECOUNT)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		return m_Results[eIssue].m_nCount;
+	}
+
+	const std::vector<nfUint32> & CMeshValidator::getIssueSamples(_In_ eMeshValidationIssue eIssue)
+	{
+		if ((nfUint32)eIssue >= NMR_MESHVALIDATOR_ISSUECOUNT)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		return m_Results[eIssue].m_Samples;
+	}
+
+	nfBool CMeshValidator::isValid()
+	{
+		for (nfUint32 nIssue = 0; nIssue < NMR_MESHVALIDATOR_ISSUECOUNT; nIssue++) {
+			if (m_Results[nIssue].m_nCount > 0)
+				return false;
+		}
+		return true;
+	}
+
+	nfBool CMeshValidator::isManifoldAndOriented()
+	{
+		if ((m_nNodeCount < 3) || (m_nFaceCount < 3))
+			return false;
+
+		return (m_Results[MESHVALIDATIONISSUE_NODEINDEXOUTOFRANGE].m_nCount == 0) &&
+			(m_Results[MESHVALIDATIONISSUE_REPEATEDNODEINDEX].m_nCount == 0) &&
+			(m_Results[MESHVALIDATIONISSUE_BOUNDARYEDGE].m_nCount == 0) &&
+			(m_Results[MESHVALIDATIONISSUE_NONMANIFOLDEDGE].m_nCount == 0) &&
+			(m_Results[MESHVALIDATIONISSUE_INCONSISTENTORIENTATION].m_nCount == 0);
+	}
+
+}
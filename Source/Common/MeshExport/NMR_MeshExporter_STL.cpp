@@ -37,7 +37,7 @@ This is a derived class for Exporting the binary STL and color STL Mesh Format.
 #include "Common/Math/NMR_Vector.h" 
 #include "Common/NMR_Exception.h" 
 #include <cmath>
-#include <list>
+#include <vector>
 
 namespace NMR {
 
@@ -52,6 +52,38 @@ namespace NMR {
 	}
 
 	void CMeshExporter_STL::exportMeshEx(_In_ CMesh * pMesh, _In_opt_ NMATRIX3 * pmMatrix, _In_opt_ CMeshExportEdgeMap * pExportEdgeMap)
+	{
+		if (!pMesh)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		writeHeader(pMesh->getFaceCount());
+		writeFacets(pMesh, pmMatrix);
+	}
+
+	void CMeshExporter_STL::writeHeader(_In_ nfUint32 nFacetCount)
+	{
+		CExportStream * pStream = getStream();
+		if (!pStream)
+			throw CNMRException(NMR_ERROR_NOEXPORTSTREAM);
+
+		nfUint32 nIdx;
+		nfByte stlheader[80];
+		char HeaderMessage[34] = "STL Export by Lib3MF";
+
+		// Fill Header
+		for (nIdx = 0; nIdx < 33; nIdx++)
+			stlheader[nIdx] = (nfByte)HeaderMessage[nIdx];
+		for (nIdx = 33; nIdx < 80; nIdx++)
+			stlheader[nIdx] = 32;
+
+		// Write Header
+		pStream->writeBuffer(&stlheader[0], 80);
+		if (isBigEndian())
+			nFacetCount = swapBytes(nFacetCount);
+		pStream->writeBuffer(&nFacetCount, sizeof (nFacetCount));
+	}
+
+	void CMeshExporter_STL::writeFacets(_In_ CMesh * pMesh, _In_opt_ const NMATRIX3 * pmMatrix)
 	{
 		if (!pMesh)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
@@ -62,13 +94,16 @@ namespace NMR {
 
 		nfUint32 nIdx, j;
 		nfUint32 nFaceCount = pMesh->getFaceCount();
+		nfBool bIsBigEndian = isBigEndian();
 		MESHFACE * face;
 		MESHNODE * node;
 
-		MESHFORMAT_STL_FACET facet;
-		std::list<MESHFORMAT_STL_FACET> facetdata;
+		std::vector<MESHFORMAT_STL_FACET> facetdata;
+		facetdata.resize(nFaceCount < NMR_MESHEXPORTER_STL_FACETBUFFERSIZE ? nFaceCount : NMR_MESHEXPORTER_STL_FACETBUFFERSIZE);
+		nfUint32 nBufferedCount = 0;
 
 		for (nIdx = 0; nIdx < nFaceCount; nIdx++) {
+			MESHFORMAT_STL_FACET & facet = facetdata[nBufferedCount];
 
 			face = pMesh->getFace(nIdx);
 			for (j = 0; j < 3; j++) {
@@ -82,38 +117,13 @@ namespace NMR {
 			// Calculate Triangle Normals
 			facet.m_normal = fnVEC3_calcTriangleNormal(facet.m_vertices[0], facet.m_vertices[1], facet.m_vertices[2]);
 			facet.m_attribute = 0;
+			if (bIsBigEndian)
+				facet.swapByteOrder();
 
-			facetdata.push_back(facet);
-		}
-
-		nfByte stlheader[80];
-		char HeaderMessage[34] = "STL Export by Lib3MF";
-		nfUint32 nFacetCount = (nfUint32) facetdata.size();
-
-		// Fill Header
-		for (nIdx = 0; nIdx < 33; nIdx++)
-			stlheader[nIdx] = (nfByte)HeaderMessage[nIdx];
-		for (nIdx = 33; nIdx < 80; nIdx++)
-			stlheader[nIdx] = 32;
-
-		// Write Header
-		pStream->writeBuffer(&stlheader[0], 80);
-		if (isBigEndian())
-			nFacetCount = swapBytes(nFacetCount);
-		pStream->writeBuffer(&nFacetCount, sizeof (nFacetCount));
-
-		std::list<MESHFORMAT_STL_FACET>::iterator iter;
-		if (isBigEndian()) {
-			MESHFORMAT_STL_FACET tmpFacet;
-			for (iter = facetdata.begin(); iter != facetdata.end(); iter++) {
-				tmpFacet = *iter;
-				tmpFacet.swapByteOrder();
-				pStream->writeBuffer(&tmpFacet, sizeof(MESHFORMAT_STL_FACET));
-			}
-		}
-		else {
-			for (iter = facetdata.begin(); iter != facetdata.end(); iter++) {
-				pStream->writeBuffer(&(*iter), sizeof(MESHFORMAT_STL_FACET));
+			nBufferedCount++;
+			if ((nBufferedCount == facetdata.size()) || (nIdx + 1 == nFaceCount)) {
+				pStream->writeBuffer(facetdata.data(), nBufferedCount * sizeof(MESHFORMAT_STL_FACET));
+				nBufferedCount = 0;
 			}
 		}
 	}
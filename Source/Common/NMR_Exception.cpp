@@ -128,6 +128,9 @@ namespace NMR {
 		case NMR_ERROR_ZIPCONTAINSINCONSISTENCIES: return "ZIP file contains inconsistencies. It might load with errors or incorrectly.";
 		case NMR_ERROR_XMLNAMESPACEALREADYREGISTERED: return "An XML namespace is already registered.";
 		case NMR_ERROR_XMLPREFIXALREADYREGISTERED: return "An XML prefix is already registered.";
+		case NMR_ERROR_COULDNOTINITINFLATE: return "Failed to initialize a zlib buffer for decompression.";
+		case NMR_ERROR_COULDNOTINFLATE: return "Failed to decompress part. The part is corrupt or does not match its size or CRC.";
+		case NMR_ERROR_COULDNOTINITDEFLATE: return "Failed to initialize a zlib buffer for compression.";
 
 
 		// Unhandled exception
@@ -33,14 +33,16 @@ a relaxed import policy on the file format.
 --*/
 
 #include "Common/NMR_ModelWarnings.h" 
+#include <cstring>
 
 namespace NMR {
 
-	CModelWarning::CModelWarning(std::string sMessage, eModelWarningLevel WarningLevel, nfError nErrorCode)
+	CModelWarning::CModelWarning(std::string sMessage, eModelWarningLevel WarningLevel, nfError nErrorCode, nfUint32 nOccurrenceCount)
 	{
 		m_sMessage = sMessage;
 		m_WarningLevel = WarningLevel;
 		m_nErrorCode = nErrorCode;
+		m_nOccurrenceCount = nOccurrenceCount;
 	}
 
 	std::string CModelWarning::getMessage()
@@ -58,9 +60,15 @@ namespace NMR {
 		return m_nErrorCode;
 	}
 
+	nfUint32 CModelWarning::getOccurrenceCount()
+	{
+		return m_nOccurrenceCount;
+	}
+
 	CModelWarnings::CModelWarnings()
 	{
 		setCriticalWarningLevel(mrwFatal);
+		m_bAggregateWarnings = false;
 	}
 
 	eModelWarningLevel CModelWarnings::getCriticalWarningLevel()
@@ -73,6 +81,18 @@ namespace NMR {
 		m_CriticalWarningLevel = WarningLevel;
 	}
 
+	nfBool CModelWarnings::getAggregateWarnings()
+	{
+		return m_bAggregateWarnings;
+	}
+
+	void CModelWarnings::setAggregateWarnings(_In_ nfBool bAggregateWarnings)
+	{
+		// Warnings that have already been collected keep their entries
+		m_bAggregateWarnings = bAggregateWarnings;
+		m_AggregatedWarningIndices.clear();
+	}
+
 	void CModelWarnings::addWarning(_In_ nfError nErrorCode, eModelWarningLevel WarningLevel)
 	{
 		CNMRException e(nErrorCode);
@@ -81,11 +101,37 @@ namespace NMR {
 
 	void CModelWarnings::addException(const _In_ CNMRException & Exception, _In_ eModelWarningLevel WarningLevel)
 	{
-		if (m_Warnings.size() < NMR_MAXWARNINGCOUNT) { // Failsafe check for Index overflows
-			std::string sMessage (Exception.what());
+		nfError nErrorCode = Exception.getErrorCode();
+
+		MODELWARNINGENTRY * pAggregatedEntry = nullptr;
+		if (m_bAggregateWarnings) {
+			nfUint64 nKey = ((nfUint64)nErrorCode << 32) | (nfUint32)WarningLevel;
+			auto iIterator = m_AggregatedWarningIndices.find(nKey);
+			if (iIterator != m_AggregatedWarningIndices.end())
+				pAggregatedEntry = &m_Warnings[iIterator->second];
+			else if (m_Warnings.size() < NMR_MAXWARNINGCOUNT)
+				m_AggregatedWarningIndices.insert(std::make_pair(nKey, (nfUint32)m_Warnings.size()));
+		}
 
-			PModelReaderWarning pWarning = std::make_shared<CModelWarning>(sMessage, WarningLevel, Exception.getErrorCode());
-			m_Warnings.push_back(pWarning);
+		if (pAggregatedEntry != nullptr) {
+			if (pAggregatedEntry->m_nOccurrenceCount < NMR_MAXWARNINGCOUNT)
+				pAggregatedEntry->m_nOccurrenceCount++;
+		}
+		else if (m_Warnings.size() < NMR_MAXWARNINGCOUNT) { // Failsafe check for Index overflows
+			MODELWARNINGENTRY Entry;
+			Entry.m_nErrorCode = nErrorCode;
+			Entry.m_WarningLevel = WarningLevel;
+			Entry.m_nOccurrenceCount = 1;
+			Entry.m_nCustomMessageIndex = -1;
+
+			// Only derived exceptions carry a message that differs from the one of their error code
+			const char * pszMessage = Exception.what();
+			if (strcmp(pszMessage, CNMRException(nErrorCode).what()) != 0) {
+				Entry.m_nCustomMessageIndex = (nfInt32)m_CustomMessages.size();
+				m_CustomMessages.push_back(pszMessage);
+			}
+
+			m_Warnings.push_back(Entry);
 		}
 
 		if ((nfInt32)WarningLevel <= (nfInt32)m_CriticalWarningLevel)
@@ -99,7 +145,25 @@ namespace NMR {
 
 	PModelReaderWarning CModelWarnings::getWarning(_In_ nfUint32 nIndex)
 	{
-		return m_Warnings[nIndex];
+		if (nIndex >= m_Warnings.size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		const MODELWARNINGENTRY & Entry = m_Warnings[nIndex];
+		std::string sMessage;
+		if (Entry.m_nCustomMessageIndex >= 0)
+			sMessage = m_CustomMessages[Entry.m_nCustomMessageIndex];
+		else
+			sMessage = CNMRException(Entry.m_nErrorCode).what();
+
+		return std::make_shared<CModelWarning>(sMessage, Entry.m_WarningLevel, Entry.m_nErrorCode, Entry.m_nOccurrenceCount);
+	}
+
+	nfUint32 CModelWarnings::getWarningOccurrenceCount(_In_ nfUint32 nIndex)
+	{
+		if (nIndex >= m_Warnings.size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		return m_Warnings[nIndex].m_nOccurrenceCount;
 	}
 
 
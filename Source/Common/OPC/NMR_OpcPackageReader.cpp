@@ -39,6 +39,7 @@ NMR_OpcPackageReader.cpp defines an OPC Package reader in a portable way.
 
 #include "Model/Classes/NMR_ModelConstants.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace NMR {
@@ -103,7 +104,7 @@ namespace NMR {
 		return -1;
 	}
 
-	COpcPackageReader::COpcPackageReader(_In_ PImportStream pImportStream, _In_ PModelWarnings pWarnings, _In_ PProgressMonitor pProgressMonitor)
+	COpcPackageReader::COpcPackageReader(_In_ PImportStream pImportStream, _In_ PModelWarnings pWarnings, _In_ PProgressMonitor pProgressMonitor, _In_ nfBool bCheckConsistency)
 		: m_pWarnings(pWarnings), m_pProgressMonitor(pProgressMonitor)
 	{
 		if (!pImportStream)
@@ -143,36 +144,23 @@ namespace NMR {
 			if (pZIPsource == nullptr)
 				throw CNMRException(NMR_ERROR_COULDNOTREADZIPFILE);
 
-			m_ZIParchive = zip_open_from_source(pZIPsource, ZIP_RDONLY | ZIP_CHECKCONS, &m_ZIPError);
-			if (m_ZIParchive == nullptr) {
+			if (bCheckConsistency) {
+				m_ZIParchive = zip_open_from_source(pZIPsource, ZIP_RDONLY | ZIP_CHECKCONS, &m_ZIPError);
+				if (m_ZIParchive == nullptr) {
+					m_ZIParchive = zip_open_from_source(pZIPsource, ZIP_RDONLY, &m_ZIPError);
+					if (m_ZIParchive == nullptr)
+						throw CNMRException(NMR_ERROR_COULDNOTREADZIPFILE);
+					else
+						m_pWarnings->addException(CNMRException(NMR_ERROR_ZIPCONTAINSINCONSISTENCIES), mrwInvalidMandatoryValue);
+				}
+			}
+			else {
 				m_ZIParchive = zip_open_from_source(pZIPsource, ZIP_RDONLY, &m_ZIPError);
 				if (m_ZIParchive == nullptr)
 					throw CNMRException(NMR_ERROR_COULDNOTREADZIPFILE);
-				else
-					m_pWarnings->addException(CNMRException(NMR_ERROR_ZIPCONTAINSINCONSISTENCIES), mrwInvalidMandatoryValue);
 			}
 
-			// Get ZIP Content
-			nfInt64 nEntryCount = zip_get_num_entries(m_ZIParchive, ZIP_FL_UNCHANGED);
-			if (nEntryCount < 0)
-				throw CNMRException(NMR_ERROR_COULDNOTREADZIPFILE);
-
-			// List and stat Entries
-			nfUint64 nUnzippedFileSize = 0;
-			for (nfInt64 nIndex = 0; nIndex < nEntryCount; nIndex++) {
-				const char * pszName = zip_get_name(m_ZIParchive, (nfUint64) nIndex, ZIP_FL_ENC_GUESS);
-				m_ZIPEntries.insert(std::make_pair(pszName, nIndex));
-
-				zip_stat_t Stat;
-				nfInt32 nResult = zip_stat_index(m_ZIParchive, nIndex, ZIP_FL_UNCHANGED, &Stat);
-				if (nResult != 0)
-					throw CNMRException(NMR_ERROR_COULDNOTSTATZIPENTRY);
-
-				nUnzippedFileSize += Stat.size;
-			}
-
-			m_pProgressMonitor->SetMaxProgress(double(nUnzippedFileSize));
-			m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+			readZIPEntries();
 
 			readContentTypes();
 			readRootRelationships();
@@ -224,14 +212,59 @@ namespace NMR {
 		m_ZIParchive = nullptr;
 	}
 
+	void COpcPackageReader::readZIPEntries()
+	{
+		nfInt64 nEntryCount = zip_get_num_entries(m_ZIParchive, ZIP_FL_UNCHANGED);
+		if (nEntryCount < 0)
+			throw CNMRException(NMR_ERROR_COULDNOTREADZIPFILE);
+
+		// The central directory is already in memory, so a single stat per entry gives name and size
+		m_ZIPEntries.clear();
+		m_ZIPEntries.reserve((size_t)nEntryCount);
+		nfUint64 nUnzippedFileSize = 0;
+		for (nfInt64 nIndex = 0; nIndex < nEntryCount; nIndex++) {
+			zip_stat_t Stat;
+			nfInt32 nResult = zip_stat_index(m_ZIParchive, (nfUint64)nIndex, ZIP_FL_UNCHANGED, &Stat);
+			if ((nResult != 0) || (Stat.name == nullptr))
+				throw CNMRException(NMR_ERROR_COULDNOTSTATZIPENTRY);
+
+			OPCPACKAGEZIPENTRY Entry;
+			Entry.m_sName = Stat.name;
+			Entry.m_nIndex = (nfUint64)nIndex;
+			Entry.m_nSize = Stat.size;
+			m_ZIPEntries.push_back(std::move(Entry));
+
+			nUnzippedFileSize += Stat.size;
+		}
+
+		// stable, so that the first of several entries with the same name is found
+		std::stable_sort(m_ZIPEntries.begin(), m_ZIPEntries.end(), [](const OPCPACKAGEZIPENTRY & A, const OPCPACKAGEZIPENTRY & B) {
+			return A.m_sName < B.m_sName;
+		});
+
+		m_pProgressMonitor->SetMaxProgress(double(nUnzippedFileSize));
+		m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+	}
+
+	_Ret_maybenull_ const OPCPACKAGEZIPENTRY * COpcPackageReader::findZIPEntry(_In_ const std::string & sName)
+	{
+		auto iIterator = std::lower_bound(m_ZIPEntries.begin(), m_ZIPEntries.end(), sName, [](const OPCPACKAGEZIPENTRY & Entry, const std::string & sValue) {
+			return Entry.m_sName < sValue;
+		});
+		if ((iIterator == m_ZIPEntries.end()) || (iIterator->m_sName != sName))
+			return nullptr;
+
+		return &(*iIterator);
+	}
+
 	PImportStream COpcPackageReader::openZIPEntry(_In_ std::string sName)
 	{
-		auto iIterator = m_ZIPEntries.find(sName);
-		if (iIterator == m_ZIPEntries.end()) {
+		const OPCPACKAGEZIPENTRY * pEntry = findZIPEntry(sName);
+		if (pEntry == nullptr) {
 			return nullptr;
 		}
 
-		return openZIPEntryIndexed(iIterator->second);
+		return openZIPEntryIndexed(pEntry->m_nIndex);
 	}
 
 	PImportStream COpcPackageReader::openZIPEntryIndexed(_In_ nfUint64 nIndex)
@@ -247,7 +280,7 @@ namespace NMR {
 		if (pFile == nullptr)
 			throw CNMRException(NMR_ERROR_COULDNOTOPENZIPENTRY);
 
-		return std::make_shared<CImportStream_ZIP>(pFile, nSize);
+		return std::make_shared<CImportStream_ZIP>(pFile, nSize, m_ZIParchive, nIndex);
 	}
 
 
@@ -304,17 +337,12 @@ namespace NMR {
 	nfUint64 COpcPackageReader::getPartSize(_In_ std::string sPath)
 	{
 		std::string sRealPath = fnRemoveLeadingPathDelimiter(sPath);
-		auto iIterator = m_ZIPEntries.find(sRealPath);
-		if (iIterator == m_ZIPEntries.end()) {
+		const OPCPACKAGEZIPENTRY * pEntry = findZIPEntry(sRealPath);
+		if (pEntry == nullptr) {
 			return 0;
 		}
 
-		zip_stat_t Stat;
-		nfInt32 nResult = zip_stat_index(m_ZIParchive, iIterator->second, ZIP_FL_UNCHANGED, &Stat);
-		if (nResult != 0)
-			throw CNMRException(NMR_ERROR_COULDNOTSTATZIPENTRY);
-
-		return Stat.size;
+		return pEntry->m_nSize;
 	}
 
 	POpcPackagePart COpcPackageReader::createPart(_In_ std::string sPath)
@@ -49,7 +49,8 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
 		m_pExportStream = pExportStream;
-		m_pZIPWriter = std::make_shared<CPortableZIPWriter>(m_pExportStream, true);
+		// Streams that cannot seek get data descriptors instead of patched local headers
+		m_pZIPWriter = std::make_shared<CPortableZIPWriter>(m_pExportStream, true, !m_pExportStream->canSeek());
 
 		m_nRelationIDCounter = 0;
 	}
@@ -60,10 +61,15 @@ namespace NMR {
 	}
 
 	POpcPackagePart COpcPackageWriter::addPart(_In_ std::string sPath)
+	{
+		return addPart(sPath, ZIPFILECOMPRESSION_DEFLATED, ZIPFILECOMPRESSIONLEVEL_DEFAULT);
+	}
+
+	POpcPackagePart COpcPackageWriter::addPart(_In_ std::string sPath, _In_ nfUint16 nCompressionMethod, _In_ nfInt32 nCompressionLevel)
 	{
 		sPath = fnRemoveLeadingPathDelimiter(sPath);
 		
-		PExportStream pStream = m_pZIPWriter->createEntry(sPath, fnGetUnixTime());
+		PExportStream pStream = m_pZIPWriter->createEntry(sPath, fnGetUnixTime(), nCompressionMethod, nCompressionLevel);
 		POpcPackagePart pPart = std::make_shared<COpcPackagePart>(sPath, pStream);
 		m_Parts.push_back(pPart);
 
@@ -141,7 +147,7 @@ namespace NMR {
 				sPath += sName;
 				sPath += std::string(".")+PACKAGE_3D_RELS_EXTENSION;
 
-				PExportStream pStream = m_pZIPWriter->createEntry(sPath, fnGetUnixTime());
+				PExportStream pStream = m_pZIPWriter->createEntry(sPath, fnGetUnixTime(), ZIPFILECOMPRESSION_DEFLATED, ZIPFILECOMPRESSIONLEVEL_DEFAULT);
 				pPart->writeRelationships(pStream);
 			}
 			iIterator++;
@@ -151,7 +157,7 @@ namespace NMR {
 
 	void COpcPackageWriter::writeContentTypes()
 	{
-		PExportStream pStream = m_pZIPWriter->createEntry(OPCPACKAGE_PATH_CONTENTTYPES, fnGetUnixTime());
+		PExportStream pStream = m_pZIPWriter->createEntry(OPCPACKAGE_PATH_CONTENTTYPES, fnGetUnixTime(), ZIPFILECOMPRESSION_DEFLATED, ZIPFILECOMPRESSIONLEVEL_DEFAULT);
 		PXmlWriter_Native pXMLWriter = std::make_shared<CXmlWriter_Native>(pStream);
 
 		pXMLWriter->WriteStartDocument();
@@ -188,7 +194,7 @@ namespace NMR {
 		if (m_RootRelationships.size() == 0)
 			return;
 
-		PExportStream pStream = m_pZIPWriter->createEntry(OPCPACKAGE_PATH_ROOTRELATIONSHIPS, fnGetUnixTime());
+		PExportStream pStream = m_pZIPWriter->createEntry(OPCPACKAGE_PATH_ROOTRELATIONSHIPS, fnGetUnixTime(), ZIPFILECOMPRESSION_DEFLATED, ZIPFILECOMPRESSIONLEVEL_DEFAULT);
 		PXmlWriter_Native pXMLWriter = std::make_shared<CXmlWriter_Native>(pStream);
 
 		pXMLWriter->WriteStartDocument();
@@ -43,6 +43,11 @@ namespace NMR {
 		// do nothing
 	}
 
+	nfBool CExportStream::canSeek()
+	{
+		return true;
+	}
+
 	void CExportStream::copyFrom(_In_ CImportStream * pImportStream, _In_ nfUint64 cbCount, _In_ nfUint32 cbBufferSize)
 	{
 		if (pImportStream == nullptr)
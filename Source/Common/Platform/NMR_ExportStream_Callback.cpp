@@ -155,5 +155,9 @@ namespace NMR {
 		return cbTotalBytesToWrite;
 	}
 
+	nfBool CExportStream_Callback::canSeek()
+	{
+		return (m_pSeekCallback != nullptr);
+	}
 
 }
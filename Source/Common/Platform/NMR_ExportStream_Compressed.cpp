@@ -32,19 +32,30 @@ NMR_ExportStream_Compressed.h defines a stream to write compressed files
 
 #include "Common/Platform/NMR_ExportStream_Compressed.h"
 #include "Common/NMR_Exception.h"
+#include <algorithm>
  
 namespace NMR {
 
 	CExportStream_Compressed::CExportStream_Compressed(PExportStream pUncompressedStream)
+		: CExportStream_Compressed(pUncompressedStream, Z_DEFAULT_COMPRESSION, EXPORTSTREAM_COMPRESSED_DEFAULTCHUNKSIZE)
+	{
+	}
+
+	CExportStream_Compressed::CExportStream_Compressed(PExportStream pUncompressedStream, nfInt32 nCompressionLevel, nfUint32 cbChunkSize)
 	{
 		if (nullptr == pUncompressedStream)
 			throw CNMRException(NMR_ERROR_INVALIDPOINTER);
+		if ((nCompressionLevel < Z_DEFAULT_COMPRESSION) || (nCompressionLevel > Z_BEST_COMPRESSION))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (cbChunkSize < EXPORTSTREAM_COMPRESSED_MINCHUNKSIZE)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		m_pUncompressedStream = pUncompressedStream;
+		m_OutBuffer.resize(cbChunkSize);
 
 		m_strm.zalloc = Z_NULL;
 		m_strm.zfree = Z_NULL;
 		m_strm.opaque = Z_NULL;
-		if (deflateInit(&m_strm, Z_DEFAULT_COMPRESSION) != Z_OK)
+		if (deflateInit(&m_strm, nCompressionLevel) != Z_OK)
 			throw CNMRException(NMR_ERROR_COULDNOTINITDEFLATE);
 	}
 
@@ -75,9 +86,10 @@ namespace NMR {
 
 	nfInt32 CExportStream_Compressed::compress(nfInt32 flush) {
 		nfInt32 ret;
+		nfUint32 cbChunkSize = (nfUint32)m_OutBuffer.size();
 		do {
-			m_strm.avail_out = (nfUint32) EXPORTSTREAM_WRITE_BUFFER_CHUNKSIZE;
-			m_strm.next_out = out;
+			m_strm.avail_out = cbChunkSize;
+			m_strm.next_out = m_OutBuffer.data();
 			ret = deflate(&m_strm, flush);
 			switch (ret) {
 			case Z_NEED_DICT:
@@ -86,8 +98,9 @@ namespace NMR {
 				(void)deflateEnd(&m_strm);
 				throw CNMRException(NMR_ERROR_COULDNOTDEFLATE);
 			}
-			int toWrite = EXPORTSTREAM_WRITE_BUFFER_CHUNKSIZE - m_strm.avail_out;
-			m_pUncompressedStream->writeBuffer(out, toWrite);
+			nfUint32 toWrite = cbChunkSize - m_strm.avail_out;
+			if (toWrite > 0)
+				m_pUncompressedStream->writeBuffer(m_OutBuffer.data(), toWrite);
 		} while (m_strm.avail_out == 0);
 		return ret;
 	}
@@ -97,9 +110,17 @@ namespace NMR {
 		if (nullptr == pBuffer)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		m_strm.avail_in = (nfUint32) cbTotalBytesToWrite;
-		m_strm.next_in = (Bytef *) pBuffer;
-		compress(Z_NO_FLUSH);
+		// avail_in is 32 bit, so larger buffers are passed on in pieces
+		const nfByte * pSource = (const nfByte *)pBuffer;
+		nfUint64 cbBytesLeft = cbTotalBytesToWrite;
+		while (cbBytesLeft > 0) {
+			nfUint32 cbPieceSize = (nfUint32)std::min(cbBytesLeft, (nfUint64)0x40000000);
+			m_strm.avail_in = cbPieceSize;
+			m_strm.next_in = (Bytef *)pSource;
+			compress(Z_NO_FLUSH);
+			pSource += cbPieceSize;
+			cbBytesLeft -= cbPieceSize;
+		}
 		
 		return cbTotalBytesToWrite;
 	}
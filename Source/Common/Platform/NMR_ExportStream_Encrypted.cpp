@@ -1,6 +1,8 @@
 #include "Common/Platform/NMR_ExportStream_Encrypted.h"
 #include "Common/NMR_Exception.h"
 
+#include <algorithm>
+
 namespace NMR {
 	CExportStream_Encrypted::CExportStream_Encrypted(PExportStream pEncryptedStream, ContentEncryptionDescriptor context)
 		:m_pEncryptedStream(pEncryptedStream), m_pDecryptContext(context)
@@ -37,15 +39,23 @@ namespace NMR {
 
 	nfUint64 CExportStream_Encrypted::writeBuffer(const void * pBuffer, nfUint64 cbTotalBytesToWrite)
 	{
+		// Encrypt in chunks of bounded size, so that the scratch buffer does not grow with the request size
+		const nfByte * pSource = (const nfByte *)pBuffer;
 		nfUint64 encryptedBytes = 0;
-		if (cbTotalBytesToWrite > 0) {
-			std::vector<nfByte> encryptBuffer(cbTotalBytesToWrite, 0);
-			encryptedBytes = m_pDecryptContext.m_fnCrypt(cbTotalBytesToWrite, (const nfByte *)pBuffer, encryptBuffer.data(), m_pDecryptContext.m_sDekDecryptData);
-			if (encryptedBytes > 0) {
-				auto writtenBytes = m_pEncryptedStream->writeBuffer(encryptBuffer.data(), encryptedBytes);
-				if (encryptedBytes != writtenBytes)
+		nfUint64 cbTotalBytesProcessed = 0;
+		while (cbTotalBytesProcessed < cbTotalBytesToWrite) {
+			nfUint64 cbChunkSize = std::min(cbTotalBytesToWrite - cbTotalBytesProcessed, (nfUint64)NMR_EXPORTSTREAM_WRITEBUFFERSIZE);
+			if (m_EncryptedBuffer.size() < cbChunkSize)
+				m_EncryptedBuffer.resize((size_t)cbChunkSize);
+
+			nfUint64 chunkEncryptedBytes = m_pDecryptContext.m_fnCrypt(cbChunkSize, pSource + cbTotalBytesProcessed, m_EncryptedBuffer.data(), m_pDecryptContext.m_sDekDecryptData);
+			if (chunkEncryptedBytes > 0) {
+				auto writtenBytes = m_pEncryptedStream->writeBuffer(m_EncryptedBuffer.data(), chunkEncryptedBytes);
+				if (chunkEncryptedBytes != writtenBytes)
 					throw CNMRException(NMR_ERROR_CALCULATIONTERMINATED);
 			}
+			encryptedBytes += chunkEncryptedBytes;
+			cbTotalBytesProcessed += cbChunkSize;
 		}
 		return encryptedBytes;
 	}
@@ -0,0 +1,326 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ExportStream_GCC_POSIX.cpp implements the CExportStream_GCC_POSIX Class.
+This is a file export stream on POSIX file descriptors, which collects writes in
+a large aligned buffer and writes it with pwrite. On Linux, the file is preallocated
+as it grows, written pages can be dropped from the page cache early, and whole
+blocks can be written with O_DIRECT.
+
+--*/
+
+#include "Common/Platform/NMR_ExportStream_GCC_POSIX.h"
+#include "Common/NMR_Exception.h"
+#include "Common/NMR_StringUtils.h"
+
+#ifndef _WIN32
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace NMR {
+
+	CExportStream_GCC_POSIX::CExportStream_GCC_POSIX(_In_ const nfWChar * pwszFileName, _In_ const EXPORTSTREAMFILEOPTIONS & Options)
+	{
+		if (pwszFileName == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		std::string sUTF8Name = fnUTF16toUTF8(std::wstring(pwszFileName));
+
+		// The file is opened for reading as well, to fill partial blocks in O_DIRECT mode
+		m_nFileDescriptor = open(sUTF8Name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+		if (m_nFileDescriptor < 0)
+			throw CNMRException(NMR_ERROR_COULDNOTCREATEFILE);
+
+		// O_DIRECT is a hint, file systems that do not support it are written through the page cache
+		m_nDirectFileDescriptor = -1;
+#ifdef O_DIRECT
+		if (Options.m_bDirectIO)
+			m_nDirectFileDescriptor = open(sUTF8Name.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+#endif
+
+		void * pBuffer = nullptr;
+		if (posix_memalign(&pBuffer, NMR_EXPORTSTREAM_POSIX_ALIGNMENT, NMR_EXPORTSTREAM_POSIX_BUFFERSIZE) != 0) {
+			releaseFile();
+			throw std::bad_alloc();
+		}
+
+		m_pBuffer = (nfByte *)pBuffer;
+		m_Options = Options;
+		m_nBufferPosition = 0;
+		m_cbBufferFill = 0;
+		m_nFileSize = 0;
+		m_nAllocatedSize = 0;
+		m_bCanPreallocate = true;
+		m_nWritebackPosition = 0;
+		m_nDroppedPosition = 0;
+
+		if (m_Options.m_nSizeHint > 0)
+			preallocate(m_Options.m_nSizeHint);
+	}
+
+	CExportStream_GCC_POSIX::~CExportStream_GCC_POSIX()
+	{
+		try {
+			close();
+		}
+		catch (...) {
+		}
+
+		releaseFile();
+		free(m_pBuffer);
+	}
+
+	void CExportStream_GCC_POSIX::releaseFile()
+	{
+		if (m_nDirectFileDescriptor >= 0) {
+			::close(m_nDirectFileDescriptor);
+			m_nDirectFileDescriptor = -1;
+		}
+		if (m_nFileDescriptor >= 0) {
+			::close(m_nFileDescriptor);
+			m_nFileDescriptor = -1;
+		}
+	}
+
+	void CExportStream_GCC_POSIX::startBuffer(_In_ nfUint64 nPosition)
+	{
+		m_nBufferPosition = nPosition;
+		m_cbBufferFill = 0;
+
+		if (m_nDirectFileDescriptor < 0)
+			return;
+
+		// Start at a block boundary, so that the buffer can be written with O_DIRECT.
+		// The leading part of the block is read back from the file.
+		nfUint64 nAlignedPosition = nPosition - (nPosition % NMR_EXPORTSTREAM_POSIX_ALIGNMENT);
+		nfUint64 cbLeadSize = nPosition - nAlignedPosition;
+		if (cbLeadSize == 0)
+			return;
+
+		nfUint64 cbBytesRead = 0;
+		if (m_nFileSize > nAlignedPosition) {
+			nfUint64 cbBytesToRead = std::min(cbLeadSize, m_nFileSize - nAlignedPosition);
+			while (cbBytesRead < cbBytesToRead) {
+				ssize_t nResult = pread(m_nFileDescriptor, m_pBuffer + cbBytesRead, (size_t)(cbBytesToRead - cbBytesRead), (off_t)(nAlignedPosition + cbBytesRead));
+				if (nResult < 0) {
+					if (errno == EINTR)
+						continue;
+					throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+				}
+				if (nResult == 0)
+					break;
+				cbBytesRead += nResult;
+			}
+		}
+		memset(m_pBuffer + cbBytesRead, 0, (size_t)(cbLeadSize - cbBytesRead));
+
+		m_nBufferPosition = nAlignedPosition;
+		m_cbBufferFill = cbLeadSize;
+	}
+
+	void CExportStream_GCC_POSIX::writeToFile(_In_ int nFileDescriptor, _In_ const nfByte * pData, _In_ nfUint64 cbCount, _In_ nfUint64 nPosition)
+	{
+		while (cbCount > 0) {
+			ssize_t nResult = pwrite(nFileDescriptor, pData, (size_t)cbCount, (off_t)nPosition);
+			if (nResult < 0) {
+				if (errno == EINTR)
+					continue;
+				throw CNMRException(NMR_ERROR_COULDNOTWRITESTREAM);
+			}
+			pData += nResult;
+			nPosition += nResult;
+			cbCount -= nResult;
+		}
+	}
+
+	void CExportStream_GCC_POSIX::flushBuffer()
+	{
+		if (m_cbBufferFill == 0)
+			return;
+
+		nfUint64 nEndPosition = m_nBufferPosition + m_cbBufferFill;
+		preallocate(nEndPosition);
+
+		// Whole blocks go through O_DIRECT, a partial block at the end through the page cache
+		nfUint64 cbDirectSize = 0;
+		if ((m_nDirectFileDescriptor >= 0) && ((m_nBufferPosition % NMR_EXPORTSTREAM_POSIX_ALIGNMENT) == 0))
+			cbDirectSize = m_cbBufferFill - (m_cbBufferFill % NMR_EXPORTSTREAM_POSIX_ALIGNMENT);
+
+		if (cbDirectSize > 0)
+			writeToFile(m_nDirectFileDescriptor, m_pBuffer, cbDirectSize, m_nBufferPosition);
+		if (m_cbBufferFill > cbDirectSize)
+			writeToFile(m_nFileDescriptor, m_pBuffer + cbDirectSize, m_cbBufferFill - cbDirectSize, m_nBufferPosition + cbDirectSize);
+
+		if (nEndPosition > m_nFileSize)
+			m_nFileSize = nEndPosition;
+		m_cbBufferFill = 0;
+
+		writeBack();
+	}
+
+	void CExportStream_GCC_POSIX::preallocate(_In_ nfUint64 nEndPosition)
+	{
+#ifdef __linux__
+		if (!m_bCanPreallocate || (nEndPosition <= m_nAllocatedSize))
+			return;
+
+		// Allocate ahead in growing steps, which keeps the file in few extents.
+		// The file size is kept, and the rest is released when the stream is closed.
+		nfUint64 cbStepSize = std::max((nfUint64)NMR_EXPORTSTREAM_POSIX_PREALLOCATIONSTEP, m_nAllocatedSize / 4);
+		nfUint64 nAllocatedSize = std::max(nEndPosition, m_nAllocatedSize + cbStepSize);
+		if (fallocate(m_nFileDescriptor, FALLOC_FL_KEEP_SIZE, (off_t)m_nAllocatedSize, (off_t)(nAllocatedSize - m_nAllocatedSize)) != 0) {
+			m_bCanPreallocate = false;
+			return;
+		}
+		m_nAllocatedSize = nAllocatedSize;
+#endif // __linux__
+	}
+
+	void CExportStream_GCC_POSIX::writeBack()
+	{
+#ifdef __linux__
+		if (!m_Options.m_bDropWrittenPages || (m_nFileSize < m_nWritebackPosition + NMR_EXPORTSTREAM_POSIX_WRITEBACKWINDOW))
+			return;
+
+		// Start the writeback of the new window, then wait for the previous one and drop its pages.
+		// This keeps the amount of dirty pages bounded without waiting for the window just written.
+		sync_file_range(m_nFileDescriptor, (off_t)m_nWritebackPosition, (off_t)(m_nFileSize - m_nWritebackPosition), SYNC_FILE_RANGE_WRITE);
+		if (m_nWritebackPosition > m_nDroppedPosition) {
+			sync_file_range(m_nFileDescriptor, (off_t)m_nDroppedPosition, (off_t)(m_nWritebackPosition - m_nDroppedPosition),
+				SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+			posix_fadvise(m_nFileDescriptor, (off_t)m_nDroppedPosition, (off_t)(m_nWritebackPosition - m_nDroppedPosition), POSIX_FADV_DONTNEED);
+			m_nDroppedPosition = m_nWritebackPosition;
+		}
+		m_nWritebackPosition = m_nFileSize;
+#endif // __linux__
+	}
+
+	nfBool CExportStream_GCC_POSIX::seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed)
+	{
+		if (position == getPosition())
+			return true;
+
+		flushBuffer();
+		startBuffer(position);
+		return true;
+	}
+
+	nfBool CExportStream_GCC_POSIX::seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		return seekPosition(getPosition() + bytes, bHasToSucceed);
+	}
+
+	nfBool CExportStream_GCC_POSIX::seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		nfUint64 nEndPosition = std::max(m_nFileSize, getPosition());
+		if (bytes > nEndPosition) {
+			if (bHasToSucceed)
+				throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+			return false;
+		}
+
+		return seekPosition(nEndPosition - bytes, bHasToSucceed);
+	}
+
+	nfUint64 CExportStream_GCC_POSIX::getPosition()
+	{
+		return m_nBufferPosition + m_cbBufferFill;
+	}
+
+	nfUint64 CExportStream_GCC_POSIX::writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite)
+	{
+		if (pBuffer == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (m_nFileDescriptor < 0)
+			throw CNMRException(NMR_ERROR_COULDNOTWRITESTREAM);
+
+		const nfByte * pData = (const nfByte *)pBuffer;
+		nfUint64 cbBytesLeft = cbTotalBytesToWrite;
+		while (cbBytesLeft > 0) {
+			// Large writes into an empty buffer are not copied
+			if ((m_cbBufferFill == 0) && (m_nDirectFileDescriptor < 0) && (cbBytesLeft >= NMR_EXPORTSTREAM_POSIX_BUFFERSIZE)) {
+				nfUint64 nEndPosition = m_nBufferPosition + cbBytesLeft;
+				preallocate(nEndPosition);
+				writeToFile(m_nFileDescriptor, pData, cbBytesLeft, m_nBufferPosition);
+				if (nEndPosition > m_nFileSize)
+					m_nFileSize = nEndPosition;
+				m_nBufferPosition = nEndPosition;
+				writeBack();
+				break;
+			}
+
+			nfUint64 cbChunkSize = std::min(cbBytesLeft, NMR_EXPORTSTREAM_POSIX_BUFFERSIZE - m_cbBufferFill);
+			memcpy(m_pBuffer + m_cbBufferFill, pData, (size_t)cbChunkSize);
+			m_cbBufferFill += cbChunkSize;
+			pData += cbChunkSize;
+			cbBytesLeft -= cbChunkSize;
+
+			if (m_cbBufferFill == NMR_EXPORTSTREAM_POSIX_BUFFERSIZE) {
+				nfUint64 nPosition = getPosition();
+				flushBuffer();
+				startBuffer(nPosition);
+			}
+		}
+
+		return cbTotalBytesToWrite;
+	}
+
+	void CExportStream_GCC_POSIX::close()
+	{
+		if (m_nFileDescriptor < 0)
+			return;
+
+		nfUint64 nPosition = getPosition();
+		flushBuffer();
+		startBuffer(nPosition);
+
+#ifdef __linux__
+		// Release the space that was allocated ahead
+		if (m_nAllocatedSize > m_nFileSize) {
+			if (ftruncate(m_nFileDescriptor, (off_t)m_nFileSize) != 0)
+				throw CNMRException(NMR_ERROR_COULDNOTWRITESTREAM);
+			m_nAllocatedSize = m_nFileSize;
+		}
+
+		if (m_Options.m_bDropWrittenPages && (m_nFileSize > m_nWritebackPosition)) {
+			sync_file_range(m_nFileDescriptor, (off_t)m_nWritebackPosition, (off_t)(m_nFileSize - m_nWritebackPosition), SYNC_FILE_RANGE_WRITE);
+			m_nWritebackPosition = m_nFileSize;
+		}
+#endif // __linux__
+	}
+
+}
+
+#endif // _WIN32
@@ -32,15 +32,18 @@ NMR_ExportStream_Memory.cpp implements the ExportStream to Memory Class.
 
 #include "Common/Platform/NMR_ExportStream_Memory.h"
 #include "Common/NMR_Exception.h"
+#include <algorithm>
+#include <cstring>
 
 namespace NMR {
 
 	CExportStreamMemory::CExportStreamMemory() {
+		m_cbSize = 0;
 		m_Position = 0;
 	}
 
 	nfBool CExportStreamMemory::seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed) {
-		if (position >= m_Buffer.size() && bHasToSucceed) {
+		if (position >= m_cbSize && bHasToSucceed) {
 			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
 		}
 		m_Position = position;
@@ -48,7 +51,7 @@ namespace NMR {
 	}
 
 	nfBool CExportStreamMemory::seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed) {
-		if (bytes + m_Position >= m_Buffer.size() && bHasToSucceed) {
+		if (bytes + m_Position >= m_cbSize && bHasToSucceed) {
 			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
 		}
 		m_Position = bytes + m_Position;
@@ -56,10 +59,10 @@ namespace NMR {
 	}
 
 	nfBool CExportStreamMemory::seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed) {
-		if (bytes >= m_Buffer.size() && bHasToSucceed) {
+		if (bytes >= m_cbSize && bHasToSucceed) {
 			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
 		}
-		m_Position = m_Buffer.size() - bytes;
+		m_Position = m_cbSize - bytes;
 		return true;
 	}
 
@@ -67,24 +70,138 @@ namespace NMR {
 		return m_Position;
 	}
 
-	nfUint64 CExportStreamMemory::writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite) {
-		nfByte *pByteBuffer = (nfByte *)pBuffer;
-		if ((m_Position + cbTotalBytesToWrite) > m_Buffer.size()) {
-			m_Buffer.resize(static_cast<size_t>(m_Position + cbTotalBytesToWrite));
+	nfUint32 CExportStreamMemory::findChunk(_In_ nfUint64 nPosition) {
+		auto iIterator = std::upper_bound(m_Chunks.begin(), m_Chunks.end(), nPosition,
+			[](nfUint64 nValue, const EXPORTSTREAMMEMORYCHUNK & Chunk) { return nValue < Chunk.m_nStart; });
+		if (iIterator == m_Chunks.begin())
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		return (nfUint32)(iIterator - m_Chunks.begin() - 1);
+	}
+
+	void CExportStreamMemory::appendChunk() {
+		nfUint64 nStart = 0;
+		if (!m_Chunks.empty()) {
+			EXPORTSTREAMMEMORYCHUNK & LastChunk = m_Chunks.back();
+			nStart = LastChunk.m_nStart + LastChunk.m_cbCapacity;
 		}
-		for (nfUint64 i = 0; i < cbTotalBytesToWrite; i++) {
-			m_Buffer[static_cast<size_t>(m_Position + i)] = pByteBuffer[i];
+
+		// Doubles the total capacity with every chunk, until the maximum chunk size is reached
+		nfUint64 cbCapacity = std::min(std::max(nStart, (nfUint64)NMR_EXPORTSTREAM_MEMORY_MINCHUNKSIZE), (nfUint64)NMR_EXPORTSTREAM_MEMORY_MAXCHUNKSIZE);
+
+		EXPORTSTREAMMEMORYCHUNK Chunk;
+		Chunk.m_pData.reset(new nfByte[(size_t)cbCapacity]);
+		Chunk.m_nStart = nStart;
+		Chunk.m_cbCapacity = cbCapacity;
+		m_Chunks.push_back(std::move(Chunk));
+	}
+
+	void CExportStreamMemory::writeData(_In_ nfUint64 nPosition, _In_opt_ const nfByte * pBuffer, _In_ nfUint64 cbBytes) {
+		if (cbBytes == 0)
+			return;
+
+		nfUint64 nEnd = nPosition + cbBytes;
+		while (m_Chunks.empty() || (m_Chunks.back().m_nStart + m_Chunks.back().m_cbCapacity < nEnd))
+			appendChunk();
+
+		nfUint32 nChunkIndex = findChunk(nPosition);
+		while (cbBytes > 0) {
+			EXPORTSTREAMMEMORYCHUNK & Chunk = m_Chunks[nChunkIndex];
+			nfUint64 nOffset = nPosition - Chunk.m_nStart;
+			nfUint64 cbToWrite = std::min(cbBytes, Chunk.m_cbCapacity - nOffset);
+			if (pBuffer != nullptr) {
+				memcpy(&Chunk.m_pData[(size_t)nOffset], pBuffer, (size_t)cbToWrite);
+				pBuffer += cbToWrite;
+			}
+			else {
+				memset(&Chunk.m_pData[(size_t)nOffset], 0, (size_t)cbToWrite);
+			}
+			nPosition += cbToWrite;
+			cbBytes -= cbToWrite;
+			nChunkIndex++;
 		}
+
+		if (nEnd > m_cbSize)
+			m_cbSize = nEnd;
+	}
+
+	nfUint64 CExportStreamMemory::writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite) {
+		if (cbTotalBytesToWrite == 0)
+			return 0;
+		if (pBuffer == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Writing behind the end of the stream leaves a gap, which is filled with zeros
+		if (m_Position > m_cbSize)
+			writeData(m_cbSize, nullptr, m_Position - m_cbSize);
+
+		writeData(m_Position, (const nfByte *)pBuffer, cbTotalBytesToWrite);
 		m_Position += cbTotalBytesToWrite;
 		return cbTotalBytesToWrite;
 	}
 
 	nfUint64 CExportStreamMemory::getDataSize() {
-		return m_Buffer.size();
+		return m_cbSize;
+	}
+
+	void CExportStreamMemory::clear() {
+		m_cbSize = 0;
+		m_Position = 0;
+	}
+
+	nfUint32 CExportStreamMemory::getChunkCount() {
+		// Chunks behind the end of the data are only reserved and are not reported
+		nfUint32 nCount = 0;
+		while ((nCount < m_Chunks.size()) && (m_Chunks[nCount].m_nStart < m_cbSize))
+			nCount++;
+		return nCount;
+	}
+
+	const nfByte * CExportStreamMemory::getChunkData(_In_ nfUint32 nIndex, _Out_ nfUint64 & cbChunkSize) {
+		if (nIndex >= m_Chunks.size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		EXPORTSTREAMMEMORYCHUNK & Chunk = m_Chunks[nIndex];
+		if (Chunk.m_nStart >= m_cbSize)
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		cbChunkSize = std::min(Chunk.m_cbCapacity, m_cbSize - Chunk.m_nStart);
+		return Chunk.m_pData.get();
+	}
+
+	void CExportStreamMemory::copyData(_In_ nfUint64 nPosition, _In_ nfUint64 cbBytes, _Out_ nfByte * pBuffer) {
+		if (cbBytes == 0)
+			return;
+		if ((pBuffer == nullptr) || (nPosition > m_cbSize) || (cbBytes > m_cbSize - nPosition))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nChunkIndex = findChunk(nPosition);
+		while (cbBytes > 0) {
+			EXPORTSTREAMMEMORYCHUNK & Chunk = m_Chunks[nChunkIndex];
+			nfUint64 nOffset = nPosition - Chunk.m_nStart;
+			nfUint64 cbToCopy = std::min(cbBytes, Chunk.m_cbCapacity - nOffset);
+			memcpy(pBuffer, &Chunk.m_pData[(size_t)nOffset], (size_t)cbToCopy);
+			pBuffer += cbToCopy;
+			nPosition += cbToCopy;
+			cbBytes -= cbToCopy;
+			nChunkIndex++;
+		}
 	}
 
 	const nfByte *CExportStreamMemory::getData() {
-		return m_Buffer.data();
+		if (m_cbSize == 0)
+			return nullptr;
+
+		if (getChunkCount() > 1) {
+			EXPORTSTREAMMEMORYCHUNK Chunk;
+			Chunk.m_pData.reset(new nfByte[(size_t)m_cbSize]);
+			Chunk.m_nStart = 0;
+			Chunk.m_cbCapacity = m_cbSize;
+			copyData(0, m_cbSize, Chunk.m_pData.get());
+
+			m_Chunks.clear();
+			m_Chunks.push_back(std::move(Chunk));
+		}
+
+		return m_Chunks[0].m_pData.get();
 	}
 
-}
\ No newline at end of file
+}
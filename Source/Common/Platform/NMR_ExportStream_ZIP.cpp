@@ -31,13 +31,15 @@ NMR_PortableZIPWriter.cpp implements a portable stream to write into ZIP files
 --*/
 
 #include "Common/Platform/NMR_ExportStream_ZIP.h"
+#include "Common/Platform/NMR_ImportStream_Deflated_Memory.h"
 #include "Common/NMR_Exception.h"
  
 namespace NMR {
 
-	CExportStream_ZIP::CExportStream_ZIP(_In_ CPortableZIPWriter * pZIPWriter, nfUint32 nEntryKey)
+	CExportStream_ZIP::CExportStream_ZIP(_In_ CPortableZIPWriter * pZIPWriter, nfUint32 nEntryKey, nfUint16 nCompressionMethod, nfInt32 nCompressionLevel)
 	{
 		m_bIsInitialized = false;
+		m_bHasDeflatedContent = false;
 
 		if (pZIPWriter == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
@@ -46,6 +48,7 @@ namespace NMR {
 
 		m_pZIPWriter = pZIPWriter;
 		m_nEntryKey = nEntryKey;
+		m_nCompressionMethod = nCompressionMethod;
 
 		m_pStream.next_in = nullptr;
 		m_pStream.avail_in = 0;
@@ -66,9 +69,13 @@ namespace NMR {
 		m_pStream.avail_out = ZIPEXPORTBUFFERSIZE;
 		m_pStream.total_out = 0;
 
-		nfInt32 nResult = deflateInit2(&m_pStream, Z_BEST_SPEED, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
-		if (nResult < 0)
-			throw CNMRException(NMR_ERROR_DEFLATEINITFAILED);
+		if (m_nCompressionMethod == ZIPFILECOMPRESSION_DEFLATED) {
+			nfInt32 nResult = deflateInit2(&m_pStream, nCompressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+			if (nResult < 0)
+				throw CNMRException(NMR_ERROR_DEFLATEINITFAILED);
+		}
+		else if (m_nCompressionMethod != ZIPFILECOMPRESSION_UNCOMPRESSED)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
 		m_bIsInitialized = true;
 	}
@@ -115,21 +122,48 @@ namespace NMR {
 		const nfByte * pByte = (const nfByte *)pBuffer;
 
 		while (cbCount > 0) {
-			nfUint32 cbBytesWritten;
+			nfUint32 cbChunkSize;
 			if (cbCount < ZIPEXPORTWRITECHUNKSIZE)
-				cbBytesWritten = writeChunk(pByte, (nfUint32)cbCount);
+				cbChunkSize = (nfUint32)cbCount;
+			else
+				cbChunkSize = ZIPEXPORTWRITECHUNKSIZE;
+
+			nfUint32 cbBytesWritten;
+			if (m_nCompressionMethod == ZIPFILECOMPRESSION_DEFLATED)
+				cbBytesWritten = writeChunk(pByte, cbChunkSize);
 			else
-				cbBytesWritten = writeChunk(pByte, ZIPEXPORTWRITECHUNKSIZE);
+				cbBytesWritten = storeChunk(pByte, cbChunkSize);
 
 			if (cbBytesWritten == 0)
 				throw CNMRException(NMR_ERROR_COULDNOTDEFLATE);
 
 			cbCount -= cbBytesWritten;
+			pByte += cbBytesWritten;
 		}
 
 		return cbTotalBytesToWrite;
 	}
 
+	void CExportStream_ZIP::copyFrom(_In_ CImportStream * pImportStream, _In_ nfUint64 cbCount, _In_ nfUint32 cbBufferSize)
+	{
+		CImportStream_Deflated_Memory * pDeflatedStream = dynamic_cast<CImportStream_Deflated_Memory *> (pImportStream);
+		if ((pDeflatedStream != nullptr) && m_bIsInitialized && (m_nCompressionMethod == ZIPFILECOMPRESSION_DEFLATED) && (m_pStream.total_in == 0) &&
+			(pDeflatedStream->getPosition() == 0) && (pDeflatedStream->retrieveSize() == cbCount)) {
+
+			deflateEnd(&m_pStream);
+			m_bIsInitialized = false;
+			m_bHasDeflatedContent = true;
+
+			m_pZIPWriter->writeDeflatedContent(m_nEntryKey, pDeflatedStream->getDeflatedData(), pDeflatedStream->getDeflatedSize(), cbCount, pDeflatedStream->getCRC32());
+			pDeflatedStream->seekPosition(cbCount, true);
+
+			close();
+			return;
+		}
+
+		CExportStream::copyFrom(pImportStream, cbCount, cbBufferSize);
+	}
+
 	nfUint32 CExportStream_ZIP::writeChunk(_In_ const nfByte * pData, nfUint32 cbCount)
 	{
 		if ((pData == nullptr) || (cbCount == 0) || (cbCount > ZIPEXPORTWRITECHUNKSIZE))
@@ -158,11 +192,28 @@ namespace NMR {
 	}
 
 
+	nfUint32 CExportStream_ZIP::storeChunk(_In_ const nfByte * pData, nfUint32 cbCount)
+	{
+		if ((pData == nullptr) || (cbCount == 0) || (cbCount > ZIPEXPORTWRITECHUNKSIZE))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Stored entries pass their data through unchanged
+		m_pZIPWriter->calculateChecksum(m_nEntryKey, pData, cbCount);
+		m_pZIPWriter->writeDeflatedBuffer(m_nEntryKey, pData, cbCount);
+
+		return cbCount;
+	}
+
 	void CExportStream_ZIP::finishDeflate()
 	{
 		if (!m_bIsInitialized)
 			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
 
+		if (m_nCompressionMethod != ZIPFILECOMPRESSION_DEFLATED) {
+			m_bIsInitialized = false;
+			return;
+		}
+
 		m_pStream.next_in = nullptr;
 		m_pStream.avail_in = 0;
 
@@ -192,6 +243,9 @@ namespace NMR {
 
 	void CExportStream_ZIP::flushZIPStream()
 	{
+		if (m_bHasDeflatedContent)
+			return;
+
 		finishDeflate();
 	}
 
@@ -0,0 +1,116 @@
+/*++
+
+Copyright (C) 2018 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ImportStream_Chunked_Memory.cpp implements a memory import stream that reads the chunks of a
+memory export stream in place, without flattening or copying them.
+
+--*/
+
+#include "Common/Platform/NMR_ImportStream_Chunked_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
+#include "Common/Platform/NMR_Platform.h"
+#include "Common/NMR_Exception.h"
+#include "Common/NMR_StringUtils.h"
+
+#include <string>
+
+namespace NMR {
+
+	CImportStream_Chunked_Memory::CImportStream_Chunked_Memory(_In_ PExportStreamMemory pExportStream)
+	{
+		if (pExportStream.get() == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_pExportStream = pExportStream;
+		m_cbSize = m_pExportStream->getDataSize();
+		m_nPosition = 0;
+	}
+
+	nfUint64 CImportStream_Chunked_Memory::readBuffer(_In_ nfByte * pBuffer, _In_ nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll)
+	{
+		__NMRASSERT(m_nPosition <= m_cbSize);
+		nfUint64 cbBytesLeft = (m_cbSize - m_nPosition);
+		nfUint64 cbBytesToRead = cbTotalBytesToRead;
+
+		if (cbBytesToRead > cbBytesLeft)
+			cbBytesToRead = cbBytesLeft;
+
+		if (cbBytesToRead > 0) {
+			m_pExportStream->copyData(m_nPosition, cbBytesToRead, pBuffer);
+			m_nPosition += cbBytesToRead;
+		}
+
+		if ((cbBytesToRead != cbTotalBytesToRead) && bNeedsToReadAll)
+			throw CNMRException(NMR_ERROR_COULDNOTREADFULLDATA);
+
+		return cbBytesToRead;
+	}
+
+	void CImportStream_Chunked_Memory::writeToFile(_In_ const nfWChar * pwszFileName)
+	{
+		if (pwszFileName == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		std::string sUTF8FileName = fnUTF16toUTF8(pwszFileName);
+		PExportStream pExportStream = fnCreateExportStreamInstance(sUTF8FileName.c_str());
+
+		nfUint32 nChunkCount = m_pExportStream->getChunkCount();
+		for (nfUint32 nIndex = 0; nIndex < nChunkCount; nIndex++) {
+			nfUint64 cbChunkSize = 0;
+			const nfByte * pChunkData = m_pExportStream->getChunkData(nIndex, cbChunkSize);
+			pExportStream->writeBuffer(pChunkData, cbChunkSize);
+		}
+		pExportStream->close();
+	}
+
+	PImportStream CImportStream_Chunked_Memory::copyToMemory()
+	{
+		__NMRASSERT(m_nPosition <= m_cbSize);
+
+		return std::make_shared<CImportStream_Unique_Memory>(this, m_cbSize - m_nPosition, true);
+	}
+
+	const nfByte * CImportStream_Chunked_Memory::getAt(nfUint64 nPosition)
+	{
+		if (nPosition >= m_cbSize)
+			throw CNMRException(NMR_ERROR_COULDNOTREADSTREAM);
+
+		nfUint32 nChunkCount = m_pExportStream->getChunkCount();
+		nfUint64 nChunkStart = 0;
+		for (nfUint32 nIndex = 0; nIndex < nChunkCount; nIndex++) {
+			nfUint64 cbChunkSize = 0;
+			const nfByte * pChunkData = m_pExportStream->getChunkData(nIndex, cbChunkSize);
+			if (nPosition < nChunkStart + cbChunkSize)
+				return pChunkData + (nPosition - nChunkStart);
+			nChunkStart += cbChunkSize;
+		}
+
+		throw CNMRException(NMR_ERROR_COULDNOTREADSTREAM);
+	}
+
+}
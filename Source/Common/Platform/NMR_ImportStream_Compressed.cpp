@@ -100,13 +100,9 @@ namespace NMR {
 			(void)inflateEnd(&m_strm);
 			throw CNMRException(NMR_ERROR_COULDNOTINFLATE);
 		}
-		if (m_strm.avail_out == 0) {
-			nfBool reachedEndOfBuffer = m_strm.avail_in == 0;
-			if (reachedEndOfBuffer && ret != Z_STREAM_END) {
-				throw CNMRException(NMR_ERROR_COULDNOTINFLATE);
-			}
+		// The output can be full exactly when the input chunk is used up. The next call then reads on.
+		if (m_strm.avail_out == 0)
 			return cbTotalBytesToRead;
-		}
 
 		nfUint64 bytesDecompressed = cbTotalBytesToRead - m_strm.avail_out;
 		return readBuffer(pBuffer + bytesDecompressed, m_strm.avail_out, bNeedsToReadAll) + bytesDecompressed;
@@ -0,0 +1,159 @@
+/*++
+
+Copyright (C) 2018 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ImportStream_Deflated_Memory.cpp implements the CImportStream_Deflated_Memory Class.
+This is a memory stream that keeps the raw deflated data of a ZIP entry and only inflates
+it when the stream is read. A ZIP writer can copy the deflated data verbatim instead.
+
+--*/
+
+#include "Common/Platform/NMR_ImportStream_Deflated_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
+#include "Common/NMR_Exception.h"
+#include "Libraries/zlib/zlib.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace NMR {
+
+	CImportStream_Deflated_Memory::CImportStream_Deflated_Memory(_In_ std::vector<nfByte> && DeflatedBuffer, _In_ nfUint64 cbInflatedSize, _In_ nfUint32 nCRC32)
+		: m_DeflatedBuffer(std::move(DeflatedBuffer)), m_nCRC32(nCRC32), m_bIsInflated(false), m_cbMaxInflateStep(UINT_MAX)
+	{
+		if (cbInflatedSize > NMR_IMPORTSTREAM_MAXMEMSTREAMSIZE)
+			throw CNMRException(NMR_ERROR_INVALIDBUFFERSIZE);
+
+		m_cbSize = cbInflatedSize;
+		m_nPosition = 0;
+	}
+
+	const nfByte * CImportStream_Deflated_Memory::getDeflatedData()
+	{
+		return m_DeflatedBuffer.data();
+	}
+
+	nfUint64 CImportStream_Deflated_Memory::getDeflatedSize()
+	{
+		return m_DeflatedBuffer.size();
+	}
+
+	nfUint32 CImportStream_Deflated_Memory::getCRC32()
+	{
+		return m_nCRC32;
+	}
+
+	void CImportStream_Deflated_Memory::ensureInflated()
+	{
+		if (!m_bIsInflated)
+			inflateBuffer();
+	}
+
+	PImportStream CImportStream_Deflated_Memory::copyToMemory()
+	{
+		__NMRASSERT(m_nPosition <= m_cbSize);
+
+		if (m_nPosition == 0) {
+			std::vector<nfByte> DeflatedBuffer(m_DeflatedBuffer);
+			return std::make_shared<CImportStream_Deflated_Memory>(std::move(DeflatedBuffer), m_cbSize, m_nCRC32);
+		}
+
+		return std::make_shared<CImportStream_Unique_Memory>(this, m_cbSize - m_nPosition, true);
+	}
+
+	void CImportStream_Deflated_Memory::inflateBuffer()
+	{
+		try {
+			m_Buffer.resize((size_t)m_cbSize);
+		}
+		catch (std::bad_alloc&) {
+			throw CNMRException(NMR_ERROR_INVALIDBUFFERSIZE);
+		}
+
+		z_stream Stream;
+		Stream.zalloc = nullptr;
+		Stream.zfree = nullptr;
+		Stream.opaque = nullptr;
+		Stream.next_in = nullptr;
+		Stream.avail_in = 0;
+		Stream.next_out = nullptr;
+		Stream.avail_out = 0;
+		if (inflateInit2(&Stream, -15) != Z_OK)
+			throw CNMRException(NMR_ERROR_COULDNOTINITINFLATE);
+
+		// Large entries are inflated in several steps
+		nfUint64 cbInputLeft = m_DeflatedBuffer.size();
+		nfUint64 cbOutputLeft = m_cbSize;
+		Stream.next_in = m_DeflatedBuffer.data();
+		Stream.next_out = m_Buffer.data();
+		nfUint32 nCRC32 = crc32(0, Z_NULL, 0);
+
+		nfInt32 nResult = Z_OK;
+		while (nResult == Z_OK) {
+			if (Stream.avail_in == 0) {
+				Stream.avail_in = (uInt)std::min(cbInputLeft, m_cbMaxInflateStep);
+				cbInputLeft -= Stream.avail_in;
+			}
+			if (Stream.avail_out == 0) {
+				Stream.avail_out = (uInt)std::min(cbOutputLeft, m_cbMaxInflateStep);
+				cbOutputLeft -= Stream.avail_out;
+			}
+
+			Bytef * pOutput = Stream.next_out;
+			nResult = inflate(&Stream, Z_NO_FLUSH);
+			nCRC32 = crc32(nCRC32, pOutput, (uInt)(Stream.next_out - pOutput));
+
+			// Z_BUF_ERROR means that no progress was possible. Go on only if an exhausted buffer
+			// can be refilled, otherwise the entry is truncated or larger than its declared size.
+			if (nResult == Z_BUF_ERROR) {
+				nfBool bCanRefillInput = (Stream.avail_in == 0) && (cbInputLeft > 0);
+				nfBool bCanRefillOutput = (Stream.avail_out == 0) && (cbOutputLeft > 0);
+				if (bCanRefillInput || bCanRefillOutput)
+					nResult = Z_OK;
+			}
+		}
+		nfUint64 cbInflated = m_cbSize - cbOutputLeft - Stream.avail_out;
+		inflateEnd(&Stream);
+
+		if ((nResult != Z_STREAM_END) || (cbInflated != m_cbSize) || (nCRC32 != m_nCRC32))
+			throw CNMRException(NMR_ERROR_COULDNOTINFLATE);
+
+		m_bIsInflated = true;
+	}
+
+	const nfByte * CImportStream_Deflated_Memory::getAt(nfUint64 nPosition)
+	{
+		if (nPosition >= m_cbSize)
+			throw CNMRException(NMR_ERROR_COULDNOTREADSTREAM);
+
+		if (!m_bIsInflated)
+			inflateBuffer();
+
+		return &m_Buffer[(size_t)nPosition];
+	}
+
+}
@@ -33,6 +33,7 @@ Abstract: This is a stub class implementation of CImportStream_Encrypted
 #include "Common/NMR_Exception.h"
 #include <vector>
 #include <array>
+#include <algorithm>
 namespace NMR {
 	CImportStream_Encrypted::CImportStream_Encrypted(PImportStream pEncryptedStream, ContentEncryptionDescriptor pDecryptContext)
 		:m_pEncryptedStream(pEncryptedStream), m_pDecryptContext(pDecryptContext)
@@ -60,14 +61,25 @@ namespace NMR {
 	}
 
 	nfUint64 CImportStream_Encrypted::readBuffer(nfByte * pBuffer, nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll) {
-		std::vector<nfByte> decBuffer(cbTotalBytesToRead, 0);
-		nfUint64 bytesRead = m_pEncryptedStream->readBuffer(decBuffer.data(), cbTotalBytesToRead, bNeedsToReadAll);
-		if (bytesRead > 0) {
-			nfUint64 decryted = m_pDecryptContext.m_fnCrypt(bytesRead, decBuffer.data(), pBuffer, m_pDecryptContext.m_sDekDecryptData);
-			if (decryted != bytesRead)
-				throw CNMRException(NMR_ERROR_CALCULATIONTERMINATED);
+		// Decrypt in chunks of bounded size, so that the scratch buffer does not grow with the request size
+		nfUint64 cbTotalBytesRead = 0;
+		while (cbTotalBytesRead < cbTotalBytesToRead) {
+			nfUint64 cbChunkSize = std::min(cbTotalBytesToRead - cbTotalBytesRead, (nfUint64)NMR_IMPORTSTREAM_READBUFFERSIZE);
+			if (m_EncryptedBuffer.size() < cbChunkSize)
+				m_EncryptedBuffer.resize((size_t)cbChunkSize);
+
+			nfUint64 bytesRead = m_pEncryptedStream->readBuffer(m_EncryptedBuffer.data(), cbChunkSize, bNeedsToReadAll);
+			if (bytesRead > 0) {
+				nfUint64 decryted = m_pDecryptContext.m_fnCrypt(bytesRead, m_EncryptedBuffer.data(), pBuffer + cbTotalBytesRead, m_pDecryptContext.m_sDekDecryptData);
+				if (decryted != bytesRead)
+					throw CNMRException(NMR_ERROR_CALCULATIONTERMINATED);
+			}
+			cbTotalBytesRead += bytesRead;
+
+			if (bytesRead < cbChunkSize)
+				break;
 		}
-		return bytesRead;
+		return cbTotalBytesRead;
 	}
 
 	nfUint64 CImportStream_Encrypted::retrieveSize() {
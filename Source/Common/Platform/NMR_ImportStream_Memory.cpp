@@ -38,6 +38,7 @@ This is an abstract platform independent class for keeping data in a memory stre
 #include "Common/NMR_StringUtils.h"
 
 #include <string>
+#include <cstring>
 
 namespace NMR {
 
@@ -99,17 +100,7 @@ namespace NMR {
 			cbBytesToRead = cbBytesLeft;
 
 		if (cbBytesToRead > 0) {
-			nfUint64 nIndex = cbBytesToRead;
-			const nfByte * pSource = getAt(m_nPosition);
-			nfByte * pTarget = pBuffer;
-
-			while (nIndex > 0) {
-				*pTarget = *pSource;
-				nIndex--;
-				pSource++;
-				pTarget++;
-			}
-
+			memcpy(pBuffer, getAt(m_nPosition), (size_t)cbBytesToRead);
 			m_nPosition += cbBytesToRead;
 		}
 
@@ -135,5 +126,6 @@ namespace NMR {
 		if (m_cbSize > 0) {
 			pExportStream->writeBuffer(getAt(0), m_cbSize);
 		}
+		pExportStream->close();
 	}
 }
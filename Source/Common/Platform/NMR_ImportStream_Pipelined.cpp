@@ -0,0 +1,244 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ImportStream_Pipelined.cpp implements the CImportStream_Pipelined Class.
+This is a stream class that reads ahead from another stream on a background thread
+into a ring of buffers, so that inflating and decrypting overlaps with parsing.
+
+--*/
+
+#include "Common/Platform/NMR_ImportStream_Pipelined.h"
+#include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
+#include "Common/NMR_Exception.h"
+#include "Common/NMR_Exception_Windows.h"
+#include <cstring>
+#include <algorithm>
+
+namespace NMR {
+
+	CImportStream_Pipelined::CImportStream_Pipelined(_In_ PImportStream pSourceStream, _In_ nfUint32 nBufferCount, _In_ nfUint32 cbBufferSize)
+	{
+		if (pSourceStream.get() == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if ((nBufferCount < 2) || (cbBufferSize == 0))
+			throw CNMRException(NMR_ERROR_INVALIDBUFFERSIZE);
+
+		m_pSourceStream = pSourceStream;
+		// The source stream must not be touched by this thread once reading ahead has started
+		m_nSize = pSourceStream->retrieveSize();
+		m_nPosition = 0;
+
+		m_Buffers.resize(nBufferCount);
+		for (auto & buffer : m_Buffers)
+			buffer.resize(cbBufferSize);
+		m_BufferSizes.resize(nBufferCount, 0);
+		m_nReadBuffer = 0;
+		m_nReadOffset = 0;
+		m_nFilledBufferCount = 0;
+
+		m_bSourceFinished = false;
+		m_bStopRequested = false;
+
+		m_Thread = std::thread(&CImportStream_Pipelined::readAhead, this);
+	}
+
+	CImportStream_Pipelined::~CImportStream_Pipelined()
+	{
+		stopReading();
+	}
+
+	void CImportStream_Pipelined::stopReading()
+	{
+		{
+			std::lock_guard<std::mutex> guard(m_Mutex);
+			m_bStopRequested = true;
+		}
+		m_BufferConsumed.notify_all();
+
+		if (m_Thread.joinable())
+			m_Thread.join();
+
+		// Data that has already been read ahead stays available
+		std::lock_guard<std::mutex> guard(m_Mutex);
+		m_bSourceFinished = true;
+	}
+
+	nfBool CImportStream_Pipelined::isPipeliningBeneficial(_In_ nfUint64 nStreamSize)
+	{
+		return (nStreamSize >= NMR_IMPORTSTREAM_PIPELINEMINSIZE) && (std::thread::hardware_concurrency() > 1);
+	}
+
+	void CImportStream_Pipelined::readAhead()
+	{
+		nfUint32 nBufferCount = (nfUint32)m_Buffers.size();
+		nfUint32 nWriteBuffer = 0;
+
+		try {
+			while (true) {
+				{
+					std::unique_lock<std::mutex> lock(m_Mutex);
+					m_BufferConsumed.wait(lock, [this, nBufferCount] { return m_bStopRequested || (m_nFilledBufferCount < nBufferCount); });
+					if (m_bStopRequested)
+						break;
+				}
+
+				// The write buffer is owned by this thread until it is counted as filled
+				std::vector<nfByte> & buffer = m_Buffers[nWriteBuffer];
+				nfUint64 cbBytesRead = m_pSourceStream->readBuffer(buffer.data(), buffer.size(), false);
+
+				{
+					std::lock_guard<std::mutex> guard(m_Mutex);
+					if (cbBytesRead > 0) {
+						m_BufferSizes[nWriteBuffer] = cbBytesRead;
+						m_nFilledBufferCount++;
+						nWriteBuffer = (nWriteBuffer + 1) % nBufferCount;
+					}
+					if (cbBytesRead < buffer.size())
+						m_bSourceFinished = true;
+				}
+				m_BufferFilled.notify_one();
+
+				if (cbBytesRead < buffer.size())
+					break;
+			}
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> guard(m_Mutex);
+			m_pSourceException = std::current_exception();
+			m_bSourceFinished = true;
+		}
+
+		m_BufferFilled.notify_one();
+	}
+
+	nfUint64 CImportStream_Pipelined::readBuffer(_In_ nfByte * pBuffer, _In_ nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll)
+	{
+		if (pBuffer == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nBufferCount = (nfUint32)m_Buffers.size();
+		nfUint64 cbBytesRead = 0;
+
+		while (cbBytesRead < cbTotalBytesToRead) {
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_BufferFilled.wait(lock, [this] { return (m_nFilledBufferCount > 0) || m_bSourceFinished; });
+
+				if (m_nFilledBufferCount == 0) {
+					if (m_pSourceException)
+						std::rethrow_exception(m_pSourceException);
+					break;
+				}
+			}
+
+			// The read buffer is owned by this thread while it is counted as filled
+			nfUint64 cbAvailable = m_BufferSizes[m_nReadBuffer] - m_nReadOffset;
+			nfUint64 cbToCopy = std::min(cbAvailable, cbTotalBytesToRead - cbBytesRead);
+			memcpy(pBuffer + cbBytesRead, m_Buffers[m_nReadBuffer].data() + m_nReadOffset, (size_t)cbToCopy);
+			cbBytesRead += cbToCopy;
+			m_nReadOffset += cbToCopy;
+
+			if (m_nReadOffset == m_BufferSizes[m_nReadBuffer]) {
+				m_nReadBuffer = (m_nReadBuffer + 1) % nBufferCount;
+				m_nReadOffset = 0;
+				{
+					std::lock_guard<std::mutex> guard(m_Mutex);
+					m_nFilledBufferCount--;
+				}
+				m_BufferConsumed.notify_one();
+			}
+		}
+
+		m_nPosition += cbBytesRead;
+
+		if ((cbBytesRead != cbTotalBytesToRead) && bNeedsToReadAll)
+			throw CNMRException(NMR_ERROR_COULDNOTREADFULLDATA);
+
+		return cbBytesRead;
+	}
+
+	nfBool CImportStream_Pipelined::seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed)
+	{
+		if (position == m_nPosition)
+			return true;
+		if (bHasToSucceed)
+			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+		return false;
+	}
+
+	nfBool CImportStream_Pipelined::seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		// Forward seeks are served by skipping over the buffered data
+		std::vector<nfByte> skipBuffer((size_t)std::min(bytes, (nfUint64)NMR_IMPORTSTREAM_READBUFFERSIZE));
+		nfUint64 cbBytesLeft = bytes;
+		while (cbBytesLeft > 0) {
+			nfUint64 cbToSkip = std::min(cbBytesLeft, (nfUint64)skipBuffer.size());
+			nfUint64 cbSkipped = readBuffer(skipBuffer.data(), cbToSkip, false);
+			cbBytesLeft -= cbSkipped;
+			if (cbSkipped < cbToSkip)
+				break;
+		}
+
+		if (cbBytesLeft > 0) {
+			if (bHasToSucceed)
+				throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+			return false;
+		}
+		return true;
+	}
+
+	nfBool CImportStream_Pipelined::seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		if (bHasToSucceed)
+			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+		return false;
+	}
+
+	nfUint64 CImportStream_Pipelined::retrieveSize()
+	{
+		return m_nSize;
+	}
+
+	void CImportStream_Pipelined::writeToFile(_In_ const nfWChar * pwszFileName)
+	{
+		throw CNMRException(NMR_ERROR_NOTIMPLEMENTED);
+	}
+
+	PImportStream CImportStream_Pipelined::copyToMemory()
+	{
+		nfUint64 cbStreamSize = retrieveSize();
+
+		return std::make_shared<CImportStream_Unique_Memory>(this, cbStreamSize, false);
+	}
+
+	nfUint64 CImportStream_Pipelined::getPosition()
+	{
+		return m_nPosition;
+	}
+
+}
@@ -35,6 +35,8 @@ This is a platform independent class for keeping data in a memory stream that ow
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
 
+#include <cstring>
+
 namespace NMR {
 
 	CImportStream_Unique_Memory::CImportStream_Unique_Memory()
@@ -103,17 +105,8 @@ namespace NMR {
 		m_cbSize = cbBytes;
 		m_nPosition = 0;
 
-		const nfByte * pSource = pBuffer;
-		nfByte * pTarget = &m_Buffer[0];
-
-		nfUint64 nIndex = cbBytes;
-		while (nIndex > 0) {
-			*pTarget = *pSource;
-
-			pSource++;
-			pTarget++;
-			nIndex--;
-		}
+		if (cbBytes > 0)
+			memcpy(&m_Buffer[0], pBuffer, (size_t)cbBytes);
 	}	
 
 	PImportStream CImportStream_Unique_Memory::copyToMemory()
@@ -33,6 +33,7 @@ This is a stream class for importing from a libZIP object.
 
 #include "Common/Platform/NMR_ImportStream_ZIP.h"
 #include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Deflated_Memory.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
 #include <math.h>
@@ -47,6 +48,16 @@ namespace NMR {
 
 		m_pFile = pFile;
 		m_nSize = nSize;
+		m_pArchive = nullptr;
+		m_nIndex = 0;
+		m_bHasBeenRead = false;
+	}
+
+	CImportStream_ZIP::CImportStream_ZIP(_In_ zip_file_t * pFile, _In_ nfUint64 nSize, _In_ zip_t * pArchive, _In_ nfUint64 nIndex)
+		: CImportStream_ZIP(pFile, nSize)
+	{
+		m_pArchive = pArchive;
+		m_nIndex = nIndex;
 	}
 
 	CImportStream_ZIP::~CImportStream_ZIP()
@@ -80,6 +91,7 @@ namespace NMR {
 	{
 		nfUint64 cbBytesLeft = cbTotalBytesToRead;
 		nfUint64 cbBytesRead = 0;
+		m_bHasBeenRead = true;
 
 		_In_ nfByte * pData = pBuffer;
 		while (cbBytesLeft > 0) {
@@ -124,10 +136,46 @@ namespace NMR {
 
 	PImportStream CImportStream_ZIP::copyToMemory()
 	{
+		if ((m_pArchive != nullptr) && !m_bHasBeenRead) {
+			PImportStream pStream = copyDeflatedToMemory();
+			if (pStream.get() != nullptr)
+				return pStream;
+		}
+
 		nfUint64 cbStreamSize = retrieveSize();
 
 		return std::make_shared<CImportStream_Unique_Memory>(this, cbStreamSize, false);
 	}
 
 
+	PImportStream CImportStream_ZIP::copyDeflatedToMemory()
+	{
+		zip_stat_t Stat;
+		if (zip_stat_index(m_pArchive, m_nIndex, ZIP_FL_UNCHANGED, &Stat) != 0)
+			throw CNMRException(NMR_ERROR_COULDNOTSTATZIPENTRY);
+
+		zip_uint64_t nRequiredFields = ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_CRC | ZIP_STAT_COMP_METHOD | ZIP_STAT_ENCRYPTION_METHOD;
+		if (((Stat.valid & nRequiredFields) != nRequiredFields) || (Stat.comp_method != ZIP_CM_DEFLATE) || (Stat.encryption_method != ZIP_EM_NONE))
+			return nullptr;
+		if ((Stat.size != m_nSize) || (Stat.comp_size > NMR_IMPORTSTREAM_MAXMEMSTREAMSIZE))
+			return nullptr;
+
+		std::vector<nfByte> DeflatedBuffer;
+		try {
+			DeflatedBuffer.resize((size_t)Stat.comp_size);
+		}
+		catch (std::bad_alloc&) {
+			throw CNMRException(NMR_ERROR_INVALIDBUFFERSIZE);
+		}
+
+		zip_file_t * pFile = zip_fopen_index(m_pArchive, m_nIndex, ZIP_FL_UNCHANGED | ZIP_FL_COMPRESSED);
+		if (pFile == nullptr)
+			throw CNMRException(NMR_ERROR_COULDNOTOPENZIPENTRY);
+
+		CImportStream_ZIP DeflatedStream(pFile, Stat.comp_size);
+		DeflatedStream.readBuffer(DeflatedBuffer.data(), Stat.comp_size, true);
+
+		return std::make_shared<CImportStream_Deflated_Memory>(std::move(DeflatedBuffer), Stat.size, Stat.crc);
+	}
+
 }
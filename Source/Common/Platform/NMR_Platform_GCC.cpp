@@ -41,6 +41,7 @@ specific classes for GCC.
 #include "Common/Platform/NMR_ExportStream_GCC_Win32.h"
 #include "Common/Platform/NMR_ImportStream_GCC_Native.h"
 #include "Common/Platform/NMR_ExportStream_GCC_Native.h"
+#include "Common/Platform/NMR_ExportStream_GCC_POSIX.h"
 #include "Common/Platform/NMR_XmlReader_Native.h"
 #include "Common/NMR_StringUtils.h"
 
@@ -54,9 +55,22 @@ namespace NMR {
 	}
 
 	PExportStream fnCreateExportStreamInstance (_In_ const nfChar * pszFileName)
+	{
+		EXPORTSTREAMFILEOPTIONS Options;
+		Options.m_nSizeHint = 0;
+		Options.m_bDropWrittenPages = false;
+		Options.m_bDirectIO = false;
+		return fnCreateExportStreamInstance(pszFileName, Options);
+	}
+
+	PExportStream fnCreateExportStreamInstance (_In_ const nfChar * pszFileName, _In_ const EXPORTSTREAMFILEOPTIONS & Options)
 	{
 		std::wstring sFileName = fnUTF8toUTF16(pszFileName);
+#ifndef _WIN32
+		return std::make_shared<CExportStream_GCC_POSIX> (sFileName.c_str(), Options);
+#else
 		return std::make_shared<CExportStream_GCC_Native> (sFileName.c_str());
+#endif // _WIN32
 	}
 
 	PXmlReader fnCreateXMLReaderInstance (_In_ PImportStream pImportStream, PProgressMonitor pProgressMonitor)
@@ -37,7 +37,7 @@ NMR_PortableZIPWriter.cpp implements a portable and fast writer of ZIP files
 
 namespace NMR {
 
-	CPortableZIPWriter::CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64)
+	CPortableZIPWriter::CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64, _In_ nfBool bWriteDataDescriptors)
 	{
 		if (pExportStream.get() == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
@@ -48,6 +48,10 @@ namespace NMR {
 		m_pCurrentEntry = nullptr;
 		m_bIsFinished = false;
 		m_bWriteZIP64 = bWriteZIP64;
+		m_bWriteDataDescriptors = bWriteDataDescriptors;
+		m_nGeneralPurposeFlags = 0;
+		if (m_bWriteDataDescriptors)
+			m_nGeneralPurposeFlags |= ZIPFILEGENERALPURPOSEFLAG_DATADESCRIPTOR;
 
 		if (m_bWriteZIP64) {
 			m_nVersionMade = ZIPFILEVERSIONNEEDEDZIP64;
@@ -69,10 +73,21 @@ namespace NMR {
 			writeDirectory();
 	}
 
-	PExportStream CPortableZIPWriter::createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp)
+	PExportStream CPortableZIPWriter::createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp, _In_ nfUint16 nCompressionMethod, _In_ nfInt32 nCompressionLevel)
 	{
 		if (m_bIsFinished)
 			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
+		if ((nCompressionMethod != ZIPFILECOMPRESSION_UNCOMPRESSED) && (nCompressionMethod != ZIPFILECOMPRESSION_DEFLATED))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if ((nCompressionLevel < 0) || (nCompressionLevel > ZIPFILECOMPRESSIONLEVEL_MAX))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Streaming readers cannot find the end of a stored entry whose sizes follow in a data descriptor.
+		// Deflate level 0 emits stored blocks instead, which costs next to nothing on top of copying.
+		if (m_bWriteDataDescriptors && (nCompressionMethod == ZIPFILECOMPRESSION_UNCOMPRESSED)) {
+			nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
+			nCompressionLevel = 0;
+		}
 		// Finish old entry state
 		closeEntry();
 
@@ -98,8 +113,8 @@ namespace NMR {
 		ZIPLOCALFILEHEADER LocalHeader;
 		LocalHeader.m_nSignature = ZIPFILEHEADERSIGNATURE;
 		LocalHeader.m_nVersion = m_nVersionNeeded;
-		LocalHeader.m_nGeneralPurposeFlags = 0;
-		LocalHeader.m_nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
+		LocalHeader.m_nGeneralPurposeFlags = m_nGeneralPurposeFlags;
+		LocalHeader.m_nCompressionMethod = nCompressionMethod;
 		LocalHeader.m_nLastModTime = nLastModTime;
 		LocalHeader.m_nLastModDate = nLastModDate;
 		LocalHeader.m_nCRC32 = 0;
@@ -139,11 +154,11 @@ namespace NMR {
 		nfUint64 nDataPosition = m_pExportStream->getPosition();
 
 		// create list entry
-		m_pCurrentEntry = std::make_shared<CPortableZIPWriterEntry>(sUTF8Name, nLastModTime, nLastModDate, nFilePosition, nExtInfoPosition, nDataPosition);
+		m_pCurrentEntry = std::make_shared<CPortableZIPWriterEntry>(sUTF8Name, nLastModTime, nLastModDate, nFilePosition, nExtInfoPosition, nDataPosition, nCompressionMethod);
 		m_Entries.push_back(m_pCurrentEntry);
 
 		// Return new ZIP Entry stream
-		m_pCurrentStream = std::make_shared<CExportStream_ZIP>(this, m_nCurrentEntryKey);
+		m_pCurrentStream = std::make_shared<CExportStream_ZIP>(this, m_nCurrentEntryKey, nCompressionMethod, nCompressionLevel);
 		return m_pCurrentStream;
 	}
 
@@ -159,54 +174,102 @@ namespace NMR {
 				throw CNMRException(NMR_ERROR_NOEXPORTSTREAM);
 			pZipStream->flushZIPStream();
 
-			// Write CRC and Size
-			ZIPLOCALFILEDESCRIPTOR FileDescriptor;
-			FileDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
-			if (m_bWriteZIP64) {
-				FileDescriptor.m_nCompressedSize =0xFFFFFFFF;
-				FileDescriptor.m_nUnCompressedSize = 0xFFFFFFFF;
+			if (m_bWriteDataDescriptors) {
+				writeDataDescriptor();
 			}
 			else {
-				if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
-					(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
-					throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
-				FileDescriptor.m_nCompressedSize = (nfUint32)m_pCurrentEntry->getCompressedSize();
-				FileDescriptor.m_nUnCompressedSize = (nfUint32)m_pCurrentEntry->getUncompressedSize();
+				patchLocalHeader();
 			}
+		}
+
+		m_pCurrentStream = nullptr;
+		m_pCurrentEntry = nullptr;
+		m_nCurrentEntryKey = 0;
+	}
+
+	void CPortableZIPWriter::writeDataDescriptor()
+	{
+		__NMRASSERT(m_pCurrentEntry.get() != nullptr);
+
+		if (m_bWriteZIP64) {
+			ZIP64DATADESCRIPTOR DataDescriptor;
+			DataDescriptor.m_nSignature = ZIPFILEDATADESCRIPTORSIGNATURE;
+			DataDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
+			DataDescriptor.m_nCompressedSize = m_pCurrentEntry->getCompressedSize();
+			DataDescriptor.m_nUnCompressedSize = m_pCurrentEntry->getUncompressedSize();
 
-			ZIP64EXTRAINFORMATIONFIELD zip64ExtraInformation;
-			zip64ExtraInformation.m_nTag = ZIPFILEDATAZIP64EXTENDEDINFORMATIONEXTRAFIELD;
-			zip64ExtraInformation.m_nFieldSize = sizeof(ZIP64EXTRAINFORMATIONFIELD) - 4;
-			zip64ExtraInformation.m_nCompressedSize = m_pCurrentEntry->getCompressedSize();
-			zip64ExtraInformation.m_nUncompressedSize = m_pCurrentEntry->getUncompressedSize();
-			
-			// Write File Descriptor to file
-			m_pExportStream->seekPosition(m_pCurrentEntry->getFilePosition() + ZIPFILEDESCRIPTOROFFSET, true);
-			
 			// prepare byte-buffer for big-endian machines
 			if (isBigEndian()) {
-				FileDescriptor.swapByteOrder();
+				DataDescriptor.swapByteOrder();
 			}
-			m_pExportStream->writeBuffer(&FileDescriptor, sizeof(FileDescriptor));
+			m_pExportStream->writeBuffer(&DataDescriptor, sizeof(DataDescriptor));
+		}
+		else {
+			if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
+				(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
+				throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
 
-			if (m_bWriteZIP64) {
-				// Write Extra Information to file
-				m_pExportStream->seekPosition(m_pCurrentEntry->getExtInfoPosition(), true);
+			ZIPDATADESCRIPTOR DataDescriptor;
+			DataDescriptor.m_nSignature = ZIPFILEDATADESCRIPTORSIGNATURE;
+			DataDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
+			DataDescriptor.m_nCompressedSize = (nfUint32)m_pCurrentEntry->getCompressedSize();
+			DataDescriptor.m_nUnCompressedSize = (nfUint32)m_pCurrentEntry->getUncompressedSize();
 
-				// prepare byte-buffer for big-endian machines
-				if (isBigEndian()) {
-					zip64ExtraInformation.swapByteOrder();
-				}
-				m_pExportStream->writeBuffer(&zip64ExtraInformation, sizeof(zip64ExtraInformation));
+			// prepare byte-buffer for big-endian machines
+			if (isBigEndian()) {
+				DataDescriptor.swapByteOrder();
 			}
+			m_pExportStream->writeBuffer(&DataDescriptor, sizeof(DataDescriptor));
+		}
+	}
+
+	void CPortableZIPWriter::patchLocalHeader()
+	{
+		__NMRASSERT(m_pCurrentEntry.get() != nullptr);
+
+		// Write CRC and Size
+		ZIPLOCALFILEDESCRIPTOR FileDescriptor;
+		FileDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
+		if (m_bWriteZIP64) {
+			FileDescriptor.m_nCompressedSize =0xFFFFFFFF;
+			FileDescriptor.m_nUnCompressedSize = 0xFFFFFFFF;
+		}
+		else {
+			if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
+				(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
+				throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
+			FileDescriptor.m_nCompressedSize = (nfUint32)m_pCurrentEntry->getCompressedSize();
+			FileDescriptor.m_nUnCompressedSize = (nfUint32)m_pCurrentEntry->getUncompressedSize();
+		}
 
-			// Reset file pointer
-			m_pExportStream->seekFromEnd(0, true);
+		ZIP64EXTRAINFORMATIONFIELD zip64ExtraInformation;
+		zip64ExtraInformation.m_nTag = ZIPFILEDATAZIP64EXTENDEDINFORMATIONEXTRAFIELD;
+		zip64ExtraInformation.m_nFieldSize = sizeof(ZIP64EXTRAINFORMATIONFIELD) - 4;
+		zip64ExtraInformation.m_nCompressedSize = m_pCurrentEntry->getCompressedSize();
+		zip64ExtraInformation.m_nUncompressedSize = m_pCurrentEntry->getUncompressedSize();
+		
+		// Write File Descriptor to file
+		m_pExportStream->seekPosition(m_pCurrentEntry->getFilePosition() + ZIPFILEDESCRIPTOROFFSET, true);
+		
+		// prepare byte-buffer for big-endian machines
+		if (isBigEndian()) {
+			FileDescriptor.swapByteOrder();
 		}
+		m_pExportStream->writeBuffer(&FileDescriptor, sizeof(FileDescriptor));
 
-		m_pCurrentStream = nullptr;
-		m_pCurrentEntry = nullptr;
-		m_nCurrentEntryKey = 0;
+		if (m_bWriteZIP64) {
+			// Write Extra Information to file
+			m_pExportStream->seekPosition(m_pCurrentEntry->getExtInfoPosition(), true);
+
+			// prepare byte-buffer for big-endian machines
+			if (isBigEndian()) {
+				zip64ExtraInformation.swapByteOrder();
+			}
+			m_pExportStream->writeBuffer(&zip64ExtraInformation, sizeof(zip64ExtraInformation));
+		}
+
+		// Reset file pointer
+		m_pExportStream->seekFromEnd(0, true);
 	}
 
 	void CPortableZIPWriter::calculateChecksum(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbUncompressedBytes)
@@ -244,6 +307,22 @@ namespace NMR {
 		}
 	}
 
+	void CPortableZIPWriter::writeDeflatedContent(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint64 cbCompressedBytes, _In_ nfUint64 cbUncompressedBytes, _In_ nfUint32 nCRC32)
+	{
+		if (m_pCurrentEntry.get() == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDZIPENTRY);
+
+		if ((pBuffer == nullptr) && (cbCompressedBytes > 0))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		if (nEntryKey != m_nCurrentEntryKey)
+			throw CNMRException(NMR_ERROR_INVALIDZIPENTRYKEY);
+
+		m_pCurrentEntry->setDeflatedContent(nCRC32, cbCompressedBytes, cbUncompressedBytes);
+		if (cbCompressedBytes > 0)
+			m_pExportStream->writeBuffer(pBuffer, cbCompressedBytes);
+	}
+
 	nfUint64 CPortableZIPWriter::getCurrentSize(_In_ nfUint32 nEntryKey)
 	{
 		if (m_pCurrentEntry.get() == nullptr)
@@ -270,8 +349,8 @@ namespace NMR {
 			DirectoryHeader.m_nSignature = ZIPFILECENTRALHEADERSIGNATURE;
 			DirectoryHeader.m_nVersionMade = m_nVersionMade;
 			DirectoryHeader.m_nVersionNeeded = m_nVersionNeeded;
-			DirectoryHeader.m_nGeneralPurposeFlags = 0;
-			DirectoryHeader.m_nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
+			DirectoryHeader.m_nGeneralPurposeFlags = m_nGeneralPurposeFlags;
+			DirectoryHeader.m_nCompressionMethod = pEntry->getCompressionMethod();
 			DirectoryHeader.m_nLastModTime = pEntry->getLastModTime();
 			DirectoryHeader.m_nLastModDate = pEntry->getLastModDate();
 			DirectoryHeader.m_nCRC32 = pEntry->getCRC32();
@@ -293,8 +372,8 @@ namespace NMR {
 				DirectoryHeader.m_nRelativeOffsetOfLocalHeader = 0xFFFFFFFF;
 			}
 			else {
-				if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
-					(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
+				if ((pEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
+					(pEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
 					throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
 				DirectoryHeader.m_nCompressedSize = (nfUint32)pEntry->getCompressedSize();
 				DirectoryHeader.m_nUnCompressedSize = (nfUint32)pEntry->getUncompressedSize();
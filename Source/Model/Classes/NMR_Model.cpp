@@ -34,6 +34,7 @@ A model is an in memory representation of the 3MF file.
 #include "Model/Classes/NMR_Model.h"
 #include "Model/Classes/NMR_ModelObject.h"
 #include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelComponentsObject.h"
 #include "Model/Classes/NMR_ModelConstants.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_ModelAttachment.h"
@@ -58,6 +59,7 @@ A model is an in memory representation of the 3MF file.
 #include <random>
 #include <mutex>
 #include <array>
+#include <algorithm>
 
 #include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_SliceRefModel.h"
 #include "Common/Platform/NMR_XmlReader.h"
@@ -70,6 +72,27 @@ A model is an in memory representation of the 3MF file.
 
 namespace NMR {
 
+	static eModelResourceType fnGetModelResourceType(_In_ CModelResource * pResource)
+	{
+		if (dynamic_cast<CModelObject *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_OBJECT;
+		if (dynamic_cast<CModelBaseMaterialResource *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_BASEMATERIALS;
+		if (dynamic_cast<CModelColorGroupResource *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_COLORGROUP;
+		if (dynamic_cast<CModelTexture2DResource *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_TEXTURE2D;
+		if (dynamic_cast<CModelTexture2DGroupResource *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_TEXTURE2DGROUP;
+		if (dynamic_cast<CModelCompositeMaterialsResource *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_COMPOSITEMATERIALS;
+		if (dynamic_cast<CModelMultiPropertyGroupResource *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_MULTIPROPERTYGROUP;
+		if (dynamic_cast<CModelSliceStack *> (pResource) != nullptr)
+			return MODELRESOURCETYPE_SLICESTACK;
+		return MODELRESOURCETYPE_OTHER;
+	}
+
 	CModel::CModel()
 	{
 		m_Unit = MODELUNIT_MILLIMETER;
@@ -145,6 +168,37 @@ namespace NMR {
 		}
 	}
 
+	void CModel::forEachMeshInstance(_In_ const ModelMeshInstanceCallback & fnCallback)
+	{
+		// Depth first traversal with an explicit stack, children are pushed in reverse to keep the component order
+		std::vector<std::pair<CModelObject *, NMATRIX3>> Stack;
+		for (auto iIterator = m_BuildItems.begin(); iIterator != m_BuildItems.end(); iIterator++) {
+			Stack.push_back(std::make_pair((*iIterator)->getObject(), (*iIterator)->getTransform()));
+
+			while (!Stack.empty()) {
+				CModelObject * pObject = Stack.back().first;
+				NMATRIX3 mTransform = Stack.back().second;
+				Stack.pop_back();
+
+				CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *>(pObject);
+				if (pMeshObject != nullptr) {
+					fnCallback(pMeshObject, mTransform);
+					continue;
+				}
+
+				CModelComponentsObject * pComponentsObject = dynamic_cast<CModelComponentsObject *>(pObject);
+				if (pComponentsObject != nullptr) {
+					nfUint32 nComponentIndex = pComponentsObject->getComponentCount();
+					while (nComponentIndex > 0) {
+						nComponentIndex--;
+						PModelComponent pComponent = pComponentsObject->getComponent(nComponentIndex);
+						Stack.push_back(std::make_pair(pComponent->getObject(), fnMATRIX3_multiply(mTransform, pComponent->getTransform())));
+					}
+				}
+			}
+		}
+	}
+
 	// Units setter/getter
 	void CModel::setUnit(_In_ eModelUnit Unit)
 	{
@@ -219,22 +273,32 @@ namespace NMR {
 
 	PModelResource CModel::findResource(_In_ UniqueResourceID nID)
 	{
-		PPackageResourceID pID = m_resourceHandler.findResourceIDByUniqueID(nID);
-		if (pID.get())
-			return findResource(pID);
-		else
-			return nullptr;
+		if (nID < m_ResourceTable.size())
+			return m_ResourceTable[nID].m_pResource;
+		return nullptr;
 	}
 
 	PModelResource CModel::findResource(_In_ PPackageResourceID pID)
 	{
-		UniqueResourceID uID = pID->getUniqueID();
+		return findResource(pID->getUniqueID());
+	}
 
-		auto iIterator = m_ResourceMap.find(uID);
-		if (iIterator != m_ResourceMap.end()) {
-			return iIterator->second;
-		}
-		return nullptr;
+	eModelResourceType CModel::findResourceType(_In_ UniqueResourceID nID)
+	{
+		if (nID < m_ResourceTable.size())
+			return m_ResourceTable[nID].m_eType;
+		return MODELRESOURCETYPE_NONE;
+	}
+
+	PModelResource CModel::findResourceOfType(_In_ UniqueResourceID nID, _In_ eModelResourceType eType)
+	{
+		if (nID >= m_ResourceTable.size())
+			return nullptr;
+
+		MODELRESOURCEENTRY & Entry = m_ResourceTable[nID];
+		if ((Entry.m_eType != eType) && (Entry.m_eType != MODELRESOURCETYPE_NONE))
+			throw CNMRException(NMR_ERROR_RESOURCETYPEMISMATCH);
+		return Entry.m_pResource;
 	}
 
 	PPackageResourceID CModel::findPackageResourceID(_In_ std::string path, ModelResourceID nID)
@@ -270,16 +334,19 @@ namespace NMR {
 
 		// Check if ID already exists
 		UniqueResourceID nID = pResource->getPackageResourceID()->getUniqueID();
-		auto iIterator = m_ResourceMap.find(nID);
-		if (iIterator != m_ResourceMap.end())
+		if (findResource(nID))
 			throw CNMRException(NMR_ERROR_DUPLICATEMODELRESOURCE);
 
 		// Add ID to objects
-		m_ResourceMap.insert(std::make_pair(nID, pResource));
+		eModelResourceType eType = fnGetModelResourceType(pResource.get());
+		if (nID >= m_ResourceTable.size())
+			m_ResourceTable.resize(nID + 1, MODELRESOURCEENTRY{ nullptr, MODELRESOURCETYPE_NONE });
+		m_ResourceTable[nID].m_pResource = pResource;
+		m_ResourceTable[nID].m_eType = eType;
 		m_Resources.push_back(pResource);
 
 		// Create correct lookup table
-		addResourceToLookupTable(pResource);
+		addResourceToLookupTable(pResource, eType);
 	}
 
 	// Metadata setter/getter
@@ -396,26 +463,29 @@ namespace NMR {
 	ModelResourceID CModel::generateResourceID()
 	{
 		// TODO: is this truly safe?
-		auto iIterator = m_ResourceMap.rbegin();
-		if (iIterator != m_ResourceMap.rend())
-			return iIterator->first + 1;
+		// The resource table does not end with an empty entry, so its size is one more than the biggest unique ID
+		if (!m_ResourceTable.empty())
+			return (ModelResourceID)m_ResourceTable.size();
 		else
 			return 1;
 	}
 
 	void CModel::updateUniqueResourceID(UniqueResourceID nOldID, UniqueResourceID nNewID)
 	{
-		if (m_ResourceMap.find(nNewID) != m_ResourceMap.end()) {
+		if (findResource(nNewID)) {
 			throw CNMRException(NMR_ERROR_DUPLICATEMODELRESOURCE);
 		}
 		else
 		{
-			auto iIterator = m_ResourceMap.find(nOldID);
-			if (iIterator == m_ResourceMap.end()) {
+			if (!findResource(nOldID)) {
 				throw CNMRException(NMR_ERROR_INVALIDMODELRESOURCE);
 			}
-			m_ResourceMap.insert(std::make_pair<>(nNewID, iIterator->second));
-			m_ResourceMap.erase(m_ResourceMap.find(nOldID));
+			if (nNewID >= m_ResourceTable.size())
+				m_ResourceTable.resize(nNewID + 1, MODELRESOURCEENTRY{ nullptr, MODELRESOURCETYPE_NONE });
+			m_ResourceTable[nNewID] = m_ResourceTable[nOldID];
+			m_ResourceTable[nOldID] = MODELRESOURCEENTRY{ nullptr, MODELRESOURCETYPE_NONE };
+			while ((!m_ResourceTable.empty()) && (!m_ResourceTable.back().m_pResource))
+				m_ResourceTable.pop_back();
 		}
 	}
 
@@ -432,16 +502,8 @@ namespace NMR {
 	// Convenience functions for objects
 	_Ret_maybenull_ CModelObject * CModel::findObject(_In_ UniqueResourceID nResourceID)
 	{
-		PModelResource pResource = findResource(nResourceID);
-		if (pResource != nullptr) {
-			CModelObject * pModelObject = dynamic_cast<CModelObject *> (pResource.get());
-			if (pModelObject == nullptr)
-				throw CNMRException (NMR_ERROR_RESOURCETYPEMISMATCH);
-
-			return pModelObject;
-		}
-
-		return nullptr;
+		PModelResource pResource = findResourceOfType(nResourceID, MODELRESOURCETYPE_OBJECT);
+		return static_cast<CModelObject *> (pResource.get());
 	}
 
 	nfUint32 CModel::getObjectCount()
@@ -494,43 +556,40 @@ namespace NMR {
 	}
 
 	// Add Resource to resource lookup tables
-	void CModel::addResourceToLookupTable(_In_ PModelResource pResource)
+	void CModel::addResourceToLookupTable(_In_ PModelResource pResource, _In_ eModelResourceType eType)
 	{
 		if (pResource.get() == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
 		// Add to lookup tables
-		CModelObject * pModelObject = dynamic_cast<CModelObject *> (pResource.get());
-		if (pModelObject != nullptr)
+		switch (eType) {
+		case MODELRESOURCETYPE_OBJECT:
 			m_ObjectLookup.push_back(pResource);
-
-		CModelBaseMaterialResource * pBaseMaterial = dynamic_cast<CModelBaseMaterialResource *> (pResource.get());
-		if (pBaseMaterial != nullptr)
+			break;
+		case MODELRESOURCETYPE_BASEMATERIALS:
 			m_BaseMaterialLookup.push_back(pResource);
-
-		CModelColorGroupResource * pColorGroup = dynamic_cast<CModelColorGroupResource *> (pResource.get());
-		if (pColorGroup != nullptr)
+			break;
+		case MODELRESOURCETYPE_COLORGROUP:
 			m_ColorGroupLookup.push_back(pResource);
-
-		CModelTexture2DResource * pTexture2D = dynamic_cast<CModelTexture2DResource *> (pResource.get());
-		if (pTexture2D != nullptr)
+			break;
+		case MODELRESOURCETYPE_TEXTURE2D:
 			m_TextureLookup.push_back(pResource);
-
-		CModelTexture2DGroupResource * pTexture2DGroup = dynamic_cast<CModelTexture2DGroupResource *> (pResource.get());
-		if (pTexture2DGroup != nullptr)
+			break;
+		case MODELRESOURCETYPE_TEXTURE2DGROUP:
 			m_Texture2DGroupLookup.push_back(pResource);
-
-		CModelCompositeMaterialsResource * pCompositeMaterials = dynamic_cast<CModelCompositeMaterialsResource *> (pResource.get());
-		if (pCompositeMaterials != nullptr)
+			break;
+		case MODELRESOURCETYPE_COMPOSITEMATERIALS:
 			m_CompositeMaterialsLookup.push_back(pResource);
-
-		CModelMultiPropertyGroupResource * pMultiPropertyGroup = dynamic_cast<CModelMultiPropertyGroupResource *> (pResource.get());
-		if (pMultiPropertyGroup != nullptr)
+			break;
+		case MODELRESOURCETYPE_MULTIPROPERTYGROUP:
 			m_MultiPropertyGroupLookup.push_back(pResource);
-
-		CModelSliceStack *pSliceStack = dynamic_cast<CModelSliceStack *>(pResource.get());
-		if (pSliceStack != nullptr) 
+			break;
+		case MODELRESOURCETYPE_SLICESTACK:
 			m_SliceStackLookup.push_back(pResource);
+			break;
+		default:
+			break;
+		}
 	}
 
 	// Clear all build items and Resources
@@ -543,7 +602,7 @@ namespace NMR {
 		m_BaseMaterialLookup.clear();
 		m_ColorGroupLookup.clear();
 		m_BuildItems.clear();
-		m_ResourceMap.clear();
+		m_ResourceTable.clear();
 		m_Resources.clear();
 		m_TextureLookup.clear();
 		m_SliceStackLookup.clear();
@@ -555,14 +614,7 @@ namespace NMR {
 
 	_Ret_maybenull_ PModelBaseMaterialResource CModel::findBaseMaterial(_In_ PPackageResourceID pID)
 	{
-		PModelResource pResource = findResource(pID);
-		if (pResource != nullptr) {
-			PModelBaseMaterialResource pBaseMaterialResource = std::dynamic_pointer_cast<CModelBaseMaterialResource>(pResource);
-			if (pBaseMaterialResource.get() == nullptr)
-				throw CNMRException(NMR_ERROR_RESOURCETYPEMISMATCH);
-			return pBaseMaterialResource;
-		}
-		return nullptr;
+		return std::static_pointer_cast<CModelBaseMaterialResource>(findResourceOfType(pID->getUniqueID(), MODELRESOURCETYPE_BASEMATERIALS));
 	}
 
 	nfUint32 CModel::getBaseMaterialCount()
@@ -611,14 +663,7 @@ namespace NMR {
 
 	_Ret_maybenull_ PModelColorGroupResource CModel::findColorGroup(_In_ UniqueResourceID nResourceID)
 	{
-		PModelResource pResource = findResource(nResourceID);
-		if (pResource != nullptr) {
-			PModelColorGroupResource pColorGroupResource = std::dynamic_pointer_cast<CModelColorGroupResource>(pResource);
-			if (pColorGroupResource.get() == nullptr)
-				throw CNMRException(NMR_ERROR_RESOURCETYPEMISMATCH);
-			return pColorGroupResource;
-		}
-		return nullptr;
+		return std::static_pointer_cast<CModelColorGroupResource>(findResourceOfType(nResourceID, MODELRESOURCETYPE_COLORGROUP));
 	}
 
 	nfUint32 CModel::getColorGroupCount()
@@ -668,14 +713,7 @@ namespace NMR {
 
 	_Ret_maybenull_ PModelTexture2DGroupResource CModel::findTexture2DGroup(_In_ UniqueResourceID nResourceID)
 	{
-		PModelResource pResource = findResource(nResourceID);
-		if (pResource != nullptr) {
-			PModelTexture2DGroupResource pTexture2DGroupResource = std::dynamic_pointer_cast<CModelTexture2DGroupResource>(pResource);
-			if (pTexture2DGroupResource.get() == nullptr)
-				throw CNMRException(NMR_ERROR_RESOURCETYPEMISMATCH);
-			return pTexture2DGroupResource;
-		}
-		return nullptr;
+		return std::static_pointer_cast<CModelTexture2DGroupResource>(findResourceOfType(nResourceID, MODELRESOURCETYPE_TEXTURE2DGROUP));
 	}
 
 	nfUint32 CModel::getTexture2DGroupCount()
@@ -735,14 +773,7 @@ namespace NMR {
 
 	_Ret_maybenull_ PModelCompositeMaterialsResource CModel::findCompositeMaterials(_In_ UniqueResourceID nResourceID)
 	{
-		PModelResource pResource = findResource(nResourceID);
-		if (pResource != nullptr) {
-			PModelCompositeMaterialsResource pCompositeMaterialsResource = std::dynamic_pointer_cast<CModelCompositeMaterialsResource>(pResource);
-			if (pCompositeMaterialsResource.get() == nullptr)
-				throw CNMRException(NMR_ERROR_RESOURCETYPEMISMATCH);
-			return pCompositeMaterialsResource;
-		}
-		return nullptr;
+		return std::static_pointer_cast<CModelCompositeMaterialsResource>(findResourceOfType(nResourceID, MODELRESOURCETYPE_COMPOSITEMATERIALS));
 	}
 
 	nfUint32 CModel::getCompositeMaterialsCount()
@@ -801,14 +832,7 @@ namespace NMR {
 
 	_Ret_maybenull_ PModelMultiPropertyGroupResource CModel::findMultiPropertyGroup(_In_ UniqueResourceID nResourceID)
 	{
-		PModelResource pResource = findResource(nResourceID);
-		if (pResource != nullptr) {
-			PModelMultiPropertyGroupResource pMultiPropertyGroupResource = std::dynamic_pointer_cast<CModelMultiPropertyGroupResource>(pResource);
-			if (pMultiPropertyGroupResource.get() == nullptr)
-				throw CNMRException(NMR_ERROR_RESOURCETYPEMISMATCH);
-			return pMultiPropertyGroupResource;
-		}
-		return nullptr;
+		return std::static_pointer_cast<CModelMultiPropertyGroupResource>(findResourceOfType(nResourceID, MODELRESOURCETYPE_MULTIPROPERTYGROUP));
 	}
 
 	nfUint32 CModel::getMultiPropertyGroupCount()
@@ -855,14 +879,7 @@ namespace NMR {
 
 	_Ret_maybenull_ PModelTexture2DResource CModel::findTexture2D(_In_ UniqueResourceID nResourceID)
 	{
-		PModelResource pResource = findResource(nResourceID);
-		if (pResource != nullptr) {
-			PModelTexture2DResource pTexture2DResource = std::dynamic_pointer_cast<CModelTexture2DResource>(pResource);
-			if (pTexture2DResource.get() == nullptr)
-				throw CNMRException(NMR_ERROR_RESOURCETYPEMISMATCH);
-			return pTexture2DResource;
-		}
-		return nullptr;
+		return std::static_pointer_cast<CModelTexture2DResource>(findResourceOfType(nResourceID, MODELRESOURCETYPE_TEXTURE2D));
 	}
 
 	nfUint32 CModel::getTexture2DCount()
@@ -1049,7 +1066,9 @@ namespace NMR {
 			PImportStream pCopiedStream = std::make_shared<CImportStream_Unique_Memory>(pInStream.get(), pInStream->retrieveSize(), true);
 			pInStream->seekPosition(nPos, true);
 
-			addAttachment(pModelAttachment->getPathURI(), pModelAttachment->getRelationShipType(), pCopiedStream);
+			PModelAttachment pNewAttachment = addAttachment(pModelAttachment->getPathURI(), pModelAttachment->getRelationShipType(), pCopiedStream);
+			if (pModelAttachment->hasCompression())
+				pNewAttachment->setCompression(pModelAttachment->getCompression(), pModelAttachment->getCompressionLevel());
 		}
 	}
 
@@ -1238,24 +1257,82 @@ namespace NMR {
 		return m_SliceStackLookup[nIndex];
 	}
 
-	std::list<CModelObject *> CModel::getSortedObjectList()
+	std::vector<CModelObject *> CModel::getSortedObjectList()
 	{
-		std::list<CModelObject *> resultList;
+		const nfUint32 nNoObject = 0xFFFFFFFF;
+		std::vector<CModelObject *> Objects;
+		std::vector<nfUint32> ObjectIndices(m_ResourceTable.size(), nNoObject);
 
+		Objects.reserve(m_ObjectLookup.size());
 		for (size_t i = 0; i < m_ObjectLookup.size(); i++) {
 			CModelObject* pObject = dynamic_cast<CModelObject*>(m_ObjectLookup[i].get());
 			if (pObject != nullptr) {
-				pObject->clearComponentDepthLevel();
-				resultList.push_back(pObject);
+				UniqueResourceID nID = pObject->getPackageResourceID()->getUniqueID();
+				if (nID >= ObjectIndices.size())
+					ObjectIndices.resize(nID + 1, nNoObject);
+				ObjectIndices[nID] = (nfUint32)Objects.size();
+				Objects.push_back(pObject);
+			}
+		}
+
+		nfUint32 nObjectCount = (nfUint32)Objects.size();
+		auto fnGetObjectIndex = [&](CModelObject * pObject) -> nfUint32 {
+			UniqueResourceID nID = pObject->getPackageResourceID()->getUniqueID();
+			return (nID < ObjectIndices.size()) ? ObjectIndices[nID] : nNoObject;
+		};
+
+		// The depth level of an object is the length of the longest chain of components that leads to it.
+		// It is computed in topological order, so every object is visited once after all objects that reference it.
+		std::vector<nfUint32> ReferenceCounts(nObjectCount, 0);
+		std::vector<nfUint32> Levels(nObjectCount, 1);
+		for (nfUint32 nIndex = 0; nIndex < nObjectCount; nIndex++) {
+			CModelComponentsObject * pComponentsObject = dynamic_cast<CModelComponentsObject *>(Objects[nIndex]);
+			if (pComponentsObject != nullptr) {
+				nfUint32 nComponentCount = pComponentsObject->getComponentCount();
+				for (nfUint32 nComponent = 0; nComponent < nComponentCount; nComponent++) {
+					nfUint32 nChildIndex = fnGetObjectIndex(pComponentsObject->getComponent(nComponent)->getObject());
+					if (nChildIndex != nNoObject)
+						ReferenceCounts[nChildIndex]++;
+				}
 			}
 		}
 
-		for (auto iIterator = resultList.begin(); iIterator != resultList.end(); iIterator++) {
-			(*iIterator)->calculateComponentDepthLevel(1);
+		std::vector<nfUint32> ReadyObjects;
+		for (nfUint32 nIndex = 0; nIndex < nObjectCount; nIndex++) {
+			if (ReferenceCounts[nIndex] == 0)
+				ReadyObjects.push_back(nIndex);
+		}
+
+		nfUint32 nVisitedCount = 0;
+		while (!ReadyObjects.empty()) {
+			nfUint32 nIndex = ReadyObjects.back();
+			ReadyObjects.pop_back();
+			nVisitedCount++;
+
+			CModelComponentsObject * pComponentsObject = dynamic_cast<CModelComponentsObject *>(Objects[nIndex]);
+			if (pComponentsObject != nullptr) {
+				nfUint32 nComponentCount = pComponentsObject->getComponentCount();
+				for (nfUint32 nComponent = 0; nComponent < nComponentCount; nComponent++) {
+					nfUint32 nChildIndex = fnGetObjectIndex(pComponentsObject->getComponent(nComponent)->getObject());
+					if (nChildIndex == nNoObject)
+						continue;
+					if (Levels[nChildIndex] < Levels[nIndex] + 1)
+						Levels[nChildIndex] = Levels[nIndex] + 1;
+					if (--ReferenceCounts[nChildIndex] == 0)
+						ReadyObjects.push_back(nChildIndex);
+				}
+			}
 		}
 
+		// Objects that are never released reference themselves through their components
+		if (nVisitedCount != nObjectCount)
+			throw CNMRException(NMR_ERROR_INVALIDMODELCOMPONENT);
+
+		for (nfUint32 nIndex = 0; nIndex < nObjectCount; nIndex++)
+			Objects[nIndex]->setComponentDepthLevel(Levels[nIndex]);
+
 		// sort by (level descending, ResourceID ascending)
-		resultList.sort( [](CModelObject * pObject1, CModelObject * pObject2)
+		std::sort(Objects.begin(), Objects.end(), [](CModelObject * pObject1, CModelObject * pObject2)
 		{
 			nfUint32 nLevel1 = pObject1->getComponentDepthLevel();
 			nfUint32 nLevel2 = pObject2->getComponentDepthLevel();
@@ -1266,7 +1343,7 @@ namespace NMR {
 			return nLevel1 > nLevel2;
 		});
 
-		return resultList;
+		return Objects;
 	}
 
 	PKeyStore CModel::getKeyStore() {
@@ -45,6 +45,9 @@ namespace NMR {
 		m_sPathURI = sPathURI;
 		m_pStream = pStream;
 		m_sRelationShipType = sRelationShipType;
+		m_eCompression = MODELATTACHMENTCOMPRESSION_AUTO;
+		m_nCompressionLevel = MODELATTACHMENT_DEFAULTCOMPRESSIONLEVEL;
+		m_bHasCompression = false;
 	}
 
 	CModelAttachment::~CModelAttachment()
@@ -82,6 +85,33 @@ namespace NMR {
 		m_sRelationShipType = sRelationShipType;
 	}
 
+	eModelAttachmentCompression CModelAttachment::getCompression()
+	{
+		return m_eCompression;
+	}
+
+	nfInt32 CModelAttachment::getCompressionLevel()
+	{
+		return m_nCompressionLevel;
+	}
+
+	void CModelAttachment::setCompression(_In_ eModelAttachmentCompression eCompression, _In_ nfInt32 nCompressionLevel)
+	{
+		if ((eCompression != MODELATTACHMENTCOMPRESSION_AUTO) && (eCompression != MODELATTACHMENTCOMPRESSION_STORE) && (eCompression != MODELATTACHMENTCOMPRESSION_DEFLATE))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if ((nCompressionLevel < 0) || (nCompressionLevel > MODELATTACHMENT_MAXCOMPRESSIONLEVEL))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_eCompression = eCompression;
+		m_nCompressionLevel = nCompressionLevel;
+		m_bHasCompression = true;
+	}
+
+	nfBool CModelAttachment::hasCompression()
+	{
+		return m_bHasCompression;
+	}
+
 
 
 }
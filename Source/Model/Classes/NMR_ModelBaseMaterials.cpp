@@ -41,47 +41,40 @@ namespace NMR {
 	CModelBaseMaterialResource::CModelBaseMaterialResource(_In_ const ModelResourceID sID, _In_ CModel * pModel)
 		: CModelResource(sID, pModel)
 	{
-		m_nNextPropertyID = 1;
 	}
 
 	nfUint32 CModelBaseMaterialResource::addBaseMaterial(_In_ const std::string sName, _In_ nfColor cDisplayColor)
 	{
-		nfUint32 nID = m_nNextPropertyID;
 		if (getCount() >= XML_3MF_MAXRESOURCEINDEX) {
 			throw CNMRException(NMR_ERROR_TOOMANYMATERIALS);
 		}
 
-		m_pMaterials.insert(
-			std::make_pair(nID, std::make_shared<CModelBaseMaterial>(sName, cDisplayColor, nID))
-		);
-
-		m_nNextPropertyID++;
-
-		clearResourceIndexMap();
-
-		return nID;
+		return m_Materials.add(std::make_shared<CModelBaseMaterial>(sName, cDisplayColor, m_Materials.getNextPropertyID()));
 	}
 
 	nfUint32 CModelBaseMaterialResource::getCount()
 	{
-		return (nfUint32)m_pMaterials.size();
+		return m_Materials.getCount();
+	}
+
+	nfBool CModelBaseMaterialResource::hasBaseMaterial(_In_ nfUint32 nPropertyID)
+	{
+		return m_Materials.hasPropertyID(nPropertyID);
 	}
 
 	PModelBaseMaterial CModelBaseMaterialResource::getBaseMaterial(_In_ nfUint32 nPropertyID)
 	{
-		auto iIterator = m_pMaterials.find(nPropertyID);
-		if (iIterator != m_pMaterials.end()) {
-			return iIterator->second;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		return m_Materials.get(nPropertyID);
+	}
+
+	PModelBaseMaterial CModelBaseMaterialResource::getBaseMaterialByIndex(_In_ ModelResourceIndex nIndex)
+	{
+		return m_Materials.getByIndex(nIndex);
 	}
 
 	void CModelBaseMaterialResource::removeMaterial(_In_ nfUint32 nPropertyID)
 	{
-		m_pMaterials.erase(nPropertyID);
-		clearResourceIndexMap();
+		m_Materials.remove(nPropertyID);
 	}
 
 	void CModelBaseMaterialResource::mergeFrom(_In_ CModelBaseMaterialResource * pSourceMaterial)
@@ -90,30 +83,22 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		
 		nfUint32 nCount = pSourceMaterial->getCount();
-
-		pSourceMaterial->buildResourceIndexMap();
+		m_Materials.reserve(getCount() + nCount);
 		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
-			ModelPropertyID nPropertyID;
-			pSourceMaterial->mapResourceIndexToPropertyID(nIndex, nPropertyID);
-			PModelBaseMaterial pMaterial = pSourceMaterial->getBaseMaterial(nPropertyID);
+			PModelBaseMaterial pMaterial = pSourceMaterial->getBaseMaterialByIndex(nIndex);
 			addBaseMaterial(pMaterial->getName(), pMaterial->getDisplayColor());
 		}
-		clearResourceIndexMap();
 	}
 
+	// The material array itself maps resource indices to PropertyIDs
 	void CModelBaseMaterialResource::buildResourceIndexMap()
 	{
-		m_ResourceIndexMap.clear();
-		m_ResourceIndexMap.reserve(m_pMaterials.size());
-
-		auto iIterator = m_pMaterials.begin();
-		while (iIterator != m_pMaterials.end()) {
-			m_ResourceIndexMap.push_back(iIterator->first);
-			iIterator++;
-		}
-
 		m_bHasResourceIndexMap = true;
 	}
 
-}
+	bool CModelBaseMaterialResource::mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID)
+	{
+		return m_Materials.getPropertyID(nPropertyIndex, nPropertyID);
+	}
 
+}
@@ -41,56 +41,55 @@ namespace NMR {
 	CModelColorGroupResource::CModelColorGroupResource(_In_ const ModelResourceID sID, _In_ CModel * pModel)
 		: CModelResource(sID, pModel)
 	{
-		m_nNextPropertyID = 1;
 	}
 
 	nfUint32 CModelColorGroupResource::addColor( _In_ nfColor cColor)
 	{
-		nfUint32 nID = m_nNextPropertyID;
 		if (getCount() >= XML_3MF_MAXRESOURCEINDEX) {
 			throw CNMRException(NMR_ERROR_TOOMANYCOLORS);
 		}
 
-		m_pColors.insert(std::make_pair(nID, cColor));
-
-		m_nNextPropertyID++;
-
-		clearResourceIndexMap();
-
-		return nID;
+		return m_Colors.add(cColor);
 	}
 
 	nfUint32 CModelColorGroupResource::getCount()
 	{
-		return (nfUint32)m_pColors.size();
+		return m_Colors.getCount();
+	}
+
+	nfBool CModelColorGroupResource::hasColor(_In_ ModelPropertyID nPropertyID)
+	{
+		return m_Colors.hasPropertyID(nPropertyID);
 	}
 
 	nfColor CModelColorGroupResource::getColor(_In_ ModelPropertyID nPropertyID)
 	{
-		auto iIterator = m_pColors.find(nPropertyID);
-		if (iIterator != m_pColors.end()) {
-			return iIterator->second;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		return m_Colors.get(nPropertyID);
 	}
 
 	void CModelColorGroupResource::setColor(_In_ ModelPropertyID nPropertyID, _In_ nfColor cColor)
 	{
-		auto iIterator = m_pColors.find(nPropertyID);
-		if (iIterator != m_pColors.end()) {
-			iIterator->second = cColor;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		m_Colors.get(nPropertyID) = cColor;
+	}
+
+	nfColor CModelColorGroupResource::getColorByIndex(_In_ ModelResourceIndex nIndex)
+	{
+		return m_Colors.getByIndex(nIndex);
+	}
+
+	void CModelColorGroupResource::setColorByIndex(_In_ ModelResourceIndex nIndex, _In_ nfColor cColor)
+	{
+		m_Colors.getByIndex(nIndex) = cColor;
+	}
+
+	void CModelColorGroupResource::reserveColors(_In_ nfUint32 nCount)
+	{
+		m_Colors.reserve(nCount);
 	}
 
 	void CModelColorGroupResource::removeColor(_In_ ModelPropertyID nPropertyID)
 	{
-		m_pColors.erase(nPropertyID);
-		clearResourceIndexMap();
+		m_Colors.remove(nPropertyID);
 	}
 
 	void CModelColorGroupResource::mergeFrom(_In_ CModelColorGroupResource * pSourceColorGroup)
@@ -99,30 +98,21 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		
 		nfUint32 nCount = pSourceColorGroup->getCount();
-
-		pSourceColorGroup->buildResourceIndexMap();
+		m_Colors.reserve(getCount() + nCount);
 		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
-			ModelPropertyID nPropertyID;
-			pSourceColorGroup->mapResourceIndexToPropertyID(nIndex, nPropertyID);
-			nfColor color = pSourceColorGroup->getColor(nPropertyID);
-			addColor(color);
+			addColor(pSourceColorGroup->getColorByIndex(nIndex));
 		}
-		clearResourceIndexMap();
 	}
 
+	// The color array itself maps resource indices to PropertyIDs
 	void CModelColorGroupResource::buildResourceIndexMap()
 	{
-		m_ResourceIndexMap.clear();
-		m_ResourceIndexMap.reserve(m_pColors.size());
-
-		auto iIterator = m_pColors.begin();
-		while (iIterator != m_pColors.end()) {
-			m_ResourceIndexMap.push_back(iIterator->first);
-			iIterator++;
-		}
-
 		m_bHasResourceIndexMap = true;
 	}
 
-}
+	bool CModelColorGroupResource::mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID)
+	{
+		return m_Colors.getPropertyID(nPropertyIndex, nPropertyID);
+	}
 
+}
@@ -138,15 +138,6 @@ namespace NMR {
 		return true;
 	}
 
-	void CModelComponentsObject::calculateComponentDepthLevel(nfUint32 nLevel)
-	{
-		CModelObject::calculateComponentDepthLevel(nLevel);
-		for (auto iIterator = m_Components.begin(); iIterator != m_Components.end(); iIterator++) {
-			CModelObject * pObject = (*iIterator)->getObject();
-			pObject->calculateComponentDepthLevel(nLevel + 1);
-		}
-	}
-
 	void CModelComponentsObject::extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix)
 	{
 		for (auto iIterator = m_Components.begin(); iIterator != m_Components.end(); iIterator++) {
@@ -44,14 +44,12 @@ namespace NMR {
 		_In_ PModelBaseMaterialResource pBaseMaterialResource)
 		: CModelResource(sID, pModel), m_pBaseMaterialResource(pBaseMaterialResource)
 	{
-		m_nNextPropertyID = 1;
 		if (!pBaseMaterialResource.get())
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 	}
 
 	nfUint32 CModelCompositeMaterialsResource::addComposite(_In_ PModelComposite pComposite)
 	{
-		nfUint32 nID = m_nNextPropertyID;
 		if (getCount() >= XML_3MF_MAXRESOURCEINDEX) {
 			throw CNMRException(NMR_ERROR_TOOMANYCOMPOSITES);
 		}
@@ -65,46 +63,32 @@ namespace NMR {
 		}
 		
 
-		m_pComposites.insert(std::make_pair(nID, pComposite));
-
-		m_nNextPropertyID++;
-
-		clearResourceIndexMap();
-
-		return nID;
+		return m_Composites.add(pComposite);
 	}
 
 	nfUint32 CModelCompositeMaterialsResource::getCount()
 	{
-		return (nfUint32)m_pComposites.size();
+		return m_Composites.getCount();
 	}
 
 	PModelComposite CModelCompositeMaterialsResource::getComposite(_In_ ModelPropertyID nPropertyID)
 	{
-		auto iIterator = m_pComposites.find(nPropertyID);
-		if (iIterator != m_pComposites.end()) {
-			return iIterator->second;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		return m_Composites.get(nPropertyID);
 	}
 
 	void CModelCompositeMaterialsResource::setComposite(_In_ ModelPropertyID nPropertyID, _In_ PModelComposite pComposite)
 	{
-		auto iIterator = m_pComposites.find(nPropertyID);
-		if (iIterator != m_pComposites.end()) {
-			iIterator->second = pComposite;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		m_Composites.get(nPropertyID) = pComposite;
+	}
+
+	PModelComposite CModelCompositeMaterialsResource::getCompositeByIndex(_In_ ModelResourceIndex nIndex)
+	{
+		return m_Composites.getByIndex(nIndex);
 	}
 
 	void CModelCompositeMaterialsResource::removeComposite(_In_ ModelPropertyID nPropertyID)
 	{
-		m_pComposites.erase(nPropertyID);
-		clearResourceIndexMap();
+		m_Composites.remove(nPropertyID);
 	}
 
 	void CModelCompositeMaterialsResource::mergeFrom(_In_ CModelCompositeMaterialsResource * pSourceCompositesMaterials)
@@ -113,34 +97,25 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		
 		nfUint32 nCount = pSourceCompositesMaterials->getCount();
-
-		pSourceCompositesMaterials->buildResourceIndexMap();
+		m_Composites.reserve(getCount() + nCount);
 		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
-			ModelPropertyID nPropertyID;
-			pSourceCompositesMaterials->mapResourceIndexToPropertyID(nIndex, nPropertyID);
-			PModelComposite pCmposite = pSourceCompositesMaterials->getComposite(nPropertyID);
-			addComposite(pCmposite);
+			addComposite(pSourceCompositesMaterials->getCompositeByIndex(nIndex));
 		}
-		clearResourceIndexMap();
 	}
 
+	// The composite array itself maps resource indices to PropertyIDs
 	void CModelCompositeMaterialsResource::buildResourceIndexMap()
 	{
-		m_ResourceIndexMap.clear();
-		m_ResourceIndexMap.reserve(m_pComposites.size());
-
-		auto iIterator = m_pComposites.begin();
-		while (iIterator != m_pComposites.end()) {
-			m_ResourceIndexMap.push_back(iIterator->first);
-			iIterator++;
-		}
-
 		m_bHasResourceIndexMap = true;
 	}
 
+	bool CModelCompositeMaterialsResource::mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID)
+	{
+		return m_Composites.getPropertyID(nPropertyIndex, nPropertyID);
+	}
+
 	PModelBaseMaterialResource CModelCompositeMaterialsResource::getBaseMaterialResource()
 	{
 		return m_pBaseMaterialResource;
 	}
 }
-
@@ -34,7 +34,7 @@ mesh object.
 
 #include "Model/Classes/NMR_ModelObject.h" 
 #include "Model/Classes/NMR_ModelMeshObject.h" 
-#include "Common/Math/NMR_PairMatchingTree.h" 
+#include "Common/Mesh/NMR_MeshValidator.h" 
 
 namespace NMR {
 
@@ -126,85 +126,9 @@ namespace NMR {
 		if (!m_pMesh->checkSanity())
 			return false;
 
-		nfUint32 nNodeCount = m_pMesh->getNodeCount();
-		nfUint32 nFaceCount = m_pMesh->getFaceCount();
-
-		if (nNodeCount < 3)
-			return false;
-		if (nFaceCount < 3)
-			return false;
-
-		CPairMatchingTree PairMatchingTree;
-		nfUint32 nFaceIndex;
-		nfInt32 nEdgeIndex;
-		nfInt32 nEdgeCounter = 0;
-		nfUint32 j;
-
-		// Build Edge Tree
-		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
-			MESHFACE * pFace = m_pMesh->getFace(nFaceIndex);
-
-			for (j = 0; j < 3; j++) {
-				nfInt32 nNodeIndex1 = pFace->m_nodeindices[j];
-				nfInt32 nNodeIndex2 = pFace->m_nodeindices[(j + 1) % 3];
-
-				if (!PairMatchingTree.checkMatch(nNodeIndex1, nNodeIndex2, nEdgeIndex)) {
-					PairMatchingTree.addMatch(nNodeIndex1, nNodeIndex2, nEdgeCounter);
-					nEdgeCounter++;
-
-					if (nEdgeCounter > NMR_MESH_MAXEDGECOUNT)
-						throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
-				}
-			}
-
-		}
-
-		// Count positively and negatively oriented edges...
-		std::vector<nfInt32> PositiveOrientations;
-		std::vector<nfInt32> NegativeOrientations;
-
-		// Create Edge arrays
-		PositiveOrientations.resize(nEdgeCounter);
-		NegativeOrientations.resize(nEdgeCounter);
-		for (nEdgeIndex = 0; nEdgeIndex < nEdgeCounter; nEdgeIndex++) {
-			PositiveOrientations[nEdgeIndex] = 0;
-			NegativeOrientations[nEdgeIndex] = 0;
-		}
-
-		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
-			MESHFACE * pFace = m_pMesh->getFace(nFaceIndex);
-
-			for (j = 0; j < 3; j++) {
-				nfInt32 nNodeIndex1 = pFace->m_nodeindices[j];
-				nfInt32 nNodeIndex2 = pFace->m_nodeindices[(j + 1) % 3];
-
-				if (PairMatchingTree.checkMatch(nNodeIndex1, nNodeIndex2, nEdgeIndex)) {
-					if ((nEdgeIndex < 0) || (nEdgeIndex >= nEdgeCounter))
-						throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
-
-					if (nNodeIndex1 <= nNodeIndex2) {
-						PositiveOrientations[nEdgeIndex]++;
-					}
-					else {
-						NegativeOrientations[nEdgeIndex]++;
-					}
-				}
-				else {
-					throw CNMRException(NMR_ERROR_INVALIDMESHTOPOLOGY);
-				}
-			}
-		}
-
-		// Check Edge Orientations and determine manifoldness
-		for (nEdgeIndex = 0; nEdgeIndex < nEdgeCounter; nEdgeIndex++) {
-			if (PositiveOrientations[nEdgeIndex] != 1)
-				return false;
-			if (NegativeOrientations[nEdgeIndex] != 1)
-				return false;
-		}
-
-		// Mesh is non-empty, oriented and manifold
-		return true;
+		// Only the topology is needed, so no samples are collected and the geometric checks are skipped
+		CMeshValidator Validator(m_pMesh.get(), 0, false);
+		return Validator.isManifoldAndOriented();
 	}
 
 
@@ -203,10 +203,9 @@ namespace NMR {
 		m_nComponentDepthLevel = 0;
 	}
 
-	void CModelObject::calculateComponentDepthLevel(nfUint32 nLevel)
+	void CModelObject::setComponentDepthLevel(nfUint32 nLevel)
 	{
-		if (nLevel >= m_nComponentDepthLevel)
-			m_nComponentDepthLevel = nLevel;
+		m_nComponentDepthLevel = nLevel;
 	}
 
 
@@ -42,7 +42,6 @@ namespace NMR {
 		_In_ CModel * pModel, _In_ PModelTexture2DResource pTexture2D)
 		: CModelResource(sID, pModel)
 	{
-		m_nNextPropertyID = 1;
 		if (!pTexture2D.get())
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		m_pTexture2D = pTexture2D;
@@ -50,51 +49,46 @@ namespace NMR {
 
 	nfUint32 CModelTexture2DGroupResource::addUVCoordinate(_In_ MODELTEXTURE2DCOORDINATE UV)
 	{
-		nfUint32 nID = m_nNextPropertyID;
 		if (getCount() >= XML_3MF_MAXRESOURCEINDEX) {
 			throw CNMRException(NMR_ERROR_TOOMANYCOLORS);
 		}
 
-		m_pUVCoordinates.insert(std::make_pair(nID, UV));
-
-		m_nNextPropertyID++;
-
-		clearResourceIndexMap();
-
-		return nID;
+		return m_UVCoordinates.add(UV);
 	}
 
 	nfUint32 CModelTexture2DGroupResource::getCount()
 	{
-		return (nfUint32)m_pUVCoordinates.size();
+		return m_UVCoordinates.getCount();
 	}
 
 	void CModelTexture2DGroupResource::setUVCoordinate(_In_ ModelPropertyID nPropertyID, _In_ MODELTEXTURE2DCOORDINATE sCoordinate)
 	{
-		auto iIterator = m_pUVCoordinates.find(nPropertyID);
-		if (iIterator != m_pUVCoordinates.end()) {
-			iIterator->second = sCoordinate;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		m_UVCoordinates.get(nPropertyID) = sCoordinate;
 	}
 
 	void CModelTexture2DGroupResource::removePropertyID(_In_ ModelPropertyID nPropertyID)
 	{
-		m_pUVCoordinates.erase(nPropertyID);
-		clearResourceIndexMap();
+		m_UVCoordinates.remove(nPropertyID);
 	}
 
 	MODELTEXTURE2DCOORDINATE CModelTexture2DGroupResource::getUVCoordinate(_In_ ModelPropertyID nPropertyID)
 	{
-		auto iIterator = m_pUVCoordinates.find(nPropertyID);
-		if (iIterator != m_pUVCoordinates.end()) {
-			return iIterator->second;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		return m_UVCoordinates.get(nPropertyID);
+	}
+
+	MODELTEXTURE2DCOORDINATE CModelTexture2DGroupResource::getUVCoordinateByIndex(_In_ ModelResourceIndex nIndex)
+	{
+		return m_UVCoordinates.getByIndex(nIndex);
+	}
+
+	void CModelTexture2DGroupResource::setUVCoordinateByIndex(_In_ ModelResourceIndex nIndex, _In_ MODELTEXTURE2DCOORDINATE sCoordinate)
+	{
+		m_UVCoordinates.getByIndex(nIndex) = sCoordinate;
+	}
+
+	void CModelTexture2DGroupResource::reserveUVCoordinates(_In_ nfUint32 nCount)
+	{
+		m_UVCoordinates.reserve(nCount);
 	}
 
 	void CModelTexture2DGroupResource::mergeFrom(_In_ CModelTexture2DGroupResource * pSourceTexture2DGroup)
@@ -103,35 +97,25 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		
 		nfUint32 nCount = pSourceTexture2DGroup->getCount();
-		pSourceTexture2DGroup->buildResourceIndexMap();
-
+		m_UVCoordinates.reserve(getCount() + nCount);
 		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
-			ModelPropertyID nPropertyID;
-			pSourceTexture2DGroup->mapResourceIndexToPropertyID(nIndex, nPropertyID);
-			MODELTEXTURE2DCOORDINATE UVCoordinate = pSourceTexture2DGroup->getUVCoordinate(nPropertyID);
-			addUVCoordinate(UVCoordinate);
+			addUVCoordinate(pSourceTexture2DGroup->getUVCoordinateByIndex(nIndex));
 		}
-		clearResourceIndexMap();
 	}
 
+	// The coordinate array itself maps resource indices to PropertyIDs
 	void CModelTexture2DGroupResource::buildResourceIndexMap()
 	{
-		m_ResourceIndexMap.clear();
-		m_ResourceIndexMap.reserve(m_pUVCoordinates.size());
-
-		auto iIterator = m_pUVCoordinates.begin();
-		while (iIterator != m_pUVCoordinates.end()) {
-			m_ResourceIndexMap.push_back(iIterator->first);
-			iIterator++;
-		}
-
 		m_bHasResourceIndexMap = true;
 	}
 
+	bool CModelTexture2DGroupResource::mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID)
+	{
+		return m_UVCoordinates.getPropertyID(nPropertyIndex, nPropertyID);
+	}
 
 	PModelTexture2DResource CModelTexture2DGroupResource::getTexture2D()
 	{
 		return m_pTexture2D;
 	}
 }
-
@@ -139,27 +139,21 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_DUPLICATERESOURCEID);
 
 		PPackageResourceID pPackageResourceID = std::make_shared<CPackageResourceID>(this, pModelPath, id);
-		UniqueIDPackageIdMap::const_iterator biggestId = std::max_element(m_resourceIDs.begin(), m_resourceIDs.end(), [](const UniqueIdPackageIdPair & v1, const UniqueIdPackageIdPair v2) {
-			return v1.first < v2.first;
-		});
-		if (biggestId != m_resourceIDs.end()) {
-			pPackageResourceID->setUniqueID(int(biggestId->first) + 1);
-		} else {
-			pPackageResourceID->setUniqueID(1);
-		}
-
+		// One more than the biggest unique ID in use
+		if (m_resourceIDs.empty())
+			m_resourceIDs.resize(1);
+		pPackageResourceID->setUniqueID((UniqueResourceID)m_resourceIDs.size());
 
-		m_resourceIDs.insert(std::make_pair(pPackageResourceID->getUniqueID(), pPackageResourceID));
+		m_resourceIDs.push_back(pPackageResourceID);
 		m_IdAndPathToPackageResourceIDs.insert(std::make_pair(std::make_pair(id, pModelPath), pPackageResourceID));
 		return pPackageResourceID;
 	}
 
 	PPackageResourceID CResourceHandler::findResourceIDByUniqueID(UniqueResourceID id)
 	{
-		auto it = m_resourceIDs.find(id);
-		if (it != m_resourceIDs.end())
+		if (id < m_resourceIDs.size())
 		{
-			return it->second;
+			return m_resourceIDs[id];
 		}
 		return nullptr;
 	}
@@ -216,13 +210,15 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		}
 
-		auto itID = m_resourceIDs.find(pPackageResourceID->m_uniqueID);
-		if (itID == m_resourceIDs.end())
+		UniqueResourceID nUniqueID = pPackageResourceID->m_uniqueID;
+		if ((nUniqueID >= m_resourceIDs.size()) || (!m_resourceIDs[nUniqueID]))
 		{
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		}
 		m_IdAndPathToPackageResourceIDs.erase(it);
-		m_resourceIDs.erase(itID);
+		m_resourceIDs[nUniqueID] = nullptr;
+		while ((!m_resourceIDs.empty()) && (!m_resourceIDs.back()))
+			m_resourceIDs.pop_back();
 	}
 
 	void CResourceHandler::clear() {
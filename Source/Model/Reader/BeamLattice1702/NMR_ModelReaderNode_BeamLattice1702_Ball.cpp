@@ -53,13 +53,18 @@ namespace NMR {
 	CModelReaderNode_BeamLattice1702_Ball::CModelReaderNode_BeamLattice1702_Ball(_In_ CModel* pModel, _In_ PModelWarnings pWarnings)
 		: CModelReaderNode(pWarnings)
 	{
+		reset();
+	}
+
+	void CModelReaderNode_BeamLattice1702_Ball::reset()
+	{
+		resetParseState();
+
 		m_nIndex = -1;
 
 		m_bHasRadius = false;
 		m_dRadius = 0;
 
-		m_bHasRadius = false;
-
 		m_bHasTag = false;
 		m_nTag = -1;
 	}
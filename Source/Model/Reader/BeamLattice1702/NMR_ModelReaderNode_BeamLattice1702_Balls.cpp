@@ -42,7 +42,7 @@ namespace NMR {
 	
 	CModelReaderNode_BeamLattice1702_Balls::CModelReaderNode_BeamLattice1702_Balls(_In_ CModel * pModel, _In_ CMesh * pMesh,
 		_In_ nfDouble defaultBallRadius, _In_ PModelWarnings pWarnings)
-		: CModelReaderNode(pWarnings)
+		: CModelReaderNode(pWarnings), m_BallNode(pModel, pWarnings)
 	{
 		__NMRASSERT(pMesh);
 		__NMRASSERT(pModel);
@@ -79,18 +79,16 @@ namespace NMR {
 		if (strcmp(pNameSpace, XML_3MF_NAMESPACE_BEAMLATTICESPEC) == 0) {
 			if (strcmp(pChildName, XML_3MF_ELEMENT_BALL) == 0) {
 				// Parse XML
-				PModelReaderNode_BeamLattice1702_Ball pXMLNode = std::make_shared<CModelReaderNode_BeamLattice1702_Ball>(m_pModel, m_pWarnings);
-				pXMLNode->parseXML(pXMLReader);
+				m_BallNode.reset();
+				m_BallNode.parseXML(pXMLReader);
 
 				// Retrieve node index
 				nfInt32 nIndex;
-				pXMLNode->retrieveIndex(nIndex, m_pMesh->getNodeCount());
+				m_BallNode.retrieveIndex(nIndex, m_pMesh->getNodeCount());
 
-				nfInt32 nTag;
-				nfBool bHasTag, bHasRadius;
+				nfBool bHasRadius;
 				nfDouble dRadius;
-				pXMLNode->retrieveTag(bHasTag, nTag);
-				pXMLNode->retrieveRadius(bHasRadius, dRadius);
+				m_BallNode.retrieveRadius(bHasRadius, dRadius);
 				
 				if (!bHasRadius) {
 					dRadius = m_dDefaultBallRadius;
@@ -56,6 +56,13 @@ namespace NMR {
 	CModelReaderNode_BeamLattice1702_Beam::CModelReaderNode_BeamLattice1702_Beam(_In_ CModel * pModel, _In_ PModelWarnings pWarnings)
 		: CModelReaderNode(pWarnings)
 	{
+		reset();
+	}
+
+	void CModelReaderNode_BeamLattice1702_Beam::reset()
+	{
+		resetParseState();
+
 		m_nIndex1 = -1;
 		m_nIndex2 = -1;
 
@@ -66,6 +73,8 @@ namespace NMR {
 
 		m_bHasCap1 = false;
 		m_bHasCap2 = false;
+		m_eCapMode1 = eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE;
+		m_eCapMode2 = eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE;
 
 		m_bHasTag = false;
 		m_nTag = -1;
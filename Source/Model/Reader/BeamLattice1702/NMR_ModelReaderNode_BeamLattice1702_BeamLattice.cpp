@@ -109,6 +109,7 @@ namespace NMR {
 			if ( std::isnan(dValue) || (dValue <= 0) || (dValue > XML_3MF_MAXIMUMCOORDINATEVALUE) )
 				throw CNMRException(NMR_ERROR_BEAMLATTICEINVALIDATTRIBUTE);
 			m_dDefaultRadius = dValue;
+			m_pMesh->setDefaultBeamRadius(dValue);
 		}
 		else if ( (strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_MINLENGTH) == 0) ||
 			(strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_PRECISION) == 0) )	// legacy
@@ -144,6 +145,7 @@ namespace NMR {
 		}
 		else if (strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_CAPMODE) == 0) {
 			m_eDefaultCapMode = stringToCapMode(pAttributeValue);
+			m_pMesh->setBeamLatticeCapMode(m_eDefaultCapMode);
 		}
 		else if (strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_BALLMODE) == 0) {
 			m_pMesh->setBeamLatticeBallMode(stringToBallMode(pAttributeValue));
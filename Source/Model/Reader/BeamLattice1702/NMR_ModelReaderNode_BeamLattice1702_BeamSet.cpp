@@ -46,7 +46,7 @@ NMR_ModelReaderNode_BeamLattice1702_BeamSet.cpp covers the official 3MF beamlatt
 namespace NMR {
 
 	CModelReaderNode_BeamLattice1702_BeamSet::CModelReaderNode_BeamLattice1702_BeamSet(_In_ BEAMSET * pBeamSet, _In_ std::unordered_set<std::string> * pUniqueIdentifiers, _In_ PModelWarnings pWarnings)
-		: CModelReaderNode(pWarnings)
+		: CModelReaderNode(pWarnings), m_RefNode(pWarnings), m_BallRefNode(pWarnings)
 	{
 		m_pBeamSet = pBeamSet;
 		m_pUniqueIdentifiers = pUniqueIdentifiers;
@@ -94,6 +94,18 @@ namespace NMR {
 
 	}
 	
+	void CModelReaderNode_BeamLattice1702_BeamSet::appendIndex(_In_ std::vector<nfUint32> & Indices, _In_ nfInt32 nIndex)
+	{
+		// Grow by at least one chunk, so that beam sets do not reallocate every few references
+		if (Indices.size() == Indices.capacity()) {
+			size_t nGrowth = Indices.capacity();
+			if (nGrowth < NMR_MESH_BEAMSETREFBLOCKCOUNT)
+				nGrowth = NMR_MESH_BEAMSETREFBLOCKCOUNT;
+			Indices.reserve(Indices.capacity() + nGrowth);
+		}
+		Indices.push_back(nIndex);
+	}
+
 	void CModelReaderNode_BeamLattice1702_BeamSet::OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader)
 	{
 		__NMRASSERT(pChildName);
@@ -102,18 +114,18 @@ namespace NMR {
 
 		if (strcmp(pNameSpace, XML_3MF_NAMESPACE_BEAMLATTICESPEC) == 0) {
 			if (strcmp(pChildName, XML_3MF_ELEMENT_REF) == 0) {
-				PModelReaderNode_BeamLattice1702_Ref pXMLNode = std::make_shared<CModelReaderNode_BeamLattice1702_Ref>(m_pWarnings);
-				pXMLNode->parseXML(pXMLReader);
+				m_RefNode.reset();
+				m_RefNode.parseXML(pXMLReader);
 				nfInt32 nIndex;
-				pXMLNode->retrieveIndex(nIndex);
-				m_pBeamSet->m_Refs.push_back(nIndex);
+				m_RefNode.retrieveIndex(nIndex);
+				appendIndex(m_pBeamSet->m_Refs, nIndex);
 			}
 			else if (strcmp(pChildName, XML_3MF_ELEMENT_BALLREF) == 0) {
-				PModelReaderNode_BeamLattice1702_BallRef pXMLNode = std::make_shared<CModelReaderNode_BeamLattice1702_BallRef>(m_pWarnings);
-				pXMLNode->parseXML(pXMLReader);
+				m_BallRefNode.reset();
+				m_BallRefNode.parseXML(pXMLReader);
 				nfInt32 nIndex;
-				pXMLNode->retrieveIndex(nIndex);
-				m_pBeamSet->m_BallRefs.push_back(nIndex);
+				m_BallRefNode.retrieveIndex(nIndex);
+				appendIndex(m_pBeamSet->m_BallRefs, nIndex);
 			}
 			else
 				m_pWarnings->addException(CNMRException(NMR_ERROR_NAMESPACE_INVALID_ELEMENT), mrwInvalidOptionalValue);
@@ -44,7 +44,7 @@ namespace NMR {
 	CModelReaderNode_BeamLattice1702_Beams::CModelReaderNode_BeamLattice1702_Beams(_In_ CModel * pModel, _In_ CMesh * pMesh,
 		_In_ nfDouble defaultRadius, _In_ eModelBeamLatticeCapMode defaultCapMode,
 		_In_ PModelWarnings pWarnings)
-		: CModelReaderNode(pWarnings)
+		: CModelReaderNode(pWarnings), m_BeamNode(pModel, pWarnings)
 	{
 		__NMRASSERT(pMesh);
 		__NMRASSERT(pModel);
@@ -82,12 +82,12 @@ namespace NMR {
 		if (strcmp(pNameSpace, XML_3MF_NAMESPACE_BEAMLATTICESPEC) == 0) {
 			if (strcmp(pChildName, XML_3MF_ELEMENT_BEAM) == 0) {
 				// Parse XML
-				PModelReaderNode_BeamLattice1702_Beam pXMLNode = std::make_shared<CModelReaderNode_BeamLattice1702_Beam>(m_pModel, m_pWarnings);
-				pXMLNode->parseXML(pXMLReader);
+				m_BeamNode.reset();
+				m_BeamNode.parseXML(pXMLReader);
 
 				// Retrieve node indices
 				nfInt32 nIndex1, nIndex2;
-				pXMLNode->retrieveIndices(nIndex1, nIndex2, m_pMesh->getNodeCount());
+				m_BeamNode.retrieveIndices(nIndex1, nIndex2, m_pMesh->getNodeCount());
 
 				MESHNODE* pNode1 = m_pMesh->getNode(nIndex1);
 				MESHNODE* pNode2 = m_pMesh->getNode(nIndex2);
@@ -95,11 +95,9 @@ namespace NMR {
 				if (fnVEC3_length(fnVEC3_sub(pNode1->m_position, pNode2->m_position)) < m_pMesh->getBeamLatticeMinLength())
 					m_pWarnings->addException(CNMRException(NMR_ERROR_BEAMLATTICENODESTOOCLOSE), mrwInvalidMandatoryValue);
 
-				nfInt32 nTag;
-				nfBool bHasTag, bHasRadius1, bHasRadius2;
+				nfBool bHasRadius1, bHasRadius2;
 				nfDouble dRadius1, dRadius2;
-				pXMLNode->retrieveTag(bHasTag, nTag);
-				pXMLNode->retrieveRadii(bHasRadius1, dRadius1, bHasRadius2, dRadius2);
+				m_BeamNode.retrieveRadii(bHasRadius1, dRadius1, bHasRadius2, dRadius2);
 				nfDouble dDefaultValueForR2 = m_dDefaultRadius;
 				if (bHasRadius1) {
 					dDefaultValueForR2 = dRadius1;
@@ -115,16 +113,12 @@ namespace NMR {
 				nfBool bHasCapMode1, bHasCapMode2;
 				eModelBeamLatticeCapMode eCap1, eCap2;
 				nfInt32 nCap1, nCap2;
-				pXMLNode->retrieveCapModes(bHasCapMode1, eCap1, bHasCapMode2, eCap2);
+				m_BeamNode.retrieveCapModes(bHasCapMode1, eCap1, bHasCapMode2, eCap2);
 				nCap1 = bHasCapMode1 ? eCap1 : m_eDefaultCapMode;
 				nCap2 = bHasCapMode2 ? eCap2 : m_eDefaultCapMode;
 
-				// Create beam if valid
-				if (nIndex1 != nIndex2) {
-					MESHNODE * pNode1 = m_pMesh->getNode(nIndex1);
-					MESHNODE * pNode2 = m_pMesh->getNode(nIndex2);
-					m_pMesh->addBeam(pNode1, pNode2, dRadius1, dRadius2, nCap1, nCap2);
-				}
+				// Create beam (retrieveIndices guarantees that both indices are valid and distinct)
+				m_pMesh->addBeam(nIndex1, nIndex2, dRadius1, dRadius2, nCap1, nCap2);
 			}
 			else
 				m_pWarnings->addException(CNMRException(NMR_ERROR_NAMESPACE_INVALID_ELEMENT), mrwInvalidOptionalValue);
@@ -59,6 +59,12 @@ namespace NMR {
 
 	}
 
+	void CModelReaderNode_BeamLattice1702_Ref::reset()
+	{
+		resetParseState();
+		m_nIndex = 0;
+	}
+
 	void CModelReaderNode_BeamLattice1702_Ref::retrieveIndex(_Out_ nfInt32 & nIndex)
 	{
 		nIndex = m_nIndex;
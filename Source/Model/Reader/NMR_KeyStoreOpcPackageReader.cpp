@@ -53,12 +53,12 @@ NMR_KeyStoreOpcPackageReader.cpp defines an OPC Package reader in a portable way
 #include <cstring>
 
 namespace NMR {
-	CKeyStoreOpcPackageReader::CKeyStoreOpcPackageReader(PImportStream pImportStream, CModelContext const & context)
+	CKeyStoreOpcPackageReader::CKeyStoreOpcPackageReader(PImportStream pImportStream, CModelContext const & context, nfBool bCheckConsistency)
 		:m_pContext(context)
 	{
 		if (!context.isComplete())
 			throw CNMRException(NMR_ERROR_INVALIDPOINTER);
-		m_pPackageReader = std::make_shared<COpcPackageReader>(pImportStream, context.warnings(), context.monitor());
+		m_pPackageReader = std::make_shared<COpcPackageReader>(pImportStream, context.warnings(), context.monitor(), bCheckConsistency);
 
 		PImportStream keyStoreStream = findKeyStoreStream();
 		if (nullptr != keyStoreStream) {
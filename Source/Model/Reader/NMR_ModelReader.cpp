@@ -43,7 +43,7 @@ A model reader reads in a model file and generates an in-memory representation o
 namespace NMR {
 
 	CModelReader::CModelReader(_In_ PModel pModel)
-		:CModelContext(pModel)
+		:CModelContext(pModel), m_nExtractionThreadCount(1), m_bRootModelReadAhead(true), m_bPackageConsistencyCheck(false)
 	{
 	}
 
@@ -82,4 +82,34 @@ namespace NMR {
 		m_RelationsToRead.erase(sRelationShipType);
 	}
 
+	void CModelReader::SetExtractionThreadCount(nfUint32 nThreadCount)
+	{
+		m_nExtractionThreadCount = nThreadCount;
+	}
+
+	nfUint32 CModelReader::GetExtractionThreadCount()
+	{
+		return m_nExtractionThreadCount;
+	}
+
+	void CModelReader::SetRootModelReadAhead(nfBool bReadAhead)
+	{
+		m_bRootModelReadAhead = bReadAhead;
+	}
+
+	nfBool CModelReader::GetRootModelReadAhead()
+	{
+		return m_bRootModelReadAhead;
+	}
+
+	void CModelReader::SetPackageConsistencyCheck(nfBool bCheckConsistency)
+	{
+		m_bPackageConsistencyCheck = bCheckConsistency;
+	}
+
+	nfBool CModelReader::GetPackageConsistencyCheck()
+	{
+		return m_bPackageConsistencyCheck;
+	}
+
 }
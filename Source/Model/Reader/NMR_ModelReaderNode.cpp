@@ -70,8 +70,7 @@ namespace NMR {
 		if (!pszName)
 			throw CNMRException(NMR_ERROR_COULDNOTGETLOCALXMLNAME);
 
-		std::string sName(pszName);
-		m_sName = sName;
+		m_sName.assign(pszName);
 
 		if (m_sName == "")
 			throw CNMRException(NMR_ERROR_NODENAMEISEMPTY);
@@ -79,6 +78,14 @@ namespace NMR {
 		m_bIsEmptyElement = pXMLReader->IsEmptyElement() != 0;
 	}
 
+	void CModelReaderNode::resetParseState()
+	{
+		m_sName.clear();
+		m_bParsedAttributes = false;
+		m_bParsedContent = false;
+		m_bIsEmptyElement = false;
+	}
+
 	std::string CModelReaderNode::getName()
 	{
 		return m_sName;
@@ -42,6 +42,7 @@ NMR_ModelReader_3MF.cpp implements the Model Reader Class for
 #include "Common/NMR_Exception_Windows.h"
 #include "Common/MeshImport/NMR_MeshImporter_STL.h"
 #include "Common/Platform/NMR_Platform.h"
+#include "Common/Platform/NMR_ImportStream_Pipelined.h"
 #include "Model/Classes/NMR_ModelAttachment.h" 
 
 #include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_SliceRefModel.h"
@@ -135,47 +136,66 @@ namespace NMR {
 		monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READROOTMODEL);
 		monitor()->ReportProgressAndQueryCancelled(true);
 
-		// Create XML Reader
-		PXmlReader pXMLReader = fnCreateXMLReaderInstance(pModelStream, monitor());
+		// Inflate and decrypt large root models on a background thread while they are parsed
+		PImportStream_Pipelined pPipelinedStream;
+		if (GetRootModelReadAhead() && CImportStream_Pipelined::isPipeliningBeneficial(pModelStream->retrieveSize())) {
+			pPipelinedStream = std::make_shared<CImportStream_Pipelined>(pModelStream);
+			pModelStream = pPipelinedStream;
+		}
 
-		eXmlReaderNodeType NodeType;
-		// Read all XML Root Nodes
-		while (!pXMLReader->IsEOF()) {
-			if (!pXMLReader->Read(NodeType))
-				break;
+		try {
+			// Create XML Reader
+			PXmlReader pXMLReader = fnCreateXMLReaderInstance(pModelStream, monitor());
 
-			// Get Node Name
-			LPCSTR pszLocalName = nullptr;
-			pXMLReader->GetLocalName(&pszLocalName, nullptr);
-			if (!pszLocalName)
-				throw CNMRException(NMR_ERROR_COULDNOTGETLOCALXMLNAME);
+			eXmlReaderNodeType NodeType;
+			// Read all XML Root Nodes
+			while (!pXMLReader->IsEOF()) {
+				if (!pXMLReader->Read(NodeType))
+					break;
 
-			if (strcmp(pszLocalName, XML_3MF_ATTRIBUTE_PREFIX_XML) == 0) {
-				PModelReader_InstructionElement pXMLNode = std::make_shared<CModelReader_InstructionElement>(warnings());
-				pXMLNode->parseXML(pXMLReader.get());
-			}
+				// Get Node Name
+				LPCSTR pszLocalName = nullptr;
+				pXMLReader->GetLocalName(&pszLocalName, nullptr);
+				if (!pszLocalName)
+					throw CNMRException(NMR_ERROR_COULDNOTGETLOCALXMLNAME);
 
-			// Compare with Model Node Name
-			if (strcmp(pszLocalName, XML_3MF_ELEMENT_MODEL) == 0) {
-				if (bHasModel)
-					throw CNMRException(NMR_ERROR_DUPLICATEMODELNODE);
-				bHasModel = true;
+				if (strcmp(pszLocalName, XML_3MF_ATTRIBUTE_PREFIX_XML) == 0) {
+					PModelReader_InstructionElement pXMLNode = std::make_shared<CModelReader_InstructionElement>(warnings());
+					pXMLNode->parseXML(pXMLReader.get());
+				}
 
-				model()->setCurrentPath(model()->rootPath());
-				PModelReaderNode_ModelBase pXMLNode = std::make_shared<CModelReaderNode_ModelBase>(model().get(), warnings(), model()->rootPath(), monitor());
-				pXMLNode->parseXML(pXMLReader.get());
+				// Compare with Model Node Name
+				if (strcmp(pszLocalName, XML_3MF_ELEMENT_MODEL) == 0) {
+					if (bHasModel)
+						throw CNMRException(NMR_ERROR_DUPLICATEMODELNODE);
+					bHasModel = true;
 
-				if (!pXMLNode->getHasResources())
-					throw CNMRException(NMR_ERROR_NORESOURCES);
-				if (!pXMLNode->getHasBuild())
-					throw CNMRException(NMR_ERROR_NOBUILD);
-			}
+					model()->setCurrentPath(model()->rootPath());
+					PModelReaderNode_ModelBase pXMLNode = std::make_shared<CModelReaderNode_ModelBase>(model().get(), warnings(), model()->rootPath(), monitor());
+					pXMLNode->parseXML(pXMLReader.get());
 
+					if (!pXMLNode->getHasResources())
+						throw CNMRException(NMR_ERROR_NORESOURCES);
+					if (!pXMLNode->getHasBuild())
+						throw CNMRException(NMR_ERROR_NOBUILD);
+				}
+
+			}
+		}
+		catch (...) {
+			// Parsing failed or was aborted, the background thread must not outlive the package
+			if (pPipelinedStream)
+				pPipelinedStream->stopReading();
+			throw;
 		}
 
 		monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_CLEANUP);
 		monitor()->ReportProgressAndQueryCancelled(false);
 
+		// The package must not be read from the background anymore when it is released
+		if (pPipelinedStream)
+			pPipelinedStream->stopReading();
+
 		// Release Memory of 3MF Package
 		release3MFOPCPackage();
 
@@ -44,6 +44,10 @@ It uses libzip and irrxml to parse the OPC package.
 #include "Common/Platform/NMR_Platform.h"
 #include "Model/Reader/NMR_ModelReader_InstructionElement.h"
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 namespace NMR {
 
 	CModelReader_3MF_Native::CModelReader_3MF_Native(_In_ PModel pModel)
@@ -56,7 +60,10 @@ namespace NMR {
 
 	PImportStream CModelReader_3MF_Native::extract3MFOPCPackage(_In_ PImportStream pPackageStream)
 	{
-		m_pPackageReader = std::make_shared<CKeyStoreOpcPackageReader>(pPackageStream, *this);
+		// In strict mode an inconsistent ZIP file fails to load, so it is always checked up front
+		nfBool bCheckConsistency = GetPackageConsistencyCheck() || (warnings()->getCriticalWarningLevel() >= mrwInvalidMandatoryValue);
+		m_pPackageReader = std::make_shared<CKeyStoreOpcPackageReader>(pPackageStream, *this, bCheckConsistency);
+		m_InflateQueue.clear();
 
 		COpcPackageRelationship * pModelRelation = m_pPackageReader->findRootRelation(PACKAGE_START_PART_RELATIONSHIP_TYPE, true);
 		if (pModelRelation == nullptr)
@@ -93,10 +100,13 @@ namespace NMR {
 			if (pThumbnailPart == nullptr)
 				throw CNMRException(NMR_ERROR_OPCCOULDNOTGETTHUMBNAILSTREAM);
 			PImportStream pThumbnailStream = pThumbnailPart->getImportStream()->copyToMemory();
+			queueInflate(pThumbnailStream);
 			model()->addPackageThumbnail()->setStream(pThumbnailStream);
 			monitor()->IncrementProgress((double)pThumbnailStream->retrieveSize());
 			monitor()->ReportProgressAndQueryCancelled(true);
 		}
+
+		inflateQueuedStreams();
 		
 		return pModelPart->getImportStream();
 	}
@@ -106,6 +116,77 @@ namespace NMR {
 		//foreach part, finalize encryption contexts
 		m_pPackageReader->close();
 		m_pPackageReader = nullptr;
+		m_InflateQueue.clear();
+	}
+
+	void CModelReader_3MF_Native::queueInflate(_In_ PImportStream pMemoryStream)
+	{
+		if (GetExtractionThreadCount() == 1)
+			return;
+
+		// Only parts that have been copied deflated can be inflated in parallel,
+		// decrypted parts are already inflated by the key store reader
+		auto pDeflatedStream = std::dynamic_pointer_cast<CImportStream_Deflated_Memory>(pMemoryStream);
+		if (pDeflatedStream.get() != nullptr)
+			m_InflateQueue.push_back(pDeflatedStream);
+	}
+
+	void CModelReader_3MF_Native::inflateQueuedStreams()
+	{
+		// The ZIP archive is read through a single stream, so the deflated data is read one part after
+		// another while copying to memory. Only inflating is spread over the worker threads.
+		std::vector<std::shared_ptr<CImportStream_Deflated_Memory>> Queue;
+		Queue.swap(m_InflateQueue);
+
+		nfUint64 nThreadCount = GetExtractionThreadCount();
+		if (nThreadCount == 0)
+			nThreadCount = std::thread::hardware_concurrency();
+		if (nThreadCount > Queue.size())
+			nThreadCount = Queue.size();
+		if (nThreadCount < 2)
+			return;
+
+		std::atomic<size_t> nNextIndex(0);
+		auto fnWork = [&Queue, &nNextIndex]() {
+			size_t nIndex;
+			while ((nIndex = nNextIndex++) < Queue.size()) {
+				try {
+					Queue[nIndex]->ensureInflated();
+				}
+				catch (CNMRException &) {
+					// the stream stays deflated and reports the error when it is read
+				}
+			}
+		};
+
+		std::vector<std::exception_ptr> Exceptions((size_t)nThreadCount);
+		std::vector<std::thread> Threads;
+		Threads.reserve((size_t)nThreadCount);
+		try {
+			for (size_t nThread = 1; nThread < nThreadCount; nThread++) {
+				Threads.push_back(std::thread([&Exceptions, &fnWork, nThread]() {
+					try {
+						fnWork();
+					}
+					catch (...) {
+						Exceptions[nThread] = std::current_exception();
+					}
+				}));
+			}
+			fnWork();
+		}
+		catch (...) {
+			Exceptions[0] = std::current_exception();
+		}
+
+		for (auto iIterator = Threads.begin(); iIterator != Threads.end(); iIterator++)
+			iIterator->join();
+		for (auto iIterator = Exceptions.begin(); iIterator != Exceptions.end(); iIterator++) {
+			if (*iIterator)
+				std::rethrow_exception(*iIterator);
+		}
+
+		monitor()->ReportProgressAndQueryCancelled(true);
 	}
 
 	void CModelReader_3MF_Native::extractTexturesFromRelationships(_In_ std::string& sTargetPartURIDir, _In_ COpcPackagePart * pModelPart)
@@ -137,6 +218,7 @@ namespace NMR {
 					POpcPackagePart pTexturePart = m_pPackageReader->createPart(sURI);
 					PImportStream pTextureAttachmentStream = pTexturePart->getImportStream();
 					PImportStream pMemoryStream = pTextureAttachmentStream->copyToMemory();
+					queueInflate(pMemoryStream);
 
 					if (pMemoryStream->retrieveSize() == 0)
 						warnings()->addException(CNMRException(NMR_ERROR_IMPORTSTREAMISEMPTY), mrwMissingMandatoryValue);
@@ -176,6 +258,7 @@ namespace NMR {
 				PImportStream pAttachmentStream = pPart->getImportStream();
 				try {
 					PImportStream pMemoryStream = pAttachmentStream->copyToMemory();
+					queueInflate(pMemoryStream);
 
 					if (pMemoryStream->retrieveSize() == 0)
 						warnings()->addException(CNMRException(NMR_ERROR_IMPORTSTREAMISEMPTY), mrwMissingMandatoryValue);
@@ -234,6 +317,7 @@ namespace NMR {
 					// this is the first time this attachment is read
 					PImportStream pAttachmentStream = pPart->getImportStream();
 					PImportStream pMemoryStream = pAttachmentStream->copyToMemory();
+					queueInflate(pMemoryStream);
 					if (pMemoryStream->retrieveSize() == 0)
 						warnings()->addException(CNMRException(NMR_ERROR_IMPORTSTREAMISEMPTY), mrwMissingMandatoryValue);
 					model()->addProductionAttachment(sURI, sRelationShipType, pMemoryStream, true);
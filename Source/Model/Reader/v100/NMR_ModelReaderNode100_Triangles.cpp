@@ -54,6 +54,8 @@ namespace NMR {
 		m_nDefaultResourceIndex = nDefaultPropertyIndex;
 
 		m_nUsedResourceID = 0;
+		m_nLastResolvedPropertyResource = 0;
+		m_pPropertiesInformation = nullptr;
 
 		m_pModel = pModel;
 		m_pMesh = pMesh;
@@ -80,6 +82,9 @@ namespace NMR {
 
 	_Ret_notnull_ CMeshInformation_Properties * CModelReaderNode100_Triangles::createPropertiesInformation()
 	{
+		if (m_pPropertiesInformation)
+			return m_pPropertiesInformation;
+
 		CMeshInformationHandler * pMeshInformationHandler = m_pMesh->createMeshInformationHandler();
 
 		CMeshInformation * pInformation = pMeshInformationHandler->getInformationByType(0, emiProperties);
@@ -95,9 +100,39 @@ namespace NMR {
 			pProperties = pNewMeshInformation.get();
 		}
 
+		m_pPropertiesInformation = pProperties;
 		return pProperties;
 	}
 
+	READERRESOLVEDPROPERTYRESOURCE & CModelReaderNode100_Triangles::resolvePropertyResource(_In_ ModelResourceID nResourceID)
+	{
+		// Consecutive triangles mostly share the same pid
+		if ((m_nLastResolvedPropertyResource < m_ResolvedPropertyResources.size()) &&
+			(m_ResolvedPropertyResources[m_nLastResolvedPropertyResource].m_nResourceID == nResourceID))
+			return m_ResolvedPropertyResources[m_nLastResolvedPropertyResource];
+
+		auto iIterator = m_ResolvedPropertyResourceIndices.find(nResourceID);
+		if (iIterator != m_ResolvedPropertyResourceIndices.end()) {
+			m_nLastResolvedPropertyResource = iIterator->second;
+			return m_ResolvedPropertyResources[m_nLastResolvedPropertyResource];
+		}
+
+		READERRESOLVEDPROPERTYRESOURCE resolvedResource;
+		resolvedResource.m_nResourceID = nResourceID;
+		resolvedResource.m_pPackageResourceID = m_pModel->findPackageResourceID(m_pModel->currentPath(), nResourceID);
+		if (resolvedResource.m_pPackageResourceID.get()) {
+			resolvedResource.m_pResource = m_pModel->findResource(resolvedResource.m_pPackageResourceID->getUniqueID());
+			if (resolvedResource.m_pResource.get() && !resolvedResource.m_pResource->hasResourceIndexMap())
+				resolvedResource.m_pResource->buildResourceIndexMap();
+		}
+
+		m_nLastResolvedPropertyResource = m_ResolvedPropertyResources.size();
+		m_ResolvedPropertyResourceIndices.insert(std::make_pair(nResourceID, m_nLastResolvedPropertyResource));
+		m_ResolvedPropertyResources.push_back(resolvedResource);
+
+		return m_ResolvedPropertyResources.back();
+	}
+
 
 	void CModelReaderNode100_Triangles::OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader)
 	{
@@ -133,14 +168,12 @@ namespace NMR {
 						// set potential default properties (i.e. used pid)
 						m_nUsedResourceID = nModelResourceID;
 
-						PPackageResourceID pID = m_pModel->findPackageResourceID(m_pModel->currentPath(), nModelResourceID);
-						if (pID.get()) {
-							// Find and Assign Resource of this Property
-							PModelResource pResource = m_pModel->findResource(pID->getUniqueID());
-							if (pResource.get () != nullptr) {
-								if (!pResource->hasResourceIndexMap())
-									pResource->buildResourceIndexMap();
-
+						READERRESOLVEDPROPERTYRESOURCE & resolvedResource = resolvePropertyResource(nModelResourceID);
+						CPackageResourceID * pID = resolvedResource.m_pPackageResourceID.get();
+						if (pID) {
+							// Assign Resource of this Property
+							CModelResource * pResource = resolvedResource.m_pResource.get();
+							if (pResource != nullptr) {
 								ModelPropertyID pPropertyID1;
 								ModelPropertyID pPropertyID2;
 								ModelPropertyID pPropertyID3;
@@ -0,0 +1,198 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_KeyStoreEncryptionPipeline.cpp implements the CKeyStoreEncryptionPipeline Class.
+Worker threads compress and encrypt the content of secured parts into a pool of
+memory streams, while the writing thread commits the finished parts to the package
+in the order in which they were added.
+
+--*/
+
+#include "Model/Writer/NMR_KeyStoreEncryptionPipeline.h"
+#include "Common/OPC/NMR_OpcPackagePart.h"
+#include "Common/NMR_Exception.h"
+
+namespace NMR {
+
+	CKeyStoreEncryptionPipeline::CKeyStoreEncryptionPipeline(_In_ CKeyStoreOpcPackageWriter * pPackageWriter, _In_ nfUint32 nThreadCount)
+	{
+		if (pPackageWriter == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (nThreadCount == 0)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_pPackageWriter = pPackageWriter;
+		m_nThreadCount = nThreadCount;
+		m_nMaxBufferCount = nThreadCount * NMR_KEYSTOREENCRYPTIONPIPELINE_BUFFERSPERTHREAD;
+		m_nNextJobToStart = 0;
+		m_nNextJobToCommit = 0;
+		m_nBufferCount = 0;
+		m_bStopRequested = false;
+	}
+
+	CKeyStoreEncryptionPipeline::~CKeyStoreEncryptionPipeline()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_bStopRequested = true;
+		}
+		m_JobAvailable.notify_all();
+
+		for (auto iIterator = m_Threads.begin(); iIterator != m_Threads.end(); iIterator++)
+			iIterator->join();
+	}
+
+	nfUint32 CKeyStoreEncryptionPipeline::resolveThreadCount(_In_ nfUint32 nThreadCount)
+	{
+		if (nThreadCount == 0)
+			nThreadCount = std::thread::hardware_concurrency();
+		if (nThreadCount == 0)
+			nThreadCount = 1;
+		return nThreadCount;
+	}
+
+	nfBool CKeyStoreEncryptionPipeline::addPart(_In_ std::string sPath, _In_ PImportStream pStream, _In_ nfInt32 nCompressionLevel)
+	{
+		if (pStream.get() == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// The key store is only read on this thread
+		KEYSTOREENCRYPTIONJOB Job;
+		if (!m_pPackageWriter->getPartEncryption(sPath, Job.m_Descriptor, Job.m_bCompressed))
+			return false;
+
+		Job.m_sPath = sPath;
+		Job.m_pStream = pStream;
+		Job.m_nCompressionLevel = nCompressionLevel;
+		Job.m_bIsDone = false;
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_Jobs.push_back(std::move(Job));
+		}
+		m_JobAvailable.notify_one();
+
+		// Threads are only started once there is something to encrypt
+		if (m_Threads.size() < m_nThreadCount)
+			m_Threads.push_back(std::thread(&CKeyStoreEncryptionPipeline::runWorker, this));
+
+		return true;
+	}
+
+	POpcPackagePart CKeyStoreEncryptionPipeline::commitNextPart()
+	{
+		KEYSTOREENCRYPTIONJOB * pJob;
+		{
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			if (m_nNextJobToCommit >= m_Jobs.size())
+				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+			pJob = &m_Jobs[m_nNextJobToCommit];
+			m_JobDone.wait(Lock, [pJob] { return pJob->m_bIsDone; });
+		}
+
+		if (pJob->m_pException)
+			std::rethrow_exception(pJob->m_pException);
+
+		POpcPackagePart pPart = m_pPackageWriter->addEncryptedPart(pJob->m_sPath);
+		PExportStream pExportStream = pPart->getExportStream();
+		PExportStreamMemory pCipherText = pJob->m_pCipherText;
+		nfUint32 nChunkCount = pCipherText->getChunkCount();
+		for (nfUint32 nChunkIndex = 0; nChunkIndex < nChunkCount; nChunkIndex++) {
+			nfUint64 cbChunkSize;
+			const nfByte * pChunkData = pCipherText->getChunkData(nChunkIndex, cbChunkSize);
+			pExportStream->writeBuffer(pChunkData, cbChunkSize);
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			pJob->m_pCipherText = nullptr;
+			pJob->m_pStream = nullptr;
+			m_FreeBuffers.push_back(pCipherText);
+			m_nNextJobToCommit++;
+		}
+		m_JobAvailable.notify_one();
+
+		return pPart;
+	}
+
+	void CKeyStoreEncryptionPipeline::runWorker()
+	{
+		while (true) {
+			KEYSTOREENCRYPTIONJOB * pJob;
+			PExportStreamMemory pCipherText;
+			{
+				std::unique_lock<std::mutex> Lock(m_Mutex);
+				m_JobAvailable.wait(Lock, [this] {
+					return m_bStopRequested || ((m_nNextJobToStart < m_Jobs.size()) && (!m_FreeBuffers.empty() || (m_nBufferCount < m_nMaxBufferCount)));
+				});
+				if (m_bStopRequested)
+					return;
+
+				pJob = &m_Jobs[m_nNextJobToStart];
+				m_nNextJobToStart++;
+
+				if (!m_FreeBuffers.empty()) {
+					pCipherText = m_FreeBuffers.back();
+					m_FreeBuffers.pop_back();
+				}
+				else {
+					m_nBufferCount++;
+				}
+			}
+
+			std::exception_ptr pException;
+			try {
+				if (pCipherText.get() == nullptr)
+					pCipherText = std::make_shared<CExportStreamMemory>();
+				encryptJob(*pJob, pCipherText);
+			}
+			catch (...) {
+				pException = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+				pJob->m_pCipherText = pCipherText;
+				pJob->m_pException = pException;
+				pJob->m_bIsDone = true;
+			}
+			m_JobDone.notify_all();
+		}
+	}
+
+	void CKeyStoreEncryptionPipeline::encryptJob(_In_ KEYSTOREENCRYPTIONJOB & Job, _In_ PExportStreamMemory pCipherText)
+	{
+		pCipherText->clear();
+
+		PExportStream pEncryptionStream = CKeyStoreOpcPackageWriter::createEncryptionStream(pCipherText, Job.m_Descriptor, Job.m_bCompressed, Job.m_nCompressionLevel);
+		Job.m_pStream->seekPosition(0, true);
+		pEncryptionStream->copyFrom(Job.m_pStream.get(), Job.m_pStream->retrieveSize(), NMR_KEYSTOREENCRYPTIONPIPELINE_COPYBUFFERSIZE);
+	}
+
+}
@@ -108,23 +108,41 @@ namespace NMR {
 		return false;
 	}
 
-	POpcPackagePart CKeyStoreOpcPackageWriter::wrapPartStream(PKeyStoreResourceData rd, POpcPackagePart part) {
+	ContentEncryptionDescriptor CKeyStoreOpcPackageWriter::makeEncryptionDescriptor(PKeyStoreResourceData rd) {
 		PSecureContext const & secureContext = m_pContext.secureContext();
 		ContentEncryptionDescriptor p = secureContext->getDekCtx();
 		PKeyStoreResourceDataGroup rdg = m_pContext.keyStore()->findResourceDataGroupByResourceDataPath(rd->packagePath());
 		p.m_sDekDecryptData.m_sParams = CKeyStoreFactory::makeContentEncryptionParams(rd, rdg);
+		return p;
+	}
 
-		PExportStream stream;
-		PExportStream encryptStream = std::make_shared<CExportStream_Encrypted>(part->getExportStream(), p);
-		if (rd->isCompressed()) {
-			PExportStream compressStream = std::make_shared<CExportStream_Compressed>(encryptStream);
-			stream = compressStream;
-		} else {
-			stream = encryptStream;
-		}
+	POpcPackagePart CKeyStoreOpcPackageWriter::wrapPartStream(PKeyStoreResourceData rd, POpcPackagePart part, nfInt32 nCompressionLevel) {
+		PExportStream stream = createEncryptionStream(part->getExportStream(), makeEncryptionDescriptor(rd), rd->isCompressed(), nCompressionLevel);
 		return std::make_shared<COpcPackagePart>(*part, stream);
 	}
 
+	PExportStream CKeyStoreOpcPackageWriter::createEncryptionStream(_In_ PExportStream pCipherStream, _In_ ContentEncryptionDescriptor Descriptor, _In_ nfBool bCompressed, _In_ nfInt32 nCompressionLevel) {
+		PExportStream encryptStream = std::make_shared<CExportStream_Encrypted>(pCipherStream, Descriptor);
+		if (bCompressed) {
+			return std::make_shared<CExportStream_Compressed>(encryptStream, nCompressionLevel, EXPORTSTREAM_COMPRESSED_DEFAULTCHUNKSIZE);
+		}
+		return encryptStream;
+	}
+
+	nfBool CKeyStoreOpcPackageWriter::getPartEncryption(_In_ std::string sPath, _Out_ ContentEncryptionDescriptor & Descriptor, _Out_ nfBool & bCompressed) {
+		NMR::PKeyStoreResourceData rd = m_pContext.keyStore()->findResourceData(sPath);
+		if ((nullptr == rd) || !m_pContext.secureContext()->hasDekCtx())
+			return false;
+
+		Descriptor = makeEncryptionDescriptor(rd);
+		bCompressed = rd->isCompressed();
+		return true;
+	}
+
+	POpcPackagePart CKeyStoreOpcPackageWriter::addEncryptedPart(_In_ std::string sPath) {
+		return m_pPackageWriter->addPart(sPath, ZIPFILECOMPRESSION_UNCOMPRESSED, 0);
+	}
+
 	void CKeyStoreOpcPackageWriter::refreshResourceDataTag(PKeyStoreResourceData rd) {
 		ContentEncryptionDescriptor dekCtx = m_pContext.secureContext()->getDekCtx();
 		PKeyStoreResourceDataGroup rdg = m_pContext.keyStore()->findResourceDataGroupByResourceDataPath(rd->packagePath());
@@ -150,20 +168,30 @@ namespace NMR {
 	}
 
 	POpcPackagePart CKeyStoreOpcPackageWriter::addPart(_In_ std::string sPath)
+	{
+		if (m_pContext.keyStore()->findResourceData(sPath) != nullptr)
+			return addPart(sPath, ZIPFILECOMPRESSION_DEFLATED, KEYSTORE_CONTENTCOMPRESSIONLEVEL_DEFAULT);
+		return addPart(sPath, ZIPFILECOMPRESSION_DEFLATED, ZIPFILECOMPRESSIONLEVEL_DEFAULT);
+	}
+
+	POpcPackagePart CKeyStoreOpcPackageWriter::addPart(_In_ std::string sPath, _In_ nfUint16 nCompressionMethod, _In_ nfInt32 nCompressionLevel)
 	{
 		PSecureContext const & secureContext = m_pContext.secureContext();
 		PKeyStore const & keyStore = m_pContext.keyStore();
 
-		auto pPart = m_pPackageWriter->addPart(sPath);
 		NMR::PKeyStoreResourceData rd = keyStore->findResourceData(sPath);
 		if (nullptr != rd) {
 			if (secureContext->hasDekCtx()) {
-				return wrapPartStream(rd, pPart);
+				// cipher text does not compress, so it is stored as is, and the
+				// requested compression is applied to the content before encryption
+				auto pPart = addEncryptedPart(sPath);
+				nfInt32 nContentCompressionLevel = (nCompressionMethod == ZIPFILECOMPRESSION_DEFLATED) ? nCompressionLevel : 0;
+				return wrapPartStream(rd, pPart, nContentCompressionLevel);
 			} else {
 				m_pContext.warnings()->addWarning(NMR_ERROR_DEKDESCRIPTORNOTFOUND, eModelWarningLevel::mrwFatal);
 			}
 		}
-		return pPart;
+		return m_pPackageWriter->addPart(sPath, nCompressionMethod, nCompressionLevel);
 	}
 
 	void CKeyStoreOpcPackageWriter::close() {
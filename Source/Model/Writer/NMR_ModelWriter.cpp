@@ -49,7 +49,8 @@ namespace NMR {
 
 	CModelWriter::CModelWriter(_In_ PModel pModel):
 		CModelContext(pModel),
-		m_nDecimalPrecision(6)
+		m_nDecimalPrecision(6),
+		m_nEncryptionThreadCount(1)
 	{
 	}
 
@@ -65,4 +66,14 @@ namespace NMR {
 		return m_nDecimalPrecision;
 	}
 
+	void CModelWriter::SetEncryptionThreadCount(nfUint32 nThreadCount)
+	{
+		m_nEncryptionThreadCount = nThreadCount;
+	}
+
+	nfUint32 CModelWriter::GetEncryptionThreadCount()
+	{
+		return m_nEncryptionThreadCount;
+	}
+
 }
@@ -42,13 +42,18 @@ using LibZ and a native XML writer implementation.
 #include "Common/NMR_Exception.h" 
 #include "Common/Platform/NMR_XmlWriter.h" 
 #include "Common/Platform/NMR_XmlWriter_Native.h" 
-#include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Chunked_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Deflated_Memory.h"
 #include "Common/Platform/NMR_ExportStream_Memory.h"
 #include "Common/NMR_StringUtils.h" 
 #include "Common/3MF_ProgressMonitor.h"
 #include "Common/NMR_ModelWarnings.h"
 #include <functional>
 #include <sstream>
+#include <array>
+#include <vector>
+#include <map>
+#include <cmath>
 
 namespace NMR {
 	
@@ -98,7 +103,7 @@ namespace NMR {
 		if (pPackageThumbnail.get() != nullptr)
 		{
 			// create Package Thumbnail Part
-			POpcPackagePart pThumbnailPart = m_pPackageWriter->addPart(pPackageThumbnail->getPathURI());
+			POpcPackagePart pThumbnailPart = addAttachmentPart(pPackageThumbnail.get(), pPackageThumbnail->getPathURI());
 			PExportStream pExportStream = pThumbnailPart->getExportStream();
 			// Copy data
 			PImportStream pPackageThumbnailStream = pPackageThumbnail->getStream();
@@ -161,7 +166,7 @@ namespace NMR {
 				PXmlWriter_Native pXMLWriter = std::make_shared<CXmlWriter_Native>(pExportStream);
 				writeNonRootModelStream(pXMLWriter.get());
 
-				pStream = std::make_shared<CImportStream_Unique_Memory>(pExportStream->getData(), pExportStream->getDataSize());
+				pStream = std::make_shared<CImportStream_Chunked_Memory>(pExportStream);
 			}
 			
 			// check, whether this non-root model is already in here
@@ -176,6 +181,80 @@ namespace NMR {
 		}
 	}
 
+	void CModelWriter_3MF_Native::selectAttachmentCompression(_In_ CModelAttachment * pAttachment, _Out_ nfUint16 & nCompressionMethod, _Out_ nfInt32 & nCompressionLevel)
+	{
+		__NMRASSERT(pAttachment != nullptr);
+
+		nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
+		nCompressionLevel = pAttachment->getCompressionLevel();
+
+		// Secured content is deflated before the encryption. Unless the attachment asks for another
+		// compression, it is always deflated at the level that was used before compression was selectable.
+		if (!pAttachment->hasCompression() && (keyStore()->findResourceData(fnIncludeLeadingPathDelimiter(pAttachment->getPathURI())) != nullptr)) {
+			nCompressionLevel = KEYSTORE_CONTENTCOMPRESSIONLEVEL_DEFAULT;
+			return;
+		}
+
+		switch (pAttachment->getCompression()) {
+		case MODELATTACHMENTCOMPRESSION_STORE:
+			nCompressionMethod = ZIPFILECOMPRESSION_UNCOMPRESSED;
+			nCompressionLevel = 0;
+			return;
+		case MODELATTACHMENTCOMPRESSION_DEFLATE:
+			return;
+		default:
+			break;
+		}
+
+		PImportStream pStream = pAttachment->getStream();
+		if (pStream.get() == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Unchanged deflated parts of a read package are copied as they are
+		if (dynamic_cast<CImportStream_Deflated_Memory *>(pStream.get()) != nullptr)
+			return;
+
+		// Estimate the order-0 entropy of the leading bytes. PNG, JPEG and other
+		// compressed formats come close to 8 bits per byte and are stored instead.
+		nfUint64 cbSampleSize = pStream->retrieveSize();
+		if (cbSampleSize > MODELWRITER_NATIVE_COMPRESSIONSAMPLESIZE)
+			cbSampleSize = MODELWRITER_NATIVE_COMPRESSIONSAMPLESIZE;
+
+		std::vector<nfByte> Sample((size_t)cbSampleSize);
+		if (cbSampleSize > 0) {
+			pStream->seekPosition(0, true);
+			pStream->readBuffer(Sample.data(), cbSampleSize, true);
+			pStream->seekPosition(0, true);
+		}
+
+		std::array<nfUint32, 256> Histogram;
+		Histogram.fill(0);
+		for (nfByte nByte : Sample)
+			Histogram[nByte]++;
+
+		nfDouble dEntropy = 0.0;
+		for (nfUint32 nFrequency : Histogram) {
+			if (nFrequency > 0) {
+				nfDouble dProbability = (nfDouble)nFrequency / (nfDouble)cbSampleSize;
+				dEntropy -= dProbability * log2(dProbability);
+			}
+		}
+
+		if (dEntropy >= MODELWRITER_NATIVE_INCOMPRESSIBLEENTROPY) {
+			nCompressionMethod = ZIPFILECOMPRESSION_UNCOMPRESSED;
+			nCompressionLevel = 0;
+		}
+	}
+
+	POpcPackagePart CModelWriter_3MF_Native::addAttachmentPart(_In_ CModelAttachment * pAttachment, _In_ std::string sPath)
+	{
+		nfUint16 nCompressionMethod;
+		nfInt32 nCompressionLevel;
+		selectAttachmentCompression(pAttachment, nCompressionMethod, nCompressionLevel);
+
+		return m_pPackageWriter->addPart(sPath, nCompressionMethod, nCompressionLevel);
+	}
+
 	void CModelWriter_3MF_Native::addAttachments(_In_ CModel * pModel, _In_ POpcPackagePart pModelPart)
 	{
 		__NMRASSERT(pModel != nullptr);
@@ -186,6 +265,37 @@ namespace NMR {
 		nfUint32 nIndex;
 
 		if (nCount > 0) {
+			// Secured attachments are compressed and encrypted ahead on worker threads
+			PKeyStoreEncryptionPipeline pPipeline;
+			std::vector<nfBool> vctIsQueued(nCount, false);
+			nfUint32 nThreadCount = CKeyStoreEncryptionPipeline::resolveThreadCount(GetEncryptionThreadCount());
+			if (nThreadCount > 1) {
+				std::map<CImportStream *, nfUint32> StreamUseCount;
+				for (nIndex = 0; nIndex < nCount; nIndex++)
+					StreamUseCount[pModel->getModelAttachment(nIndex)->getStream().get()]++;
+
+				pPipeline = std::make_shared<CKeyStoreEncryptionPipeline>(m_pPackageWriter.get(), nThreadCount);
+				for (nIndex = 0; nIndex < nCount; nIndex++) {
+					PModelAttachment pAttachment = pModel->getModelAttachment(nIndex);
+					PImportStream pStream = pAttachment->getStream();
+					// A stream that is shared between attachments cannot be read by two threads
+					if ((pStream.get() == nullptr) || (StreamUseCount[pStream.get()] > 1))
+						continue;
+
+					std::string sPath = fnIncludeLeadingPathDelimiter(pAttachment->getPathURI());
+					if (keyStore()->findResourceData(sPath) == nullptr)
+						continue;
+
+					nfUint16 nCompressionMethod;
+					nfInt32 nCompressionLevel;
+					selectAttachmentCompression(pAttachment.get(), nCompressionMethod, nCompressionLevel);
+					if (nCompressionMethod != ZIPFILECOMPRESSION_DEFLATED)
+						nCompressionLevel = 0;
+
+					vctIsQueued[nIndex] = pPipeline->addPart(sPath, pStream, nCompressionLevel);
+				}
+			}
+
 			for (nIndex = 0; nIndex < nCount; nIndex++) {
 
 				monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEATTACHMENTS);
@@ -200,13 +310,19 @@ namespace NMR {
 				if (pStream.get() == nullptr)
 					throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-				// create Attachment Part
-				POpcPackagePart pAttachmentPart = m_pPackageWriter->addPart(sPath);
-				PExportStream pExportStream = pAttachmentPart->getExportStream();
-
-				// Copy data
-				pStream->seekPosition(0, true);
-				pExportStream->copyFrom(pStream.get(), pStream->retrieveSize(), MODELWRITER_NATIVE_BUFFERSIZE);
+				POpcPackagePart pAttachmentPart;
+				if (vctIsQueued[nIndex]) {
+					pAttachmentPart = pPipeline->commitNextPart();
+				}
+				else {
+					// create Attachment Part
+					pAttachmentPart = addAttachmentPart(pAttachment.get(), sPath);
+					PExportStream pExportStream = pAttachmentPart->getExportStream();
+
+					// Copy data
+					pStream->seekPosition(0, true);
+					pExportStream->copyFrom(pStream.get(), pStream->retrieveSize(), MODELWRITER_NATIVE_BUFFERSIZE);
+				}
 
 				// add relationships
 				m_pPackageWriter->addPartRelationship(pModelPart, sRelationShipType.c_str(), pAttachmentPart.get());
@@ -33,6 +33,7 @@ A model writer exports the in memory representation into a binary STL file.
 
 #include "Model/Writer/NMR_ModelWriter_STL.h"
 #include "Model/Classes/NMR_ModelConstants.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
 #include "Common/MeshExport/NMR_MeshExporter_STL.h"
@@ -50,13 +51,20 @@ namespace NMR {
 		if (!pStream.get())
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		// Create Merged Mesh
-		PMesh pMesh = std::make_shared<CMesh>();
-		model()->mergeToMesh(pMesh.get());
+		// Count the facets of all mesh instances first, as STL stores the count in front of the facets
+		nfUint64 nFacetCount = 0;
+		model()->forEachMeshInstance([&nFacetCount](CModelMeshObject * pMeshObject, const NMATRIX3 & mTransform) {
+			nFacetCount += pMeshObject->getMesh()->getFaceCount();
+		});
+		if (nFacetCount > NMR_MESH_MAXFACECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYFACES);
 
-		// Export Merged Mesh to STL
-		PMeshExporter pExporter = std::make_shared<CMeshExporter_STL>(pStream);
-		pExporter->exportMesh(pMesh.get(), nullptr);
+		// Stream the facets of every instance, without merging the meshes into one
+		std::shared_ptr<CMeshExporter_STL> pExporter = std::make_shared<CMeshExporter_STL>(pStream);
+		pExporter->writeHeader((nfUint32)nFacetCount);
+		model()->forEachMeshInstance([&pExporter](CModelMeshObject * pMeshObject, const NMATRIX3 & mTransform) {
+			pExporter->writeFacets(pMeshObject->getMesh(), &mTransform);
+		});
 	}
 
 }
@@ -429,8 +429,8 @@ namespace NMR {
 
 	void CModelWriterNode100_Mesh::putDouble(_In_ const nfDouble dValue, _In_ std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> & line, _In_ nfUint32 & nBufferPos) {
 		// Format float with "%.$ACCf" syntax where $ACC = m_snPosAfterDecPoint
-		nfInt64 nAbsValue = (nfInt64)(dValue * m_nPutDoubleFactor);
-		nAbsValue = MAX(nAbsValue, -nAbsValue);
+		// Round to the last digit, so that single precision beam radii (e.g. 3.1f = 3.0999999) are written as typed
+		nfInt64 nAbsValue = (nfInt64)(fabs(dValue) * m_nPutDoubleFactor + 0.5);
 		nfBool bIsNegative = dValue < 0;
 
 		int nStart = nBufferPos;
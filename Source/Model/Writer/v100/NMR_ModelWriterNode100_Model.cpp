@@ -374,7 +374,7 @@ namespace NMR {
 
 	void CModelWriterNode100_Model::writeObjects()
 	{
-		std::list <CModelObject *> objectList = m_pModel->getSortedObjectList();
+		std::vector <CModelObject *> objectList = m_pModel->getSortedObjectList();
 
 		for (auto iIterator = objectList.begin(); iIterator != objectList.end(); iIterator++) {
 			CModelObject * pObject = *iIterator;
@@ -35,6 +35,7 @@ UnitTest_EncryptionUtils.h: Encryption Utilities for UnitTests
 #include "lib3mf_implicit.hpp"
 
 #include <map>
+#include <mutex>
 #include <openssl/evp.h>
 #include <openssl/pem.h>
 
@@ -57,6 +58,8 @@ struct KekContext {
 
 struct DekContext {
 	std::map<Lib3MF_uint64, PEVP_CIPHER_CTX> ciphers;
+	// Guards ciphers, as the writer may encrypt several resource data concurrently
+	std::mutex mutex;
 	Lib3MF::CWrapper * wrapper;
 };
 
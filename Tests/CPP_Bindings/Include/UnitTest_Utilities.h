@@ -172,6 +172,24 @@ inline sLib3MFTriangle fnCreateTriangle(int v0, int v1, int v2)
 void fnCreateBox(std::vector<sLib3MFPosition> &vctVertices, std::vector<sLib3MFTriangle> &vctTriangles);
 
 
+// An entry of the central directory of a ZIP package
+struct sZIPEntryInfo
+{
+	std::string m_sName;
+	Lib3MF_uint16 m_nFlags;
+	Lib3MF_uint16 m_nMethod;
+	Lib3MF_uint32 m_nCRC32;
+	Lib3MF_uint64 m_nCompressedSize;
+	Lib3MF_uint64 m_nUncompressedSize;
+	Lib3MF_uint64 m_nLocalHeaderOffset;
+	Lib3MF_uint64 m_nDataOffset;
+};
+
+// Reads the central directory of a ZIP package, including ZIP64 sizes and offsets
+std::vector<sZIPEntryInfo> fnReadZIPEntries(const std::vector<Lib3MF_uint8> & buffer);
+const sZIPEntryInfo * fnFindZIPEntry(const std::vector<sZIPEntryInfo> & entries, const std::string & sName);
+
+
 inline void CheckReaderWarnings(Lib3MF::PReader reader, Lib3MF_uint32 nWarnings)
 {
 	EXPECT_EQ(reader->GetWarningCount(), nWarnings);
@@ -253,6 +253,111 @@ namespace Lib3MF
 		ASSERT_TRUE(bAreEqual);
 	}
 
+	TEST_F(AttachmentsT, RewriteUnchangedPackageThumbnail)
+	{
+		auto reader = model->QueryReader("3mf");
+		reader->ReadFromFile(std::string(TESTFILESPATH) + "/Attachments/withPackageThumbnail.3mf");
+
+		// The unchanged thumbnail is copied into the new package without being deflated again
+		std::vector<Lib3MF_uint8> vctFileBuffer;
+		{
+			auto writer = model->QueryWriter("3mf");
+			writer->WriteToBuffer(vctFileBuffer);
+		}
+		auto readModel = wrapper->CreateModel();
+		{
+			auto reader = readModel->QueryReader("3mf");
+			reader->ReadFromBuffer(vctFileBuffer);
+		}
+		CheckPackageThumbnailAreEqual(model, readModel);
+
+		// The entry carries the same deflated bytes and CRC as in the source package
+		std::vector<Lib3MF_uint8> vctSourceBuffer = ReadFileIntoBuffer(std::string(TESTFILESPATH) + "/Attachments/withPackageThumbnail.3mf");
+		std::string sThumbnailName = model->GetPackageThumbnailAttachment()->GetPath().substr(1);
+		std::vector<sZIPEntryInfo> sourceEntries = fnReadZIPEntries(vctSourceBuffer);
+		std::vector<sZIPEntryInfo> writtenEntries = fnReadZIPEntries(vctFileBuffer);
+		const sZIPEntryInfo * pSourceEntry = fnFindZIPEntry(sourceEntries, sThumbnailName);
+		const sZIPEntryInfo * pWrittenEntry = fnFindZIPEntry(writtenEntries, sThumbnailName);
+		ASSERT_TRUE(pSourceEntry != nullptr);
+		ASSERT_TRUE(pWrittenEntry != nullptr);
+		ASSERT_EQ(pSourceEntry->m_nMethod, 8);
+		ASSERT_EQ(pWrittenEntry->m_nMethod, 8);
+		ASSERT_EQ(pWrittenEntry->m_nCRC32, pSourceEntry->m_nCRC32);
+		ASSERT_EQ(pWrittenEntry->m_nUncompressedSize, pSourceEntry->m_nUncompressedSize);
+		ASSERT_EQ(pWrittenEntry->m_nCompressedSize, pSourceEntry->m_nCompressedSize);
+		ASSERT_TRUE(std::equal(vctSourceBuffer.begin() + (size_t)pSourceEntry->m_nDataOffset,
+			vctSourceBuffer.begin() + (size_t)(pSourceEntry->m_nDataOffset + pSourceEntry->m_nCompressedSize),
+			vctFileBuffer.begin() + (size_t)pWrittenEntry->m_nDataOffset));
+	}
+
+	TEST_F(AttachmentsT, ReadCorruptedDeflatedAttachment)
+	{
+		std::vector<Lib3MF_uint8> vctSourceBuffer = ReadFileIntoBuffer(std::string(TESTFILESPATH) + "/Attachments/withPackageThumbnail.3mf");
+		std::vector<sZIPEntryInfo> sourceEntries = fnReadZIPEntries(vctSourceBuffer);
+		const sZIPEntryInfo * pEntry = fnFindZIPEntry(sourceEntries, "Metadata/thumbnail.png");
+		ASSERT_TRUE(pEntry != nullptr);
+		ASSERT_EQ(pEntry->m_nMethod, 8);
+
+		// Corrupt the deflated data in the middle of the entry
+		size_t nCorruptStart = (size_t)(pEntry->m_nDataOffset + pEntry->m_nCompressedSize / 2);
+		for (size_t i = nCorruptStart; i < nCorruptStart + 256; i++)
+			vctSourceBuffer[i] ^= 0x5A;
+
+		// The attachment is only inflated when it is read, and the package loads without warnings
+		auto reader = model->QueryReader("3mf");
+		reader->ReadFromBuffer(vctSourceBuffer);
+		CheckReaderWarnings(reader, 0);
+		ASSERT_TRUE(model->HasPackageThumbnailAttachment());
+
+		std::vector<Lib3MF_uint8> vctThumbnailBuffer;
+		try {
+			model->GetPackageThumbnailAttachment()->WriteToBuffer(vctThumbnailBuffer);
+			ASSERT_FALSE(true);
+		}
+		catch (ELib3MFException const & e) {
+			// Errors of the core library are passed on as generic exceptions with their message
+			ASSERT_EQ(e.getErrorCode(), LIB3MF_ERROR_GENERICEXCEPTION);
+			ASSERT_NE(std::string(e.what()).find("Failed to decompress part"), std::string::npos) << e.what();
+		}
+	}
+
+	TEST_F(AttachmentsT, AttachmentCompression)
+	{
+		std::string sPayload;
+		for (int i = 0; i < 4096; i++)
+			sPayload += m_sAttachmetPayload;
+
+		auto attachment = model->AddAttachment(m_sRelationShipPath + ".xml", m_sAttachmetType);
+		attachment->ReadFromBuffer(CLib3MFInputVector<Lib3MF_uint8>((Lib3MF_uint8*)sPayload.data(), sPayload.size()));
+
+		eAttachmentCompression eCompression;
+		Lib3MF_uint32 nLevel;
+		attachment->GetCompression(eCompression, nLevel);
+		ASSERT_EQ(eCompression, eAttachmentCompression::Auto);
+		ASSERT_EQ(nLevel, 1);
+		ASSERT_SPECIFIC_THROW(attachment->SetCompression(eAttachmentCompression::Deflate, 10), ELib3MFException);
+
+		std::vector<Lib3MF_uint8> vctDeflatedBuffer, vctStoredBuffer;
+		attachment->SetCompression(eAttachmentCompression::Deflate, 9);
+		model->QueryWriter("3mf")->WriteToBuffer(vctDeflatedBuffer);
+		attachment->SetCompression(eAttachmentCompression::Store, 0);
+		model->QueryWriter("3mf")->WriteToBuffer(vctStoredBuffer);
+
+		ASSERT_LT(vctDeflatedBuffer.size(), sPayload.size());
+		ASSERT_GT(vctStoredBuffer.size(), sPayload.size());
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->AddRelationToRead(m_sAttachmetType);
+		reader->ReadFromBuffer(vctStoredBuffer);
+		ASSERT_EQ(readModel->GetAttachmentCount(), 1);
+
+		std::vector<Lib3MF_uint8> buffer;
+		readModel->GetAttachment(0)->WriteToBuffer(buffer);
+		ASSERT_EQ(buffer.size(), sPayload.size());
+		ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), sPayload.begin()));
+	}
+
 }
 
 
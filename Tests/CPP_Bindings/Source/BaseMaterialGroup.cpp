@@ -107,4 +107,30 @@ namespace Lib3MF
 		ASSERT_EQ("2", baseMaterialGroup->GetName(propertyIDs[1]));
 	}
 
+	TEST_F(BaseMaterialGroup, BulkDisplayColors)
+	{
+		baseMaterialGroup->AddMaterial("1", wrapper->RGBAToColor(0, 10, 20, 30));
+		baseMaterialGroup->AddMaterial("2", wrapper->RGBAToColor(5, 15, 25, 35));
+
+		std::vector<Lib3MF_uint32> propertyIDs;
+		baseMaterialGroup->GetAllPropertyIDs(propertyIDs);
+
+		std::vector<sColor> colors;
+		baseMaterialGroup->GetDisplayColors(propertyIDs, colors);
+		ASSERT_EQ(colors.size(), 2);
+		ASSERT_EQ(colors[0].m_Blue, 20);
+		ASSERT_EQ(colors[1].m_Blue, 25);
+
+		std::swap(colors[0], colors[1]);
+		baseMaterialGroup->SetDisplayColors(propertyIDs, colors);
+		ASSERT_EQ(baseMaterialGroup->GetDisplayColor(propertyIDs[0]).m_Blue, 25);
+		ASSERT_EQ(baseMaterialGroup->GetDisplayColor(propertyIDs[1]).m_Blue, 20);
+
+		// An unknown PropertyID leaves the whole base material group untouched
+		baseMaterialGroup->RemoveMaterial(propertyIDs[1]);
+		std::swap(colors[0], colors[1]);
+		ASSERT_SPECIFIC_THROW(baseMaterialGroup->SetDisplayColors(propertyIDs, colors), ELib3MFException);
+		ASSERT_EQ(baseMaterialGroup->GetDisplayColor(propertyIDs[0]).m_Blue, 25);
+	}
+
 }
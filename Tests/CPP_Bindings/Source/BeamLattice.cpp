@@ -365,7 +365,7 @@ namespace Lib3MF
 		for (int i = 0; i < 2; i++) {
 			ASSERT_EQ(outBeam.m_CapModes[i], beam.m_CapModes[i]);
 			ASSERT_EQ(outBeam.m_Indices[i], beam.m_Indices[i]);
-			ASSERT_DOUBLE_EQ(outBeam.m_Radii[i], beam.m_Radii[i]);
+			ASSERT_FLOAT_EQ((float)outBeam.m_Radii[i], (float)beam.m_Radii[i]);
 		}
 
 		beam.m_Radii[0] = 4;
@@ -418,7 +418,7 @@ namespace Lib3MF
 			for (int j = 0; j < 2; j++) {
 				ASSERT_EQ(outBeams[i].m_CapModes[j], beams[i].m_CapModes[j]);
 				ASSERT_EQ(outBeams[i].m_Indices[j], beams[i].m_Indices[j]);
-				ASSERT_DOUBLE_EQ(outBeams[i].m_Radii[j], beams[i].m_Radii[j]);
+				ASSERT_FLOAT_EQ((float)outBeams[i].m_Radii[j], (float)beams[i].m_Radii[j]);
 			}
 		}
 
@@ -431,6 +431,8 @@ namespace Lib3MF
 		catch (ELib3MFException) {
 			ASSERT_TRUE(true);
 		}
+		// a failing bulk call leaves the beams untouched
+		ASSERT_EQ(beamLattice->GetBeamCount(), 3);
 
 		// fix beams for adding balls
 		beams[0].m_Indices[0] = 0;
@@ -476,6 +478,79 @@ namespace Lib3MF
 		}
 	}
 
+	TEST_F(BeamLattice, SetBeamsDropsBalls)
+	{
+		sPosition p;
+		p.m_Coordinates[0] = 1;
+		p.m_Coordinates[1] = 1;
+		p.m_Coordinates[2] = 1;
+		mesh->AddVertex(p);
+		p.m_Coordinates[0] = 2;
+		mesh->AddVertex(p);
+
+		sBeam beam;
+		beam.m_CapModes[0] = eBeamLatticeCapMode::Sphere;
+		beam.m_CapModes[1] = eBeamLatticeCapMode::Sphere;
+		beam.m_Radii[0] = 1.0;
+		beam.m_Radii[1] = 1.0;
+		std::vector<sBeam> beams(4);
+		for (int i = 0; i < 4; i++) {
+			beam.m_Indices[0] = i;
+			beam.m_Indices[1] = i + 1;
+			beams[i] = beam;
+		}
+		beamLattice->SetBeams(beams);
+		ASSERT_EQ(beamLattice->GetDroppedBallCount(), 0);
+
+		beamLattice->SetBallOptions(eBeamLatticeBallMode::Mixed, 1.2);
+		std::vector<sBall> balls(5);
+		for (int i = 0; i < 5; i++) {
+			balls[i].m_Index = i;
+			balls[i].m_Radius = 1.0 + i;
+		}
+		beamLattice->SetBalls(balls);
+		ASSERT_EQ(beamLattice->GetBallCount(), 5);
+
+		// Nodes 2 and 4 lose their beams, so the balls 2 and 4 are dropped
+		beams.resize(2);
+		beams[1].m_Indices[0] = 1;
+		beams[1].m_Indices[1] = 3;
+		beamLattice->SetBeams(beams);
+		ASSERT_EQ(beamLattice->GetDroppedBallCount(), 2);
+		ASSERT_EQ(beamLattice->GetBallCount(), 3);
+
+		std::vector<sBall> outBalls;
+		beamLattice->GetBalls(outBalls);
+		ASSERT_EQ(outBalls[0].m_Index, 0);
+		ASSERT_EQ(outBalls[1].m_Index, 1);
+		ASSERT_EQ(outBalls[2].m_Index, 3);
+		ASSERT_DOUBLE_EQ(outBalls[2].m_Radius, 4.0);
+
+		auto beamSet = beamLattice->AddBeamSet();
+		std::vector<Lib3MF_uint32> ballReferences = { 2, 1, 0 };
+		beamSet->SetBallReferences(ballReferences);
+
+		// Moving the beam away from node 3 drops its ball
+		beam.m_Indices[0] = 0;
+		beam.m_Indices[1] = 2;
+		beamLattice->SetBeam(1, beam);
+		ASSERT_EQ(beamLattice->GetDroppedBallCount(), 1);
+		ASSERT_EQ(beamLattice->GetBallCount(), 2);
+		// The count belongs to the mesh, not to the beamlattice instance that changed it
+		ASSERT_EQ(mesh->BeamLattice()->GetDroppedBallCount(), 1);
+
+		// References to the dropped ball are removed, the others point to the new ball indices
+		std::vector<Lib3MF_uint32> outBallReferences;
+		beamSet->GetBallReferences(outBallReferences);
+		ASSERT_EQ(outBallReferences, std::vector<Lib3MF_uint32>({ 1, 0 }));
+
+		// Balls which keep their beams are not reported
+		beam.m_Indices[0] = 1;
+		beamLattice->SetBeam(1, beam);
+		ASSERT_EQ(beamLattice->GetDroppedBallCount(), 0);
+		ASSERT_EQ(beamLattice->GetBallCount(), 2);
+	}
+
 	TEST_F(BeamLattice, BeamSet)
 	{
 		auto beamSet = beamLattice->AddBeamSet();
@@ -598,6 +673,66 @@ namespace Lib3MF
 		}
 	}
 
+	void GetLatticeBeams(PModel model, std::vector<sBeam> & beams)
+	{
+		auto meshObjects = model->GetMeshObjects();
+		while (meshObjects->MoveNext()) {
+			auto beamLattice = meshObjects->GetCurrentMeshObject()->BeamLattice();
+			if (beamLattice->GetBeamCount() > 0) {
+				beamLattice->GetBeams(beams);
+				return;
+			}
+		}
+	}
+
+	TEST_F(BeamLattice, Read_Box_Defaults_RoundTrip)
+	{
+		// The lattice defaults are radius="2.5" and cap="butt". The writer omits r1/r2 and cap1/cap2 if they match these.
+		std::string fName("Box_Defaults.3mf");
+		auto model = wrapper->CreateModel();
+		{
+			auto reader = model->QueryReader("3mf");
+			reader->ReadFromFile(sTestFilesPath + "/" + "BeamLattice" + "/" + fName);
+			ASSERT_EQ(reader->GetWarningCount(), 0);
+		}
+		std::vector<sBeam> beams;
+		GetLatticeBeams(model, beams);
+		ASSERT_EQ(beams.size(), 12);
+
+		ASSERT_FLOAT_EQ((float)beams[0].m_Radii[0], 2.5f);
+		ASSERT_FLOAT_EQ((float)beams[0].m_Radii[1], 2.5f);
+		ASSERT_EQ(beams[0].m_CapModes[0], eBeamLatticeCapMode::Butt);
+		ASSERT_EQ(beams[0].m_CapModes[1], eBeamLatticeCapMode::Butt);
+		ASSERT_FLOAT_EQ((float)beams[1].m_Radii[0], 3.1f);
+		ASSERT_EQ(beams[1].m_CapModes[0], eBeamLatticeCapMode::Sphere);
+		ASSERT_EQ(beams[1].m_CapModes[1], eBeamLatticeCapMode::Butt);
+		ASSERT_FLOAT_EQ((float)beams[2].m_Radii[0], 2.5f);
+		ASSERT_FLOAT_EQ((float)beams[2].m_Radii[1], 4.0f);
+		ASSERT_EQ(beams[2].m_CapModes[1], eBeamLatticeCapMode::HemiSphere);
+		ASSERT_FLOAT_EQ((float)beams[7].m_Radii[0], 1.0f);
+		ASSERT_EQ(beams[7].m_CapModes[0], eBeamLatticeCapMode::Sphere);
+
+		std::vector<Lib3MF_uint8> buffer;
+		model->QueryWriter("3mf")->WriteToBuffer(buffer);
+
+		auto modelIn = wrapper->CreateModel();
+		{
+			auto reader = modelIn->QueryReader("3mf");
+			reader->ReadFromBuffer(buffer);
+			ASSERT_EQ(reader->GetWarningCount(), 0);
+		}
+		std::vector<sBeam> beamsIn;
+		GetLatticeBeams(modelIn, beamsIn);
+		ASSERT_EQ(beamsIn.size(), beams.size());
+		for (size_t i = 0; i < beams.size(); i++) {
+			for (int j = 0; j < 2; j++) {
+				ASSERT_EQ(beamsIn[i].m_Indices[j], beams[i].m_Indices[j]);
+				ASSERT_FLOAT_EQ((float)beamsIn[i].m_Radii[j], (float)beams[i].m_Radii[j]) << "beam " << i;
+				ASSERT_EQ(beamsIn[i].m_CapModes[j], beams[i].m_CapModes[j]) << "beam " << i;
+			}
+		}
+	}
+
 	void Read_Attributes_Negative(std::string fName)
 	{
 		auto model = BeamLattice::wrapper->CreateModel();
@@ -101,4 +101,67 @@ namespace Lib3MF
 		ASSERT_EQ(wrapper->RGBAToColor(5, 15, 25, 35).m_Red, colorGroup->GetColor(propertyIDs[1]).m_Red);
 	}
 
+	TEST_F(ColorGroup, BulkColors)
+	{
+		std::vector<sColor> colors = { wrapper->RGBAToColor(0, 10, 20, 30), wrapper->RGBAToColor(5, 15, 25, 35), wrapper->RGBAToColor(40, 50, 60, 70) };
+		Lib3MF_uint32 nFirstPropertyID = colorGroup->AddColors(colors);
+		ASSERT_EQ(colorGroup->GetCount(), 3);
+
+		std::vector<Lib3MF_uint32> propertyIDs = { nFirstPropertyID + 2, nFirstPropertyID };
+		std::vector<sColor> obtainedColors;
+		colorGroup->GetColors(propertyIDs, obtainedColors);
+		ASSERT_EQ(obtainedColors.size(), 2);
+		ASSERT_EQ(obtainedColors[0].m_Red, 40);
+		ASSERT_EQ(obtainedColors[1].m_Alpha, 30);
+
+		colorGroup->SetColors(propertyIDs, std::vector<sColor>({ wrapper->RGBAToColor(1, 2, 3, 4), wrapper->RGBAToColor(5, 6, 7, 8) }));
+		ASSERT_EQ(colorGroup->GetColor(nFirstPropertyID + 2).m_Green, 2);
+		ASSERT_EQ(colorGroup->GetColor(nFirstPropertyID + 1).m_Green, 15);
+		ASSERT_EQ(colorGroup->GetColor(nFirstPropertyID).m_Green, 6);
+
+		ASSERT_SPECIFIC_THROW(colorGroup->SetColors(propertyIDs, colors), ELib3MFException);
+
+		// An unknown PropertyID leaves the whole color group untouched
+		propertyIDs = { nFirstPropertyID, nFirstPropertyID + 1, nFirstPropertyID + 3 };
+		ASSERT_SPECIFIC_THROW(colorGroup->SetColors(propertyIDs, colors), ELib3MFException);
+		ASSERT_EQ(colorGroup->GetColor(nFirstPropertyID).m_Green, 6);
+		ASSERT_EQ(colorGroup->GetColor(nFirstPropertyID + 1).m_Green, 15);
+		ASSERT_EQ(colorGroup->GetColor(nFirstPropertyID + 2).m_Green, 2);
+	}
+
+	TEST_F(ColorGroup, GetSetAllColors)
+	{
+		std::vector<sColor> colors;
+		for (Lib3MF_uint8 i = 0; i < 10; i++)
+			colors.push_back(wrapper->RGBAToColor(i, 2 * i, 3 * i, 255));
+		colorGroup->AddColors(colors);
+
+		std::vector<Lib3MF_uint32> propertyIDs;
+		colorGroup->GetAllPropertyIDs(propertyIDs);
+		colorGroup->RemoveColor(propertyIDs[3]);
+		colorGroup->RemoveColor(propertyIDs[9]);
+		Lib3MF_uint32 nNewPropertyID = colorGroup->AddColor(wrapper->RGBAToColor(100, 0, 0, 0));
+		ASSERT_EQ(nNewPropertyID, propertyIDs[9] + 1);
+
+		std::vector<sColor> obtainedColors;
+		colorGroup->GetAllColors(obtainedColors);
+		colorGroup->GetAllPropertyIDs(propertyIDs);
+		ASSERT_EQ(obtainedColors.size(), 9);
+		ASSERT_EQ(propertyIDs.size(), 9);
+		for (size_t i = 0; i < obtainedColors.size(); i++) {
+			ASSERT_EQ(obtainedColors[i].m_Red, colorGroup->GetColor(propertyIDs[i]).m_Red);
+		}
+		ASSERT_EQ(obtainedColors[3].m_Red, 4);
+		ASSERT_EQ(obtainedColors[8].m_Red, 100);
+		ASSERT_SPECIFIC_THROW(colorGroup->GetColor(nNewPropertyID - 1), ELib3MFException);
+
+		for (auto & color : obtainedColors)
+			color.m_Alpha = 17;
+		colorGroup->SetAllColors(obtainedColors);
+		ASSERT_EQ(colorGroup->GetColor(nNewPropertyID).m_Alpha, 17);
+
+		obtainedColors.pop_back();
+		ASSERT_SPECIFIC_THROW(colorGroup->SetAllColors(obtainedColors), ELib3MFException);
+	}
+
 }
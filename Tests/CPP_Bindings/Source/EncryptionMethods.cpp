@@ -264,7 +264,137 @@ namespace Lib3MF {
 		ASSERT_EQ(1, meshObj->Count());
 	}
 
+	TEST_F(EncryptionMethods, WriteEncryptedModelWithEncryptionThreads) {
+		ByteVector buffer;
+		{
+			auto reader = model->QueryReader("3mf");
+			DekContext dekUserData;
+			reset(dekUserData);
+			reader->SetContentEncryptionCallback(EncryptionCallbacks::dataDecryptClientCallback, (Lib3MF_pvoid)(&dekUserData));
+
+			KekContext kekUserData;
+			reset(kekUserData);
+			reader->AddKeyWrappingCallback("LIB3MF#TEST", EncryptionCallbacks::keyDecryptClientCallback, &kekUserData);
+			reader->ReadFromFile(sTestFilesPath + "/SecureContent/keystore_encrypted_compressed.3mf");
+
+			auto writer = model->QueryWriter("3mf");
+			ASSERT_EQ(writer->GetEncryptionThreadCount(), 1);
+			writer->SetEncryptionThreadCount(4);
+			ASSERT_EQ(writer->GetEncryptionThreadCount(), 4);
+
+			reset(dekUserData);
+			writer->SetContentEncryptionCallback(EncryptionCallbacks::dataEncryptClientCallback, &dekUserData);
+			reset(kekUserData);
+			writer->AddKeyWrappingCallback("LIB3MF#TEST", EncryptionCallbacks::keyEncryptClientCallback, &kekUserData);
+			writer->WriteToBuffer(buffer);
+			ASSERT_EQ(writer->GetWarningCount(), 0);
+		}
+
+		model = wrapper->CreateModel();
+		{
+			auto reader = model->QueryReader("3mf");
+			DekContext dekUserData;
+			reset(dekUserData);
+			reader->SetContentEncryptionCallback(EncryptionCallbacks::dataDecryptClientCallback, (Lib3MF_pvoid)(&dekUserData));
 
+			KekContext kekUserData;
+			reset(kekUserData);
+			reader->AddKeyWrappingCallback("LIB3MF#TEST", EncryptionCallbacks::keyDecryptClientCallback, &kekUserData);
+			reader->ReadFromBuffer(buffer);
+
+			ASSERT_EQ(model->GetResources()->Count(), 28);
+			ASSERT_EQ(model->GetKeyStore()->GetResourceDataCount(), 1);
+		}
+	}
+
+
+
+	TEST_F(EncryptionMethods, WriteSecuredPartsWithEncryptionThreads) {
+		// Every mesh lives in a secured part of its own, which the writer stores like an attachment
+		const int partCount = 6;
+
+		auto keyStore = model->GetKeyStore();
+		auto consumer = keyStore->AddConsumer("LIB3MF#TEST", "contentKey", publicKey);
+		auto rdGroup = keyStore->AddResourceDataGroup();
+		rdGroup->AddAccessRight(consumer.get(),
+			eWrappingAlgorithm::RSA_OAEP,
+			eMgfAlgorithm::MGF1_SHA1,
+			eDigestMethod::SHA1);
+
+		std::vector<std::vector<sPosition>> partVertices;
+		for (int i = 0; i < partCount; i++) {
+			// A strip of triangles, large enough to span several deflate output chunks
+			std::vector<sPosition> vertices;
+			std::vector<sTriangle> triangles;
+			int vertexCount = 20000 + i * 5000;
+			for (int j = 0; j < vertexCount; j++) {
+				vertices.push_back(fnCreateVertex((float)(j / 2), (float)(j % 2) * 10.0f, (float)i));
+				if (j >= 2)
+					triangles.push_back(fnCreateTriangle(j - 2, j - 1, j));
+			}
+			partVertices.push_back(vertices);
+
+			auto meshObject = model->AddMeshObject();
+			meshObject->SetName("Part" + std::to_string(i));
+			meshObject->SetGeometry(vertices, triangles);
+			model->AddBuildItem(meshObject.get(), getIdentityTransform());
+
+			auto part = model->FindOrCreatePackagePart("/3D/securepart" + std::to_string(i) + ".model");
+			meshObject->SetPackagePart(part.get());
+			ByteVector aad = { 'l', 'i', 'b', '3', 'm', 'f', (Lib3MF_uint8)i };
+			keyStore->AddResourceData(rdGroup.get(), part.get(), eEncryptionAlgorithm::AES256_GCM,
+				(i % 2 == 0) ? eCompression::Deflate : eCompression::NoCompression, aad);
+		}
+
+		auto writeModel = [&](Lib3MF_uint32 threadCount, ByteVector & buffer) {
+			auto writer = model->QueryWriter("3mf");
+			writer->SetEncryptionThreadCount(threadCount);
+			DekContext dekUserData;
+			reset(dekUserData);
+			writer->SetContentEncryptionCallback(EncryptionCallbacks::dataEncryptClientCallback, &dekUserData);
+			KekContext kekUserData;
+			reset(kekUserData);
+			writer->AddKeyWrappingCallback("LIB3MF#TEST", EncryptionCallbacks::keyEncryptClientCallback, &kekUserData);
+			writer->WriteToBuffer(buffer);
+			ASSERT_EQ(writer->GetWarningCount(), 0);
+		};
+
+		ByteVector serialBuffer, threadedBuffer;
+		writeModel(1, serialBuffer);
+		writeModel(4, threadedBuffer);
+		// Keys, IVs and tags are random, but the parts are written in the same order with the same sizes
+		ASSERT_EQ(serialBuffer.size(), threadedBuffer.size());
+
+		for (ByteVector * buffer : { &serialBuffer, &threadedBuffer }) {
+			auto readModel = wrapper->CreateModel();
+			auto reader = readModel->QueryReader("3mf");
+			DekContext dekUserData;
+			reset(dekUserData);
+			reader->SetContentEncryptionCallback(EncryptionCallbacks::dataDecryptClientCallback, &dekUserData);
+			KekContext kekUserData;
+			reset(kekUserData);
+			reader->AddKeyWrappingCallback("LIB3MF#TEST", EncryptionCallbacks::keyDecryptClientCallback, &kekUserData);
+			reader->ReadFromBuffer(*buffer);
+			ASSERT_EQ(reader->GetWarningCount(), 0);
+
+			ASSERT_EQ(readModel->GetKeyStore()->GetResourceDataCount(), (Lib3MF_uint64)partCount);
+			auto meshObjects = readModel->GetMeshObjects();
+			ASSERT_EQ(meshObjects->Count(), (Lib3MF_uint64)partCount);
+			while (meshObjects->MoveNext()) {
+				auto meshObject = meshObjects->GetCurrentMeshObject();
+				std::string name = meshObject->GetName();
+				int i = std::stoi(name.substr(4));
+				ASSERT_EQ(meshObject->PackagePart()->GetPath(), "/3D/securepart" + std::to_string(i) + ".model");
+
+				std::vector<sPosition> vertices;
+				meshObject->GetVertices(vertices);
+				ASSERT_EQ(vertices.size(), partVertices[i].size());
+				for (size_t j = 0; j < vertices.size(); j++)
+					for (int k = 0; k < 3; k++)
+						ASSERT_EQ(vertices[j].m_Coordinates[k], partVertices[i][j].m_Coordinates[k]);
+			}
+		}
+	}
 
 	TEST_F(EncryptionMethods, WriteAdditionalConsumerToEncryptedModel) {
 		ByteVector buffer;
@@ -88,4 +88,44 @@ namespace Lib3MF
 		ExpectEqModels(m_pModel, pReadModel);
 	}
 
+	TEST_F(MergeModels, MergeToInstancedModel)
+	{
+		auto pModel = wrapper->CreateModel();
+		std::vector<sPosition> vctVertices;
+		std::vector<sTriangle> vctTriangles;
+		fnCreateBox(vctVertices, vctTriangles);
+		auto pMesh = pModel->AddMeshObject();
+		pMesh->SetGeometry(vctVertices, vctTriangles);
+
+		auto pInner = pModel->AddComponentsObject();
+		sTransform t = getIdentityTransform();
+		for (int i = 0; i < 3; i++) {
+			t.m_Fields[3][0] = 100.0f * i;
+			pInner->AddComponent(pMesh.get(), t);
+		}
+		auto pOuter = pModel->AddComponentsObject();
+		t = getIdentityTransform();
+		t.m_Fields[3][2] = 200.0f;
+		pOuter->AddComponent(pInner.get(), t);
+		pOuter->AddComponent(pMesh.get(), getIdentityTransform());
+		pModel->AddBuildItem(pOuter.get(), getIdentityTransform());
+
+		auto pMergedModel = pModel->MergeToInstancedModel();
+		EXPECT_EQ(pMergedModel->GetMeshObjects()->Count(), 1);
+		EXPECT_EQ(pMergedModel->GetComponentsObjects()->Count(), 0);
+
+		// One build item per placement of the mesh, in component order and with the combined transforms
+		auto pBuildItems = pMergedModel->GetBuildItems();
+		ASSERT_EQ(pBuildItems->Count(), 4);
+		const float fExpectedTranslations[4][3] = { { 0.0f, 0.0f, 200.0f }, { 100.0f, 0.0f, 200.0f }, { 200.0f, 0.0f, 200.0f }, { 0.0f, 0.0f, 0.0f } };
+		for (int i = 0; i < 4; i++) {
+			ASSERT_TRUE(pBuildItems->MoveNext());
+			auto pBuildItem = pBuildItems->GetCurrent();
+			sTransform transform = pBuildItem->GetObjectTransform();
+			for (int j = 0; j < 3; j++)
+				EXPECT_EQ(transform.m_Fields[3][j], fExpectedTranslations[i][j]);
+			EXPECT_EQ(pBuildItem->GetObjectResource()->IsMeshObject(), true);
+		}
+	}
+
 }
@@ -216,6 +216,158 @@ namespace Lib3MF
 	{
 		auto beamLattice = mesh->BeamLattice();
 	}
+
+	TEST_F(MeshObject, SpatialQueries)
+	{
+		Lib3MF_uint32 nTriangleIndex;
+		Lib3MF_double dDistance;
+		sPosition closestPoint;
+		ASSERT_FALSE(mesh->GetClosestPoint(fnCreateVertex(0.0f, 0.0f, 0.0f), closestPoint, nTriangleIndex, dDistance));
+
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+		mesh->BuildBVH();
+
+		ASSERT_TRUE(mesh->IntersectRay(fnCreateVertex(50.0f, 50.0f, -10.0f), fnCreateVertex(0.0f, 0.0f, 2.0f), nTriangleIndex, dDistance));
+		ASSERT_EQ(nTriangleIndex, 0);
+		ASSERT_DOUBLE_EQ(dDistance, 10.0);
+		ASSERT_FALSE(mesh->IntersectRay(fnCreateVertex(50.0f, 50.0f, -10.0f), fnCreateVertex(0.0f, 0.0f, -1.0f), nTriangleIndex, dDistance));
+		ASSERT_SPECIFIC_THROW(mesh->IntersectRay(fnCreateVertex(50.0f, 50.0f, -10.0f), fnCreateVertex(0.0f, 0.0f, 0.0f), nTriangleIndex, dDistance), ELib3MFException);
+
+		ASSERT_TRUE(mesh->GetClosestPoint(fnCreateVertex(50.0f, 50.0f, 350.0f), closestPoint, nTriangleIndex, dDistance));
+		ASSERT_EQ(nTriangleIndex, 2);
+		ASSERT_DOUBLE_EQ(dDistance, 50.0);
+		ASSERT_FLOAT_EQ(closestPoint.m_Coordinates[0], 50.0f);
+		ASSERT_FLOAT_EQ(closestPoint.m_Coordinates[1], 50.0f);
+		ASSERT_FLOAT_EQ(closestPoint.m_Coordinates[2], 300.0f);
+
+		sBox box;
+		for (int j = 0; j < 3; j++) {
+			box.m_MinCoordinate[j] = -1.0f;
+			box.m_MaxCoordinate[j] = 1.0f;
+		}
+		std::vector<Lib3MF_uint32> vctTriangleIndices;
+		mesh->GetTrianglesInBox(box, vctTriangleIndices);
+		std::vector<Lib3MF_uint32> vctExpectedIndices = { 0, 1, 4, 5, 10 };
+		ASSERT_EQ(vctTriangleIndices, vctExpectedIndices);
+
+		mesh->ReleaseBVH();
+		box.m_MinCoordinate[0] = 150.0f;
+		box.m_MaxCoordinate[0] = 160.0f;
+		mesh->GetTrianglesInBox(box, vctTriangleIndices);
+		ASSERT_TRUE(vctTriangleIndices.empty());
+	}
+
+	TEST_F(MeshObject, SpatialQueriesAfterGeometryChange)
+	{
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+
+		Lib3MF_uint32 nTriangleIndex;
+		Lib3MF_double dDistance;
+		ASSERT_TRUE(mesh->IntersectRay(fnCreateVertex(50.0f, 50.0f, -100.0f), fnCreateVertex(0.0f, 0.0f, 1.0f), nTriangleIndex, dDistance));
+		ASSERT_DOUBLE_EQ(dDistance, 100.0);
+
+		// Move the bottom face down
+		for (Lib3MF_uint32 i = 0; i < 4; i++) {
+			sPosition vertex = pVertices[i];
+			vertex.m_Coordinates[2] = -20.0f;
+			mesh->SetVertex(i, vertex);
+		}
+		ASSERT_TRUE(mesh->IntersectRay(fnCreateVertex(50.0f, 50.0f, -100.0f), fnCreateVertex(0.0f, 0.0f, 1.0f), nTriangleIndex, dDistance));
+		ASSERT_DOUBLE_EQ(dDistance, 80.0);
+	}
+
+	TEST_F(MeshObject, RangeOperations)
+	{
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+
+		std::vector<sPosition> vctVertices;
+		mesh->GetVertexRange(2, 4, vctVertices);
+		ASSERT_EQ(vctVertices.size(), 4);
+		for (Lib3MF_uint32 i = 0; i < 4; i++) {
+			for (int j = 0; j < 3; j++)
+				ASSERT_EQ(vctVertices[i].m_Coordinates[j], pVertices[i + 2].m_Coordinates[j]);
+			vctVertices[i].m_Coordinates[0] += 1.0;
+		}
+		mesh->SetVertexRange(4, vctVertices);
+		for (Lib3MF_uint32 i = 0; i < 4; i++) {
+			sPosition posOut = mesh->GetVertex(i + 4);
+			ASSERT_EQ(posOut.m_Coordinates[0], pVertices[i + 2].m_Coordinates[0] + 1.0);
+		}
+		ASSERT_SPECIFIC_THROW(mesh->SetVertexRange(5, vctVertices), ELib3MFException);
+		ASSERT_SPECIFIC_THROW(mesh->GetVertexRange(7, 2, vctVertices), ELib3MFException);
+
+		std::vector<sTriangleProperties> vctProperties(3);
+		for (Lib3MF_uint32 i = 0; i < 3; i++) {
+			vctProperties[i].m_ResourceID = 1;
+			for (int j = 0; j < 3; j++)
+				vctProperties[i].m_PropertyIDs[j] = i + 1;
+		}
+		mesh->SetTrianglePropertiesRange(9, vctProperties);
+
+		std::vector<sTriangleProperties> vctObtainedProperties;
+		mesh->GetTrianglePropertiesRange(8, 4, vctObtainedProperties);
+		ASSERT_EQ(vctObtainedProperties.size(), 4);
+		ASSERT_EQ(vctObtainedProperties[0].m_ResourceID, 0);
+		for (Lib3MF_uint32 i = 0; i < 3; i++) {
+			ASSERT_EQ(vctObtainedProperties[i + 1].m_ResourceID, 1);
+			ASSERT_EQ(vctObtainedProperties[i + 1].m_PropertyIDs[2], i + 1);
+		}
+		ASSERT_SPECIFIC_THROW(mesh->SetTrianglePropertiesRange(10, vctProperties), ELib3MFException);
+	}
+
+	TEST_F(MeshObject, Validate)
+	{
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+		auto report = mesh->Validate(16);
+		ASSERT_TRUE(report->IsValid());
+		ASSERT_TRUE(report->IsManifoldAndOriented());
+
+		// A flipped triangle uses all of its edges in the same direction as its neighbours
+		mesh->SetTriangle(2, fnCreateTriangle(5, 4, 6));
+		report = mesh->Validate(16);
+		ASSERT_FALSE(report->IsValid());
+		ASSERT_FALSE(report->IsManifoldAndOriented());
+		ASSERT_EQ(report->GetIssueCount(eMeshValidationIssue::InconsistentOrientation), 3);
+		ASSERT_EQ(report->GetIssueCount(eMeshValidationIssue::BoundaryEdge), 0);
+		std::vector<Lib3MF_uint32> vctSamples;
+		report->GetIssueSamples(eMeshValidationIssue::InconsistentOrientation, vctSamples);
+		ASSERT_EQ(vctSamples, std::vector<Lib3MF_uint32>({ 2, 3, 5, 9 }));
+
+		report = mesh->Validate(1);
+		report->GetIssueSamples(eMeshValidationIssue::InconsistentOrientation, vctSamples);
+		ASSERT_EQ(vctSamples, std::vector<Lib3MF_uint32>({ 2 }));
+
+		// A duplicate triangle with opposite orientation makes its edges non-manifold
+		mesh->SetTriangle(2, pTriangles[2]);
+		mesh->AddTriangle(fnCreateTriangle(4, 6, 5));
+		report = mesh->Validate(16);
+		ASSERT_FALSE(report->IsManifoldAndOriented());
+		ASSERT_EQ(report->GetIssueCount(eMeshValidationIssue::DuplicateTriangle), 1);
+		ASSERT_EQ(report->GetIssueCount(eMeshValidationIssue::NonManifoldEdge), 3);
+		ASSERT_EQ(report->GetIssueCount(eMeshValidationIssue::InconsistentOrientation), 0);
+		report->GetIssueSamples(eMeshValidationIssue::DuplicateTriangle, vctSamples);
+		ASSERT_EQ(vctSamples, std::vector<Lib3MF_uint32>({ 12 }));
+	}
+
+	TEST_F(MeshObject, ValidateZeroAreaTriangles)
+	{
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+		// A sliver whose apex is off the line only by rounding, a thin but proper triangle and a triangle with a zero length edge
+		mesh->AddVertex(fnCreateVertex(0.0f, 0.0f, -1.0f));
+		mesh->AddVertex(fnCreateVertex(100.0f, 0.0f, -1.0f));
+		mesh->AddVertex(fnCreateVertex(50.0f, 0.00001f, -1.0f));
+		mesh->AddVertex(fnCreateVertex(50.0f, 0.01f, -1.0f));
+		mesh->AddVertex(fnCreateVertex(100.0f, 0.0f, -1.0f));
+		mesh->AddTriangle(fnCreateTriangle(8, 9, 10));
+		mesh->AddTriangle(fnCreateTriangle(8, 9, 11));
+		mesh->AddTriangle(fnCreateTriangle(8, 9, 12));
+
+		auto report = mesh->Validate(16);
+		ASSERT_EQ(report->GetIssueCount(eMeshValidationIssue::ZeroAreaTriangle), 2);
+		std::vector<Lib3MF_uint32> vctSamples;
+		report->GetIssueSamples(eMeshValidationIssue::ZeroAreaTriangle, vctSamples);
+		ASSERT_EQ(vctSamples, std::vector<Lib3MF_uint32>({ 12, 14 }));
+	}
 	
 }
 
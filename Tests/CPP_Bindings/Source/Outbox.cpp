@@ -152,6 +152,45 @@ namespace Lib3MF
 
 		CompareBoxes(sOutbox, sExpectedOutbox);
 	}
-}
 
+	TEST_F(Outbox, CheckUpdateAfterVertexChange)
+	{
+		auto newModel = wrapper->CreateModel();
+		auto mesh = newModel->AddMeshObject();
+		std::vector<sLib3MFPosition> vctVertices;
+		std::vector<sLib3MFTriangle> vctTriangles;
+		fnCreateBox(vctVertices, vctTriangles);
+		mesh->SetGeometry(vctVertices, vctTriangles);
+
+		// Rotation by 90 degrees around the z-axis, followed by a translation in x
+		sTransform transform = getIdentityTransform();
+		transform.m_Fields[0][0] = 0.0f;
+		transform.m_Fields[0][1] = 1.0f;
+		transform.m_Fields[1][0] = -1.0f;
+		transform.m_Fields[1][1] = 0.0f;
+		transform.m_Fields[3][0] = 10.0f;
+		auto buildItem = newModel->AddBuildItem(mesh.get(), transform);
 
+		Lib3MF::sBox sExpectedOutbox;
+		sExpectedOutbox.m_MinCoordinate[0] = -90.0f;
+		sExpectedOutbox.m_MinCoordinate[1] = 0.0f;
+		sExpectedOutbox.m_MinCoordinate[2] = 0.0f;
+		sExpectedOutbox.m_MaxCoordinate[0] = 10.0f;
+		sExpectedOutbox.m_MaxCoordinate[1] = 100.0f;
+		sExpectedOutbox.m_MaxCoordinate[2] = 100.0f;
+		CompareBoxes(buildItem->GetOutbox(), sExpectedOutbox);
+
+		mesh->SetVertex(6, fnCreateVertex(200.0f, 100.0f, 100.0f));
+		sExpectedOutbox.m_MaxCoordinate[1] = 200.0f;
+		CompareBoxes(buildItem->GetOutbox(), sExpectedOutbox);
+		CompareBoxes(newModel->GetOutbox(), sExpectedOutbox);
+
+		Lib3MF::sBox sMeshOutbox = mesh->GetOutbox();
+		EXPECT_FLOAT_EQ(sMeshOutbox.m_MaxCoordinate[0], 200.0f);
+		EXPECT_FLOAT_EQ(sMeshOutbox.m_MinCoordinate[0], 0.0f);
+
+		mesh->AddVertex(fnCreateVertex(-50.0f, 0.0f, 0.0f));
+		sMeshOutbox = mesh->GetOutbox();
+		EXPECT_FLOAT_EQ(sMeshOutbox.m_MinCoordinate[0], -50.0f);
+	}
+}
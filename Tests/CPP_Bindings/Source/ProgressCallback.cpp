@@ -88,6 +88,19 @@ namespace Lib3MF
 		*pAbort = dProgress > 0.5;
 	}
 
+	struct sProgressCounter {
+		Lib3MF_uint32 m_nCallCount;
+		eProgressIdentifier m_eLastIdentifier;
+	};
+
+	void Callback_Counting(bool* pAbort, Lib3MF_double dProgress, eProgressIdentifier identifier, Lib3MF_pvoid pUserData)
+	{
+		sProgressCounter* pCounter = reinterpret_cast<sProgressCounter*>(pUserData);
+		pCounter->m_nCallCount++;
+		pCounter->m_eLastIdentifier = identifier;
+		*pAbort = false;
+	}
+
 	TEST_F(ProgressCallbackTest, Write)
 	{
 		ProgressCallbackTest::writer3MF->SetProgressCallback(Callback_Positive, reinterpret_cast<Lib3MF_pvoid>(ProgressCallbackTest::m_spUserData));
@@ -115,5 +128,27 @@ namespace Lib3MF
 		}
 	}
 
+	TEST_F(ProgressCallbackTest, WriteIsRateLimited)
+	{
+		std::vector<sPosition> vctVertices;
+		std::vector<sTriangle> vctTriangles;
+		fnCreateBox(vctVertices, vctTriangles);
+		const Lib3MF_uint32 nObjectCount = 2000;
+		for (Lib3MF_uint32 iObject = 0; iObject < nObjectCount; iObject++) {
+			auto mesh = model->AddMeshObject();
+			mesh->SetGeometry(vctVertices, vctTriangles);
+			model->AddBuildItem(mesh.get(), getIdentityTransform());
+		}
+
+		sProgressCounter counter = { 0, eProgressIdentifier::QUERYCANCELED };
+		ProgressCallbackTest::writer3MF->SetProgressCallback(Callback_Counting, reinterpret_cast<Lib3MF_pvoid>(&counter));
+		std::vector<Lib3MF_uint8> buffer;
+		ProgressCallbackTest::writer3MF->WriteToBuffer(buffer);
+
+		// The callback is called at most every few milliseconds, and always once when done
+		ASSERT_GT(counter.m_nCallCount, (Lib3MF_uint32)0);
+		ASSERT_LT(counter.m_nCallCount, nObjectCount);
+		ASSERT_EQ(counter.m_eLastIdentifier, eProgressIdentifier::DONE);
+	}
 
 }
@@ -33,6 +33,10 @@ UnitTest_Reader.cpp: Defines Unittests for the Reader classes
 #include "UnitTest_Utilities.h"
 #include "lib3mf_implicit.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 namespace Lib3MF
 {
 	class Reader : public ::testing::Test {
@@ -65,6 +69,51 @@ namespace Lib3MF
 		CheckReaderWarnings(Reader::reader3MF, 0);
 	}
 
+	TEST_F(Reader, 3MFReadWithPackageConsistencyCheck)
+	{
+		ASSERT_FALSE(Reader::reader3MF->GetPackageConsistencyCheck());
+		Reader::reader3MF->SetPackageConsistencyCheck(true);
+		ASSERT_TRUE(Reader::reader3MF->GetPackageConsistencyCheck());
+		Reader::reader3MF->ReadFromFile(sTestFilesPath + "/Reader/" + "Pyramid.3mf");
+		CheckReaderWarnings(Reader::reader3MF, 0);
+	}
+
+	TEST_F(Reader, 3MFReadInconsistentPackage)
+	{
+		// The modification time in the local header of the model part differs from the central directory
+		auto buffer = ReadFileIntoBuffer(sTestFilesPath + "/Reader/" + "Pyramid.3mf");
+		auto entries = fnReadZIPEntries(buffer);
+		const sZIPEntryInfo * pEntry = fnFindZIPEntry(entries, "3D/3dmodel.model");
+		ASSERT_TRUE(pEntry != nullptr);
+		buffer[(size_t)pEntry->m_nLocalHeaderOffset + 10] ^= 0xFF;
+		buffer[(size_t)pEntry->m_nLocalHeaderOffset + 11] ^= 0xFF;
+
+		// By default, the local headers are not compared with the central directory
+		Reader::reader3MF->ReadFromBuffer(buffer);
+		CheckReaderWarnings(Reader::reader3MF, 0);
+		ASSERT_EQ(model->GetMeshObjects()->Count(), 1);
+
+		{
+			auto checkedModel = wrapper->CreateModel();
+			auto checkedReader = checkedModel->QueryReader("3mf");
+			checkedReader->SetPackageConsistencyCheck(true);
+			checkedReader->ReadFromBuffer(buffer);
+			ASSERT_EQ(checkedReader->GetWarningCount(), 1);
+			Lib3MF_uint32 nErrorCode;
+			checkedReader->GetWarning(0, nErrorCode);
+			ASSERT_EQ(nErrorCode, 0x104Du); // NMR_ERROR_ZIPCONTAINSINCONSISTENCIES
+			ASSERT_EQ(checkedModel->GetMeshObjects()->Count(), 1);
+		}
+
+		// Strict mode always checks the package and fails on the inconsistency
+		{
+			auto strictModel = wrapper->CreateModel();
+			auto strictReader = strictModel->QueryReader("3mf");
+			strictReader->SetStrictModeActive(true);
+			ASSERT_SPECIFIC_THROW(strictReader->ReadFromBuffer(buffer), ELib3MFException);
+		}
+	}
+
 	TEST_F(Reader, STLReadFromFile)
 	{
 		Reader::readerSTL->ReadFromFile(sTestFilesPath + "/Reader/" + "Pyramid.stl");
@@ -118,6 +167,115 @@ namespace Lib3MF
 		CheckReaderWarnings(Reader::reader3MF, 0);
 	}
 
+	// Reads from a buffer and records reads that happen after the reader has returned or on another thread
+	struct GuardedReadBuffer
+	{
+		PositionedVector<Lib3MF_uint8> buffer;
+		std::atomic<bool> bReturned;
+		std::atomic<Lib3MF_uint32> nReadsAfterReturn;
+		std::thread::id callingThread;
+		std::atomic<Lib3MF_uint32> nReadsOnOtherThreads;
+		GuardedReadBuffer() : bReturned(false), nReadsAfterReturn(0), callingThread(std::this_thread::get_id()), nReadsOnOtherThreads(0) {};
+
+		void recordRead() {
+			if (bReturned)
+				nReadsAfterReturn++;
+			if (std::this_thread::get_id() != callingThread)
+				nReadsOnOtherThreads++;
+		}
+
+		static void readCallback(Lib3MF_uint64 nByteData, Lib3MF_uint64 nNumBytes, Lib3MF_pvoid pUserData) {
+			GuardedReadBuffer* pGuarded = reinterpret_cast<GuardedReadBuffer*>(pUserData);
+			pGuarded->recordRead();
+			PositionedVector<Lib3MF_uint8>::readCallback(nByteData, nNumBytes, &pGuarded->buffer);
+		}
+
+		static void seekCallback(Lib3MF_uint64 nPosition, Lib3MF_pvoid pUserData) {
+			GuardedReadBuffer* pGuarded = reinterpret_cast<GuardedReadBuffer*>(pUserData);
+			pGuarded->recordRead();
+			PositionedVector<Lib3MF_uint8>::seekCallback(nPosition, &pGuarded->buffer);
+		}
+	};
+
+	// Writes a model whose root model part is a few MB, so that it is read ahead on a background thread
+	std::vector<Lib3MF_uint8> fnWriteLargeModel(PWrapper wrapper, Lib3MF_uint32 nVertexCount)
+	{
+		auto model = wrapper->CreateModel();
+		auto mesh = model->AddMeshObject();
+		std::vector<sPosition> vctVertices(nVertexCount);
+		std::vector<sTriangle> vctTriangles(nVertexCount - 2);
+		for (Lib3MF_uint32 i = 0; i < nVertexCount; i++)
+			vctVertices[i] = fnCreateVertex(i * 0.25f, (i % 97) * 1.5f, (i % 13) * 3.0f);
+		for (Lib3MF_uint32 i = 0; i < nVertexCount - 2; i++)
+			vctTriangles[i] = fnCreateTriangle(i, i + 1, i + 2);
+		mesh->SetGeometry(vctVertices, vctTriangles);
+		model->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		std::vector<Lib3MF_uint8> buffer;
+		model->QueryWriter("3mf")->WriteToBuffer(buffer);
+		return buffer;
+	}
+
+	TEST_F(Reader, 3MFReadLargeRootModelFromCallback)
+	{
+		GuardedReadBuffer guarded;
+		guarded.buffer.vec = fnWriteLargeModel(wrapper, 40000);
+
+		Reader::reader3MF->ReadFromCallback(GuardedReadBuffer::readCallback, guarded.buffer.vec.size(), GuardedReadBuffer::seekCallback,
+			reinterpret_cast<Lib3MF_pvoid>(&guarded));
+		guarded.bReturned = true;
+		CheckReaderWarnings(Reader::reader3MF, 0);
+
+		auto meshObjects = model->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mesh = meshObjects->GetCurrentMeshObject();
+		ASSERT_EQ(mesh->GetVertexCount(), 40000);
+		ASSERT_EQ(mesh->GetTriangleCount(), 39998);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		ASSERT_EQ(guarded.nReadsAfterReturn, 0);
+	}
+
+	TEST_F(Reader, 3MFReadLargeRootModelWithoutReadAhead)
+	{
+		ASSERT_TRUE(Reader::reader3MF->GetRootModelReadAhead());
+		Reader::reader3MF->SetRootModelReadAhead(false);
+		ASSERT_FALSE(Reader::reader3MF->GetRootModelReadAhead());
+
+		GuardedReadBuffer guarded;
+		guarded.buffer.vec = fnWriteLargeModel(wrapper, 40000);
+
+		// All callbacks stay on the calling thread
+		Reader::reader3MF->ReadFromCallback(GuardedReadBuffer::readCallback, guarded.buffer.vec.size(), GuardedReadBuffer::seekCallback,
+			reinterpret_cast<Lib3MF_pvoid>(&guarded));
+		guarded.bReturned = true;
+		CheckReaderWarnings(Reader::reader3MF, 0);
+		ASSERT_EQ(guarded.nReadsOnOtherThreads, 0);
+
+		auto meshObjects = model->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetVertexCount(), 40000);
+	}
+
+	TEST_F(Reader, 3MFReadLargeRootModelWithSourceError)
+	{
+		GuardedReadBuffer guarded;
+		guarded.buffer.vec = fnWriteLargeModel(wrapper, 40000);
+
+		// Corrupt the compressed root model in the middle of the package
+		size_t nCorruptStart = guarded.buffer.vec.size() / 2;
+		for (size_t i = nCorruptStart; i < nCorruptStart + 4096; i++)
+			guarded.buffer.vec[i] ^= 0x5A;
+
+		// The error surfaces while the root model is parsed, and no reads happen once the reader has returned
+		ASSERT_SPECIFIC_THROW(Reader::reader3MF->ReadFromCallback(GuardedReadBuffer::readCallback, guarded.buffer.vec.size(),
+			GuardedReadBuffer::seekCallback, reinterpret_cast<Lib3MF_pvoid>(&guarded)), ELib3MFException);
+		guarded.bReturned = true;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		ASSERT_EQ(guarded.nReadsAfterReturn, 0);
+	}
+
 	TEST_F(Reader, Production)
 	{
 		auto buffer = ReadFileIntoBuffer(sTestFilesPath + "/Production/" + "2ProductionBoxes.3mf");
@@ -125,6 +283,23 @@ namespace Lib3MF
 		CheckReaderWarnings(Reader::reader3MF, 0);
 	}
 
+	TEST_F(Reader, ProductionWithExtractionThreads)
+	{
+		ASSERT_EQ(Reader::reader3MF->GetExtractionThreadCount(), (Lib3MF_uint32)1);
+		Reader::reader3MF->SetExtractionThreadCount(4);
+		ASSERT_EQ(Reader::reader3MF->GetExtractionThreadCount(), (Lib3MF_uint32)4);
+
+		auto buffer = ReadFileIntoBuffer(sTestFilesPath + "/Production/" + "2ProductionBoxes.3mf");
+		Reader::reader3MF->ReadFromBuffer(buffer);
+		CheckReaderWarnings(Reader::reader3MF, 0);
+
+		auto serialModel = wrapper->CreateModel();
+		auto serialReader = serialModel->QueryReader("3mf");
+		serialReader->ReadFromBuffer(buffer);
+		ASSERT_EQ(model->GetObjects()->Count(), serialModel->GetObjects()->Count());
+		ASSERT_EQ(model->GetBuildItems()->Count(), serialModel->GetBuildItems()->Count());
+	}
+
 	TEST_F(Reader, ProductionExternalModel) {
 		auto reader = model->QueryReader("3mf");
 		reader->ReadFromFile(sTestFilesPath + "/Production/" + "detachedmodel.3mf");
@@ -132,4 +307,31 @@ namespace Lib3MF
 		ASSERT_EQ(28, model->GetObjects()->Count());
 	}
 
+	TEST_F(Reader, AggregateWarnings) {
+		auto reader = model->QueryReader("3mf");
+		reader->ReadFromFile(sTestFilesPath + "/Production/" + "detachedmodel.3mf");
+		Lib3MF_uint32 nWarningCount = reader->GetWarningCount();
+		ASSERT_GT(nWarningCount, (Lib3MF_uint32)1);
+
+		auto aggregatingModel = wrapper->CreateModel();
+		auto aggregatingReader = aggregatingModel->QueryReader("3mf");
+		ASSERT_FALSE(aggregatingReader->GetAggregateWarnings());
+		aggregatingReader->SetAggregateWarnings(true);
+		ASSERT_TRUE(aggregatingReader->GetAggregateWarnings());
+		aggregatingReader->ReadFromFile(sTestFilesPath + "/Production/" + "detachedmodel.3mf");
+
+		Lib3MF_uint32 nAggregatedCount = aggregatingReader->GetWarningCount();
+		ASSERT_LT(nAggregatedCount, nWarningCount);
+
+		Lib3MF_uint32 nOccurrenceCount = 0;
+		for (Lib3MF_uint32 iWarning = 0; iWarning < nAggregatedCount; iWarning++) {
+			Lib3MF_uint32 nErrorCode;
+			std::string sWarning = aggregatingReader->GetWarning(iWarning, nErrorCode);
+			ASSERT_FALSE(sWarning.empty());
+			nOccurrenceCount += aggregatingReader->GetWarningOccurrenceCount(iWarning);
+		}
+		ASSERT_EQ(nOccurrenceCount, nWarningCount);
+		ASSERT_EQ(reader->GetWarningOccurrenceCount(0), (Lib3MF_uint32)1);
+	}
+
 }
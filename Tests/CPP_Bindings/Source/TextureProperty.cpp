@@ -114,6 +114,35 @@ namespace Lib3MF
 		texture2DGroup->GetAllPropertyIDs(properties2D);
 	}
 
+	TEST_F(TextureProperty, Bulk_Texture2DGroup)
+	{
+		auto texture2DGroup = model->AddTexture2DGroup(texture2D.get());
+		std::vector<sTex2Coord> coords = { { 0.0, 0.25 }, { 0.5, 0.75 }, { 1.0, 0.125 } };
+		Lib3MF_uint32 nFirstPropertyID = texture2DGroup->AddTex2Coords(coords);
+		ASSERT_EQ(texture2DGroup->GetCount(), 3);
+
+		std::vector<Lib3MF_uint32> propertyIDs;
+		texture2DGroup->GetAllPropertyIDs(propertyIDs);
+		ASSERT_EQ(propertyIDs[0], nFirstPropertyID);
+
+		std::vector<sTex2Coord> obtainedCoords;
+		texture2DGroup->GetTex2Coords(propertyIDs, obtainedCoords);
+		ASSERT_EQ(obtainedCoords.size(), 3);
+		for (size_t i = 0; i < 3; i++) {
+			EXPECT_DOUBLE_EQ(obtainedCoords[i].m_U, coords[i].m_U);
+			EXPECT_DOUBLE_EQ(obtainedCoords[i].m_V, coords[i].m_V);
+		}
+
+		texture2DGroup->RemoveTex2Coord(propertyIDs[1]);
+		texture2DGroup->GetAllTex2Coords(obtainedCoords);
+		ASSERT_EQ(obtainedCoords.size(), 2);
+		EXPECT_DOUBLE_EQ(obtainedCoords[1].m_V, coords[2].m_V);
+
+		obtainedCoords[0].m_U = 0.5;
+		texture2DGroup->SetAllTex2Coords(obtainedCoords);
+		EXPECT_DOUBLE_EQ(texture2DGroup->GetTex2Coord(propertyIDs[0]).m_U, 0.5);
+	}
+
 	TEST_F(TextureProperty, WriteRead)
 	{
 		auto texture2DGroup = model->AddTexture2DGroup(texture2D.get());
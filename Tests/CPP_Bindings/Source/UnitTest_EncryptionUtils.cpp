@@ -154,17 +154,20 @@ void EncryptionCallbacks::dataEncryptClientCallback(
 	else {
 		PEVP_CIPHER_CTX ctx;
 
-		auto it = dek->ciphers.find(p.GetDescriptor());
+		{
+			std::lock_guard<std::mutex> lock(dek->mutex);
+			auto it = dek->ciphers.find(p.GetDescriptor());
 
-		if (it != dek->ciphers.end()) {
-			ctx = it->second;
-		} else {
-			ByteVector key, iv, aad;
-			p.GetKey(key);
-			p.GetInitializationVector(iv);
-			p.GetAdditionalAuthenticationData(aad);
-			ctx = AesMethods::Encrypt::init(key.data(), iv.data(), aad.size(), aad.data());
-			dek->ciphers[p.GetDescriptor()] = ctx;
+			if (it != dek->ciphers.end()) {
+				ctx = it->second;
+			} else {
+				ByteVector key, iv, aad;
+				p.GetKey(key);
+				p.GetInitializationVector(iv);
+				p.GetAdditionalAuthenticationData(aad);
+				ctx = AesMethods::Encrypt::init(key.data(), iv.data(), aad.size(), aad.data());
+				dek->ciphers[p.GetDescriptor()] = ctx;
+			}
 		}
 
 		if (0 == plainSize || nullptr == plainBuffer) {
@@ -176,7 +179,10 @@ void EncryptionCallbacks::dataEncryptClientCallback(
 				*status = tag.size();
 				p.SetAuthenticationTag(tag);
 			}
-			dek->ciphers.erase(it);
+			{
+				std::lock_guard<std::mutex> lock(dek->mutex);
+				dek->ciphers.erase(p.GetDescriptor());
+			}
 			ctx.reset();
 		} else if (0 == cipherSize || nullptr == cipherBuffer) {
 			*cipherNeeded = plainSize;
@@ -33,6 +33,8 @@ UnitTest_Utilities.cpp: Implementtion of Utilities for UnitTests
 
 #include "UnitTest_Utilities.h"
 
+#include <stdexcept>
+
 void fnCreateBox(std::vector<Lib3MF::sPosition> &vctVertices, std::vector<Lib3MF::sTriangle> &vctTriangles) {
 	float fSizeX = 100.0f;
 	float fSizeY = 100.0f;
@@ -67,3 +69,95 @@ void fnCreateBox(std::vector<Lib3MF::sPosition> &vctVertices, std::vector<Lib3MF
 	vctTriangles[11] = fnCreateTriangle(4, 7, 3);
 }
 
+
+static Lib3MF_uint64 fnReadLittleEndian(const std::vector<Lib3MF_uint8> & buffer, Lib3MF_uint64 nOffset, Lib3MF_uint32 nByteCount)
+{
+	if (nOffset + nByteCount > buffer.size())
+		throw std::runtime_error("ZIP structure exceeds the buffer");
+	Lib3MF_uint64 nValue = 0;
+	for (Lib3MF_uint32 i = 0; i < nByteCount; i++)
+		nValue |= ((Lib3MF_uint64)buffer[(size_t)(nOffset + i)]) << (8 * i);
+	return nValue;
+}
+
+std::vector<sZIPEntryInfo> fnReadZIPEntries(const std::vector<Lib3MF_uint8> & buffer)
+{
+	// The end of central directory record is at least 22 bytes before the end, followed by a comment
+	if (buffer.size() < 22)
+		throw std::runtime_error("buffer is too small for a ZIP package");
+	Lib3MF_uint64 nEndOffset = buffer.size() - 22;
+	while (fnReadLittleEndian(buffer, nEndOffset, 4) != 0x06054b50) {
+		if (nEndOffset == 0)
+			throw std::runtime_error("no end of central directory record");
+		nEndOffset--;
+	}
+
+	Lib3MF_uint64 nEntryCount = fnReadLittleEndian(buffer, nEndOffset + 10, 2);
+	Lib3MF_uint64 nDirectoryOffset = fnReadLittleEndian(buffer, nEndOffset + 16, 4);
+	if ((nEndOffset >= 20) && (fnReadLittleEndian(buffer, nEndOffset - 20, 4) == 0x07064b50)) {
+		Lib3MF_uint64 nZIP64EndOffset = fnReadLittleEndian(buffer, nEndOffset - 12, 8);
+		if (fnReadLittleEndian(buffer, nZIP64EndOffset, 4) != 0x06064b50)
+			throw std::runtime_error("invalid ZIP64 end of central directory record");
+		nEntryCount = fnReadLittleEndian(buffer, nZIP64EndOffset + 32, 8);
+		nDirectoryOffset = fnReadLittleEndian(buffer, nZIP64EndOffset + 48, 8);
+	}
+
+	std::vector<sZIPEntryInfo> entries;
+	Lib3MF_uint64 nOffset = nDirectoryOffset;
+	for (Lib3MF_uint64 iEntry = 0; iEntry < nEntryCount; iEntry++) {
+		if (fnReadLittleEndian(buffer, nOffset, 4) != 0x02014b50)
+			throw std::runtime_error("invalid central directory header");
+
+		sZIPEntryInfo entry;
+		entry.m_nFlags = (Lib3MF_uint16)fnReadLittleEndian(buffer, nOffset + 8, 2);
+		entry.m_nMethod = (Lib3MF_uint16)fnReadLittleEndian(buffer, nOffset + 10, 2);
+		entry.m_nCRC32 = (Lib3MF_uint32)fnReadLittleEndian(buffer, nOffset + 16, 4);
+		entry.m_nCompressedSize = fnReadLittleEndian(buffer, nOffset + 20, 4);
+		entry.m_nUncompressedSize = fnReadLittleEndian(buffer, nOffset + 24, 4);
+		Lib3MF_uint64 nNameLength = fnReadLittleEndian(buffer, nOffset + 28, 2);
+		Lib3MF_uint64 nExtraLength = fnReadLittleEndian(buffer, nOffset + 30, 2);
+		Lib3MF_uint64 nCommentLength = fnReadLittleEndian(buffer, nOffset + 32, 2);
+		entry.m_nLocalHeaderOffset = fnReadLittleEndian(buffer, nOffset + 42, 4);
+		entry.m_sName = std::string(buffer.begin() + (size_t)(nOffset + 46), buffer.begin() + (size_t)(nOffset + 46 + nNameLength));
+
+		// Sizes and offsets that do not fit into 32 bit are given in the ZIP64 extra field, in this order
+		Lib3MF_uint64 nExtraOffset = nOffset + 46 + nNameLength;
+		Lib3MF_uint64 nExtraEnd = nExtraOffset + nExtraLength;
+		while (nExtraOffset + 4 <= nExtraEnd) {
+			Lib3MF_uint64 nHeaderID = fnReadLittleEndian(buffer, nExtraOffset, 2);
+			Lib3MF_uint64 nFieldSize = fnReadLittleEndian(buffer, nExtraOffset + 2, 2);
+			if (nHeaderID == 0x0001) {
+				Lib3MF_uint64 nFieldOffset = nExtraOffset + 4;
+				if (entry.m_nUncompressedSize == 0xFFFFFFFF) {
+					entry.m_nUncompressedSize = fnReadLittleEndian(buffer, nFieldOffset, 8);
+					nFieldOffset += 8;
+				}
+				if (entry.m_nCompressedSize == 0xFFFFFFFF) {
+					entry.m_nCompressedSize = fnReadLittleEndian(buffer, nFieldOffset, 8);
+					nFieldOffset += 8;
+				}
+				if (entry.m_nLocalHeaderOffset == 0xFFFFFFFF)
+					entry.m_nLocalHeaderOffset = fnReadLittleEndian(buffer, nFieldOffset, 8);
+			}
+			nExtraOffset += 4 + nFieldSize;
+		}
+
+		if (fnReadLittleEndian(buffer, entry.m_nLocalHeaderOffset, 4) != 0x04034b50)
+			throw std::runtime_error("invalid local file header");
+		entry.m_nDataOffset = entry.m_nLocalHeaderOffset + 30 + fnReadLittleEndian(buffer, entry.m_nLocalHeaderOffset + 26, 2) +
+			fnReadLittleEndian(buffer, entry.m_nLocalHeaderOffset + 28, 2);
+
+		entries.push_back(entry);
+		nOffset += 46 + nNameLength + nExtraLength + nCommentLength;
+	}
+	return entries;
+}
+
+const sZIPEntryInfo * fnFindZIPEntry(const std::vector<sZIPEntryInfo> & entries, const std::string & sName)
+{
+	for (auto iEntry = entries.begin(); iEntry != entries.end(); iEntry++) {
+		if (iEntry->m_sName == sName)
+			return &(*iEntry);
+	}
+	return nullptr;
+}
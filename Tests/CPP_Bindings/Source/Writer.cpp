@@ -134,6 +134,19 @@ namespace Lib3MF
 		ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), bufferFromFile.begin()));
 	}
 
+	TEST_F(Writer, 3MFCompareWithFileWriteOptions)
+	{
+		std::vector<Lib3MF_uint8> buffer;
+		Writer::writer3MF->WriteToBuffer(buffer);
+
+		Writer::writer3MF->SetFileWriteOptions(buffer.size(), true, true);
+		Writer::writer3MF->WriteToFile(Writer::OutFolder + "PyramidOptions.3mf");
+		auto bufferFromFile = ReadFileIntoBuffer(Writer::OutFolder + "PyramidOptions.3mf");
+
+		ASSERT_EQ(buffer.size(), bufferFromFile.size());
+		ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), bufferFromFile.begin()));
+	}
+
 	TEST_F(Writer, 3MFPrecision)
 	{
 		std::vector<sPosition> vctVertices;
@@ -178,6 +191,32 @@ namespace Lib3MF
 		ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), callbackBuffer.vec.begin()));
 	}
 
+	TEST_F(Writer, 3MFWriteToCallbackWithoutSeeking)
+	{
+		// Without a seek callback, the writer cannot seek. UnitTest_ModelWriter_3MF.cpp checks that it does not attempt to.
+		PositionedVector<Lib3MF_uint8> callbackBuffer;
+		Writer::writer3MF->WriteToCallback(PositionedVector<Lib3MF_uint8>::writeCallback,
+			nullptr, reinterpret_cast<Lib3MF_pvoid>(&callbackBuffer));
+
+		// CRC and sizes of every entry follow its data in a data descriptor (general purpose flag bit 3)
+		auto entries = fnReadZIPEntries(callbackBuffer.vec);
+		ASSERT_FALSE(entries.empty());
+		for (auto iEntry = entries.begin(); iEntry != entries.end(); iEntry++)
+			ASSERT_NE(iEntry->m_nFlags & 0x0008, 0) << iEntry->m_sName;
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->ReadFromBuffer(callbackBuffer.vec);
+
+		auto writtenMeshObjects = model->GetMeshObjects();
+		auto readMeshObjects = readModel->GetMeshObjects();
+		ASSERT_EQ(readMeshObjects->Count(), writtenMeshObjects->Count());
+		while (writtenMeshObjects->MoveNext()) {
+			ASSERT_TRUE(readMeshObjects->MoveNext());
+			ASSERT_EQ(readMeshObjects->GetCurrentMeshObject()->GetTriangleCount(), writtenMeshObjects->GetCurrentMeshObject()->GetTriangleCount());
+		}
+	}
+
 	TEST_F(Writer, STLWriteToCallback)
 	{
 		PositionedVector<Lib3MF_uint8> callbackBuffer;
@@ -0,0 +1,58 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_Streams.h: Utilities for the UnitTests of the stream classes
+
+--*/
+
+#ifndef __NMR_UNITTEST_STREAMS
+#define __NMR_UNITTEST_STREAMS
+
+#include "gtest/gtest.h"
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Exception.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+
+#include <vector>
+
+namespace NMR
+{
+	// Returns a reproducible sequence of bytes, so that misplaced data is detected at any offset
+	inline std::vector<nfByte> fnCreateStreamTestData(_In_ nfUint64 cbSize, _In_ nfUint32 nSeed = 1)
+	{
+		std::vector<nfByte> Data((size_t)cbSize);
+		nfUint32 nState = nSeed;
+		for (auto & nByte : Data) {
+			nState = nState * 1664525 + 1013904223;
+			nByte = (nfByte)(nState >> 24);
+		}
+		return Data;
+	}
+}
+
+#endif //__NMR_UNITTEST_STREAMS
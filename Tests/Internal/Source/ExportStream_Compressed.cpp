@@ -0,0 +1,132 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_ExportStream_Compressed.cpp: Defines Unittests for the CExportStream_Compressed class
+
+--*/
+
+#include "UnitTest_Streams.h"
+#include "Common/Platform/NMR_ExportStream_Compressed.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Compressed.h"
+#include "Common/Platform/NMR_ImportStream_Chunked_Memory.h"
+
+namespace NMR
+{
+	// A memory stream that records the size of every write
+	class CExportStream_RecordingMemory : public CExportStreamMemory {
+	public:
+		std::vector<nfUint64> m_WriteSizes;
+
+		virtual nfUint64 writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite)
+		{
+			m_WriteSizes.push_back(cbTotalBytesToWrite);
+			return CExportStreamMemory::writeBuffer(pBuffer, cbTotalBytesToWrite);
+		}
+	};
+
+	// Text-like data that compresses well, followed by data that does not compress at all
+	std::vector<nfByte> fnCreateCompressionTestData()
+	{
+		std::vector<nfByte> Data;
+		for (nfUint32 nIndex = 0; Data.size() < 3000000; nIndex++) {
+			std::string sLine = "<vertex x=\"" + std::to_string(nIndex % 1000) + "\" y=\"" + std::to_string(nIndex / 7) + "\" z=\"0\" />\n";
+			Data.insert(Data.end(), sLine.begin(), sLine.end());
+		}
+		std::vector<nfByte> Noise = fnCreateStreamTestData(1000000);
+		Data.insert(Data.end(), Noise.begin(), Noise.end());
+		return Data;
+	}
+
+	std::vector<nfByte> fnInflate(_In_ PExportStreamMemory pCompressed, _In_ nfUint64 cbReadSize)
+	{
+		CImportStream_Compressed Stream(std::make_shared<CImportStream_Chunked_Memory>(pCompressed));
+		std::vector<nfByte> Data;
+		std::vector<nfByte> Buffer((size_t)cbReadSize);
+		nfUint64 cbRead;
+		while ((cbRead = Stream.readBuffer(Buffer.data(), cbReadSize, false)) > 0)
+			Data.insert(Data.end(), Buffer.begin(), Buffer.begin() + (size_t)cbRead);
+		return Data;
+	}
+
+	TEST(ExportStream_Compressed, RoundTrip)
+	{
+		std::vector<nfByte> Data = fnCreateCompressionTestData();
+
+		for (nfInt32 nLevel : { 0, 1, 9 }) {
+			const nfUint32 cbChunkSize = 65536;
+			auto pCompressed = std::make_shared<CExportStream_RecordingMemory>();
+			{
+				CExportStream_Compressed Stream(pCompressed, nLevel, cbChunkSize);
+				// One write far larger than the chunk, then many small ones
+				ASSERT_EQ(Stream.writeBuffer(Data.data(), 2000000), 2000000u);
+				for (size_t nOffset = 2000000; nOffset < Data.size(); nOffset += 1000)
+					Stream.writeBuffer(&Data[nOffset], std::min((size_t)1000, Data.size() - nOffset));
+				Stream.close();
+			}
+
+			ASSERT_GT(pCompressed->m_WriteSizes.size(), 1u);
+			for (nfUint64 cbWriteSize : pCompressed->m_WriteSizes)
+				ASSERT_LE(cbWriteSize, cbChunkSize);
+			if (nLevel == 0)
+				ASSERT_GT(pCompressed->getDataSize(), Data.size());
+			else
+				ASSERT_LT(pCompressed->getDataSize(), Data.size());
+
+			// The reads end at varying offsets within the compressed input chunks
+			for (nfUint64 cbReadSize : { 1017, 1024, 4093, 65536 })
+				ASSERT_TRUE(fnInflate(pCompressed, cbReadSize) == Data) << "level " << nLevel << ", read size " << cbReadSize;
+		}
+	}
+
+	TEST(ExportStream_Compressed, HigherLevelCompressesBetter)
+	{
+		std::vector<nfByte> Data = fnCreateCompressionTestData();
+		std::vector<nfUint64> CompressedSizes;
+		for (nfInt32 nLevel : { 1, 9 }) {
+			auto pCompressed = std::make_shared<CExportStreamMemory>();
+			CExportStream_Compressed Stream(pCompressed, nLevel, EXPORTSTREAM_COMPRESSED_DEFAULTCHUNKSIZE);
+			Stream.writeBuffer(Data.data(), Data.size());
+			Stream.close();
+			CompressedSizes.push_back(pCompressed->getDataSize());
+		}
+		ASSERT_LT(CompressedSizes[1], CompressedSizes[0]);
+	}
+
+	TEST(ExportStream_Compressed, InvalidParameters)
+	{
+		auto pCompressed = std::make_shared<CExportStreamMemory>();
+		ASSERT_THROW(CExportStream_Compressed(nullptr), CNMRException);
+		ASSERT_THROW(CExportStream_Compressed(pCompressed, 10, EXPORTSTREAM_COMPRESSED_DEFAULTCHUNKSIZE), CNMRException);
+		ASSERT_THROW(CExportStream_Compressed(pCompressed, -2, EXPORTSTREAM_COMPRESSED_DEFAULTCHUNKSIZE), CNMRException);
+		ASSERT_THROW(CExportStream_Compressed(pCompressed, 1, EXPORTSTREAM_COMPRESSED_MINCHUNKSIZE - 1), CNMRException);
+
+		CExportStream_Compressed Stream(pCompressed, 1, EXPORTSTREAM_COMPRESSED_MINCHUNKSIZE);
+		ASSERT_THROW(Stream.writeBuffer(nullptr, 1), CNMRException);
+	}
+}
@@ -0,0 +1,308 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_Model.cpp: Defines Unittests for the CModel class
+UnitTest_ExportStream_GCC_POSIX.cpp: Defines Unittests for the CExportStream_GCC_POSIX class
+
+--*/
+
+#include "UnitTest_Streams.h"
+#include "Common/Platform/NMR_ExportStream_GCC_POSIX.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+
+#ifndef _WIN32
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace NMR
+{
+	const std::string sPOSIXTestFileName = "ExportStream_GCC_POSIX.bin";
+
+	std::wstring fnPOSIXTestFileNameW()
+	{
+		return std::wstring(sPOSIXTestFileName.begin(), sPOSIXTestFileName.end());
+	}
+
+	std::vector<nfByte> fnReadPOSIXTestFile()
+	{
+		std::ifstream File(sPOSIXTestFileName, std::ios::binary);
+		return std::vector<nfByte>(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+	}
+
+	// Allocated size of the test file, including the space that is preallocated behind its end
+	nfUint64 fnAllocatedPOSIXTestFileSize()
+	{
+		struct stat FileStatus;
+		if (stat(sPOSIXTestFileName.c_str(), &FileStatus) != 0)
+			return 0;
+		return (nfUint64)FileStatus.st_blocks * 512;
+	}
+
+	std::vector<nfByte> fnMemoryStreamData(_In_ CExportStreamMemory & Stream)
+	{
+		const nfByte * pData = Stream.getData();
+		return std::vector<nfByte>(pData, pData + Stream.getDataSize());
+	}
+
+	// Calls the test for every combination of the file options
+	void fnForEachPOSIXFileOptions(_In_ std::function<void(const EXPORTSTREAMFILEOPTIONS &)> Test)
+	{
+		const nfUint64 SizeHints[3] = { 0, 1000000, 100 * 1024 * 1024 };
+		for (nfUint32 nSizeHint = 0; nSizeHint < 3; nSizeHint++) {
+			for (nfUint32 nFlags = 0; nFlags < 4; nFlags++) {
+				EXPORTSTREAMFILEOPTIONS Options;
+				Options.m_nSizeHint = SizeHints[nSizeHint];
+				Options.m_bDropWrittenPages = (nFlags & 1) != 0;
+				Options.m_bDirectIO = (nFlags & 2) != 0;
+
+				SCOPED_TRACE("SizeHint " + std::to_string(Options.m_nSizeHint) + ", DropWrittenPages " + std::to_string(Options.m_bDropWrittenPages) +
+					", DirectIO " + std::to_string(Options.m_bDirectIO));
+				Test(Options);
+				unlink(sPOSIXTestFileName.c_str());
+			}
+		}
+	}
+
+	TEST(ExportStream_GCC_POSIX, RandomWritesAndSeeks)
+	{
+		// Large enough for pieces that wrap the buffer and for writes that bypass it
+		const nfUint64 cbPatternSize = 3 * NMR_EXPORTSTREAM_POSIX_BUFFERSIZE;
+		std::vector<nfByte> Pattern = fnCreateStreamTestData(cbPatternSize, 7);
+
+		fnForEachPOSIXFileOptions([&](const EXPORTSTREAMFILEOPTIONS & Options) {
+			std::mt19937 Random(11);
+			CExportStreamMemory Expected;
+			{
+				CExportStream_GCC_POSIX Stream(fnPOSIXTestFileNameW().c_str(), Options);
+
+				for (nfUint32 nStep = 0; nStep < 300; nStep++) {
+					nfUint64 cbSize = Expected.getDataSize();
+					switch (Random() % 6) {
+					case 0:
+						// Inside the data, mostly at unaligned positions
+						ASSERT_TRUE(Stream.seekPosition(Random() % (cbSize + 1), false));
+						Expected.seekPosition(Stream.getPosition(), false);
+						break;
+					case 1:
+						// Behind the end, which leaves a gap of zeros
+						ASSERT_TRUE(Stream.seekPosition(cbSize + Random() % 10000, false));
+						Expected.seekPosition(Stream.getPosition(), false);
+						break;
+					case 2: {
+						nfUint64 cbFromEnd = Random() % (cbSize + 1);
+						ASSERT_TRUE(Stream.seekFromEnd(cbFromEnd, false));
+						Expected.seekFromEnd(cbFromEnd, false);
+						break;
+					}
+					case 3: {
+						nfUint64 nPosition = Random() % (cbSize + 1);
+						ASSERT_TRUE(Stream.seekPosition(nPosition, false));
+						ASSERT_TRUE(Stream.seekForward(Random() % 5000, false));
+						Expected.seekPosition(Stream.getPosition(), false);
+						break;
+					}
+					default:
+						break;
+					}
+					ASSERT_EQ(Stream.getPosition(), Expected.getPosition());
+
+					// Mostly small pieces, some of them larger than the buffer
+					nfUint64 cbWrite = (Random() % 20 == 0) ? (Random() % cbPatternSize) + 1 : (Random() % 20000) + 1;
+					nfUint64 nOffset = Random() % (cbPatternSize - cbWrite + 1);
+					ASSERT_EQ(Stream.writeBuffer(&Pattern[(size_t)nOffset], cbWrite), cbWrite);
+					Expected.writeBuffer(&Pattern[(size_t)nOffset], cbWrite);
+					ASSERT_EQ(Stream.getPosition(), Expected.getPosition());
+
+					// Keeps the file at a size that is quick to compare
+					if (Expected.getDataSize() > 4 * cbPatternSize)
+						break;
+				}
+				Stream.close();
+			}
+			ASSERT_TRUE(fnReadPOSIXTestFile() == fnMemoryStreamData(Expected));
+		});
+	}
+
+	TEST(ExportStream_GCC_POSIX, PatchFlushedBlocks)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(10000, 3);
+		std::vector<nfByte> Patch = fnCreateStreamTestData(3000, 5);
+
+		fnForEachPOSIXFileOptions([&](const EXPORTSTREAMFILEOPTIONS & Options) {
+			CExportStreamMemory Expected;
+			CExportStream_GCC_POSIX Stream(fnPOSIXTestFileNameW().c_str(), Options);
+
+			// Every step is done on both streams. With O_DIRECT, the first flush writes two whole blocks
+			// directly and the tail through the page cache, and every later seek reads back a partial block.
+			auto fnSeek = [&](nfUint64 nPosition) {
+				ASSERT_TRUE(Stream.seekPosition(nPosition, false));
+				Expected.seekPosition(nPosition, false);
+			};
+			auto fnWrite = [&](const std::vector<nfByte> & Buffer, nfUint64 cbCount) {
+				ASSERT_EQ(Stream.writeBuffer(Buffer.data(), cbCount), cbCount);
+				Expected.writeBuffer(Buffer.data(), cbCount);
+				ASSERT_EQ(Stream.getPosition(), Expected.getPosition());
+			};
+
+			fnWrite(Data, Data.size());
+			// Patch inside the first block and across the second block boundary
+			fnSeek(5000);
+			fnWrite(Patch, 100);
+			fnSeek(8000);
+			fnWrite(Patch, 500);
+			// Patch that extends the file
+			fnSeek(9000);
+			fnWrite(Patch, 3000);
+			ASSERT_TRUE(Stream.seekFromEnd(12000, false));
+			ASSERT_EQ(Stream.getPosition(), 0u);
+			Expected.seekFromEnd(12000, false);
+			fnWrite(Patch, 10);
+			// The block of the new position ends behind the end of the file, so its start is read back and the rest is zero
+			fnSeek(12200);
+			fnWrite(Data, 100);
+			// The block of the new position starts behind the end of the file
+			fnSeek(20000);
+			fnWrite(Data, 10);
+
+			Stream.close();
+			ASSERT_TRUE(fnReadPOSIXTestFile() == fnMemoryStreamData(Expected));
+		});
+	}
+
+	TEST(ExportStream_GCC_POSIX, SeekFromEnd)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(5000);
+
+		fnForEachPOSIXFileOptions([&](const EXPORTSTREAMFILEOPTIONS & Options) {
+			CExportStream_GCC_POSIX Stream(fnPOSIXTestFileNameW().c_str(), Options);
+			Stream.writeBuffer(Data.data(), Data.size());
+
+			ASSERT_FALSE(Stream.seekFromEnd(5001, false));
+			ASSERT_THROW(Stream.seekFromEnd(5001, true), CNMRException);
+			ASSERT_EQ(Stream.getPosition(), 5000u);
+
+			// The end includes data that has not been flushed yet
+			ASSERT_TRUE(Stream.seekFromEnd(5000, true));
+			ASSERT_EQ(Stream.getPosition(), 0u);
+			ASSERT_TRUE(Stream.seekFromEnd(1, true));
+			ASSERT_EQ(Stream.getPosition(), 4999u);
+			Stream.writeBuffer(Data.data(), 2);
+			ASSERT_TRUE(Stream.seekFromEnd(0, true));
+			ASSERT_EQ(Stream.getPosition(), 5001u);
+
+			Stream.close();
+			std::vector<nfByte> FileData = fnReadPOSIXTestFile();
+			ASSERT_EQ(FileData.size(), 5001u);
+			ASSERT_TRUE(std::equal(Data.begin(), Data.begin() + 4999, FileData.begin()));
+			ASSERT_EQ(FileData[4999], Data[0]);
+			ASSERT_EQ(FileData[5000], Data[1]);
+		});
+	}
+
+#ifdef __linux__
+	// File systems without fallocate are written without preallocation
+	nfBool fnPOSIXTestFileCanPreallocate()
+	{
+		int nFileDescriptor = open(sPOSIXTestFileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+		if (nFileDescriptor < 0)
+			return false;
+		nfBool bCanPreallocate = (fallocate(nFileDescriptor, FALLOC_FL_KEEP_SIZE, 0, 4096) == 0);
+		close(nFileDescriptor);
+		unlink(sPOSIXTestFileName.c_str());
+		return bCanPreallocate;
+	}
+
+	TEST(ExportStream_GCC_POSIX, PreallocationIsReleasedOnClose)
+	{
+		if (!fnPOSIXTestFileCanPreallocate())
+			return;
+
+		std::vector<nfByte> Data = fnCreateStreamTestData(10000);
+		fnForEachPOSIXFileOptions([&](const EXPORTSTREAMFILEOPTIONS & Options) {
+			CExportStream_GCC_POSIX Stream(fnPOSIXTestFileNameW().c_str(), Options);
+			ASSERT_GE(fnAllocatedPOSIXTestFileSize(), Options.m_nSizeHint);
+
+			Stream.writeBuffer(Data.data(), Data.size());
+			Stream.close();
+			// Flushing allocates at least one step ahead, and closing truncates the file to its size again
+			ASSERT_EQ(fnReadPOSIXTestFile(), Data);
+			ASSERT_LT(fnAllocatedPOSIXTestFileSize(), (nfUint64)NMR_EXPORTSTREAM_POSIX_ALIGNMENT * 16);
+		});
+	}
+
+	TEST(ExportStream_GCC_POSIX, PreallocationGrows)
+	{
+		if (!fnPOSIXTestFileCanPreallocate())
+			return;
+
+		const nfUint64 cbPieceSize = 1024 * 1024;
+		const nfUint64 cbTotalSize = NMR_EXPORTSTREAM_POSIX_PREALLOCATIONSTEP + 6 * cbPieceSize + 123;
+		std::vector<nfByte> Data = fnCreateStreamTestData(cbTotalSize);
+
+		EXPORTSTREAMFILEOPTIONS Options;
+		Options.m_nSizeHint = 0;
+		Options.m_bDropWrittenPages = true;
+		Options.m_bDirectIO = false;
+		{
+			CExportStream_GCC_POSIX Stream(fnPOSIXTestFileNameW().c_str(), Options);
+			ASSERT_EQ(fnAllocatedPOSIXTestFileSize(), 0u);
+
+			nfUint64 cbWritten = 0;
+			nfBool bHasGrown = false;
+			while (cbWritten < cbTotalSize) {
+				nfUint64 cbCount = std::min(cbPieceSize, cbTotalSize - cbWritten);
+				Stream.writeBuffer(&Data[(size_t)cbWritten], cbCount);
+				cbWritten += cbCount;
+
+				// The first flush allocates a whole step, the first flush behind it allocates the next step
+				if (cbWritten == NMR_EXPORTSTREAM_POSIX_BUFFERSIZE) {
+					ASSERT_GE(fnAllocatedPOSIXTestFileSize(), (nfUint64)NMR_EXPORTSTREAM_POSIX_PREALLOCATIONSTEP);
+				}
+				if (fnAllocatedPOSIXTestFileSize() >= 2 * (nfUint64)NMR_EXPORTSTREAM_POSIX_PREALLOCATIONSTEP)
+					bHasGrown = true;
+			}
+			ASSERT_TRUE(bHasGrown);
+
+			Stream.close();
+			ASSERT_LT(fnAllocatedPOSIXTestFileSize(), cbTotalSize + (nfUint64)NMR_EXPORTSTREAM_POSIX_ALIGNMENT * 16);
+		}
+		ASSERT_TRUE(fnReadPOSIXTestFile() == Data);
+		unlink(sPOSIXTestFileName.c_str());
+	}
+#endif // __linux__
+
+}
+
+#endif // _WIN32
@@ -0,0 +1,212 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_ExportStream_Memory.cpp: Defines Unittests for the CExportStreamMemory class
+
+--*/
+
+#include "UnitTest_Streams.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+
+#include <cstring>
+
+namespace NMR
+{
+	// Concatenates the chunks of the stream, checking that they are contiguous and that only the last one is partially filled
+	std::vector<nfByte> fnGatherChunks(_In_ CExportStreamMemory & Stream)
+	{
+		std::vector<nfByte> Data;
+		nfUint32 nChunkCount = Stream.getChunkCount();
+		for (nfUint32 nIndex = 0; nIndex < nChunkCount; nIndex++) {
+			nfUint64 cbChunkSize = 0;
+			const nfByte * pChunkData = Stream.getChunkData(nIndex, cbChunkSize);
+			EXPECT_GT(cbChunkSize, 0u);
+			Data.insert(Data.end(), pChunkData, pChunkData + cbChunkSize);
+		}
+		EXPECT_EQ(Data.size(), Stream.getDataSize());
+		return Data;
+	}
+
+	void fnWriteInPieces(_In_ CExportStreamMemory & Stream, _In_ const std::vector<nfByte> & Data, _In_ size_t cbPieceSize)
+	{
+		for (size_t nOffset = 0; nOffset < Data.size(); nOffset += cbPieceSize) {
+			nfUint64 cbToWrite = std::min(cbPieceSize, Data.size() - nOffset);
+			ASSERT_EQ(Stream.writeBuffer(&Data[nOffset], cbToWrite), cbToWrite);
+		}
+	}
+
+	TEST(ExportStream_Memory, EmptyStream)
+	{
+		CExportStreamMemory Stream;
+		ASSERT_EQ(Stream.getDataSize(), 0u);
+		ASSERT_EQ(Stream.getChunkCount(), 0u);
+		ASSERT_EQ(Stream.getData(), nullptr);
+		ASSERT_EQ(Stream.writeBuffer(nullptr, 0), 0u);
+		ASSERT_THROW(Stream.writeBuffer(nullptr, 1), CNMRException);
+	}
+
+	TEST(ExportStream_Memory, WriteAcrossChunks)
+	{
+		// Large enough to grow the chunks from the minimum to the maximum size and beyond
+		const nfUint64 cbSize = 2 * NMR_EXPORTSTREAM_MEMORY_MAXCHUNKSIZE + 12345;
+		std::vector<nfByte> Data = fnCreateStreamTestData(cbSize);
+
+		CExportStreamMemory Stream;
+		fnWriteInPieces(Stream, Data, 77777);
+		ASSERT_EQ(Stream.getDataSize(), cbSize);
+		ASSERT_EQ(Stream.getPosition(), cbSize);
+
+		// The first two chunks have the minimum size, then every chunk doubles the capacity until the maximum size is reached
+		nfUint64 nExpectedStart = 0;
+		nfUint32 nChunkCount = Stream.getChunkCount();
+		for (nfUint32 nIndex = 0; nIndex < nChunkCount; nIndex++) {
+			nfUint64 cbExpectedCapacity = std::min(std::max(nExpectedStart, NMR_EXPORTSTREAM_MEMORY_MINCHUNKSIZE), NMR_EXPORTSTREAM_MEMORY_MAXCHUNKSIZE);
+			nfUint64 cbChunkSize = 0;
+			Stream.getChunkData(nIndex, cbChunkSize);
+			if (nIndex + 1 < nChunkCount)
+				ASSERT_EQ(cbChunkSize, cbExpectedCapacity);
+			else
+				ASSERT_EQ(cbChunkSize, cbSize - nExpectedStart);
+			nExpectedStart += cbExpectedCapacity;
+		}
+		// 64 KB, 64 KB, 128 KB, ..., 8 MB reach 16 MB in 9 chunks, the remainder goes into another chunk of 8 MB
+		ASSERT_EQ(nChunkCount, 10u);
+
+		nfUint64 cbChunkSize = 0;
+		ASSERT_THROW(Stream.getChunkData(nChunkCount, cbChunkSize), CNMRException);
+		ASSERT_TRUE(fnGatherChunks(Stream) == Data);
+	}
+
+	TEST(ExportStream_Memory, OverwriteAcrossChunks)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(300000);
+		std::vector<nfByte> Patch = fnCreateStreamTestData(150000, 2);
+
+		CExportStreamMemory Stream;
+		fnWriteInPieces(Stream, Data, 4096);
+
+		// Crosses the boundaries at 64 KB, 128 KB and 256 KB
+		ASSERT_TRUE(Stream.seekPosition(60000, true));
+		Stream.writeBuffer(Patch.data(), 10000);
+		ASSERT_TRUE(Stream.seekPosition(120000, true));
+		Stream.writeBuffer(Patch.data() + 10000, 140000);
+		std::copy(Patch.begin(), Patch.begin() + 10000, Data.begin() + 60000);
+		std::copy(Patch.begin() + 10000, Patch.end(), Data.begin() + 120000);
+		ASSERT_EQ(Stream.getPosition(), 260000u);
+		ASSERT_EQ(Stream.getDataSize(), 300000u);
+		ASSERT_TRUE(fnGatherChunks(Stream) == Data);
+
+		// Overwriting the end of the stream extends it
+		ASSERT_TRUE(Stream.seekFromEnd(100, true));
+		Stream.writeBuffer(Patch.data(), 1000);
+		Data.resize(299900);
+		Data.insert(Data.end(), Patch.begin(), Patch.begin() + 1000);
+		ASSERT_EQ(Stream.getDataSize(), 300900u);
+		ASSERT_TRUE(fnGatherChunks(Stream) == Data);
+	}
+
+	TEST(ExportStream_Memory, WriteBehindEndFillsGapWithZeros)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(300000);
+
+		CExportStreamMemory Stream;
+		Stream.writeBuffer(Data.data(), Data.size());
+		ASSERT_THROW(Stream.seekPosition(300000, true), CNMRException);
+
+		// Clearing keeps the chunks with their old content, which must not show up in the gap
+		Stream.clear();
+		ASSERT_EQ(Stream.getDataSize(), 0u);
+		ASSERT_EQ(Stream.getChunkCount(), 0u);
+		Stream.writeBuffer(Data.data(), 1000);
+		ASSERT_TRUE(Stream.seekPosition(200000, false));
+		Stream.writeBuffer(Data.data() + 1000, 1000);
+		ASSERT_EQ(Stream.getDataSize(), 201000u);
+
+		std::vector<nfByte> Expected(201000, 0);
+		std::copy(Data.begin(), Data.begin() + 1000, Expected.begin());
+		std::copy(Data.begin() + 1000, Data.begin() + 2000, Expected.begin() + 200000);
+		ASSERT_TRUE(fnGatherChunks(Stream) == Expected);
+
+		// A gap that starts behind the last chunk allocates new chunks
+		ASSERT_TRUE(Stream.seekForward(1000000, false));
+		Stream.writeBuffer(Data.data(), 10);
+		ASSERT_EQ(Stream.getDataSize(), 1201010u);
+		Expected.resize(1201000, 0);
+		Expected.insert(Expected.end(), Data.begin(), Data.begin() + 10);
+		ASSERT_TRUE(fnGatherChunks(Stream) == Expected);
+	}
+
+	TEST(ExportStream_Memory, CopyDataAcrossChunks)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(1000000);
+		CExportStreamMemory Stream;
+		fnWriteInPieces(Stream, Data, 65536);
+
+		const nfUint64 Ranges[][2] = { { 0, 1000000 }, { 65535, 2 }, { 60000, 500000 }, { 131072, 131072 }, { 999999, 1 }, { 1000000, 0 } };
+		for (auto & Range : Ranges) {
+			std::vector<nfByte> Buffer((size_t)Range[1] + 1, 0xAB);
+			Stream.copyData(Range[0], Range[1], Buffer.data());
+			ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.end() - 1, Data.begin() + (size_t)Range[0]));
+			ASSERT_EQ(Buffer.back(), 0xAB);
+		}
+
+		nfByte Buffer[2];
+		ASSERT_THROW(Stream.copyData(999999, 2, Buffer), CNMRException);
+		ASSERT_THROW(Stream.copyData(1000001, 1, Buffer), CNMRException);
+		ASSERT_THROW(Stream.copyData(0, 1, nullptr), CNMRException);
+	}
+
+	TEST(ExportStream_Memory, GetDataMergesChunks)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(500000);
+		CExportStreamMemory Stream;
+		fnWriteInPieces(Stream, Data, 100000);
+		ASSERT_GT(Stream.getChunkCount(), 1u);
+
+		const nfByte * pData = Stream.getData();
+		ASSERT_NE(pData, nullptr);
+		ASSERT_EQ(memcmp(pData, Data.data(), Data.size()), 0);
+		ASSERT_EQ(Stream.getChunkCount(), 1u);
+		ASSERT_EQ(Stream.getData(), pData);
+
+		// The merged chunk is written and read like any other chunk
+		std::vector<nfByte> Patch = fnCreateStreamTestData(600000, 3);
+		ASSERT_TRUE(Stream.seekPosition(400000, true));
+		Stream.writeBuffer(Patch.data(), Patch.size());
+		Data.resize(400000);
+		Data.insert(Data.end(), Patch.begin(), Patch.end());
+		ASSERT_EQ(Stream.getDataSize(), 1000000u);
+		ASSERT_TRUE(fnGatherChunks(Stream) == Data);
+
+		std::vector<nfByte> Buffer(300000);
+		Stream.copyData(350000, Buffer.size(), Buffer.data());
+		ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.end(), Data.begin() + 350000));
+
+		ASSERT_EQ(memcmp(Stream.getData(), Data.data(), Data.size()), 0);
+	}
+}
@@ -0,0 +1,106 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_ImportStream_Chunked_Memory.cpp: Defines Unittests for the CImportStream_Chunked_Memory class
+
+--*/
+
+#include "UnitTest_Streams.h"
+#include "Common/Platform/NMR_ImportStream_Chunked_Memory.h"
+
+namespace NMR
+{
+	PExportStreamMemory fnCreateChunkedExportStream(_In_ const std::vector<nfByte> & Data)
+	{
+		PExportStreamMemory pExportStream = std::make_shared<CExportStreamMemory>();
+		pExportStream->writeBuffer(Data.data(), Data.size());
+		return pExportStream;
+	}
+
+	TEST(ImportStream_Chunked_Memory, ReadBufferAcrossChunks)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(1000000);
+		PExportStreamMemory pExportStream = fnCreateChunkedExportStream(Data);
+		ASSERT_GT(pExportStream->getChunkCount(), 1u);
+
+		CImportStream_Chunked_Memory Stream(pExportStream);
+		ASSERT_EQ(Stream.retrieveSize(), Data.size());
+
+		// Pieces that do not align with the chunk boundaries
+		std::vector<nfByte> ReadData;
+		std::vector<nfByte> Buffer(99999);
+		nfUint64 cbRead;
+		while ((cbRead = Stream.readBuffer(Buffer.data(), Buffer.size(), false)) > 0)
+			ReadData.insert(ReadData.end(), Buffer.begin(), Buffer.begin() + (size_t)cbRead);
+		ASSERT_TRUE(ReadData == Data);
+		ASSERT_EQ(Stream.getPosition(), Data.size());
+
+		ASSERT_TRUE(Stream.seekFromEnd(10, true));
+		ASSERT_THROW(Stream.readBuffer(Buffer.data(), 11, true), CNMRException);
+	}
+
+	TEST(ImportStream_Chunked_Memory, Seek)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(1000000);
+		CImportStream_Chunked_Memory Stream(fnCreateChunkedExportStream(Data));
+
+		std::vector<nfByte> Buffer(200000);
+		ASSERT_TRUE(Stream.seekPosition(65530, true));
+		ASSERT_EQ(Stream.readBuffer(Buffer.data(), Buffer.size(), true), Buffer.size());
+		ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.end(), Data.begin() + 65530));
+
+		ASSERT_TRUE(Stream.seekForward(1000, true));
+		ASSERT_EQ(Stream.getPosition(), 266530u);
+		ASSERT_EQ(Stream.readBuffer(Buffer.data(), 10, true), 10u);
+		ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.begin() + 10, Data.begin() + 266530));
+
+		ASSERT_TRUE(Stream.seekFromEnd(100, true));
+		ASSERT_EQ(Stream.readBuffer(Buffer.data(), Buffer.size(), false), 100u);
+		ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.begin() + 100, Data.end() - 100));
+
+		ASSERT_THROW(Stream.seekPosition(1000001, true), CNMRException);
+		ASSERT_FALSE(Stream.seekPosition(1000001, false));
+		ASSERT_FALSE(Stream.seekFromEnd(1000001, false));
+		ASSERT_EQ(Stream.getPosition(), 1000000u);
+	}
+
+	TEST(ImportStream_Chunked_Memory, CopyToMemory)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(1000000);
+		CImportStream_Chunked_Memory Stream(fnCreateChunkedExportStream(Data));
+
+		// Only the data behind the current position is copied
+		ASSERT_TRUE(Stream.seekPosition(100000, true));
+		PImportStream pCopy = Stream.copyToMemory();
+		ASSERT_EQ(pCopy->retrieveSize(), 900000u);
+
+		std::vector<nfByte> Buffer(900000);
+		ASSERT_EQ(pCopy->readBuffer(Buffer.data(), Buffer.size(), true), Buffer.size());
+		ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.end(), Data.begin() + 100000));
+	}
+}
@@ -0,0 +1,137 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_ImportStream_Deflated_Memory.cpp: Defines Unittests for the CImportStream_Deflated_Memory class
+
+--*/
+
+#include "UnitTest_Streams.h"
+#include "Common/Platform/NMR_ImportStream_Deflated_Memory.h"
+#include "Libraries/zlib/zlib.h"
+
+namespace NMR
+{
+	// Inflates in small steps, so that the stepping of entries beyond 4 GB is exercised with little memory
+	class CImportStream_Deflated_SmallSteps : public CImportStream_Deflated_Memory {
+	public:
+		CImportStream_Deflated_SmallSteps(_In_ std::vector<nfByte> && DeflatedBuffer, _In_ nfUint64 cbInflatedSize, _In_ nfUint32 nCRC32)
+			: CImportStream_Deflated_Memory(std::move(DeflatedBuffer), cbInflatedSize, nCRC32)
+		{
+			m_cbMaxInflateStep = 1000;
+		}
+	};
+
+	// Raw deflate data, as it is stored in a ZIP entry
+	std::vector<nfByte> fnDeflateRaw(_In_ const std::vector<nfByte> & Data)
+	{
+		z_stream Stream = {};
+		if (deflateInit2(&Stream, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw CNMRException(NMR_ERROR_COULDNOTINITDEFLATE);
+
+		std::vector<nfByte> Deflated(deflateBound(&Stream, (uLong)Data.size()));
+		Stream.next_in = (Bytef *)Data.data();
+		Stream.avail_in = (uInt)Data.size();
+		Stream.next_out = Deflated.data();
+		Stream.avail_out = (uInt)Deflated.size();
+		nfInt32 nResult = deflate(&Stream, Z_FINISH);
+		Deflated.resize(Stream.total_out);
+		deflateEnd(&Stream);
+		if (nResult != Z_STREAM_END)
+			throw CNMRException(NMR_ERROR_COULDNOTDEFLATE);
+		return Deflated;
+	}
+
+	// Compressible data, so that the deflated buffer is split into several input steps as well
+	std::vector<nfByte> fnCreateInflateTestData()
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(100000);
+		for (size_t nIndex = 0; nIndex < Data.size(); nIndex++)
+			Data[nIndex] = (nfByte)('a' + (Data[nIndex] & 0x03));
+		return Data;
+	}
+
+	nfUint32 fnCRC32(_In_ const std::vector<nfByte> & Data)
+	{
+		return crc32(crc32(0, Z_NULL, 0), Data.data(), (uInt)Data.size());
+	}
+
+	void fnExpectInflateError(_In_ CImportStream_Deflated_Memory & Stream)
+	{
+		try {
+			Stream.ensureInflated();
+			FAIL() << "A malformed entry was inflated";
+		}
+		catch (CNMRException & Exception) {
+			ASSERT_EQ(Exception.getErrorCode(), NMR_ERROR_COULDNOTINFLATE);
+		}
+	}
+
+	TEST(ImportStream_Deflated_Memory, InflatesInSteps)
+	{
+		std::vector<nfByte> Data = fnCreateInflateTestData();
+		std::vector<nfByte> Deflated = fnDeflateRaw(Data);
+		ASSERT_GT(Deflated.size(), 1000u);
+		nfUint64 cbDeflatedSize = Deflated.size();
+
+		CImportStream_Deflated_SmallSteps Stream(std::move(Deflated), Data.size(), fnCRC32(Data));
+		ASSERT_EQ(Stream.getDeflatedSize(), cbDeflatedSize);
+		ASSERT_EQ(Stream.retrieveSize(), Data.size());
+
+		std::vector<nfByte> Buffer(Data.size());
+		ASSERT_EQ(Stream.readBuffer(Buffer.data(), Buffer.size(), true), Buffer.size());
+		ASSERT_TRUE(Buffer == Data);
+	}
+
+	TEST(ImportStream_Deflated_Memory, TruncatedEntryFails)
+	{
+		std::vector<nfByte> Data = fnCreateInflateTestData();
+		std::vector<nfByte> Deflated = fnDeflateRaw(Data);
+		Deflated.resize(Deflated.size() / 2);
+
+		// The declared size still needs further output steps when the input runs out
+		CImportStream_Deflated_SmallSteps Stream(std::move(Deflated), Data.size() * 2, fnCRC32(Data) ^ 1);
+		fnExpectInflateError(Stream);
+	}
+
+	TEST(ImportStream_Deflated_Memory, EntryLargerThanDeclaredSizeFails)
+	{
+		std::vector<nfByte> Data = fnCreateInflateTestData();
+
+		// The output runs out while further input steps are left
+		CImportStream_Deflated_SmallSteps Stream(fnDeflateRaw(Data), Data.size() / 2, fnCRC32(Data));
+		fnExpectInflateError(Stream);
+	}
+
+	TEST(ImportStream_Deflated_Memory, WrongCRCFails)
+	{
+		std::vector<nfByte> Data = fnCreateInflateTestData();
+
+		CImportStream_Deflated_Memory Stream(fnDeflateRaw(Data), Data.size(), fnCRC32(Data) ^ 1);
+		fnExpectInflateError(Stream);
+	}
+}
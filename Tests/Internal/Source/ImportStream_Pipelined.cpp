@@ -0,0 +1,196 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_ImportStream_Pipelined.cpp: Defines Unittests for the CImportStream_Pipelined class
+
+--*/
+
+#include "UnitTest_Streams.h"
+#include "Common/Platform/NMR_ImportStream_Pipelined.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace NMR
+{
+	// A memory stream that fails once it is read beyond a given position, and that records reads after it was released
+	class CImportStream_Guarded : public CImportStream_Shared_Memory {
+	private:
+		nfUint64 m_nFailPosition;
+	public:
+		std::atomic<nfUint32> m_nReadCount;
+		std::atomic<nfBool> m_bReleased;
+		std::atomic<nfUint32> m_nReadsAfterRelease;
+
+		CImportStream_Guarded(_In_ const std::vector<nfByte> & Data, _In_ nfUint64 nFailPosition)
+			: CImportStream_Shared_Memory(Data.data(), Data.size()), m_nFailPosition(nFailPosition),
+			m_nReadCount(0), m_bReleased(false), m_nReadsAfterRelease(0)
+		{
+		}
+
+		virtual nfUint64 readBuffer(_In_ nfByte * pBuffer, _In_ nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll)
+		{
+			m_nReadCount++;
+			if (m_bReleased)
+				m_nReadsAfterRelease++;
+			if (getPosition() >= m_nFailPosition)
+				throw CNMRException(NMR_ERROR_COULDNOTREADZIPFILE);
+			return CImportStream_Shared_Memory::readBuffer(pBuffer, cbTotalBytesToRead, bNeedsToReadAll);
+		}
+	};
+	typedef std::shared_ptr<CImportStream_Guarded> PImportStream_Guarded;
+
+	const nfUint32 nTestBufferSize = 64 * 1024;
+
+	TEST(ImportStream_Pipelined, ReadsLargeStream)
+	{
+		// Larger than NMR_IMPORTSTREAM_PIPELINEMINSIZE, and not a multiple of the buffer size
+		std::vector<nfByte> Data = fnCreateStreamTestData(3 * 1024 * 1024 + 123);
+		PImportStream pSource = std::make_shared<CImportStream_Shared_Memory>(Data.data(), Data.size());
+		ASSERT_TRUE(Data.size() >= NMR_IMPORTSTREAM_PIPELINEMINSIZE);
+
+		CImportStream_Pipelined Stream(pSource);
+		ASSERT_EQ(Stream.retrieveSize(), Data.size());
+
+		std::vector<nfByte> Buffer(Data.size());
+		nfUint64 cbRead = 0;
+		while (cbRead < Data.size()) {
+			nfUint64 cbChunk = Stream.readBuffer(Buffer.data() + cbRead, std::min((nfUint64)7777, Data.size() - cbRead), false);
+			ASSERT_TRUE(cbChunk > 0);
+			cbRead += cbChunk;
+			ASSERT_EQ(Stream.getPosition(), cbRead);
+		}
+		ASSERT_TRUE(Buffer == Data);
+
+		nfByte nByte;
+		ASSERT_EQ(Stream.readBuffer(&nByte, 1, false), 0);
+		ASSERT_THROW(Stream.readBuffer(&nByte, 1, true), CNMRException);
+	}
+
+	TEST(ImportStream_Pipelined, CopyToMemory)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(5 * nTestBufferSize + 17);
+		PImportStream pSource = std::make_shared<CImportStream_Shared_Memory>(Data.data(), Data.size());
+
+		CImportStream_Pipelined Stream(pSource, 3, nTestBufferSize);
+		PImportStream pCopy = Stream.copyToMemory();
+		ASSERT_EQ(pCopy->retrieveSize(), Data.size());
+
+		std::vector<nfByte> Buffer(Data.size());
+		pCopy->readBuffer(Buffer.data(), Buffer.size(), true);
+		ASSERT_TRUE(Buffer == Data);
+	}
+
+	TEST(ImportStream_Pipelined, Seek)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(4 * nTestBufferSize);
+		PImportStream pSource = std::make_shared<CImportStream_Shared_Memory>(Data.data(), Data.size());
+
+		CImportStream_Pipelined Stream(pSource, 2, nTestBufferSize);
+		ASSERT_TRUE(Stream.seekPosition(0, true));
+		ASSERT_TRUE(Stream.seekForward(nTestBufferSize + 5, true));
+		ASSERT_EQ(Stream.getPosition(), nTestBufferSize + 5);
+
+		nfByte nByte;
+		Stream.readBuffer(&nByte, 1, true);
+		ASSERT_EQ(nByte, Data[nTestBufferSize + 5]);
+
+		// The stream can only move forward
+		ASSERT_FALSE(Stream.seekPosition(0, false));
+		ASSERT_THROW(Stream.seekPosition(0, true), CNMRException);
+		ASSERT_FALSE(Stream.seekFromEnd(1, false));
+		ASSERT_FALSE(Stream.seekForward(Data.size(), false));
+	}
+
+	TEST(ImportStream_Pipelined, RethrowsSourceErrorAfterBufferedData)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(8 * nTestBufferSize);
+		PImportStream_Guarded pSource = std::make_shared<CImportStream_Guarded>(Data, 3 * nTestBufferSize);
+
+		CImportStream_Pipelined Stream(pSource, 4, nTestBufferSize);
+
+		// All data that was read before the error is delivered
+		std::vector<nfByte> Buffer(3 * nTestBufferSize);
+		ASSERT_EQ(Stream.readBuffer(Buffer.data(), Buffer.size(), true), Buffer.size());
+		ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.end(), Data.begin()));
+
+		// Then the error of the source is thrown on the reading thread, and on every later read
+		for (int nAttempt = 0; nAttempt < 2; nAttempt++) {
+			try {
+				Stream.readBuffer(Buffer.data(), 1, false);
+				ASSERT_FALSE(true);
+			}
+			catch (CNMRException & e) {
+				ASSERT_EQ(e.getErrorCode(), NMR_ERROR_COULDNOTREADZIPFILE);
+			}
+		}
+	}
+
+	TEST(ImportStream_Pipelined, StopReading)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(1024 * 1024);
+		PImportStream_Guarded pSource = std::make_shared<CImportStream_Guarded>(Data, Data.size());
+
+		CImportStream_Pipelined Stream(pSource, 2, 4096);
+		std::vector<nfByte> Buffer(Data.size());
+		ASSERT_EQ(Stream.readBuffer(Buffer.data(), 100, true), 100);
+
+		// After stopReading returns, the source stream is not accessed anymore
+		Stream.stopReading();
+		pSource->m_bReleased = true;
+
+		// Data that was already read ahead is still delivered
+		nfUint64 cbRest = Stream.readBuffer(Buffer.data() + 100, Buffer.size() - 100, false);
+		ASSERT_TRUE(cbRest <= 2 * 4096 - 100);
+		ASSERT_TRUE(std::equal(Buffer.begin(), Buffer.begin() + 100 + (size_t)cbRest, Data.begin()));
+		ASSERT_EQ(Stream.readBuffer(Buffer.data(), 1, false), 0);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		ASSERT_EQ(pSource->m_nReadsAfterRelease, 0);
+	}
+
+	TEST(ImportStream_Pipelined, DestructorStopsReading)
+	{
+		std::vector<nfByte> Data = fnCreateStreamTestData(1024 * 1024);
+		PImportStream_Guarded pSource = std::make_shared<CImportStream_Guarded>(Data, Data.size());
+
+		{
+			// The ring is full and the background thread waits for a consumer that never comes
+			CImportStream_Pipelined Stream(pSource, 2, 4096);
+			while (pSource->m_nReadCount < 2)
+				std::this_thread::yield();
+		}
+		pSource->m_bReleased = true;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		ASSERT_EQ(pSource->m_nReadsAfterRelease, 0);
+		ASSERT_EQ(pSource->m_nReadCount, 2);
+	}
+
+}
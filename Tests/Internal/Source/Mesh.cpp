@@ -0,0 +1,181 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_Model.cpp: Defines Unittests for the CModel class
+UnitTest_Mesh.cpp: Defines Unittests for the outbox cache of the CMesh class
+
+--*/
+
+#include "gtest/gtest.h"
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Math/NMR_Matrix.h"
+
+#include <cmath>
+#include <random>
+
+namespace NMR
+{
+	// The fourteen extreme nodes along the axes and the diagonals are placed explicitly, so that the
+	// hull tetrahedra of the outbox cache are known: centroid (0,0,0), axis extremes at distance 10
+	// and diagonal extremes at (+-5, +-5, +-5).
+	void fnAddOutboxTestExtremes(_In_ CMesh & Mesh)
+	{
+		for (nfUint32 k = 0; k < 3; k++) {
+			NVEC3 vPosition = fnVEC3_make(0.0, 0.0, 0.0);
+			vPosition.m_fields[k] = 10.0;
+			Mesh.addNode(vPosition);
+			vPosition.m_fields[k] = -10.0;
+			Mesh.addNode(vPosition);
+		}
+		for (nfUint32 nOctant = 0; nOctant < 8; nOctant++) {
+			Mesh.addNode(fnVEC3_make((nOctant & 1) ? -5.0 : 5.0, (nOctant & 2) ? -5.0 : 5.0, (nOctant & 4) ? -5.0 : 5.0));
+		}
+	}
+
+	// Adds nodes that lie exactly on the faces of the hull tetrahedra, both on the outer faces and on the
+	// faces shared with the centroid.
+	void fnAddOutboxTestFaceNodes(_In_ CMesh & Mesh, _In_ std::mt19937 & Random)
+	{
+		std::uniform_real_distribution<nfFloat> Distribution(0.0, 1.0);
+		for (nfUint32 nOctant = 0; nOctant < 8; nOctant++) {
+			NVEC3 vCorners[4];
+			vCorners[0] = fnVEC3_make((nOctant & 1) ? -10.0 : 10.0, 0.0, 0.0);
+			vCorners[1] = fnVEC3_make(0.0, (nOctant & 2) ? -10.0 : 10.0, 0.0);
+			vCorners[2] = fnVEC3_make(0.0, 0.0, (nOctant & 4) ? -10.0 : 10.0);
+			vCorners[3] = fnVEC3_make((nOctant & 1) ? -5.0 : 5.0, (nOctant & 2) ? -5.0 : 5.0, (nOctant & 4) ? -5.0 : 5.0);
+
+			for (nfUint32 k = 0; k < 3; k++) {
+				NVEC3 vA = vCorners[k];
+				NVEC3 vB = vCorners[(k + 1) % 3];
+				for (nfUint32 nIndex = 0; nIndex < 16; nIndex++) {
+					nfFloat fU = Distribution(Random);
+					nfFloat fV = Distribution(Random) * (1.0 - fU);
+					// Outer face through both axis extremes and the diagonal extreme
+					Mesh.addNode(fnVEC3_add(fnVEC3_add(fnVEC3_scale(vA, fU), fnVEC3_scale(vB, fV)), fnVEC3_scale(vCorners[3], 1.0 - fU - fV)));
+					// Inner faces through the centroid
+					Mesh.addNode(fnVEC3_add(fnVEC3_scale(vA, fU), fnVEC3_scale(vB, fV)));
+					Mesh.addNode(fnVEC3_add(fnVEC3_scale(vA, fU), fnVEC3_scale(vCorners[3], fV)));
+				}
+			}
+		}
+	}
+
+	void fnAddOutboxTestInnerNodes(_In_ CMesh & Mesh, _In_ std::mt19937 & Random, _In_ nfUint32 nCount)
+	{
+		// Points within a sphere of radius 8 never exceed the explicit extremes along the axes or the diagonals
+		std::uniform_real_distribution<nfFloat> Distribution(-1.0, 1.0);
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
+			NVEC3 vDirection = fnVEC3_make(Distribution(Random), Distribution(Random), Distribution(Random));
+			nfFloat fLength = fnVEC3_length(vDirection);
+			if (fLength < 1.0e-3)
+				continue;
+			nfFloat fRadius = (nIndex % 2) ? 8.0 : 8.0 * fabs(Distribution(Random));
+			Mesh.addNode(fnVEC3_scale(vDirection, fRadius / fLength));
+		}
+	}
+
+	NOUTBOX3 fnBruteForceOutbox(_In_ CMesh & Mesh, _In_ const NMATRIX3 mMatrix)
+	{
+		NOUTBOX3 vOutbox;
+		fnOutboxInitialize(vOutbox);
+		nfUint32 nNodeCount = Mesh.getNodeCount();
+		for (nfUint32 iNode = 0; iNode < nNodeCount; iNode++)
+			fnOutboxMergeVector(vOutbox, fnMATRIX3_apply(mMatrix, Mesh.getNode(iNode)->m_position));
+		return vOutbox;
+	}
+
+	std::vector<NMATRIX3> fnOutboxTestTransforms()
+	{
+		std::vector<NMATRIX3> Transforms;
+		// Rotations by 45 degrees around the axes turn the outer faces (e.g. x + y = 10) perpendicular to a transformed axis
+		for (nfUint32 k = 0; k < 3; k++) {
+			NVEC3 vAxis = fnVEC3_make(0.0, 0.0, 0.0);
+			vAxis.m_fields[k] = 1.0;
+			Transforms.push_back(fnMATRIX3_rotation(vAxis, (nfFloat)(M_PI / 4.0)));
+			Transforms.push_back(fnMATRIX3_rotation(vAxis, (nfFloat)(-M_PI / 4.0)));
+		}
+		Transforms.push_back(fnMATRIX3_transformation(fnVEC3_make(1.0, 2.0, 3.0), 0.7, fnVEC3_make(100.0, -50.0, 3.0)));
+		Transforms.push_back(fnMATRIX3_transformation(fnVEC3_make(-1.0, 1.0, 1.0), 2.5, fnVEC3_make(0.0, 0.0, 0.0)));
+		Transforms.push_back(fnMATRIX3_multiply(fnMATRIX3_scale(1.0, 3.0, 0.25), fnMATRIX3_rotation(fnVEC3_make(0.0, 1.0, -2.0), 1.1)));
+		return Transforms;
+	}
+
+	void fnCompareOutboxWithBruteForce(_In_ CMesh & Mesh)
+	{
+		std::vector<NMATRIX3> Transforms = fnOutboxTestTransforms();
+		for (auto iIterator = Transforms.begin(); iIterator != Transforms.end(); iIterator++) {
+			NOUTBOX3 vOutbox;
+			fnOutboxInitialize(vOutbox);
+			Mesh.extendOutbox(vOutbox, *iIterator);
+
+			NOUTBOX3 vExpected = fnBruteForceOutbox(Mesh, *iIterator);
+			for (nfUint32 k = 0; k < 3; k++) {
+				EXPECT_EQ(vOutbox.m_min.m_fields[k], vExpected.m_min.m_fields[k]);
+				EXPECT_EQ(vOutbox.m_max.m_fields[k], vExpected.m_max.m_fields[k]);
+			}
+		}
+	}
+
+	TEST(Mesh, OutboxOfTransformedMeshMatchesAllNodes)
+	{
+		std::mt19937 Random(3);
+		CMesh Mesh;
+		fnAddOutboxTestExtremes(Mesh);
+		fnAddOutboxTestFaceNodes(Mesh, Random);
+		fnAddOutboxTestInnerNodes(Mesh, Random, 5000);
+		ASSERT_GE(Mesh.getNodeCount(), (nfUint32)NMR_MESH_OUTBOXHULLMINNODECOUNT);
+
+		fnCompareOutboxWithBruteForce(Mesh);
+	}
+
+	TEST(Mesh, OutboxFollowsVertexChanges)
+	{
+		std::mt19937 Random(5);
+		CMesh Mesh;
+		fnAddOutboxTestInnerNodes(Mesh, Random, 2000);
+		fnAddOutboxTestExtremes(Mesh);
+		fnAddOutboxTestFaceNodes(Mesh, Random);
+		fnCompareOutboxWithBruteForce(Mesh);
+
+		// An inner node that moves outside of the hull has to become a candidate
+		Mesh.getNode(10)->m_position = fnVEC3_make(3.0, -20.0, 7.0);
+		Mesh.invalidateGeometryCache();
+		fnCompareOutboxWithBruteForce(Mesh);
+
+		// Moving the extremes inwards exposes nodes that were pruned before
+		nfUint32 nNodeCount = Mesh.getNodeCount();
+		for (nfUint32 iNode = 0; iNode < nNodeCount; iNode++) {
+			MESHNODE * pNode = Mesh.getNode(iNode);
+			if (fnVEC3_length(pNode->m_position) > 8.5)
+				pNode->m_position = fnVEC3_scale(pNode->m_position, 0.1);
+		}
+		Mesh.invalidateGeometryCache();
+		fnCompareOutboxWithBruteForce(Mesh);
+	}
+
+}
@@ -0,0 +1,130 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_Model.cpp: Defines Unittests for the CModel class
+
+--*/
+
+#include "gtest/gtest.h"
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelComponentsObject.h"
+#include "Model/Classes/NMR_ModelComponent.h"
+#include "Common/Mesh/NMR_Mesh.h"
+
+namespace NMR
+{
+	PModelMeshObject fnAddMeshObject(_In_ CModel & Model)
+	{
+		PModelMeshObject pObject = std::make_shared<CModelMeshObject>(Model.generateResourceID(), &Model, std::make_shared<CMesh>());
+		Model.addResource(pObject);
+		return pObject;
+	}
+
+	PModelComponentsObject fnAddComponentsObject(_In_ CModel & Model)
+	{
+		PModelComponentsObject pObject = std::make_shared<CModelComponentsObject>(Model.generateResourceID(), &Model);
+		Model.addResource(pObject);
+		return pObject;
+	}
+
+	void fnAddComponent(_In_ PModelComponentsObject pParent, _In_ PModelObject pChild)
+	{
+		pParent->addComponent(std::make_shared<CModelComponent>(pChild.get()));
+	}
+
+	TEST(Model, SortedObjectListOfSharedSubassemblies)
+	{
+		CModel Model;
+		// Components objects are created first, so that their ResourceIDs are lower than those of their children
+		PModelComponentsObject pA = fnAddComponentsObject(Model);
+		PModelComponentsObject pB = fnAddComponentsObject(Model);
+		PModelComponentsObject pC = fnAddComponentsObject(Model);
+		PModelMeshObject pMesh1 = fnAddMeshObject(Model);
+		PModelMeshObject pMesh2 = fnAddMeshObject(Model);
+		PModelComponentsObject pD = fnAddComponentsObject(Model);
+
+		// C is shared by A and B, and A also references it directly. Mesh2 is shared by A, C and D.
+		fnAddComponent(pA, pB);
+		fnAddComponent(pA, pC);
+		fnAddComponent(pA, pMesh2);
+		fnAddComponent(pB, pC);
+		fnAddComponent(pB, pMesh1);
+		fnAddComponent(pC, pMesh1);
+		fnAddComponent(pC, pMesh2);
+		fnAddComponent(pD, pMesh2);
+
+		std::vector<CModelObject *> Objects = Model.getSortedObjectList();
+
+		// Sorted by depth level descending, then by ResourceID ascending
+		const std::vector<CModelObject *> ExpectedObjects = { pMesh1.get(), pMesh2.get(), pC.get(), pB.get(), pA.get(), pD.get() };
+		ASSERT_EQ(Objects, ExpectedObjects);
+
+		// The depth level is the length of the longest component chain that leads to an object
+		ASSERT_EQ(pA->getComponentDepthLevel(), 1u);
+		ASSERT_EQ(pD->getComponentDepthLevel(), 1u);
+		ASSERT_EQ(pB->getComponentDepthLevel(), 2u);
+		ASSERT_EQ(pC->getComponentDepthLevel(), 3u);
+		ASSERT_EQ(pMesh1->getComponentDepthLevel(), 4u);
+		ASSERT_EQ(pMesh2->getComponentDepthLevel(), 4u);
+	}
+
+	TEST(Model, SortedObjectListWithoutComponents)
+	{
+		CModel Model;
+		PModelMeshObject pMesh1 = fnAddMeshObject(Model);
+		PModelMeshObject pMesh2 = fnAddMeshObject(Model);
+
+		std::vector<CModelObject *> Objects = Model.getSortedObjectList();
+		const std::vector<CModelObject *> ExpectedObjects = { pMesh1.get(), pMesh2.get() };
+		ASSERT_EQ(Objects, ExpectedObjects);
+		ASSERT_EQ(pMesh1->getComponentDepthLevel(), 1u);
+	}
+
+	TEST(Model, SortedObjectListDetectsComponentCycle)
+	{
+		CModel Model;
+		PModelComponentsObject pA = fnAddComponentsObject(Model);
+		PModelComponentsObject pB = fnAddComponentsObject(Model);
+		PModelComponentsObject pC = fnAddComponentsObject(Model);
+		PModelMeshObject pMesh = fnAddMeshObject(Model);
+
+		fnAddComponent(pA, pB);
+		fnAddComponent(pB, pC);
+		fnAddComponent(pC, pMesh);
+		fnAddComponent(pC, pA);
+
+		try {
+			Model.getSortedObjectList();
+			FAIL() << "A component cycle was not detected";
+		}
+		catch (CNMRException & Exception) {
+			ASSERT_EQ(Exception.getErrorCode(), NMR_ERROR_INVALIDMODELCOMPONENT);
+		}
+	}
+}
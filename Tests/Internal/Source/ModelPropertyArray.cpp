@@ -0,0 +1,129 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_ModelPropertyArray.cpp: Defines Unittests for the CModelPropertyArray class
+
+--*/
+
+#include "gtest/gtest.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
+
+#include <memory>
+
+namespace NMR
+{
+	TEST(ModelPropertyArray, DenseAccess)
+	{
+		CModelPropertyArray<nfUint32> Array;
+		for (nfUint32 nIndex = 0; nIndex < 10; nIndex++)
+			ASSERT_EQ(Array.add(nIndex * 10), nIndex + 1);
+
+		ASSERT_TRUE(Array.isDense());
+		ASSERT_EQ(Array.getCount(), 10u);
+		ASSERT_EQ(Array.get(4), 30u);
+		ASSERT_FALSE(Array.hasPropertyID(0));
+		ASSERT_FALSE(Array.hasPropertyID(11));
+		ASSERT_THROW(Array.get(11), CNMRException);
+	}
+
+	TEST(ModelPropertyArray, RemoveKeepsPropertyIDs)
+	{
+		CModelPropertyArray<nfUint32> Array;
+		for (nfUint32 nIndex = 0; nIndex < 10; nIndex++)
+			Array.add(nIndex * 10);
+
+		Array.remove(3);
+		Array.remove(7);
+		Array.remove(7);
+		Array.remove(42);
+		ASSERT_FALSE(Array.isDense());
+		ASSERT_EQ(Array.getCount(), 8u);
+		ASSERT_FALSE(Array.hasPropertyID(3));
+		ASSERT_FALSE(Array.hasPropertyID(7));
+		ASSERT_THROW(Array.get(7), CNMRException);
+		ASSERT_EQ(Array.get(8), 70u);
+
+		// New entries continue after the highest PropertyID ever handed out
+		ASSERT_EQ(Array.add(100), 11u);
+		ASSERT_EQ(Array.getCount(), 9u);
+
+		const ModelPropertyID ExpectedIDs[] = { 1, 2, 4, 5, 6, 8, 9, 10, 11 };
+		for (nfUint32 nIndex = 0; nIndex < 9; nIndex++) {
+			ModelPropertyID nPropertyID;
+			ASSERT_TRUE(Array.getPropertyID(nIndex, nPropertyID));
+			ASSERT_EQ(nPropertyID, ExpectedIDs[nIndex]);
+			ASSERT_EQ(Array.getByIndex(nIndex), (nPropertyID <= 10) ? (nPropertyID - 1) * 10 : 100);
+		}
+		ModelPropertyID nPropertyID;
+		ASSERT_FALSE(Array.getPropertyID(9, nPropertyID));
+		ASSERT_THROW(Array.getByIndex(9), CNMRException);
+
+		// Removing after a compaction marks entries again
+		Array.remove(1);
+		Array.remove(11);
+		ASSERT_EQ(Array.getCount(), 7u);
+		ASSERT_TRUE(Array.getPropertyID(0, nPropertyID));
+		ASSERT_EQ(nPropertyID, 2u);
+		ASSERT_TRUE(Array.getPropertyID(6, nPropertyID));
+		ASSERT_EQ(nPropertyID, 10u);
+	}
+
+	TEST(ModelPropertyArray, RemoveManyEntries)
+	{
+		const nfUint32 nCount = 200000;
+		CModelPropertyArray<nfUint32> Array;
+		Array.reserve(nCount);
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++)
+			Array.add(nIndex);
+
+		// Removing every other entry from the front would be quadratic if every removal shifted the array
+		for (ModelPropertyID nPropertyID = 1; nPropertyID <= nCount; nPropertyID += 2)
+			Array.remove(nPropertyID);
+		ASSERT_EQ(Array.getCount(), nCount / 2);
+
+		for (nfUint32 nIndex = 0; nIndex < nCount / 2; nIndex++) {
+			ModelPropertyID nPropertyID;
+			ASSERT_TRUE(Array.getPropertyID(nIndex, nPropertyID));
+			ASSERT_EQ(nPropertyID, 2 * nIndex + 2);
+			ASSERT_EQ(Array.getByIndex(nIndex), 2 * nIndex + 1);
+		}
+	}
+
+	TEST(ModelPropertyArray, RemoveReleasesEntry)
+	{
+		CModelPropertyArray<std::shared_ptr<nfUint32>> Array;
+		auto pEntry = std::make_shared<nfUint32>(1);
+		Array.add(pEntry);
+		Array.add(std::make_shared<nfUint32>(2));
+		ASSERT_EQ(pEntry.use_count(), 2);
+
+		Array.remove(1);
+		ASSERT_EQ(pEntry.use_count(), 1);
+		ASSERT_EQ(*Array.get(2), 2u);
+	}
+}
@@ -0,0 +1,167 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_ModelWriter_3MF.cpp: Defines Unittests for writing 3MF packages to streams that cannot seek
+
+--*/
+
+#include "gtest/gtest.h"
+#include "UnitTest_Streams.h"
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelBuildItem.h"
+#include "Model/Classes/NMR_ModelAttachment.h"
+#include "Model/Classes/NMR_ModelConstants.h"
+#include "Model/Reader/NMR_ModelReader_3MF_Native.h"
+#include "Model/Writer/NMR_ModelWriter_3MF_Native.h"
+#include "Common/Platform/NMR_ExportStream.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+#include "Common/Math/NMR_Matrix.h"
+#include "Common/NMR_Exception.h"
+
+namespace NMR
+{
+	// An export stream that can only be appended to. Every seek is counted, including those that are
+	// allowed to fail, so that a writer cannot silently fall back to seeking.
+	class CExportStream_SequentialSpy : public CExportStream {
+	private:
+		std::vector<nfByte> m_Data;
+		nfUint32 m_nSeekCount;
+
+		nfBool recordSeek(_In_ nfBool bHasToSucceed)
+		{
+			m_nSeekCount++;
+			if (bHasToSucceed)
+				throw CNMRException(NMR_ERROR_CALLBACKSTREAMCANNOTSEEK);
+			return false;
+		}
+	public:
+		CExportStream_SequentialSpy() : m_nSeekCount(0) {}
+
+		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed) { return recordSeek(bHasToSucceed); }
+		virtual nfBool seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed) { return recordSeek(bHasToSucceed); }
+		virtual nfBool seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed) { return recordSeek(bHasToSucceed); }
+		virtual nfUint64 getPosition() { return m_Data.size(); }
+		virtual nfBool canSeek() { return false; }
+
+		virtual nfUint64 writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite)
+		{
+			const nfByte * pBytes = (const nfByte *)pBuffer;
+			m_Data.insert(m_Data.end(), pBytes, pBytes + cbTotalBytesToWrite);
+			return cbTotalBytesToWrite;
+		}
+
+		const std::vector<nfByte> & getData() { return m_Data; }
+		nfUint32 getSeekCount() { return m_nSeekCount; }
+	};
+
+	nfUint64 fnReadZIPValue(_In_ const std::vector<nfByte> & Data, _In_ nfUint64 nOffset, _In_ nfUint32 nBytes)
+	{
+		if (nOffset + nBytes > Data.size())
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		nfUint64 nValue = 0;
+		for (nfUint32 nIndex = 0; nIndex < nBytes; nIndex++)
+			nValue |= ((nfUint64)Data[(size_t)(nOffset + nIndex)]) << (8 * nIndex);
+		return nValue;
+	}
+
+	// Returns the general purpose flags of all central directory entries
+	std::vector<nfUint16> fnReadZIPEntryFlags(_In_ const std::vector<nfByte> & Data)
+	{
+		nfUint64 nEndOffset = Data.size() - 22;
+		while (fnReadZIPValue(Data, nEndOffset, 4) != 0x06054b50)
+			nEndOffset--;
+		nfUint64 nEntryCount = fnReadZIPValue(Data, nEndOffset + 10, 2);
+		nfUint64 nDirectoryOffset = fnReadZIPValue(Data, nEndOffset + 16, 4);
+		if ((nEntryCount == 0xFFFF) || (nDirectoryOffset == 0xFFFFFFFF)) {
+			// The ZIP64 end of central directory locator precedes the end of central directory record
+			nfUint64 nEnd64Offset = fnReadZIPValue(Data, nEndOffset - 20 + 8, 8);
+			nEntryCount = fnReadZIPValue(Data, nEnd64Offset + 32, 8);
+			nDirectoryOffset = fnReadZIPValue(Data, nEnd64Offset + 48, 8);
+		}
+
+		std::vector<nfUint16> Flags;
+		nfUint64 nOffset = nDirectoryOffset;
+		for (nfUint64 nEntry = 0; nEntry < nEntryCount; nEntry++) {
+			EXPECT_EQ(fnReadZIPValue(Data, nOffset, 4), 0x02014b50u);
+			Flags.push_back((nfUint16)fnReadZIPValue(Data, nOffset + 8, 2));
+			nOffset += 46 + fnReadZIPValue(Data, nOffset + 28, 2) + fnReadZIPValue(Data, nOffset + 30, 2) + fnReadZIPValue(Data, nOffset + 32, 2);
+		}
+		return Flags;
+	}
+
+	TEST(ModelWriter_3MF, WriteToStreamWithoutSeeking)
+	{
+		PModel pModel = std::make_shared<CModel>();
+		PMesh pMesh = std::make_shared<CMesh>();
+		MESHNODE * pNodes[4];
+		pNodes[0] = pMesh->addNode(fnVEC3_make(0.0f, 0.0f, 0.0f));
+		pNodes[1] = pMesh->addNode(fnVEC3_make(10.0f, 0.0f, 0.0f));
+		pNodes[2] = pMesh->addNode(fnVEC3_make(0.0f, 10.0f, 0.0f));
+		pNodes[3] = pMesh->addNode(fnVEC3_make(0.0f, 0.0f, 10.0f));
+		pMesh->addFace(pNodes[0], pNodes[2], pNodes[1]);
+		pMesh->addFace(pNodes[0], pNodes[1], pNodes[3]);
+		pMesh->addFace(pNodes[1], pNodes[2], pNodes[3]);
+		pMesh->addFace(pNodes[2], pNodes[0], pNodes[3]);
+		PModelMeshObject pObject = std::make_shared<CModelMeshObject>(pModel->generateResourceID(), pModel.get(), pMesh);
+		pModel->addResource(pObject);
+		pModel->addBuildItem(std::make_shared<CModelBuildItem>(pObject.get(), pModel->createHandle()));
+
+		std::vector<nfByte> Payload = fnCreateStreamTestData(200000);
+		pModel->addAttachment("/3D/Textures/texture.png", PACKAGE_TEXTURE_RELATIONSHIP_TYPE,
+			std::make_shared<CImportStream_Shared_Memory>(Payload.data(), Payload.size()));
+
+		std::shared_ptr<CExportStream_SequentialSpy> pStream = std::make_shared<CExportStream_SequentialSpy>();
+		CModelWriter_3MF_Native Writer(pModel);
+		Writer.exportToStream(pStream);
+		ASSERT_EQ(pStream->getSeekCount(), 0u);
+
+		// CRC and sizes of every entry follow its data in a data descriptor
+		std::vector<nfUint16> Flags = fnReadZIPEntryFlags(pStream->getData());
+		ASSERT_GE(Flags.size(), 4u);
+		for (auto iIterator = Flags.begin(); iIterator != Flags.end(); iIterator++)
+			ASSERT_NE(*iIterator & 0x0008, 0);
+
+		PModel pReadModel = std::make_shared<CModel>();
+		CModelReader_3MF_Native Reader(pReadModel);
+		Reader.readStream(std::make_shared<CImportStream_Shared_Memory>(pStream->getData().data(), pStream->getData().size()));
+		ASSERT_EQ(Reader.warnings()->getWarningCount(), 0u);
+		ASSERT_EQ(pReadModel->getObjectCount(), 1u);
+		ASSERT_EQ(pReadModel->getBuildItemCount(), 1u);
+
+		PModelAttachment pAttachment = pReadModel->findModelAttachment("/3D/Textures/texture.png");
+		ASSERT_TRUE(pAttachment != nullptr);
+		PImportStream pAttachmentStream = pAttachment->getStream();
+		ASSERT_EQ(pAttachmentStream->retrieveSize(), Payload.size());
+		std::vector<nfByte> ReadPayload(Payload.size());
+		pAttachmentStream->seekPosition(0, true);
+		pAttachmentStream->readBuffer(ReadPayload.data(), ReadPayload.size(), true);
+		ASSERT_TRUE(ReadPayload == Payload);
+	}
+
+}